@@ -0,0 +1,71 @@
+#include "pch.h"
+#include "Microbenchmark.h"
+#include "Assets/AssetManager.h"
+
+namespace
+{
+// Project-like tree: sources with metas spread over nested folders, half textures with import settings, half materials
+void make_assets_tree(const std::filesystem::path &root, uint32_t asset_count)
+{
+	MicrobenchmarkRandom random(1);
+	std::filesystem::remove_all(root);
+	for (uint32_t i = 0; i < asset_count; i++)
+	{
+		std::filesystem::path folder = root / eastl::string().sprintf("Folder%u/Sub%u", i / 2048, i / 128 % 16).c_str();
+		if (i % 128 == 0)
+			std::filesystem::create_directories(folder);
+
+		bool is_texture = i % 2 == 0;
+		std::filesystem::path source_path = folder / eastl::string().sprintf("Asset%u%s", i, is_texture ? ".png" : ".material").c_str();
+		std::ofstream(source_path).close();
+
+		std::filesystem::path meta_path = source_path;
+		meta_path += ".meta";
+		std::ofstream meta(meta_path);
+		meta << "guid: " << (uint64_t(random.next()) << 32 | random.next() | 1) << "\n";
+		meta << "runtime_guid: " << (is_texture ? uint64_t(random.next()) << 32 | random.next() | 1 : 0) << "\n";
+		meta << "runtime_version: 1\n";
+		meta << "type: " << (is_texture ? "Texture" : "Material") << "\n";
+		if (is_texture && i % 4 == 0)
+			meta << "Parameters:\n  generate_mipmaps: false\n";
+	}
+}
+
+void bench_refresh(Microbenchmarks &bench, const char *cold_name, const char *warm_name, uint32_t asset_count)
+{
+	if (!bench.isEnabled(cold_name) && !bench.isEnabled(warm_name))
+		return;
+
+	std::filesystem::path previous_root = AssetManager::getAssetsRoot();
+	std::filesystem::path root = std::filesystem::temp_directory_path() / "MicrobenchmarkAssets";
+	make_assets_tree(root, asset_count);
+	AssetManager::setAssetsRoot(root);
+	std::filesystem::path registry_path = root / ".runtimes" / "registry.bin";
+
+	// Cold: every meta is parsed, as on the first start or after the registry is lost
+	bench.run(cold_name, asset_count, [&]()
+	{
+		AssetManager::shutdown();
+		std::filesystem::remove(registry_path);
+		AssetManager::refresh();
+	});
+
+	// Warm: metas are unchanged since the registry was saved
+	AssetManager::shutdown();
+	AssetManager::refresh();
+	bench.run(warm_name, asset_count, [&]()
+	{
+		AssetManager::shutdown();
+		AssetManager::refresh();
+	});
+
+	AssetManager::shutdown();
+	AssetManager::setAssetsRoot(previous_root);
+	std::filesystem::remove_all(root);
+}
+}
+
+void runAssetBenchmarks(Microbenchmarks &bench)
+{
+	bench_refresh(bench, "AssetManager/refresh_cold_100k", "AssetManager/refresh_warm_100k", 100000);
+}
@@ -0,0 +1,85 @@
+#include "pch.h"
+#include "Microbenchmark.h"
+#include "Rendering/DDGIProbeScheduler.h"
+
+namespace
+{
+// Default volume: 16x8x16 probes in 4 cascades, variances are spread like a scene with a few changing regions
+void bench_schedule(Microbenchmarks &bench, const char *name, uint32_t budget)
+{
+	if (!bench.isEnabled(name))
+		return;
+
+	const uint32_t probes_count = 16 * 8 * 16 * 4;
+	MicrobenchmarkRandom random(1);
+	DDGIProbeScheduler scheduler;
+	scheduler.reset(probes_count);
+	for (uint32_t probe = 0; probe < probes_count; probe++)
+	{
+		float change = random.unit();
+		scheduler.reportChange(probe, change * change * change);
+	}
+	for (uint32_t i = 0; i < 256; i++)
+		scheduler.markSceneChanged(random.range(probes_count));
+
+	eastl::vector<uint32_t> scheduled;
+	bench.run(name, probes_count, [&]()
+	{
+		scheduled.clear();
+		scheduler.schedule(budget, scheduled);
+	});
+}
+
+// Static frames, then a light moving through the volume and a scene-wide change. Whatever the priorities are,
+// no probe may wait longer than the starvation bound and no frame may update more probes than the budget.
+// Same frames are replayed round robin (no variance and scene change priorities), adaptive scheduling must leave
+// at least 10% less error behind. Half of a 256 budget is reserved for the oldest probes, so the gain grows with the budget
+void bench_replay(Microbenchmarks &bench, const char *name, uint32_t budget)
+{
+	if (!bench.isEnabled(name))
+		return;
+
+	const uint32_t probes_count = 16 * 8 * 16 * 4;
+	const uint32_t frames_count = 600;
+	eastl::vector<DDGIProbeScheduler::ReplayFrame> frames(frames_count);
+	for (uint32_t frame = 200; frame < 400; frame++)
+	{
+		uint32_t light_probe = (frame - 200) * probes_count / 200;
+		for (uint32_t probe = light_probe; probe < eastl::min(light_probe + 64, probes_count); probe++)
+			frames[frame].changed_probes.push_back(probe);
+	}
+	for (uint32_t probe = 0; probe < probes_count; probe++)
+		frames[450].changed_probes.push_back(probe);
+
+	eastl::span<const DDGIProbeScheduler::ReplayFrame> frames_span(frames.data(), frames.size());
+	DDGIProbeScheduler scheduler;
+	DDGIProbeScheduler::ReplayResult result = DDGIProbeScheduler::replay(scheduler, probes_count, budget, frames_span, 0.01f);
+
+	DDGIProbeScheduler round_robin_scheduler;
+	round_robin_scheduler.variance_weight = 0.0f;
+	round_robin_scheduler.scene_change_boost = 0.0f;
+	DDGIProbeScheduler::ReplayResult round_robin_result = DDGIProbeScheduler::replay(round_robin_scheduler, probes_count, budget, frames_span, 0.01f);
+
+	uint32_t starvation_bound = scheduler.getStarvationBound(budget);
+	eastl::string message;
+	message.sprintf("%u updates, max age %u (bound %u), at most %u updates per frame (budget %u), average error %.4f (round robin %.4f)",
+					(uint32_t)result.updates, result.max_age, starvation_bound, result.max_frame_updates, budget, result.average_error,
+					round_robin_result.average_error);
+	bench.check(name, result.updates > 0 && result.max_age <= starvation_bound && result.max_frame_updates <= budget &&
+				result.average_error <= round_robin_result.average_error * 0.9, message);
+
+	bench.run(name, uint64_t(probes_count) * frames_count, [&]()
+	{
+		DDGIProbeScheduler replay_scheduler;
+		DDGIProbeScheduler::replay(replay_scheduler, probes_count, budget, frames_span, 0.01f);
+	});
+}
+}
+
+void runDDGIBenchmarks(Microbenchmarks &bench)
+{
+	bench_schedule(bench, "DDGI/schedule_8192_probes_256", 256);
+	bench_schedule(bench, "DDGI/schedule_8192_probes_1024", 1024);
+	bench_replay(bench, "DDGI/replay_8192_probes_256", 256);
+	bench_replay(bench, "DDGI/replay_8192_probes_1024", 1024);
+}
@@ -0,0 +1,84 @@
+#include "pch.h"
+#include "Microbenchmark.h"
+#include "Renderers/DebugDrawList.h"
+
+namespace
+{
+void make_spheres(uint32_t count, eastl::vector<glm::vec4> &spheres)
+{
+	MicrobenchmarkRandom random(1);
+	spheres.resize(count);
+	for (glm::vec4 &sphere : spheres)
+		sphere = glm::vec4(random.unit() * 1000.0f, random.unit() * 100.0f, random.unit() * 1000.0f, 0.1f + random.unit());
+}
+
+// Immediate drawing: the list is refilled and uploaded every frame
+void bench_immediate_spheres(Microbenchmarks &bench, const char *name, uint32_t count)
+{
+	if (!bench.isEnabled(name))
+		return;
+
+	eastl::vector<glm::vec4> spheres;
+	make_spheres(count, spheres);
+
+	DebugDrawList list;
+	bench.run(name, count, [&]()
+	{
+		list.clear();
+		for (const glm::vec4 &sphere : spheres)
+			list.addSphere(glm::vec3(sphere), sphere.w, glm::vec3(1, 0, 0));
+		list.upload();
+	});
+}
+
+void bench_immediate_boxes(Microbenchmarks &bench, const char *name, uint32_t count)
+{
+	if (!bench.isEnabled(name))
+		return;
+
+	eastl::vector<glm::vec4> spheres;
+	make_spheres(count, spheres);
+
+	DebugDrawList list;
+	bench.run(name, count, [&]()
+	{
+		list.clear();
+		for (const glm::vec4 &sphere : spheres)
+			list.addBoundBox(BoundBox(glm::vec3(sphere) - sphere.w, glm::vec3(sphere) + sphere.w), glm::vec3(0, 1, 0));
+		list.upload();
+	});
+}
+
+// Retained drawing: the list is filled once, frames only submit it
+void bench_retained_spheres(Microbenchmarks &bench, const char *name, uint32_t count)
+{
+	if (!bench.isEnabled(name))
+		return;
+
+	eastl::vector<glm::vec4> spheres;
+	make_spheres(count, spheres);
+
+	DebugDrawList list;
+	list.reserve(DEBUG_PRIMITIVE_SPHERE, count);
+	for (const glm::vec4 &sphere : spheres)
+		list.addSphere(glm::vec3(sphere), sphere.w, glm::vec3(1, 0, 0));
+
+	bench.run(name, count, [&]()
+	{
+		list.upload();
+	});
+
+	// Line list of a 16 segment sphere made of six circles, as spheres were drawn before instancing
+	uint64_t line_sphere_bytes = 6 * 16 * 2 * (sizeof(glm::vec4) + sizeof(glm::vec3));
+	eastl::string message;
+	message.sprintf("%u uploads, %u B per sphere instead of %u B of lines", list.getUploadsCount(), (uint32_t)sizeof(DebugPrimitiveGPU), (uint32_t)line_sphere_bytes);
+	bench.check(name, list.getUploadsCount() == 1 && list.getCount(DEBUG_PRIMITIVE_SPHERE) == count, message);
+}
+}
+
+void runDebugDrawBenchmarks(Microbenchmarks &bench)
+{
+	bench_immediate_spheres(bench, "DebugDraw/immediate_spheres_1m", 1000000);
+	bench_immediate_boxes(bench, "DebugDraw/immediate_boxes_1m", 1000000);
+	bench_retained_spheres(bench, "DebugDraw/retained_spheres_1m", 1000000);
+}
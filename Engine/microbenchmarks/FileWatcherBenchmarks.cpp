@@ -0,0 +1,153 @@
+#include "pch.h"
+#include "Microbenchmark.h"
+#include "Utils/FileWatcher.h"
+#include <fstream>
+#include <thread>
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+// Watched empty directory in temp, removed with everything in it when the case ends
+struct WatchedDirectory
+{
+	std::filesystem::path root = std::filesystem::temp_directory_path() / "MicrobenchmarkFileWatcher";
+	FileWatcher watcher;
+	bool is_watched = false;
+
+	WatchedDirectory()
+	{
+		std::filesystem::remove_all(root);
+		std::filesystem::create_directories(root);
+		is_watched = watcher.addPath(root.wstring().c_str());
+	}
+
+	~WatchedDirectory()
+	{
+		std::filesystem::remove_all(root);
+	}
+
+	// Batch of the changes made so far, popped as if the debounce and batch times passed.
+	// Windows delivers notifications asynchronously, so polling is retried for a while
+	bool popSettledBatch(eastl::vector<FileWatcher::Change> &changes, uint32_t attempts = 50)
+	{
+		for (uint32_t attempt = 0; attempt < attempts; attempt++)
+		{
+			Clock::time_point now = Clock::now();
+			watcher.poll(now);
+			if (watcher.popBatch(changes, now + std::chrono::seconds(10)))
+				return true;
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		}
+		return false;
+	}
+};
+
+void write_file(const std::filesystem::path &path, const char *content)
+{
+	std::ofstream file(path, std::ios::binary);
+	file << content;
+}
+
+eastl::string describe(const eastl::vector<FileWatcher::Change> &changes)
+{
+	eastl::string text;
+	for (const FileWatcher::Change &change : changes)
+	{
+		if (!text.empty())
+			text += ", ";
+		text += std::filesystem::path(change.path.c_str()).filename().string().c_str();
+		text += change.type == FileWatcher::ChangeType::Changed ? " changed" : " removed";
+	}
+	return text.empty() ? "nothing" : text;
+}
+
+bool is_single_change(const eastl::vector<FileWatcher::Change> &changes, const char *filename, FileWatcher::ChangeType type)
+{
+	return changes.size() == 1 && std::filesystem::path(changes[0].path.c_str()).filename() == filename && changes[0].type == type;
+}
+
+void check_create(Microbenchmarks &bench, const char *name)
+{
+	if (!bench.isEnabled(name))
+		return;
+
+	WatchedDirectory directory;
+	write_file(directory.root / "created.txt", "created");
+
+	eastl::vector<FileWatcher::Change> changes;
+	directory.popSettledBatch(changes);
+	bench.check(name, directory.is_watched && is_single_change(changes, "created.txt", FileWatcher::ChangeType::Changed), describe(changes));
+}
+
+// File written in chunks and kept open must not be reported until it is closed, even past the batch time
+void check_write_in_chunks(Microbenchmarks &bench, const char *name)
+{
+	if (!bench.isEnabled(name))
+		return;
+
+	WatchedDirectory directory;
+	eastl::vector<FileWatcher::Change> changes;
+	bool is_reported_open = false;
+	{
+		std::ofstream file(directory.root / "chunks.bin", std::ios::binary);
+		for (uint32_t chunk = 0; chunk < 4; chunk++)
+		{
+			eastl::vector<char> data(64 * 1024, char('a' + chunk));
+			file.write(data.data(), data.size());
+			file.flush();
+#ifndef _WIN32
+			is_reported_open |= directory.popSettledBatch(changes, 1);
+#endif
+		}
+	}
+	directory.popSettledBatch(changes);
+
+	eastl::string message;
+	message.sprintf("%s while open, %s after close", is_reported_open ? "reported" : "not reported", describe(changes).c_str());
+	bench.check(name, directory.is_watched && !is_reported_open && is_single_change(changes, "chunks.bin", FileWatcher::ChangeType::Changed), message);
+}
+
+// Editor save: new content goes to a temp file that is renamed over the target. Temp file is created and gone in one batch
+void check_rename(Microbenchmarks &bench, const char *name)
+{
+	if (!bench.isEnabled(name))
+		return;
+
+	WatchedDirectory directory;
+	write_file(directory.root / "saved.txt", "old");
+	eastl::vector<FileWatcher::Change> changes;
+	directory.popSettledBatch(changes);
+
+	write_file(directory.root / "saved.txt.tmp", "new");
+	std::filesystem::rename(directory.root / "saved.txt.tmp", directory.root / "saved.txt");
+	directory.popSettledBatch(changes);
+	bench.check(name, directory.is_watched && is_single_change(changes, "saved.txt", FileWatcher::ChangeType::Changed), describe(changes));
+}
+
+// Deleted file is reported as removed, a file created and deleted in one batch is not reported at all
+void check_delete(Microbenchmarks &bench, const char *name)
+{
+	if (!bench.isEnabled(name))
+		return;
+
+	WatchedDirectory directory;
+	write_file(directory.root / "deleted.txt", "deleted");
+	eastl::vector<FileWatcher::Change> changes;
+	directory.popSettledBatch(changes);
+
+	std::filesystem::remove(directory.root / "deleted.txt");
+	write_file(directory.root / "temporary.txt", "temporary");
+	std::filesystem::remove(directory.root / "temporary.txt");
+	directory.popSettledBatch(changes);
+	bench.check(name, directory.is_watched && is_single_change(changes, "deleted.txt", FileWatcher::ChangeType::Removed), describe(changes));
+}
+}
+
+void runFileWatcherBenchmarks(Microbenchmarks &bench)
+{
+	check_create(bench, "FileWatcher/create");
+	check_write_in_chunks(bench, "FileWatcher/write_in_chunks");
+	check_rename(bench, "FileWatcher/rename");
+	check_delete(bench, "FileWatcher/delete");
+}
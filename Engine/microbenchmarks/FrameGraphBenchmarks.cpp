@@ -0,0 +1,61 @@
+#include "pch.h"
+#include "Microbenchmark.h"
+#include "FrameGraph/FrameGraph.h"
+
+namespace
+{
+// Chain of passes shaped like a frame: every pass renders a new target from the previous ones,
+// some passes write debug targets nobody reads and get culled, the last one presents.
+void build_frame_graph(FrameGraph &frame_graph, uint32_t pass_count)
+{
+	for (uint32_t i = 0; i < pass_count; i++)
+	{
+		frame_graph.addCallbackPass(eastl::string().sprintf("Microbenchmark Pass %u", i),
+		[&](RenderPassBuilder &builder)
+		{
+			builder.createTexture(GFXRID_ID(MicrobenchmarkTarget, i), 1920, 1080, FORMAT_R16G16B16A16_SFLOAT);
+			builder.writeTexture(GFXRID_ID(MicrobenchmarkTarget, i));
+			if (i % 8 != 7)
+			{
+				builder.createBuffer(GFXRID_ID(MicrobenchmarkBuffer, i), sizeof(uint32_t), 4096, BufferUsage::NONE);
+				builder.writeBuffer(GFXRID_ID(MicrobenchmarkBuffer, i));
+			}
+
+			// Debug passes (every 8th) are not read by anyone
+			for (uint32_t input : {i - 1, i - 2, i - 4})
+			{
+				if (input < i && input % 8 != 7)
+				{
+					builder.readTexture(GFXRID_ID(MicrobenchmarkTarget, input));
+					builder.readBuffer(GFXRID_ID(MicrobenchmarkBuffer, input));
+				}
+			}
+
+			if (i == pass_count - 1)
+				builder.setSideEffect(true);
+		},
+		[](const RenderPassResources &resources, RHICommandList *cmd_list)
+		{
+		});
+	}
+}
+
+void bench_frame_graph(Microbenchmarks &bench, const char *name, uint32_t pass_count)
+{
+	if (!bench.isEnabled(name))
+		return;
+
+	bench.run(name, pass_count, [&]()
+	{
+		FrameGraph frame_graph;
+		build_frame_graph(frame_graph, pass_count);
+		frame_graph.compile();
+	});
+}
+}
+
+void runFrameGraphBenchmarks(Microbenchmarks &bench)
+{
+	bench_frame_graph(bench, "FrameGraph/build_compile_64_passes", 64);
+	bench_frame_graph(bench, "FrameGraph/build_compile_512_passes", 512);
+}
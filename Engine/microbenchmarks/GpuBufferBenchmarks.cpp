@@ -0,0 +1,131 @@
+#include "pch.h"
+#include "Microbenchmark.h"
+#include "FrameGraph/FrameGraph.h"
+#include "Rendering/GpuTable.h"
+#include "Rendering/GlobalBufferCache.h"
+
+namespace
+{
+// Same size as a row of instance transforms
+struct TableRow
+{
+	glm::mat4 transform;
+};
+
+void bench_gpu_table_dirty_rows(Microbenchmarks &bench, const char *name, uint32_t rows, uint32_t changed_rows)
+{
+	if (!bench.isEnabled(name))
+		return;
+
+	GpuTable<TableRow> table;
+	table.init("Microbenchmark Table", rows, ReplicationPolicy::DirtyRows);
+	for (uint32_t i = 0; i < rows; i++)
+		table.add({glm::mat4(1.0f)});
+
+	MicrobenchmarkRandom random(1);
+	RHICommandList *cmd_list = gDynamicRHI->getCmdList();
+	bench.run(name, changed_rows, [&]()
+	{
+		gUploadManager->beginFrame();
+		for (uint32_t i = 0; i < changed_rows; i++)
+			table.set(random.range(rows), {glm::mat4(random.unit())});
+		table.upload(cmd_list);
+	});
+}
+
+void bench_gpu_table_copy(Microbenchmarks &bench, const char *name, uint32_t rows)
+{
+	if (!bench.isEnabled(name))
+		return;
+
+	GpuTable<TableRow> table;
+	table.init("Microbenchmark Table", rows, ReplicationPolicy::Copy);
+
+	eastl::vector<TableRow> values(rows, {glm::mat4(1.0f)});
+	RHICommandList *cmd_list = gDynamicRHI->getCmdList();
+	bench.run(name, rows, [&]()
+	{
+		gUploadManager->beginFrame();
+		table.reset();
+		table.addArray(eastl::span<const TableRow>(values.data(), values.size()));
+		table.upload(cmd_list);
+	});
+}
+
+void bench_gpu_table_add_free(Microbenchmarks &bench, const char *name, uint32_t live_rows, uint32_t changes)
+{
+	if (!bench.isEnabled(name))
+		return;
+
+	GpuTable<TableRow> table;
+	table.init("Microbenchmark Table", live_rows, ReplicationPolicy::DirtyRows);
+
+	// Entities spawn and die in random order, free ranges get fragmented
+	eastl::vector<uint32_t> slots;
+	for (uint32_t i = 0; i < live_rows; i++)
+		slots.push_back(table.add({glm::mat4(1.0f)}));
+
+	MicrobenchmarkRandom random(1);
+	bench.run(name, changes * 2, [&]()
+	{
+		for (uint32_t i = 0; i < changes; i++)
+		{
+			uint32_t &slot = slots[random.range(slots.size())];
+			table.free(slot);
+			slot = table.add({glm::mat4(1.0f)});
+		}
+	});
+}
+
+void bench_global_buffer_allocate(Microbenchmarks &bench, const char *name, uint32_t live_allocations, uint32_t changes)
+{
+	if (!bench.isEnabled(name))
+		return;
+
+	struct Allocation
+	{
+		uint64_t offset;
+		uint32_t size;
+	};
+
+	// Meshlet geometry of streamed LOD groups, 1..256 KB each
+	constexpr uint32_t MAX_SIZE = 256 * 1024;
+	BufferDescription source_desc;
+	source_desc.size = MAX_SIZE;
+	source_desc.use_staging_buffer = false;
+	RHIBufferRef source = gDynamicRHI->createBuffer(source_desc);
+	RHICommandList *cmd_list = gDynamicRHI->getCmdList();
+
+	MicrobenchmarkRandom random(1);
+	auto allocate = [&]()
+	{
+		uint32_t size = Math::alignedSize<uint32_t>(1024 + random.range(MAX_SIZE - 1024), 16);
+		return Allocation{GlobalBufferCache::addMeshletGeometryData(source, 0, size, cmd_list), size};
+	};
+
+	eastl::vector<Allocation> allocations;
+	for (uint32_t i = 0; i < live_allocations; i++)
+		allocations.push_back(allocate());
+
+	bench.run(name, changes * 2, [&]()
+	{
+		for (uint32_t i = 0; i < changes; i++)
+		{
+			Allocation &allocation = allocations[random.range(allocations.size())];
+			if (allocation.offset != UINT64_MAX)
+				GlobalBufferCache::removeMeshletGeometryData(allocation.offset, allocation.size);
+			allocation = allocate();
+		}
+	});
+
+	GlobalBufferCache::shutdown();
+}
+}
+
+void runGpuBufferBenchmarks(Microbenchmarks &bench)
+{
+	bench_gpu_table_dirty_rows(bench, "GpuTable/set_1k_of_64k_dirty_rows", 65536, 1024);
+	bench_gpu_table_copy(bench, "GpuTable/copy_16k_rows", 16384);
+	bench_gpu_table_add_free(bench, "GpuTable/add_free_16k_live", 16384, 256);
+	bench_global_buffer_allocate(bench, "GlobalBuffer/allocate_range_4k_live", 4096, 64);
+}
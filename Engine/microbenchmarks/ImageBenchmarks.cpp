@@ -0,0 +1,173 @@
+#include "pch.h"
+#include "Microbenchmark.h"
+#include "Utils/BCnEncoder.h"
+#include "Utils/Image.h"
+#include "Utils/Math.h"
+#include "Utils/dds.h"
+#include <fstream>
+
+namespace
+{
+// Photo-like RGBA8 image: smooth gradients with grain, a few hard edged shapes and an alpha ramp
+eastl::vector<uint8_t> make_photo(uint32_t size)
+{
+	MicrobenchmarkRandom random(1);
+	eastl::vector<uint8_t> rgba((uint64_t)size * size * 4);
+	for (uint32_t y = 0; y < size; y++)
+	{
+		for (uint32_t x = 0; x < size; x++)
+		{
+			float u = x / float(size);
+			float v = y / float(size);
+			float color[4] = {
+				0.5f + 0.4f * sinf(u * 6.0f + v * 2.0f),
+				0.5f + 0.4f * cosf(v * 5.0f - u * 3.0f),
+				0.3f + 0.3f * u * v,
+				u
+			};
+			// Shapes with sharp edges inside blocks
+			if ((x / 37 + y / 29) % 7 == 0)
+			{
+				color[0] = 0.9f;
+				color[1] = 0.15f;
+			}
+			uint8_t *texel = rgba.data() + ((uint64_t)y * size + x) * 4;
+			for (uint32_t c = 0; c < 4; c++)
+			{
+				float grain = c < 3 ? (random.unit() - 0.5f) * 0.03f : 0.0f;
+				texel[c] = (uint8_t)glm::clamp((color[c] + grain) * 255.0f + 0.5f, 0.0f, 255.0f);
+			}
+		}
+	}
+	return rgba;
+}
+
+// Encodes every block on one thread, the check decodes them back and compares the channels the format keeps.
+// PSNR thresholds are a few dB under what the encoder reaches, so quality regressions fail the run
+void bench_encode(Microbenchmarks &bench, const char *name, Format format, uint32_t size, double min_psnr)
+{
+	if (!bench.isEnabled(name))
+		return;
+
+	eastl::vector<uint8_t> rgba = make_photo(size);
+	uint32_t blocks_side = Math::divideRoundUp(size, 4u);
+	uint32_t block_bytes = BCn::getBlockBytes(format);
+	eastl::vector<uint8_t> compressed((uint64_t)blocks_side * blocks_side * block_bytes);
+	auto encode = [&]()
+	{
+		uint8_t texels[64];
+		uint8_t *block = compressed.data();
+		for (uint32_t y = 0; y < blocks_side; y++)
+		{
+			for (uint32_t x = 0; x < blocks_side; x++, block += block_bytes)
+			{
+				BCn::loadBlock(rgba.data(), size, size, x, y, texels);
+				BCn::encodeBlock(format, texels, block);
+			}
+		}
+	};
+
+	auto start_time = std::chrono::steady_clock::now();
+	encode();
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+
+	uint32_t channels = BCn::getChannelCount(format);
+	double squared_error = 0.0;
+	bool is_decoded = true;
+	uint8_t texels[64];
+	uint8_t decoded[64];
+	const uint8_t *block = compressed.data();
+	for (uint32_t y = 0; y < blocks_side; y++)
+	{
+		for (uint32_t x = 0; x < blocks_side; x++, block += block_bytes)
+		{
+			BCn::loadBlock(rgba.data(), size, size, x, y, texels);
+			is_decoded &= BCn::decodeBlock(format, block, decoded);
+			for (uint32_t i = 0; i < 64; i++)
+			{
+				if (i % 4 >= channels)
+					continue;
+				int d = (int)texels[i] - (int)decoded[i];
+				squared_error += d * d;
+			}
+		}
+	}
+	double mse = squared_error / ((double)size * size * channels);
+	double psnr = mse > 0.0 ? 10.0 * log10(255.0 * 255.0 / mse) : 99.0;
+
+	eastl::string message;
+	message.sprintf("PSNR %.2f dB (at least %.1f), %.1f MTexels/s on one thread", psnr, min_psnr, (double)size * size / eastl::max(seconds, 1e-9) / 1e6);
+	bench.check(name, is_decoded && psnr >= min_psnr, message);
+
+	bench.run(name, (uint64_t)size * size, encode);
+}
+
+// BC7 .dds with a full mip chain of random blocks, returns bytes of all mips
+uint64_t write_dds(const std::filesystem::path &path, uint32_t size)
+{
+	uint32_t mip_levels = 1;
+	while ((size >> mip_levels) > 0)
+		mip_levels++;
+
+	uint64_t data_size = 0;
+	for (uint32_t mip = 0; mip < mip_levels; mip++)
+	{
+		uint64_t blocks_side = Math::divideRoundUp(size >> mip, 4u);
+		data_size += blocks_side * blocks_side * BCn::getBlockBytes(FORMAT_BC7);
+	}
+
+	eastl::vector<uint8_t> file(sizeof(dds::Header) + data_size);
+	dds::write_header(file.data(), dds::DXGI_FORMAT_BC7_UNORM, size, size, mip_levels);
+	MicrobenchmarkRandom random(1);
+	for (uint64_t i = sizeof(dds::Header); i < file.size(); i++)
+		file[i] = (uint8_t)random.next();
+	std::ofstream(path, std::ios::binary).write((const char *)file.data(), file.size());
+	return data_size;
+}
+
+// Loads a .dds runtime and copies its mips into upload memory, as texture uploads do. Mapped images copy straight from
+// the page cache, heap ones first copy all mips to the heap as loading did before .dds files were mapped
+void bench_load_dds(Microbenchmarks &bench, const char *name, uint32_t size, bool is_mapped)
+{
+	if (!bench.isEnabled(name))
+		return;
+
+	std::filesystem::path path = std::filesystem::temp_directory_path() / "microbenchmark_image.dds";
+	uint64_t data_size = write_dds(path, size);
+
+	eastl::vector<uint8_t> staging(data_size);
+	uint64_t uploaded_bytes = 0;
+	uint64_t heap_bytes = 0;
+	auto load = [&]()
+	{
+		Image image(path.string().c_str());
+		if (!is_mapped)
+			image.copyMappedData();
+		eastl::span<const uint8_t> data = image.getData();
+		uploaded_bytes = eastl::min<uint64_t>(data.size(), staging.size());
+		memcpy(staging.data(), data.data(), uploaded_bytes);
+		heap_bytes = image.isMapped() ? 0 : data.size();
+	};
+
+	auto start_time = std::chrono::steady_clock::now();
+	load();
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+
+	eastl::string message;
+	message.sprintf("%.1f MB of mips, %.1f MB on the heap, first load %.2f ms", data_size / 1048576.0, heap_bytes / 1048576.0, seconds * 1000.0);
+	bench.check(name, uploaded_bytes == data_size && heap_bytes == (is_mapped ? 0 : data_size), message);
+
+	bench.run(name, 1, load);
+	std::filesystem::remove(path);
+}
+}
+
+void runImageBenchmarks(Microbenchmarks &bench)
+{
+	bench_load_dds(bench, "Image/load_dds_2k_bc7_mapped", 2048, true);
+	bench_load_dds(bench, "Image/load_dds_2k_bc7_heap", 2048, false);
+	bench_encode(bench, "BCn/encode_bc1_512", FORMAT_BC1, 512, 38.0);
+	bench_encode(bench, "BCn/encode_bc4_512", FORMAT_BC4, 512, 46.0);
+	bench_encode(bench, "BCn/encode_bc5_512", FORMAT_BC5, 512, 46.0);
+	bench_encode(bench, "BCn/encode_bc7_512", FORMAT_BC7, 512, 42.0);
+}
@@ -0,0 +1,78 @@
+#include "pch.h"
+#include "Microbenchmark.h"
+#include "Rendering/LightClusters.h"
+
+namespace
+{
+// Point lights scattered in front of a camera at the origin looking down -z, a few of them behind it or past z_far
+void make_lights(uint64_t seed, uint32_t count, float z_far, eastl::vector<LightClusters::Light> &lights)
+{
+	MicrobenchmarkRandom random(seed);
+	lights.resize(count);
+	for (LightClusters::Light &light : lights)
+	{
+		float u = random.unit();
+		float depth = -5.0f + u * u * (z_far + 50.0f);
+		light.position = glm::vec3((random.unit() * 2.0f - 1.0f) * depth, (random.unit() * 2.0f - 1.0f) * depth * 0.6f, -depth);
+		float r = random.unit();
+		light.radius = 0.1f + r * r * r * 30.0f;
+	}
+}
+
+bool is_same_lists(const LightClusters &a, const LightClusters &b)
+{
+	const eastl::vector<LightClusters::Range> &ranges_a = a.getRanges();
+	const eastl::vector<LightClusters::Range> &ranges_b = b.getRanges();
+	for (uint32_t cluster = 0; cluster < LightClusters::CLUSTERS_COUNT; cluster++)
+	{
+		if (ranges_a[cluster].offset != ranges_b[cluster].offset || ranges_a[cluster].count != ranges_b[cluster].count)
+			return false;
+	}
+	return a.getLightIndices() == b.getLightIndices();
+}
+
+// SSE binning against the scalar reference on several light sets, then the time of the default path
+void bench_build(Microbenchmarks &bench, const char *name, uint32_t lights_count, uint32_t seeds_count)
+{
+	if (!bench.isEnabled(name))
+		return;
+
+	const float z_near = 0.1f;
+	const float z_far = 500.0f;
+	glm::mat4 view = glm::mat4(1.0f);
+	glm::mat4 projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, z_near, z_far);
+
+	LightClusters clusters;
+	LightClusters reference_clusters;
+	reference_clusters.use_reference_binning = true;
+	eastl::vector<LightClusters::Light> lights;
+	uint32_t mismatched_seeds = 0;
+	uint64_t binned_pairs = 0;
+	for (uint32_t seed = 1; seed <= seeds_count; seed++)
+	{
+		make_lights(seed, lights_count, z_far, lights);
+		clusters.build(view, projection, z_near, z_far, lights);
+		reference_clusters.build(view, projection, z_near, z_far, lights);
+		binned_pairs += clusters.getLightIndices().size();
+		if (!is_same_lists(clusters, reference_clusters))
+			mismatched_seeds++;
+	}
+
+	eastl::string message;
+	message.sprintf("%u of %u light sets differ from the reference binning, %.1f clusters per light", mismatched_seeds, seeds_count,
+					binned_pairs / double(uint64_t(lights_count) * seeds_count));
+	bench.check(name, binned_pairs > 0 && mismatched_seeds == 0, message);
+
+	make_lights(1, lights_count, z_far, lights);
+	bench.run(name, lights_count, [&]()
+	{
+		clusters.build(view, projection, z_near, z_far, lights);
+	});
+}
+}
+
+void runLightClustersBenchmarks(Microbenchmarks &bench)
+{
+	bench_build(bench, "LightClusters/build_256", 256, 8);
+	bench_build(bench, "LightClusters/build_4096", 4096, 8);
+}
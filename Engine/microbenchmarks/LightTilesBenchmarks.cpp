@@ -0,0 +1,173 @@
+#include "pch.h"
+#include "Microbenchmark.h"
+#include "Rendering/LightTiles.h"
+
+namespace
+{
+// Reverse-z depth of a floor going away from the camera with noise, top rows are sky
+void make_depth(const LightTiles::Projection &projection, float z_near, MicrobenchmarkRandom &random, eastl::vector<float> &depth)
+{
+	glm::uvec2 resolution = glm::uvec2(projection.resolution);
+	depth.resize(resolution.x * resolution.y);
+	for (uint32_t y = 0; y < resolution.y; y++)
+	{
+		float horizon = float(y) / resolution.y * 2.0f - 0.6f;
+		for (uint32_t x = 0; x < resolution.x; x++)
+		{
+			float linear_depth = horizon > 0.0f ? z_near * 2.0f / horizon * (0.9f + random.unit() * 0.2f) : 0.0f;
+			depth[y * resolution.x + x] = linear_depth > 0.0f ? z_near / linear_depth : 0.0f;
+		}
+	}
+}
+
+void bench_bin_reference(Microbenchmarks &bench, const char *name, uint32_t lights_count)
+{
+	if (!bench.isEnabled(name))
+		return;
+
+	const float z_near = 0.1f;
+	glm::mat4 projection = glm::perspective(glm::radians(60.0f), 1920.0f / 1080.0f, 1000.0f, z_near);
+	LightTiles::Projection tiles_projection = LightTiles::getProjection(projection, glm::vec2(1920, 1080));
+
+	MicrobenchmarkRandom random(1);
+	eastl::vector<float> depth;
+	make_depth(tiles_projection, z_near, random, depth);
+
+	eastl::vector<glm::vec4> spheres;
+	LightTiles::makeRandomSpheres(1, lights_count, tiles_projection, z_near, 200.0f, spheres);
+
+	glm::uvec2 tiles = LightTiles::getTilesCount(glm::uvec2(1920, 1080));
+	eastl::vector<uint32_t> tile_lights;
+	bench.run(name, tiles.x * tiles.y, [&]()
+	{
+		LightTiles::binReference(tiles_projection, depth.data(), spheres, tile_lights);
+	});
+}
+
+// View space x and y of a point at depth on the pixel center
+glm::vec2 get_pixel_view_position(const LightTiles::Projection &projection, glm::uvec2 pixel, float depth)
+{
+	float ndc_x = (pixel.x + 0.5f) / projection.resolution.x * 2.0f - 1.0f;
+	float ndc_y = 1.0f - (pixel.y + 0.5f) / projection.resolution.y * 2.0f;
+	return glm::vec2((ndc_x * projection.slopes.x + projection.slopes.y) * depth, (ndc_y * projection.slopes.z + projection.slopes.w) * depth);
+}
+
+// Pixels a sphere can cover: bounds of view x / depth and y / depth over the box around it, whole screen if it reaches the camera
+void get_sphere_pixels(const LightTiles::Projection &projection, const glm::vec4 &sphere, glm::uvec2 &pixels_min, glm::uvec2 &pixels_max)
+{
+	glm::uvec2 resolution = glm::uvec2(projection.resolution);
+	pixels_min = glm::uvec2(0);
+	pixels_max = resolution;
+	float near_depth = sphere.z - sphere.w;
+	float far_depth = sphere.z + sphere.w;
+	if (near_depth <= 0.0f)
+		return;
+
+	float min_x = glm::min((sphere.x - sphere.w) / near_depth, (sphere.x - sphere.w) / far_depth);
+	float max_x = glm::max((sphere.x + sphere.w) / near_depth, (sphere.x + sphere.w) / far_depth);
+	float min_y = glm::min((sphere.y - sphere.w) / near_depth, (sphere.y - sphere.w) / far_depth);
+	float max_y = glm::max((sphere.y + sphere.w) / near_depth, (sphere.y + sphere.w) / far_depth);
+
+	// Rows go top to bottom
+	float ndc_min_x = (min_x - projection.slopes.y) / projection.slopes.x;
+	float ndc_max_x = (max_x - projection.slopes.y) / projection.slopes.x;
+	float ndc_min_y = (min_y - projection.slopes.w) / projection.slopes.z;
+	float ndc_max_y = (max_y - projection.slopes.w) / projection.slopes.z;
+	float x0 = glm::clamp((ndc_min_x * 0.5f + 0.5f) * resolution.x - 1.0f, 0.0f, float(resolution.x));
+	float x1 = glm::clamp((ndc_max_x * 0.5f + 0.5f) * resolution.x + 1.0f, 0.0f, float(resolution.x));
+	float y0 = glm::clamp((0.5f - ndc_max_y * 0.5f) * resolution.y - 1.0f, 0.0f, float(resolution.y));
+	float y1 = glm::clamp((0.5f - ndc_min_y * 0.5f) * resolution.y + 1.0f, 0.0f, float(resolution.y));
+	pixels_min = glm::uvec2(x0, y0);
+	pixels_max = glm::uvec2(x1, y1);
+}
+
+// Binning must be conservative: every pixel inside a sphere has the light in the list of its tile. Tiles with
+// more than MAX_LIGHTS_PER_TILE lights keep the lowest indices, so a light missing there must come after all kept ones
+void check_bin_reference_covers_pixels(Microbenchmarks &bench, const char *name, uint32_t lights_count, uint32_t seeds_count)
+{
+	if (!bench.isEnabled(name))
+		return;
+
+	const float z_near = 0.1f;
+	glm::uvec2 resolution = glm::uvec2(960, 540);
+	glm::mat4 projection = glm::perspective(glm::radians(60.0f), float(resolution.x) / resolution.y, 1000.0f, z_near);
+	LightTiles::Projection tiles_projection = LightTiles::getProjection(projection, glm::vec2(resolution));
+	glm::uvec2 tiles = LightTiles::getTilesCount(resolution);
+
+	MicrobenchmarkRandom random(1);
+	eastl::vector<float> depth;
+	make_depth(tiles_projection, z_near, random, depth);
+	eastl::vector<float> linear_depth(depth.size());
+	for (uint32_t i = 0; i < depth.size(); i++)
+		linear_depth[i] = depth[i] > 0.0f ? LightTiles::getLinearDepth(tiles_projection, depth[i]) : 0.0f;
+
+	uint64_t covered_pixels = 0;
+	uint32_t missed_pixels = 0;
+	uint32_t overflowed_tiles = 0;
+	eastl::string first_miss;
+	eastl::vector<glm::vec4> spheres;
+	eastl::vector<uint32_t> tile_lights;
+	eastl::vector<bool> is_light_in_tile;
+	for (uint32_t seed = 1; seed <= seeds_count; seed++)
+	{
+		LightTiles::makeRandomSpheres(seed, lights_count, tiles_projection, z_near, 200.0f, spheres);
+		LightTiles::binReference(tiles_projection, depth.data(), spheres, tile_lights);
+
+		// Light bits of every tile, lights past the kept ones of full tiles count as binned
+		is_light_in_tile.assign((uint64_t)tiles.x * tiles.y * lights_count, false);
+		for (uint32_t tile = 0; tile < tiles.x * tiles.y; tile++)
+		{
+			const uint32_t *list = &tile_lights[tile * LightTiles::TILE_STRIDE];
+			uint32_t count = glm::min(list[0], LightTiles::MAX_LIGHTS_PER_TILE);
+			for (uint32_t i = 0; i < count; i++)
+				is_light_in_tile[(uint64_t)tile * lights_count + list[1 + i]] = true;
+			if (list[0] > LightTiles::MAX_LIGHTS_PER_TILE)
+			{
+				overflowed_tiles++;
+				for (uint32_t light = list[count] + 1; light < lights_count; light++)
+					is_light_in_tile[(uint64_t)tile * lights_count + light] = true;
+			}
+		}
+
+		for (uint32_t light = 0; light < lights_count; light++)
+		{
+			const glm::vec4 &sphere = spheres[light];
+			glm::uvec2 pixels_min, pixels_max;
+			get_sphere_pixels(tiles_projection, sphere, pixels_min, pixels_max);
+			for (uint32_t y = pixels_min.y; y < pixels_max.y; y++)
+			{
+				for (uint32_t x = pixels_min.x; x < pixels_max.x; x++)
+				{
+					float pixel_depth = linear_depth[y * resolution.x + x];
+					if (pixel_depth <= 0.0f)
+						continue;
+					glm::vec3 position = glm::vec3(get_pixel_view_position(tiles_projection, glm::uvec2(x, y), pixel_depth), pixel_depth);
+					glm::vec3 delta = position - glm::vec3(sphere);
+					if (glm::dot(delta, delta) > sphere.w * sphere.w)
+						continue;
+
+					covered_pixels++;
+					uint32_t tile = (y / LightTiles::TILE_SIZE) * tiles.x + x / LightTiles::TILE_SIZE;
+					if (is_light_in_tile[(uint64_t)tile * lights_count + light])
+						continue;
+					if (missed_pixels == 0)
+						first_miss.sprintf(", first: seed %u light %u pixel (%u, %u)", seed, light, x, y);
+					missed_pixels++;
+				}
+			}
+		}
+	}
+
+	eastl::string message;
+	message.sprintf("%u seeds of %u lights, %llu covered pixels, %u missed, %u full tiles%s", seeds_count, lights_count,
+					(unsigned long long)covered_pixels, missed_pixels, overflowed_tiles, first_miss.c_str());
+	bench.check(name, covered_pixels > 0 && missed_pixels == 0, message);
+}
+}
+
+void runLightTilesBenchmarks(Microbenchmarks &bench)
+{
+	check_bin_reference_covers_pixels(bench, "LightTiles/bin_reference_covers_pixels_540p", 2048, 4);
+	bench_bin_reference(bench, "LightTiles/bin_reference_1080p_128", 128);
+	bench_bin_reference(bench, "LightTiles/bin_reference_1080p_1024", 1024);
+}
@@ -0,0 +1,82 @@
+#include "pch.h"
+#include "Microbenchmark.h"
+#include "Core/AsyncLogSink.h"
+
+namespace
+{
+constexpr uint32_t QUEUE_SIZE = 8192;
+constexpr uint32_t FLOOD_BURST = QUEUE_SIZE / 2;
+constexpr uint32_t FLOOD_BURSTS = 64;
+
+// Same file sink as Log::init, console is left out to not flood the results
+std::shared_ptr<spdlog::logger> make_logger(const std::filesystem::path &path, std::shared_ptr<AsyncLogSink> *async_sink)
+{
+	auto file_sink = std::make_shared<spdlog::sinks::basic_file_sink_mt>(path.string(), true);
+	std::shared_ptr<spdlog::logger> logger;
+	if (async_sink)
+	{
+		*async_sink = std::make_shared<AsyncLogSink>(std::vector<spdlog::sink_ptr>{file_sink}, QUEUE_SIZE);
+		logger = std::make_shared<spdlog::logger>("Benchmark Logger", *async_sink);
+		logger->flush_on(spdlog::level::critical);
+	} else
+	{
+		// Previous setup, every message is flushed on the calling thread
+		logger = std::make_shared<spdlog::logger>("Benchmark Logger", file_sink);
+		logger->flush_on(spdlog::level::trace);
+	}
+	logger->set_level(spdlog::level::trace);
+	logger->set_pattern("[%T] [%^%l%$] %n: %v");
+	return logger;
+}
+
+// Flood like UploadManager ring-full warnings: distinct messages and one message repeated every call.
+// Flood comes in bursts of half the queue, each warn call is timed alone and the flush after a burst is not timed,
+// so the latency is what the calling thread pays. Flush still writes every message, then nothing may be dropped
+void bench_warnings(Microbenchmarks &bench, const char *flood_name, const char *repeated_name, bool is_async)
+{
+	if (!bench.isEnabled(flood_name) && !bench.isEnabled(repeated_name))
+		return;
+
+	std::filesystem::path path = std::filesystem::temp_directory_path() / "MicrobenchmarkLog.log";
+	{
+		std::shared_ptr<AsyncLogSink> async_sink;
+		std::shared_ptr<spdlog::logger> logger = make_logger(path, is_async ? &async_sink : nullptr);
+		if (bench.isEnabled(flood_name))
+		{
+			eastl::vector<double> latencies_ns;
+			latencies_ns.reserve(FLOOD_BURSTS * FLOOD_BURST);
+			uint64_t index = 0;
+			for (uint32_t burst = 0; burst < FLOOD_BURSTS; burst++)
+			{
+				for (uint32_t i = 0; i < FLOOD_BURST; i++)
+				{
+					auto start = std::chrono::steady_clock::now();
+					logger->warn("Upload ring is full, staging {} bytes for buffer {} waits", 65536, index++);
+					latencies_ns.push_back(std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count());
+				}
+				logger->flush();
+			}
+			eastl::sort(latencies_ns.begin(), latencies_ns.end());
+
+			uint64_t dropped = async_sink ? async_sink->getDroppedCount() : 0;
+			eastl::string message;
+			message.sprintf("warn call p50 %.0f ns, p99 %.0f ns, %llu messages, %llu dropped", latencies_ns[latencies_ns.size() / 2],
+							latencies_ns[latencies_ns.size() * 99 / 100], (unsigned long long)index, (unsigned long long)dropped);
+			bench.check(flood_name, dropped == 0, message);
+		}
+
+		bench.run(repeated_name, 1, [&]()
+		{
+			logger->warn("Upload ring is full, staging {} bytes waits", 65536);
+		});
+		logger->flush();
+	}
+	std::filesystem::remove(path);
+}
+}
+
+void runLogBenchmarks(Microbenchmarks &bench)
+{
+	bench_warnings(bench, "Log/warning_flood_sync", "Log/repeated_warning_sync", false);
+	bench_warnings(bench, "Log/warning_flood_async", "Log/repeated_warning_async", true);
+}
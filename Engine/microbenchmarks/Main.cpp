@@ -0,0 +1,74 @@
+#include "pch.h"
+#include "Microbenchmark.h"
+#include "Rendering/UploadManager.h"
+#include "Rendering/GlobalBufferCache.h"
+#include "RHI/RHIUploadBatch.h"
+#include "RHI/Null/NullDynamicRHI.h"
+#include "Physics/PhysXWrapper.h"
+
+// Measures CPU side of engine data paths on the null RHI, no window or GPU is needed.
+// Usage: Microbenchmarks [-filter text] [-min_time ms] [-output results.csv] [-baseline results.csv]
+// Exit code is 1 if a case failed its checks.
+int main(int argc, char *argv[])
+{
+	eastl::string filter;
+	eastl::string output_path = "microbenchmarks.csv";
+	eastl::string baseline_path;
+	double min_sample_time_ms = 20.0;
+
+	for (int i = 1; i + 1 < argc; i += 2)
+	{
+		eastl::string arg = argv[i];
+		if (arg == "-filter")
+			filter = argv[i + 1];
+		else if (arg == "-min_time")
+			min_sample_time_ms = std::stod(argv[i + 1]);
+		else if (arg == "-output")
+			output_path = argv[i + 1];
+		else if (arg == "-baseline")
+			baseline_path = argv[i + 1];
+	}
+
+	Log::init();
+	gDynamicRHI = new NullDynamicRHI();
+	gDynamicRHI->init();
+	gUploadManager = new UploadManager();
+	gUploadManager->init();
+	PhysXWrapper::init();
+
+	Microbenchmarks bench(filter, min_sample_time_ms);
+	runMeshBenchmarks(bench);
+	runTextureStreamingBenchmarks(bench);
+	runImageBenchmarks(bench);
+	runGpuBufferBenchmarks(bench);
+	runFrameGraphBenchmarks(bench);
+	runSceneBenchmarks(bench);
+	runPrefabBenchmarks(bench);
+	runAssetBenchmarks(bench);
+	runFileWatcherBenchmarks(bench);
+	runLogBenchmarks(bench);
+	runMitsubaBenchmarks(bench);
+	runLightTilesBenchmarks(bench);
+	runLightClustersBenchmarks(bench);
+	runDDGIBenchmarks(bench);
+	runDebugDrawBenchmarks(bench);
+
+	eastl::vector<Microbenchmarks::Result> baseline;
+	bool has_baseline = !baseline_path.empty() && Microbenchmarks::readCsv(baseline_path.c_str(), baseline);
+	bench.printResults(has_baseline ? &baseline : nullptr);
+	bench.writeCsv(output_path.c_str());
+	if (bench.getFailuresCount() > 0)
+		CORE_ERROR("{} microbenchmark checks failed", bench.getFailuresCount());
+
+	PhysXWrapper::shutdown();
+	GlobalBufferCache::shutdown();
+	RHIUploadBatch::shutdown();
+	gUploadManager->shutdown();
+	delete gUploadManager;
+	gUploadManager = nullptr;
+	gDynamicRHI->shutdown();
+	delete gDynamicRHI;
+	gDynamicRHI = nullptr;
+	Log::shutdown();
+	return bench.getFailuresCount() > 0 ? 1 : 0;
+}
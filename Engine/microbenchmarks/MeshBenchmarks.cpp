@@ -0,0 +1,392 @@
+#include "pch.h"
+#include "Microbenchmark.h"
+#include "Rendering/Model.h"
+#include "Rendering/MeshletBuilder.h"
+#include "Rendering/GlobalBufferCache.h"
+#include "Rendering/RayTracingProxy.h"
+#include "Rendering/GeometryStreaming.h"
+#include "Rendering/GeometryResidencyPolicy.h"
+#include "Rendering/MeshletTraversal.h"
+#include "Assets/MeshSerializer.h"
+#include "Assets/ModelImportSettings.h"
+
+namespace
+{
+struct SyntheticMesh
+{
+	eastl::vector<Engine::Vertex> vertices;
+	eastl::vector<uint32_t> indices;
+	BoundBox bound_box;
+};
+
+// Rolling terrain with noise, close to scanned or sculpted meshes that simplify unevenly
+SyntheticMesh make_terrain(uint32_t quads_per_side, uint64_t seed)
+{
+	MicrobenchmarkRandom random(seed);
+	SyntheticMesh mesh;
+	uint32_t side = quads_per_side + 1;
+	mesh.vertices.resize(side * side);
+	for (uint32_t y = 0; y < side; y++)
+	{
+		for (uint32_t x = 0; x < side; x++)
+		{
+			glm::vec2 uv = glm::vec2(x, y) / float(quads_per_side);
+			float height = sinf(uv.x * 12.0f) * cosf(uv.y * 9.0f) * 0.5f + random.unit() * 0.05f;
+
+			Engine::Vertex &vertex = mesh.vertices[y * side + x];
+			vertex.pos = glm::vec3(uv.x * 100.0f, height * 10.0f, uv.y * 100.0f);
+			vertex.normal = glm::normalize(glm::vec3(random.unit() - 0.5f, 4.0f, random.unit() - 0.5f));
+			vertex.tangent = glm::vec3(1, 0, 0);
+			vertex.uv = uv;
+			mesh.bound_box.extend(vertex.pos);
+		}
+	}
+
+	mesh.indices.reserve(quads_per_side * quads_per_side * 6);
+	for (uint32_t y = 0; y < quads_per_side; y++)
+	{
+		for (uint32_t x = 0; x < quads_per_side; x++)
+		{
+			uint32_t i = y * side + x;
+			mesh.indices.insert(mesh.indices.end(), {i, i + side, i + 1, i + 1, i + side, i + side + 1});
+		}
+	}
+	return mesh;
+}
+
+Ref<Engine::Mesh> make_mesh(const SyntheticMesh &synthetic, size_t id)
+{
+	Ref<Engine::Mesh> mesh = new Engine::Mesh();
+	mesh->id = id;
+	mesh->attribute_flags = MeshFormat::MESH_ATTR_TANGENT;
+	mesh->bound_box = synthetic.bound_box;
+	return mesh;
+}
+
+void bench_meshlet_builder(Microbenchmarks &bench, const char *name, uint32_t quads_per_side)
+{
+	if (!bench.isEnabled(name))
+		return;
+
+	SyntheticMesh terrain = make_terrain(quads_per_side, 1);
+	ModelImportSettings settings;
+	uint32_t triangles = terrain.indices.size() / 3;
+	bench.run(name, triangles, [&]()
+	{
+		Ref<Engine::Mesh> mesh = make_mesh(terrain, 1);
+		MeshletBuildData build_data = MeshletBuilder::build(mesh, "Microbenchmark Terrain", terrain.vertices, terrain.indices, settings);
+	});
+}
+
+// Model of mesh_count terrains under one root, written the same way importers stream it
+bool write_terrain_model(const std::string &path, uint32_t mesh_count, uint32_t quads_per_side)
+{
+	Model model;
+	MeshNode *root = new MeshNode();
+	root->name = "Root";
+	model.getLinearNodes().push_back(root);
+
+	ModelImportSettings settings;
+	eastl::vector<Ref<Engine::Mesh>> meshes; // primitives don't own them
+	MeshSerializer::StreamingWriter writer = MeshSerializer::beginStream(path.c_str());
+	for (uint32_t i = 0; i < mesh_count; i++)
+	{
+		SyntheticMesh terrain = make_terrain(quads_per_side, i + 1);
+		Ref<Engine::Mesh> mesh = meshes.emplace_back(make_mesh(terrain, i + 1));
+		MeshletBuildData build_data = MeshletBuilder::build(mesh, "Microbenchmark Terrain", terrain.vertices, terrain.indices, settings);
+		MeshSerializer::writeMeshBlock(writer, mesh, &build_data);
+
+		MeshNode *node = new MeshNode();
+		node->name.sprintf("Terrain %u", i);
+		node->parent = root;
+		node->primitives.push_back({mesh.getReference(), new Material()});
+		root->children.push_back(node);
+		model.getLinearNodes().push_back(node);
+	}
+	bool is_written = MeshSerializer::finalizeStream(writer, &model);
+
+	// Nodes are owned here, model never got a root
+	model.getLinearNodes().clear();
+	delete root;
+	return is_written;
+}
+
+void bench_mesh_serializer_load(Microbenchmarks &bench, const char *name, uint32_t mesh_count, uint32_t quads_per_side)
+{
+	if (!bench.isEnabled(name))
+		return;
+
+	std::string path = (std::filesystem::temp_directory_path() / "microbenchmark.mesh").string();
+	if (!write_terrain_model(path, mesh_count, quads_per_side))
+		return;
+
+	Model model;
+	bench.run(name, mesh_count, [&]()
+	{
+		MeshSerializer::load(&model, path.c_str());
+	});
+	model.cleanup();
+
+	// Metadata of every loaded mesh stays in the global buffers
+	GlobalBufferCache::shutdown();
+	std::filesystem::remove(path);
+}
+
+// Proxy is built from the loaded .mesh like at runtime, then checked against the source terrain:
+// it must fit the budget and every sampled source vertex must be near the proxy. Simplification error is
+// an estimate of the distance, so the distance is allowed to be up to twice the error of the cut
+void bench_ray_tracing_proxy(Microbenchmarks &bench, const char *name, uint32_t quads_per_side, uint32_t max_triangles)
+{
+	if (!bench.isEnabled(name))
+		return;
+
+	std::string path = (std::filesystem::temp_directory_path() / "microbenchmark_proxy.mesh").string();
+	if (!write_terrain_model(path, 1, quads_per_side))
+		return;
+
+	Model model;
+	MeshSerializer::load(&model, path.c_str());
+	eastl::vector<Ref<Engine::Mesh>> meshes;
+	model.getMeshes(meshes);
+	const Engine::MeshletFileView *file_view = meshes.empty() ? nullptr : model.getFileView(meshes[0]->id);
+	if (file_view && meshes[0]->meshlet_data)
+	{
+		Engine::Mesh *mesh = meshes[0];
+		Engine::IndexedGeometry proxy;
+		RayTracingProxy::Info info = RayTracingProxy::build(*mesh->meshlet_data, *file_view, mesh->attribute_flags, max_triangles, proxy);
+		RayTracingProxy::Error error = RayTracingProxy::measureError(proxy, *mesh->meshlet_data, *file_view, mesh->attribute_flags, 4096);
+
+		float radius = glm::length(mesh->bound_box.getSize()) * 0.5f;
+		float max_distance = info.error_threshold * 2.0f + radius * 1e-4f;
+		eastl::string message;
+		message.sprintf("%u triangles (budget %u), cut error %.4f, distance max %.4f mean %.4f over %u vertices", info.triangles_count, max_triangles,
+						info.error_threshold, error.max_distance, error.mean_distance, error.samples_count);
+		bench.check(name, info.triangles_count > 0 && info.triangles_count <= max_triangles && error.max_distance <= max_distance, message);
+
+		uint32_t source_triangles = quads_per_side * quads_per_side * 2;
+		bench.run(name, source_triangles, [&]()
+		{
+			RayTracingProxy::build(*mesh->meshlet_data, *file_view, mesh->attribute_flags, max_triangles, proxy);
+		});
+	} else
+	{
+		bench.check(name, false, "terrain has no meshlets");
+	}
+	meshes.clear();
+	model.cleanup();
+
+	GlobalBufferCache::shutdown();
+	std::filesystem::remove(path);
+}
+
+// Group uploads decoded the way shaders do must give back the .mesh triangles of every meshlet
+void bench_packed_triangles(Microbenchmarks &bench, const char *name, uint32_t quads_per_side)
+{
+	if (!bench.isEnabled(name))
+		return;
+
+	std::string path = (std::filesystem::temp_directory_path() / "microbenchmark_packed_triangles.mesh").string();
+	if (!write_terrain_model(path, 1, quads_per_side))
+		return;
+
+	Model model;
+	MeshSerializer::load(&model, path.c_str());
+	eastl::vector<Ref<Engine::Mesh>> meshes;
+	model.getMeshes(meshes);
+	const Engine::MeshletFileView *file_view = meshes.empty() ? nullptr : model.getFileView(meshes[0]->id);
+	if (file_view && meshes[0]->meshlet_data)
+	{
+		Engine::Mesh *mesh = meshes[0];
+		const Engine::MeshletGeometry &meshlet_data = *mesh->meshlet_data;
+		uint32_t groups_count = meshlet_data.meshlet_lod_groups.size();
+
+		uint32_t triangles_count = 0;
+		uint32_t mismatches = 0;
+		eastl::vector<uint8_t> group_data;
+		for (uint32_t group_id = 0; group_id < groups_count; group_id++)
+		{
+			group_data.resize(GeometryStreaming::getGroupDataSize(mesh, group_id));
+			GeometryStreaming::fillGroupData(group_data.data(), mesh, group_id, *file_view);
+
+			const LODGroup &group = meshlet_data.meshlet_lod_groups[group_id];
+			const uint8_t *src_tris = file_view->triangles_ptr + meshlet_data.meshlet_lod_group_data_info[group_id].cpu_triangle_offset;
+			for (uint32_t m = 0; m < group.meshlet_count; m++)
+			{
+				Meshlet header;
+				memcpy(&header, group_data.data() + m * sizeof(Meshlet), sizeof(Meshlet));
+				uint32_t src_offset = meshlet_data.getMeshlet(group.first_meshlet + m).triangle_offset;
+				for (uint32_t t = 0; t < header.triangle_count; t++)
+				{
+					const uint8_t *src = src_tris + src_offset + t * 3;
+					glm::uvec3 triangle = GeometryStreaming::decodePackedTriangle(group_data.data(), header.triangle_offset + t * 3);
+					if (triangle != glm::uvec3(src[0], src[1], src[2]))
+						mismatches++;
+					triangles_count++;
+				}
+			}
+		}
+
+		eastl::string message;
+		message.sprintf("%u mismatches over %u triangles in %u groups", mismatches, triangles_count, groups_count);
+		bench.check(name, triangles_count > 0 && mismatches == 0, message);
+
+		bench.run(name, groups_count, [&]()
+		{
+			for (uint32_t group_id = 0; group_id < groups_count; group_id++)
+			{
+				group_data.resize(GeometryStreaming::getGroupDataSize(mesh, group_id));
+				GeometryStreaming::fillGroupData(group_data.data(), mesh, group_id, *file_view);
+			}
+		});
+	} else
+	{
+		bench.check(name, false, "terrain has no meshlets");
+	}
+	meshes.clear();
+	model.cleanup();
+
+	GlobalBufferCache::shutdown();
+	std::filesystem::remove(path);
+}
+
+// Trace frame from the CPU traversal: groups of the selected cut, the ones the GPU requests while they are missing.
+// Groups get flat indices the way GeometryStreaming assigns them, mesh after mesh, with their screen error in pixels
+void record_trace_frame(const MeshletTraversal::View &view, const MeshletTraversal::Result &result, eastl::span<const MeshletTraversal::Instance> instances,
+						const eastl::hash_map<const Engine::MeshletGeometry *, uint32_t> &group_bases, GeometryResidencyPolicy::ReplayFrame &frame)
+{
+	eastl::vector<eastl::pair<uint32_t, float>> used;
+	for (const MeshletTraversal::SelectedMeshlet &meshlet : result.meshlets)
+	{
+		// Terrains are only translated, scale is 1
+		const MeshletTraversal::Instance &instance = instances[meshlet.instance_id];
+		const LODGroup &group = instance.geometry->meshlet_lod_groups[meshlet.group_index];
+		float error = MeshletTraversal::getProjectedError(view, instance.world_transform, 1.0f, group.center, group.radius, group.error);
+		used.push_back({group_bases.at(instance.geometry) + meshlet.group_index, error / view.error_threshold});
+	}
+	eastl::sort(used.begin(), used.end());
+
+	frame.used_groups.clear();
+	frame.used_errors.clear();
+	for (const auto &[group, error] : used)
+	{
+		if (!frame.used_groups.empty() && frame.used_groups.back() == group)
+		{
+			frame.used_errors.back() = eastl::max(frame.used_errors.back(), error);
+			continue;
+		}
+		frame.used_groups.push_back(group);
+		frame.used_errors.push_back(error);
+	}
+}
+
+// Flight over a grid of terrains recorded with MeshletTraversal, then replayed against the residency policy
+// with half of the touched geometry as the budget. Flight goes one way, so groups come back rarely:
+// most requests must hit and uploads must stay close to the compulsory bytes
+void bench_residency_replay(Microbenchmarks &bench, const char *name, uint32_t grid_side, uint32_t quads_per_side, uint32_t frames_count)
+{
+	if (!bench.isEnabled(name))
+		return;
+
+	std::string path = (std::filesystem::temp_directory_path() / "microbenchmark_residency.mesh").string();
+	uint32_t mesh_count = grid_side * grid_side;
+	if (!write_terrain_model(path, mesh_count, quads_per_side))
+		return;
+
+	Model model;
+	MeshSerializer::load(&model, path.c_str());
+	eastl::vector<Ref<Engine::Mesh>> meshes;
+	model.getMeshes(meshes);
+
+	eastl::hash_map<const Engine::MeshletGeometry *, uint32_t> group_bases;
+	eastl::vector<MeshletTraversal::Instance> instances;
+	eastl::vector<uint64_t> group_sizes;
+	for (const Ref<Engine::Mesh> &mesh : meshes)
+	{
+		if (!mesh->meshlet_data)
+			continue;
+		const Engine::MeshletGeometry *geometry = &*mesh->meshlet_data;
+		group_bases[geometry] = group_sizes.size();
+		for (uint32_t group_id = 0; group_id < geometry->meshlet_lod_groups.size(); group_id++)
+			group_sizes.push_back(GeometryStreaming::getGroupDataSize(mesh, group_id));
+
+		// Terrains are 100 units wide
+		uint32_t cell = instances.size();
+		MeshletTraversal::Instance &instance = instances.emplace_back();
+		instance.geometry = geometry;
+		instance.world_transform = glm::translate(glm::mat4(1.0f), glm::vec3(cell % grid_side * 100.0f, 0.0f, cell / grid_side * 100.0f));
+		instance.bound_box = mesh->bound_box;
+		instance.instance_id = cell;
+	}
+
+	eastl::vector<GeometryResidencyPolicy::ReplayFrame> trace(frames_count);
+	MeshletTraversal::Result result;
+	float grid_size = grid_side * 100.0f;
+	for (uint32_t frame = 0; frame < frames_count; frame++)
+	{
+		// Low flight along the middle of the grid, looking ahead and down, inverse-Z like the engine camera
+		float t = frame / float(eastl::max(frames_count - 1, 1u));
+		glm::vec3 position(grid_size * 0.5f, 15.0f, grid_size + 50.0f - t * (grid_size + 100.0f));
+		glm::mat4 view = glm::lookAt(position, position + glm::vec3(0.0f, -0.3f, -1.0f), glm::vec3(0, 1, 0));
+		glm::mat4 proj = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 1000.0f, 0.1f);
+
+		MeshletTraversal::View traversal_view;
+		traversal_view.view_projection = proj * view;
+		traversal_view.camera_position = position;
+		traversal_view.error_threshold = MeshletTraversal::View::computeErrorThreshold(glm::radians(60.0f), 1080.0f);
+		eastl::span<const MeshletTraversal::Instance> instances_span(instances.data(), instances.size());
+		MeshletTraversal::traverse(traversal_view, instances_span, result);
+		record_trace_frame(traversal_view, result, instances_span, group_bases, trace[frame]);
+	}
+
+	// Every touched group loaded once, what an unlimited budget uploads
+	eastl::vector<uint8_t> is_touched(group_sizes.size(), 0);
+	uint64_t compulsory_bytes = 0;
+	uint64_t requests = 0;
+	for (const GeometryResidencyPolicy::ReplayFrame &frame : trace)
+	{
+		requests += frame.used_groups.size();
+		for (uint32_t group : frame.used_groups)
+		{
+			if (!is_touched[group])
+				compulsory_bytes += group_sizes[group];
+			is_touched[group] = 1;
+		}
+	}
+
+	uint64_t budget_bytes = compulsory_bytes / 2;
+	constexpr uint32_t STALE_AGE = 8;
+	eastl::span<const GeometryResidencyPolicy::ReplayFrame> trace_span(trace.data(), trace.size());
+	eastl::span<const uint64_t> sizes_span(group_sizes.data(), group_sizes.size());
+
+	BudgetLRUResidencyPolicy policy;
+	GeometryResidencyPolicy::ReplayResult replay = GeometryResidencyPolicy::replay(policy, trace_span, sizes_span, budget_bytes, STALE_AGE);
+
+	eastl::string message;
+	message.sprintf("%llu requests, hit rate %.3f, %llu loads, %llu evictions, uploaded %.2f MB of %.2f MB compulsory, peak %.2f MB with %.2f MB budget",
+					replay.requests, replay.getHitRate(), replay.loads, replay.evictions, replay.upload_bytes / 1048576.0, compulsory_bytes / 1048576.0,
+					replay.peak_resident_bytes / 1048576.0, budget_bytes / 1048576.0);
+	bench.check(name, requests > 0 && replay.requests == requests && replay.getHitRate() >= 0.8f && replay.upload_bytes <= compulsory_bytes * 2, message);
+
+	bench.run(name, requests, [&]()
+	{
+		BudgetLRUResidencyPolicy replay_policy;
+		GeometryResidencyPolicy::replay(replay_policy, trace_span, sizes_span, budget_bytes, STALE_AGE);
+	});
+
+	meshes.clear();
+	model.cleanup();
+
+	GlobalBufferCache::shutdown();
+	std::filesystem::remove(path);
+}
+}
+
+void runMeshBenchmarks(Microbenchmarks &bench)
+{
+	bench_meshlet_builder(bench, "MeshletBuilder/build_8k_tris", 64);
+	bench_meshlet_builder(bench, "MeshletBuilder/build_128k_tris", 256);
+	bench_mesh_serializer_load(bench, "MeshSerializer/load_64_meshes", 64, 32);
+	bench_ray_tracing_proxy(bench, "RayTracingProxy/build_128k_tris_4k", 256, 4096);
+	bench_packed_triangles(bench, "GeometryStreaming/fill_groups_128k_tris", 256);
+	bench_residency_replay(bench, "GeometryStreaming/residency_replay_flight_4x4", 4, 64, 240);
+}
@@ -0,0 +1,127 @@
+#include "pch.h"
+#include "Microbenchmark.h"
+#include <EASTL/sort.h>
+#include <fstream>
+#include <sstream>
+
+namespace
+{
+double median(double *values, int count)
+{
+	eastl::sort(values, values + count);
+	return count % 2 ? values[count / 2] : (values[count / 2 - 1] + values[count / 2]) * 0.5;
+}
+
+const Microbenchmarks::Result *find_result(const eastl::vector<Microbenchmarks::Result> &results, const eastl::string &name)
+{
+	for (const Microbenchmarks::Result &result : results)
+	{
+		if (result.name == name)
+			return &result;
+	}
+	return nullptr;
+}
+}
+
+Microbenchmarks::Microbenchmarks(const eastl::string &filter, double min_sample_time_ms): filter(filter), min_sample_time_ns(min_sample_time_ms * 1e6)
+{
+}
+
+bool Microbenchmarks::isEnabled(const char *name) const
+{
+	return filter.empty() || eastl::string(name).find(filter) != eastl::string::npos;
+}
+
+void Microbenchmarks::add_result(const char *name, uint64_t items, uint64_t iterations, double *samples)
+{
+	Result &result = results.emplace_back();
+	result.name = name;
+	result.items = items;
+	result.iterations = iterations;
+	result.median_ns = median(samples, SAMPLE_COUNT);
+	result.min_ns = samples[0]; // sorted by median()
+
+	double deviations[SAMPLE_COUNT];
+	for (int i = 0; i < SAMPLE_COUNT; i++)
+		deviations[i] = fabs(samples[i] - result.median_ns);
+	result.mad_percent = result.median_ns > 0.0 ? median(deviations, SAMPLE_COUNT) / result.median_ns * 100.0 : 0.0;
+
+	CORE_INFO("{:<40} {:>14.2f} ns/item  (x{} items, {} iterations/sample, +-{:.1f}%)", name, result.median_ns, items, iterations, result.mad_percent);
+}
+
+void Microbenchmarks::check(const char *name, bool is_passed, const eastl::string &message)
+{
+	if (is_passed)
+	{
+		CORE_INFO("{:<40} passed: {}", name, message.c_str());
+		return;
+	}
+	CORE_ERROR("{:<40} FAILED: {}", name, message.c_str());
+	failures_count++;
+}
+
+void Microbenchmarks::printResults(const eastl::vector<Result> *baseline) const
+{
+	CORE_INFO("{:<40} {:>14} {:>14} {:>8} {:>10}", "Case", "Median ns", "Min ns", "MAD %", "Baseline");
+	for (const Result &result : results)
+	{
+		eastl::string change = "-";
+		if (const Result *base = baseline ? find_result(*baseline, result.name) : nullptr)
+		{
+			// Differences within the noise of both runs are not reported as changes
+			double delta = (result.median_ns - base->median_ns) / base->median_ns * 100.0;
+			double noise = eastl::max(result.mad_percent, base->mad_percent) * 2.0;
+			change.sprintf("%+.1f%%%s", delta, fabs(delta) > noise ? (delta > 0.0 ? " slower" : " faster") : "");
+		}
+		CORE_INFO("{:<40} {:>14.2f} {:>14.2f} {:>8.1f} {:>10}", result.name, result.median_ns, result.min_ns, result.mad_percent, change);
+	}
+}
+
+bool Microbenchmarks::writeCsv(const char *path) const
+{
+	std::ofstream file(path);
+	if (!file.is_open())
+	{
+		CORE_ERROR("Failed to write microbenchmark results to {}", path);
+		return false;
+	}
+
+	file << "name,items,iterations,median_ns,min_ns,mad_percent\n";
+	for (const Result &result : results)
+	{
+		file << result.name.c_str() << ',' << result.items << ',' << result.iterations << ','
+			<< fmt::format("{:.3f},{:.3f},{:.2f}", result.median_ns, result.min_ns, result.mad_percent) << '\n';
+	}
+	CORE_INFO("Microbenchmark results written to {}", path);
+	return true;
+}
+
+bool Microbenchmarks::readCsv(const char *path, eastl::vector<Result> &results)
+{
+	std::ifstream file(path);
+	if (!file.is_open())
+	{
+		CORE_ERROR("Failed to read microbenchmark baseline {}", path);
+		return false;
+	}
+
+	std::string line;
+	std::getline(file, line); // header
+	while (std::getline(file, line))
+	{
+		std::stringstream row(line);
+		std::string name, items, iterations, median_ns, min_ns, mad_percent;
+		if (!std::getline(row, name, ',') || !std::getline(row, items, ',') || !std::getline(row, iterations, ',')
+			|| !std::getline(row, median_ns, ',') || !std::getline(row, min_ns, ',') || !std::getline(row, mad_percent, ','))
+			continue;
+
+		Result &result = results.emplace_back();
+		result.name = name.c_str();
+		result.items = std::stoull(items);
+		result.iterations = std::stoull(iterations);
+		result.median_ns = std::stod(median_ns);
+		result.min_ns = std::stod(min_ns);
+		result.mad_percent = std::stod(mad_percent);
+	}
+	return true;
+}
@@ -0,0 +1,120 @@
+#pragma once
+#include <EASTL/string.h>
+#include <EASTL/vector.h>
+#include <chrono>
+#include "Core/Log.h"
+
+// Runs small pieces of engine code in a loop and reports time per item (one row, node, pass...).
+// Every case is measured in SAMPLE_COUNT samples, each sample runs the case enough times to last min_sample_time,
+// median is the reported value and the median absolute deviation shows how noisy it was.
+// Results are written as CSV with one row per case in registration order, so runs of two commits can be compared.
+class Microbenchmarks
+{
+public:
+	struct Result
+	{
+		eastl::string name;
+		uint64_t items = 0; // per iteration
+		uint64_t iterations = 0; // per sample
+		double median_ns = 0.0; // per item
+		double min_ns = 0.0;
+		double mad_percent = 0.0;
+	};
+
+	Microbenchmarks(const eastl::string &filter, double min_sample_time_ms);
+
+	// Case names are "System/case", filter is a substring of them. Cases check it before preparing their data.
+	bool isEnabled(const char *name) const;
+
+	template <typename Iteration>
+	void run(const char *name, uint64_t items, Iteration &&iteration)
+	{
+		if (!isEnabled(name))
+			return;
+
+		// Engine code logs loads and builds, writing it out would be measured too
+		spdlog::level::level_enum log_level = Log::getCoreLogger()->level();
+		Log::getCoreLogger()->set_level(spdlog::level::warn);
+
+		// Warm caches and lazily created state, then find iterations per sample
+		iteration();
+		uint64_t iterations = 1;
+		while (iterations < MAX_ITERATIONS && measure(iteration, iterations) < min_sample_time_ns)
+			iterations *= 2;
+
+		double samples[SAMPLE_COUNT];
+		for (double &sample : samples)
+			sample = measure(iteration, iterations) / double(iterations * items);
+
+		Log::getCoreLogger()->set_level(log_level);
+		add_result(name, items, iterations, samples);
+	}
+
+	const eastl::vector<Result> &getResults() const { return results; }
+
+	// Cases that also validate what they measure report it here, failures make the run exit with an error
+	void check(const char *name, bool is_passed, const eastl::string &message);
+	uint32_t getFailuresCount() const { return failures_count; }
+
+	void printResults(const eastl::vector<Result> *baseline = nullptr) const;
+	bool writeCsv(const char *path) const;
+	static bool readCsv(const char *path, eastl::vector<Result> &results);
+
+	static constexpr int SAMPLE_COUNT = 15;
+	static constexpr uint64_t MAX_ITERATIONS = 1ull << 24;
+
+private:
+	template <typename Iteration>
+	static double measure(Iteration &iteration, uint64_t iterations)
+	{
+		auto start = std::chrono::steady_clock::now();
+		for (uint64_t i = 0; i < iterations; i++)
+			iteration();
+		return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	void add_result(const char *name, uint64_t items, uint64_t iterations, double *samples);
+
+	eastl::string filter;
+	double min_sample_time_ns;
+	eastl::vector<Result> results;
+	uint32_t failures_count = 0;
+};
+
+// Deterministic generator, synthetic data must be the same on every run and platform
+class MicrobenchmarkRandom
+{
+public:
+	MicrobenchmarkRandom(uint64_t seed): state(seed ? seed : 1) {}
+
+	uint32_t next()
+	{
+		state ^= state << 13;
+		state ^= state >> 7;
+		state ^= state << 17;
+		return uint32_t(state >> 32);
+	}
+
+	uint32_t range(uint32_t max) { return next() % max; }
+	float unit() { return (next() >> 8) * (1.0f / 16777216.0f); }
+
+private:
+	uint64_t state;
+};
+
+// Groups of cases, one file per engine area
+void runMeshBenchmarks(Microbenchmarks &bench);
+void runTextureStreamingBenchmarks(Microbenchmarks &bench);
+void runImageBenchmarks(Microbenchmarks &bench);
+void runGpuBufferBenchmarks(Microbenchmarks &bench);
+void runFrameGraphBenchmarks(Microbenchmarks &bench);
+void runSceneBenchmarks(Microbenchmarks &bench);
+void runPrefabBenchmarks(Microbenchmarks &bench);
+void runAssetBenchmarks(Microbenchmarks &bench);
+void runFileWatcherBenchmarks(Microbenchmarks &bench);
+void runLogBenchmarks(Microbenchmarks &bench);
+void runMitsubaBenchmarks(Microbenchmarks &bench);
+void runLightTilesBenchmarks(Microbenchmarks &bench);
+void runLightClustersBenchmarks(Microbenchmarks &bench);
+void runDDGIBenchmarks(Microbenchmarks &bench);
+void runDebugDrawBenchmarks(Microbenchmarks &bench);
@@ -0,0 +1,150 @@
+#include "pch.h"
+#include "Microbenchmark.h"
+#include "Editor/MitsubaExporter.h"
+#include <fstream>
+
+namespace
+{
+Ref<Engine::Mesh> make_grid_mesh(uint32_t quads_per_side, MicrobenchmarkRandom &random)
+{
+	Ref<Engine::Mesh> mesh = new Engine::Mesh();
+	mesh->indexed.emplace();
+	uint32_t side = quads_per_side + 1;
+	mesh->indexed->vertices.resize(side * side);
+	for (uint32_t y = 0; y < side; y++)
+	{
+		for (uint32_t x = 0; x < side; x++)
+		{
+			Engine::Vertex &vertex = mesh->indexed->vertices[y * side + x];
+			vertex.uv = glm::vec2(x, y) / float(quads_per_side);
+			vertex.pos = glm::vec3(vertex.uv.x, random.unit() * 0.1f, vertex.uv.y);
+			vertex.normal = glm::vec3(0, 1, 0);
+		}
+	}
+	for (uint32_t y = 0; y < quads_per_side; y++)
+	{
+		for (uint32_t x = 0; x < quads_per_side; x++)
+		{
+			uint32_t i = y * side + x;
+			mesh->indexed->indices.insert(mesh->indexed->indices.end(), {i, i + side, i + 1, i + 1, i + side, i + side + 1});
+		}
+	}
+	return mesh;
+}
+
+// Reads the text header of a binary .ply back, element counts are -1 when missing
+struct PlyHeader
+{
+	bool is_binary_little_endian = false;
+	int64_t vertices_count = -1;
+	int64_t faces_count = -1;
+	uint64_t size = 0; // bytes up to and including end_header
+};
+
+bool read_ply_header(const std::filesystem::path &path, PlyHeader &header)
+{
+	std::ifstream file(path, std::ios::binary);
+	std::string line;
+	if (!std::getline(file, line) || line != "ply")
+		return false;
+	header.size = line.size() + 1;
+	while (std::getline(file, line))
+	{
+		header.size += line.size() + 1;
+		if (line == "end_header")
+			return true;
+		if (line == "format binary_little_endian 1.0")
+			header.is_binary_little_endian = true;
+		else if (line.rfind("element vertex ", 0) == 0)
+			header.vertices_count = std::stoll(line.substr(15));
+		else if (line.rfind("element face ", 0) == 0)
+			header.faces_count = std::stoll(line.substr(13));
+	}
+	return false;
+}
+
+// Scene-like export: every mesh is placed several times. Cold writes every file, warm finds all of them from the previous export
+void bench_export(Microbenchmarks &bench, const char *cold_name, const char *warm_name, uint32_t mesh_count, uint32_t instances_per_mesh, uint32_t quads_per_side)
+{
+	if (!bench.isEnabled(cold_name) && !bench.isEnabled(warm_name))
+		return;
+
+	MicrobenchmarkRandom random(1);
+	eastl::vector<Ref<Engine::Mesh>> meshes;
+	for (uint32_t i = 0; i < mesh_count; i++)
+		meshes.push_back(make_grid_mesh(quads_per_side, random));
+
+	MitsubaExporter exporter;
+	exporter.scene["type"] = "scene";
+	for (uint32_t i = 0; i < mesh_count * instances_per_mesh; i++)
+	{
+		MitsubaExporter::MeshInstance &instance = exporter.instances.push_back();
+		instance.mesh = meshes[i % mesh_count];
+		instance.model_guid = 1;
+		instance.mesh_id = i % mesh_count;
+		instance.to_world = glm::translate(glm::mat4(1.0f), glm::vec3(i, 0, 0));
+		instance.bsdf = {{"type", "diffuse"}};
+	}
+
+	std::filesystem::path directory = std::filesystem::temp_directory_path() / "MicrobenchmarkMitsuba";
+	std::filesystem::path scene_path = directory / "scene_export.json";
+	std::filesystem::path mesh_directory = directory / "meshes";
+	std::filesystem::remove_all(directory);
+	std::filesystem::create_directories(directory);
+
+	// Instances share files: cold writes every distinct mesh once, warm finds all of them
+	exporter.exportScene(scene_path, mesh_directory, 0);
+	MitsubaExporter::Stats cold = exporter.getStats();
+	exporter.exportScene(scene_path, mesh_directory, 0);
+	MitsubaExporter::Stats warm = exporter.getStats();
+	uint32_t instances_count = mesh_count * instances_per_mesh;
+	if (bench.isEnabled(cold_name))
+	{
+		// Every vertex is x y z nx ny nz u v floats, every face is a uchar count and 3 int indices
+		uint32_t side = quads_per_side + 1;
+		PlyHeader header;
+		std::filesystem::path ply_path;
+		for (const auto &entry : std::filesystem::directory_iterator(mesh_directory))
+		{
+			ply_path = entry.path();
+			break;
+		}
+		bool is_header_read = !ply_path.empty() && read_ply_header(ply_path, header);
+		uint64_t expected_size = header.size + uint64_t(side) * side * 8 * sizeof(float) + uint64_t(quads_per_side) * quads_per_side * 2 * (1 + 3 * sizeof(uint32_t));
+		bool is_ply_valid = is_header_read && header.is_binary_little_endian && header.vertices_count == side * side &&
+			header.faces_count == quads_per_side * quads_per_side * 2 && std::filesystem::file_size(ply_path) == expected_size;
+
+		eastl::string message;
+		message.sprintf("%u instances, %u unique meshes, %u written, %u cached, ply header %s (%lld vertices, %lld faces)", cold.instances, cold.unique_meshes,
+						cold.written_meshes, cold.cached_meshes, is_ply_valid ? "valid" : "invalid", (long long)header.vertices_count, (long long)header.faces_count);
+		bench.check(cold_name, cold.instances == instances_count && cold.unique_meshes == mesh_count && cold.written_meshes == mesh_count &&
+					cold.cached_meshes == 0 && is_ply_valid, message);
+	}
+	if (bench.isEnabled(warm_name))
+	{
+		eastl::string message;
+		message.sprintf("%u instances, %u unique meshes, %u written, %u cached", warm.instances, warm.unique_meshes, warm.written_meshes, warm.cached_meshes);
+		bench.check(warm_name, warm.instances == instances_count && warm.unique_meshes == mesh_count && warm.written_meshes == 0 &&
+					warm.cached_meshes == mesh_count, message);
+	}
+
+	bench.run(cold_name, mesh_count, [&]()
+	{
+		std::filesystem::remove_all(mesh_directory);
+		exporter.exportScene(scene_path, mesh_directory, 0);
+	});
+
+	exporter.exportScene(scene_path, mesh_directory, 0);
+	bench.run(warm_name, mesh_count, [&]()
+	{
+		exporter.exportScene(scene_path, mesh_directory, 0);
+	});
+
+	std::filesystem::remove_all(directory);
+}
+}
+
+void runMitsubaBenchmarks(Microbenchmarks &bench)
+{
+	bench_export(bench, "Mitsuba/export_cold_256x4", "Mitsuba/export_warm_256x4", 256, 4, 128);
+}
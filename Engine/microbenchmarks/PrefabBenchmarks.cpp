@@ -0,0 +1,169 @@
+#include "pch.h"
+#include "Microbenchmark.h"
+#include "Scene/Scene.h"
+#include "Scene/Entity.h"
+#include "Scene/Prefab.h"
+#include "Rendering/ShaderStructs.h"
+#include "Assets/AssetManager.h"
+#include <psapi.h>
+
+namespace
+{
+constexpr uint32_t BUILDING_FLOORS = 4;
+constexpr uint32_t ROOMS_PER_FLOOR = 5;
+constexpr uint32_t BUILDING_NODES = 1 + BUILDING_FLOORS * (1 + ROOMS_PER_FLOOR);
+
+// Meshes reference a model that is never loaded, so only scene data is measured
+MeshRendererComponent::MeshId make_mesh_id(size_t mesh_id)
+{
+	MeshRendererComponent::MeshId id;
+	id.model_asset.guid = 0x4D6F64656C;
+	id.mesh_id = mesh_id;
+	return id;
+}
+
+// Building: floors under the root, rooms under floors, every node has a mesh
+Entity make_building(Scene *scene, glm::vec3 position)
+{
+	Entity root = scene->createEntity("Building");
+	root.addComponent<MeshRendererComponent>().meshes.push_back(make_mesh_id(0));
+	for (uint32_t floor = 0; floor < BUILDING_FLOORS; floor++)
+	{
+		Entity floor_entity = scene->createEntity("Floor");
+		floor_entity.getTransform().parent = root;
+		root.getTransform().children.push_back(floor_entity);
+		floor_entity.addComponent<MeshRendererComponent>().meshes.push_back(make_mesh_id(1));
+		floor_entity.getTransform().setPosition(glm::vec3(0, floor * 3.0f, 0));
+
+		for (uint32_t room = 0; room < ROOMS_PER_FLOOR; room++)
+		{
+			Entity room_entity = scene->createEntity("Room");
+			room_entity.getTransform().parent = floor_entity;
+			floor_entity.getTransform().children.push_back(room_entity);
+			room_entity.addComponent<MeshRendererComponent>().meshes.push_back(make_mesh_id(2 + room));
+			room_entity.getTransform().setPosition(glm::vec3(room * 4.0f, 0, 0));
+		}
+	}
+	root.getTransform().setPosition(position);
+	return root;
+}
+
+glm::vec3 city_position(uint32_t building)
+{
+	return glm::vec3(building % 32 * 30.0f, 0, building / 32 * 30.0f);
+}
+
+// Private bytes of the process, heap growth while a scene is loaded
+uint64_t get_private_bytes()
+{
+	PROCESS_MEMORY_COUNTERS_EX counters{};
+	GetProcessMemoryInfo(GetCurrentProcess(), (PROCESS_MEMORY_COUNTERS *)&counters, sizeof(counters));
+	return counters.PrivateUsage;
+}
+
+Ref<Scene> load_city(const std::filesystem::path &path)
+{
+	Ref<Scene> scene = Scene::loadScene(path.string().c_str());
+	for (auto [entity, prefab_instance] : scene->getEntitiesWith<PrefabInstanceComponent>().each())
+		prefab_instance.getPrefab();
+	scene->clearDirty();
+	return scene;
+}
+
+// The same city of buildings saved as copied entity subtrees and as prefab instances
+void bench_city(Microbenchmarks &bench, const char *copies_name, const char *instances_name, const char *memory_name, uint32_t building_count)
+{
+	if (!bench.isEnabled(copies_name) && !bench.isEnabled(instances_name) && !bench.isEnabled(memory_name))
+		return;
+
+	std::filesystem::path previous_root = AssetManager::getAssetsRoot();
+	std::filesystem::path root = std::filesystem::temp_directory_path() / "MicrobenchmarkPrefabs";
+	std::filesystem::remove_all(root);
+	std::filesystem::create_directories(root);
+	AssetManager::setAssetsRoot(root);
+	AssetManager::refresh();
+
+	std::filesystem::path copies_path = root / "CityCopies.scene";
+	std::filesystem::path instances_path = root / "CityInstances.scene";
+	std::filesystem::path prefab_path = root / "Building.prefab";
+	{
+		Ref<Scene> scene = new Scene();
+		Scene::setCurrentScene(scene);
+		Entity first_building;
+		for (uint32_t i = 0; i < building_count; i++)
+		{
+			Entity building = make_building(scene, city_position(i));
+			if (i == 0)
+				first_building = building;
+		}
+		scene->saveFile(copies_path.string().c_str());
+
+		Prefab::createFromEntity(first_building)->save(prefab_path);
+		AssetManager::getOrCreateMetadata(prefab_path);
+		Scene::closeScene();
+	}
+	{
+		Ref<Scene> scene = new Scene();
+		Scene::setCurrentScene(scene);
+		AssetReference prefab_reference(prefab_path);
+		for (uint32_t i = 0; i < building_count; i++)
+		{
+			Entity entity = scene->createEntity("Building");
+			entity.addComponent<PrefabInstanceComponent>().prefab_asset = prefab_reference;
+			entity.getTransform().setPosition(city_position(i));
+		}
+		scene->saveFile(instances_path.string().c_str());
+		Scene::closeScene();
+	}
+
+	bench.run(copies_name, building_count, [&]()
+	{
+		load_city(copies_path);
+		Scene::closeScene();
+	});
+
+	bench.run(instances_name, building_count, [&]()
+	{
+		load_city(instances_path);
+		Scene::closeScene();
+	});
+
+	if (bench.isEnabled(memory_name))
+	{
+		uint64_t before = get_private_bytes();
+		Ref<Scene> copies = load_city(copies_path);
+		int64_t copies_bytes = int64_t(get_private_bytes() - before);
+		uint32_t copies_entities = copies->getEntitiesWith<TransformComponent>().size();
+		Scene::closeScene();
+		copies = nullptr;
+
+		before = get_private_bytes();
+		Ref<Scene> instances = load_city(instances_path);
+		int64_t instances_bytes = int64_t(get_private_bytes() - before);
+		uint32_t instances_entities = instances->getEntitiesWith<TransformComponent>().size();
+		Scene::closeScene();
+		instances = nullptr;
+
+		// Copies have mesh and material records per instance, instances share the ones of the prefab
+		uint64_t parts = uint64_t(building_count) * BUILDING_NODES;
+		uint64_t copies_gpu_bytes = parts * (sizeof(InstanceGPU) + sizeof(MeshGPU) + sizeof(MaterialGPU));
+		uint64_t instances_gpu_bytes = parts * sizeof(InstanceGPU) + BUILDING_NODES * (sizeof(InstanceGPU) + sizeof(MeshGPU) + sizeof(MaterialGPU));
+
+		eastl::string message;
+		message.sprintf("copies: %u entities, %.1f MB heap, %.1f MB file, %.1f MB GPU records; instances: %u entities, %.1f MB heap, %.1f MB file, %.1f MB GPU records",
+						copies_entities, copies_bytes / 1048576.0, std::filesystem::file_size(copies_path) / 1048576.0, copies_gpu_bytes / 1048576.0,
+						instances_entities, instances_bytes / 1048576.0, std::filesystem::file_size(instances_path) / 1048576.0, instances_gpu_bytes / 1048576.0);
+		bench.check(memory_name, instances_entities == building_count && copies_entities == building_count * BUILDING_NODES && instances_bytes < copies_bytes, message);
+	}
+
+	AssetManager::shutdown();
+	AssetManager::setAssetsRoot(previous_root);
+	AssetManager::refresh();
+	std::filesystem::remove_all(root);
+}
+}
+
+void runPrefabBenchmarks(Microbenchmarks &bench)
+{
+	bench_city(bench, "Prefab/load_city_1k_copies", "Prefab/load_city_1k_instances", "Prefab/memory_city_1k", 1024);
+}
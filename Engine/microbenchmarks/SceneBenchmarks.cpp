@@ -0,0 +1,252 @@
+#include "pch.h"
+#include "Microbenchmark.h"
+#include "Scene/Scene.h"
+#include "Scene/Entity.h"
+#include "Scene/SceneSpatialIndex.h"
+
+namespace
+{
+struct SyntheticHierarchy
+{
+	eastl::vector<entt::entity> roots;
+	eastl::vector<entt::entity> leaves;
+	uint32_t entity_count = 0;
+};
+
+void add_children(Scene *scene, Entity parent, uint32_t depth, uint32_t branching, MicrobenchmarkRandom &random, SyntheticHierarchy &hierarchy)
+{
+	if (depth == 0)
+	{
+		hierarchy.leaves.push_back(parent);
+		return;
+	}
+
+	for (uint32_t i = 0; i < branching; i++)
+	{
+		Entity child = scene->createEntity("Child");
+		TransformComponent &transform = child.getTransform();
+		transform.parent = parent;
+		transform.local_position = glm::vec3(random.unit(), random.unit(), random.unit()) * 10.0f;
+		parent.getTransform().children.push_back(child);
+		hierarchy.entity_count++;
+		add_children(scene, child, depth - 1, branching, random, hierarchy);
+	}
+}
+
+// Prefab-like trees: many roots, each with a few levels of children
+SyntheticHierarchy make_hierarchy(Scene *scene, uint32_t root_count, uint32_t depth, uint32_t branching)
+{
+	MicrobenchmarkRandom random(1);
+	SyntheticHierarchy hierarchy;
+	for (uint32_t i = 0; i < root_count; i++)
+	{
+		Entity root = scene->createEntity("Root");
+		hierarchy.roots.push_back(root);
+		hierarchy.entity_count++;
+		add_children(scene, root, depth, branching, random, hierarchy);
+		root.getTransform().setPosition(glm::vec3(i, 0, 0));
+	}
+	scene->clearDirty();
+	return hierarchy;
+}
+
+void bench_move_roots(Microbenchmarks &bench, const char *name, uint32_t root_count, uint32_t depth, uint32_t branching)
+{
+	if (!bench.isEnabled(name))
+		return;
+
+	Ref<Scene> scene = new Scene();
+	Scene::setCurrentScene(scene);
+	SyntheticHierarchy hierarchy = make_hierarchy(scene, root_count, depth, branching);
+
+	float offset = 0.0f;
+	bench.run(name, hierarchy.entity_count, [&]()
+	{
+		offset += 1.0f;
+		for (entt::entity root : hierarchy.roots)
+			Entity(root).getTransform().setPosition(glm::vec3(offset, 0, 0));
+		scene->clearDirty();
+	});
+	Scene::closeScene();
+}
+
+void bench_write_leaves(Microbenchmarks &bench, const char *name, uint32_t root_count, uint32_t depth, uint32_t branching, uint32_t write_count)
+{
+	if (!bench.isEnabled(name))
+		return;
+
+	Ref<Scene> scene = new Scene();
+	Scene::setCurrentScene(scene);
+	SyntheticHierarchy hierarchy = make_hierarchy(scene, root_count, depth, branching);
+
+	// Animated bones or physics bodies deep in the trees
+	MicrobenchmarkRandom random(2);
+	eastl::vector<Scene::LocalTransformWrite> writes(write_count);
+	for (Scene::LocalTransformWrite &write : writes)
+	{
+		write.entity = hierarchy.leaves[random.range(hierarchy.leaves.size())];
+		write.position = glm::vec3(random.unit(), random.unit(), random.unit());
+		write.rotation = glm::angleAxis(random.unit() * 6.28f, glm::vec3(0, 1, 0));
+	}
+
+	bench.run(name, write_count, [&]()
+	{
+		scene->writeLocalTransforms(writes);
+		scene->clearDirty();
+	});
+	Scene::closeScene();
+}
+
+// Open world: boxes from props to buildings over 4 x 4 km, 1% of them are moving with their own velocity
+struct SyntheticWorld
+{
+	eastl::vector<BoundBox> bounds;
+	eastl::vector<uint32_t> moving;
+	eastl::vector<glm::vec3> velocities;
+};
+
+SyntheticWorld make_world(uint32_t entity_count)
+{
+	MicrobenchmarkRandom random(3);
+	SyntheticWorld world;
+	world.bounds.resize(entity_count);
+	for (BoundBox &bounds : world.bounds)
+	{
+		glm::vec3 center = glm::vec3(random.unit() * 4000.0f, random.unit() * 50.0f, random.unit() * 4000.0f);
+		float size = random.unit();
+		glm::vec3 extent = glm::vec3(0.2f + size * size * size * 10.0f);
+		bounds = BoundBox(center - extent, center + extent);
+	}
+
+	uint32_t moving_count = entity_count / 100;
+	for (uint32_t i = 0; i < moving_count; i++)
+	{
+		world.moving.push_back(random.range(entity_count));
+		world.velocities.push_back(glm::vec3(random.unit() - 0.5f, 0.0f, random.unit() - 0.5f) * 0.5f);
+	}
+	return world;
+}
+
+void build_index(const SyntheticWorld &world, SceneSpatialIndex &index)
+{
+	index.clear();
+	for (uint32_t i = 0; i < world.bounds.size(); i++)
+		index.update(entt::entity(i), world.bounds[i]);
+}
+
+void move_entities(SyntheticWorld &world, SceneSpatialIndex &index)
+{
+	for (uint32_t i = 0; i < world.moving.size(); i++)
+	{
+		BoundBox &bounds = world.bounds[world.moving[i]];
+		bounds = BoundBox(bounds.min + world.velocities[i], bounds.max + world.velocities[i]);
+		index.update(entt::entity(world.moving[i]), bounds);
+	}
+}
+
+void bench_spatial_index_build(Microbenchmarks &bench, const char *name, uint32_t entity_count)
+{
+	if (!bench.isEnabled(name))
+		return;
+
+	SyntheticWorld world = make_world(entity_count);
+	SceneSpatialIndex index;
+	bench.run(name, entity_count, [&]()
+	{
+		build_index(world, index);
+	});
+}
+
+// Moves 1% of entities per iteration, then checks the tree and the queries against a scan of all bounds
+void bench_spatial_index_move(Microbenchmarks &bench, const char *name, uint32_t entity_count)
+{
+	if (!bench.isEnabled(name))
+		return;
+
+	SyntheticWorld world = make_world(entity_count);
+	SceneSpatialIndex index;
+	build_index(world, index);
+	bench.run(name, world.moving.size(), [&]()
+	{
+		move_entities(world, index);
+	});
+
+	MicrobenchmarkRandom random(4);
+	uint32_t mismatches = 0;
+	eastl::vector<entt::entity> entities;
+	for (uint32_t query = 0; query < 16; query++)
+	{
+		glm::vec3 center = glm::vec3(random.unit() * 4000.0f, 25.0f, random.unit() * 4000.0f);
+		BoundBox box(center - glm::vec3(50.0f), center + glm::vec3(50.0f));
+		entities.clear();
+		index.queryBox(box, entities);
+
+		size_t expected = 0;
+		for (const BoundBox &bounds : world.bounds)
+		{
+			if (glm::all(glm::lessThanEqual(bounds.min, box.max)) && glm::all(glm::lessThanEqual(box.min, bounds.max)))
+				expected++;
+		}
+		if (entities.size() != expected)
+			mismatches++;
+	}
+
+	eastl::string message;
+	message.sprintf("height %u, %u of 16 box queries differ from a scan", index.getHeight(), mismatches);
+	bench.check(name, index.validate() && index.getCount() == entity_count && mismatches == 0, message);
+}
+
+void bench_spatial_index_queries(Microbenchmarks &bench, uint32_t entity_count)
+{
+	const char *raycast_name = "SceneSpatialIndex/raycast_1m";
+	const char *frustum_name = "SceneSpatialIndex/frustum_1m";
+	const char *box_name = "SceneSpatialIndex/box_query_1m";
+	if (!bench.isEnabled(raycast_name) && !bench.isEnabled(frustum_name) && !bench.isEnabled(box_name))
+		return;
+
+	SyntheticWorld world = make_world(entity_count);
+	SceneSpatialIndex index;
+	build_index(world, index);
+
+	// Camera on the ground looking along the world, picking rays through the view
+	MicrobenchmarkRandom random(5);
+	glm::vec3 camera_position = glm::vec3(2000.0f, 2.0f, 100.0f);
+	glm::mat4 view = glm::lookAt(camera_position, glm::vec3(2000.0f, 2.0f, 1000.0f), glm::vec3(0, 1, 0));
+	glm::mat4 projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 1000.0f);
+	BoundFrustum frustum(projection, view);
+
+	const uint32_t rays_count = 64;
+	eastl::vector<glm::vec3> directions(rays_count);
+	for (glm::vec3 &direction : directions)
+		direction = glm::normalize(glm::vec3(random.unit() - 0.5f, (random.unit() - 0.5f) * 0.2f, 1.0f));
+
+	eastl::vector<SceneSpatialIndex::RayHit> hits;
+	bench.run(raycast_name, rays_count, [&]()
+	{
+		for (const glm::vec3 &direction : directions)
+			index.raycast(camera_position, direction, 1000.0f, hits);
+	});
+
+	eastl::vector<entt::entity> entities;
+	bench.run(frustum_name, 1, [&]()
+	{
+		entities.clear();
+		index.queryFrustum(frustum, entities);
+	});
+
+	bench.run(box_name, 1, [&]()
+	{
+		entities.clear();
+		index.queryBox(BoundBox(camera_position - glm::vec3(100.0f), camera_position + glm::vec3(100.0f)), entities);
+	});
+}
+}
+
+void runSceneBenchmarks(Microbenchmarks &bench)
+{
+	bench_move_roots(bench, "Scene/move_roots_37k_entities", 64, 3, 8);
+	bench_write_leaves(bench, "Scene/write_4k_leaves_37k_entities", 64, 3, 8, 4096);
+	bench_spatial_index_build(bench, "SceneSpatialIndex/build_100k", 100000);
+	bench_spatial_index_move(bench, "SceneSpatialIndex/move_1pct_1m", 1000000);
+	bench_spatial_index_queries(bench, 1000000);
+}
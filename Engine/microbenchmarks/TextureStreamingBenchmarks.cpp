@@ -0,0 +1,114 @@
+#include "pch.h"
+#include "Microbenchmark.h"
+#include "Rendering/TextureStreamingPolicy.h"
+
+namespace
+{
+constexpr uint32_t TAIL_SIZE = 64;
+
+struct SyntheticTexture
+{
+	eastl::vector<uint64_t> mip_sizes;
+	uint32_t tail_mip;
+};
+
+// Square BC7 textures from 256 to 4096, one byte per texel and 4x4 blocks, mips up to TAIL_SIZE are the tail
+eastl::vector<SyntheticTexture> make_textures(uint32_t count)
+{
+	MicrobenchmarkRandom random(1);
+	eastl::vector<SyntheticTexture> textures(count);
+	for (SyntheticTexture &texture : textures)
+	{
+		uint32_t size = 256u << random.range(5);
+		for (uint32_t mip_size = size; mip_size > 0; mip_size /= 2)
+		{
+			uint64_t blocks_size = eastl::max(mip_size, 4u);
+			texture.mip_sizes.push_back(blocks_size * blocks_size);
+		}
+		texture.tail_mip = 0;
+		while ((size >> texture.tail_mip) > TAIL_SIZE)
+			texture.tail_mip++;
+	}
+	return textures;
+}
+
+void add_textures(TextureStreamingPolicy &policy, const eastl::vector<SyntheticTexture> &textures)
+{
+	for (uint32_t i = 0; i < textures.size(); i++)
+		policy.addTexture(i, eastl::span<const uint64_t>(textures[i].mip_sizes.data(), textures[i].mip_sizes.size()), textures[i].tail_mip);
+}
+
+// Textures stand along a corridor in index order. The camera walks it, stops for a while in the middle and walks on,
+// textures close to it want fine mips. Pixels sample a sparse subset, so only half of the visible textures report each frame
+eastl::vector<TextureStreamingPolicy::ReplayFrame> make_walk_feedback(const eastl::vector<SyntheticTexture> &textures, uint32_t frames_count)
+{
+	MicrobenchmarkRandom random(2);
+	eastl::vector<TextureStreamingPolicy::ReplayFrame> frames(frames_count);
+	float speed = textures.size() / float(frames_count);
+	for (uint32_t frame = 0; frame < frames_count; frame++)
+	{
+		uint32_t walked_frames = frame < frames_count / 3 ? frame : eastl::max(frame, frames_count / 2) - frames_count / 6;
+		int center = int(walked_frames * speed * 1.5f);
+		for (int i = eastl::max(center - 96, 0); i < eastl::min(center + 96, (int)textures.size()); i++)
+		{
+			if (random.range(2) == 0)
+				continue;
+			uint32_t desired_mip = eastl::min(uint32_t(abs(i - center) / 16), textures[i].tail_mip);
+			frames[frame].feedback.push_back({(uint32_t)i, desired_mip});
+		}
+	}
+	return frames;
+}
+
+// Synthetic feedback replayed against the policy: resident bytes must never go over the budget and
+// uploads of one frame must fit max_upload_bytes_per_frame unless the frame changes a single texture
+void bench_replay_walk(Microbenchmarks &bench, const char *name, uint32_t textures_count, uint32_t frames_count)
+{
+	if (!bench.isEnabled(name))
+		return;
+
+	eastl::vector<SyntheticTexture> textures = make_textures(textures_count);
+	eastl::vector<TextureStreamingPolicy::ReplayFrame> frames = make_walk_feedback(textures, frames_count);
+
+	uint64_t full_bytes = 0;
+	uint64_t tail_bytes = 0;
+	uint64_t largest_texture_bytes = 0;
+	for (const SyntheticTexture &texture : textures)
+	{
+		uint64_t size = 0;
+		for (uint32_t mip = 0; mip < texture.mip_sizes.size(); mip++)
+		{
+			size += texture.mip_sizes[mip];
+			if (mip >= texture.tail_mip)
+				tail_bytes += texture.mip_sizes[mip];
+		}
+		full_bytes += size;
+		largest_texture_bytes = eastl::max(largest_texture_bytes, size);
+	}
+	uint64_t budget_bytes = eastl::max(full_bytes / 8, tail_bytes * 2);
+	eastl::span<const TextureStreamingPolicy::ReplayFrame> frames_span(frames.data(), frames.size());
+
+	TextureStreamingPolicy policy;
+	add_textures(policy, textures);
+	TextureStreamingPolicy::ReplayResult result = TextureStreamingPolicy::replay(policy, frames_span, budget_bytes);
+
+	uint64_t max_frame_upgrade_bytes = eastl::max(policy.max_upload_bytes_per_frame, largest_texture_bytes);
+	eastl::string message;
+	message.sprintf("%u upgrades, %u downgrades, %.1f%% satisfied, peak %.1f MB of %.1f MB budget, at most %u upgrades and %.1f MB per frame",
+					(uint32_t)result.upgrades, (uint32_t)result.downgrades, result.getSatisfiedRate() * 100.0f, result.peak_resident_bytes / 1048576.0,
+					budget_bytes / 1048576.0, result.peak_frame_upgrades, result.peak_frame_upgrade_bytes / 1048576.0);
+	bench.check(name, result.upgrades > 0 && result.peak_resident_bytes <= budget_bytes && result.peak_frame_upgrade_bytes <= max_frame_upgrade_bytes, message);
+
+	bench.run(name, result.requests, [&]()
+	{
+		TextureStreamingPolicy replay_policy;
+		add_textures(replay_policy, textures);
+		TextureStreamingPolicy::replay(replay_policy, frames_span, budget_bytes);
+	});
+}
+}
+
+void runTextureStreamingBenchmarks(Microbenchmarks &bench)
+{
+	bench_replay_walk(bench, "TextureStreaming/replay_walk_1k_textures", 1024, 600);
+}
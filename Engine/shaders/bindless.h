@@ -19,6 +19,28 @@ float4 SampleTextureArray(uint index, float3 uvw, SamplerState sampler)
     Texture2DArray tex = ResourceDescriptorHeap[index];
     return tex.Sample(sampler, uvw);
 }
+
+// Texture streaming feedback, every frame one pixel of each 8x8 tile reports the finest mip it samples.
+// uv derivatives are taken by the caller, so this can be called from non uniform control flow.
+void WriteTextureFeedback(uint index, float2 uv_dx, float2 uv_dy, uint2 pixel)
+{
+    if (texture_feedback_buffer_id == 0 || index == 0)
+        return;
+    uint2 tile_pixel = pixel & 7;
+    if (tile_pixel.x + tile_pixel.y * 8 != (frame * 29) % 64)
+        return;
+
+    Texture2D tex = ResourceDescriptorHeap[index];
+    float2 size;
+    tex.GetDimensions(size.x, size.y);
+    float2 dx = uv_dx * size;
+    float2 dy = uv_dy * size;
+    float lod = 0.5 * log2(max(max(dot(dx, dx), dot(dy, dy)), 1e-8));
+
+    RWByteAddressBuffer feedback = ResourceDescriptorHeap[texture_feedback_buffer_id];
+    uint value = (uint)clamp(floor(lod) + TEXTURE_FEEDBACK_MIP_BIAS, 0, 255);
+    feedback.InterlockedMin(index * 4, value);
+}
 #endif
 
 float4 SampleTextureLevel(uint index, float2 uv, int lod)
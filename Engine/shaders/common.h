@@ -100,6 +100,8 @@ cbuffer FrameConstants : register(b32) {
 	uint tlas_id;
 	uint ddgi_volume_buffer_id;
 	uint lines_gpu_buffer_id;
+	uint texture_feedback_buffer_id;
+	uint debug_primitives_gpu_buffer_id;
 };
 
 struct DrawIndexedIndirect
@@ -137,6 +139,7 @@ struct Material
 };
 
 #define INSTANCE_FLAG_INVALID 0x1
+#define INSTANCE_FLAG_DYNAMIC 0x2
 
 struct Instance
 {
@@ -241,6 +244,9 @@ struct Meshlet
 
 #define GROUP_NON_RESIDENT_ADDRESS_START uint32_t(1) << 31
 #define MAX_UNLOAD_REQUESTS 1024
+
+#define TEXTURE_FEEDBACK_NONE 0xFFFFFFFFu
+#define TEXTURE_FEEDBACK_MIP_BIAS 16
 // meshlet_id encoding: flat_group_idx << 8 | local_meshlet_id
 struct GroupResidency
 {
@@ -454,6 +460,69 @@ void addScreenQuad(float2 p0, float2 p1, float3 color)
 	addLine(float3(p1.x, p0.y, 0), float3(p1.x, p1.y, 0), color, true);
 }
 
+#define DEBUG_PRIMITIVE_LINE 0
+#define DEBUG_PRIMITIVE_BOX 1
+#define DEBUG_PRIMITIVE_SPHERE 2
+#define DEBUG_PRIMITIVE_TYPES_COUNT 3
+#define DEBUG_SPHERE_SEGMENTS 24
+#define MAX_GPU_DEBUG_PRIMITIVES 65536
+
+// Same layout as DebugPrimitiveGPU: transform columns, then color
+#define DEBUG_PRIMITIVE_SIZE 80
+
+void storeDebugPrimitive(RWByteAddressBuffer buffer, uint offset, float4x4 transform, float4 color)
+{
+	float4x4 columns = transpose(transform);
+	buffer.Store4(offset, asuint(columns[0]));
+	buffer.Store4(offset + 16, asuint(columns[1]));
+	buffer.Store4(offset + 32, asuint(columns[2]));
+	buffer.Store4(offset + 48, asuint(columns[3]));
+	buffer.Store4(offset + 64, asuint(color));
+}
+
+void loadDebugPrimitive(ByteAddressBuffer buffer, uint offset, out float4x4 transform, out float4 color)
+{
+	transform = transpose(float4x4(
+		asfloat(buffer.Load4(offset)),
+		asfloat(buffer.Load4(offset + 16)),
+		asfloat(buffer.Load4(offset + 32)),
+		asfloat(buffer.Load4(offset + 48))));
+	color = asfloat(buffer.Load4(offset + 64));
+}
+
+// Counters of every type go first, then MAX_GPU_DEBUG_PRIMITIVES primitives of every type
+void addDebugPrimitive(uint type, float4x4 transform, float3 color)
+{
+	RWByteAddressBuffer gpu_primitives = ResourceDescriptorHeap[debug_primitives_gpu_buffer_id];
+
+	uint index;
+	gpu_primitives.InterlockedAdd(type * 4, 1, index);
+	if (index >= MAX_GPU_DEBUG_PRIMITIVES)
+		return;
+
+	storeDebugPrimitive(gpu_primitives, DEBUG_PRIMITIVE_TYPES_COUNT * 4 + (type * MAX_GPU_DEBUG_PRIMITIVES + index) * DEBUG_PRIMITIVE_SIZE, transform, float4(color, 1));
+}
+
+void addDebugBox(float3 center, float3 half_extents, float3 color)
+{
+	float4x4 transform = float4x4(
+		half_extents.x, 0, 0, center.x,
+		0, half_extents.y, 0, center.y,
+		0, 0, half_extents.z, center.z,
+		0, 0, 0, 1);
+	addDebugPrimitive(DEBUG_PRIMITIVE_BOX, transform, color);
+}
+
+void addDebugSphere(float3 center, float radius, float3 color)
+{
+	float4x4 transform = float4x4(
+		radius, 0, 0, center.x,
+		0, radius, 0, center.y,
+		0, 0, radius, center.z,
+		0, 0, 0, 1);
+	addDebugPrimitive(DEBUG_PRIMITIVE_SPHERE, transform, color);
+}
+
 void addBoundBox(float3 min, float3 max, float3 color)
 {
 	addLine(min, float3(max.x, min.y, min.z), color);
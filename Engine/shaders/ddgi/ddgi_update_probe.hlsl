@@ -9,6 +9,7 @@ static StructuredBuffer<uint> probes_to_update = ResourceDescriptorHeap[volume.p
 cbuffer Constants : register(b1)
 {
 	uint output_atlas_tex_id;
+	uint probe_changes_buffer_id; // Relative irradiance change per probe for DDGIProbeScheduler
 };
 
 #ifdef IRRADIANCE
@@ -19,6 +20,35 @@ cbuffer Constants : register(b1)
 	static RWTexture2DArray<float2> output_atlas = ResourceDescriptorHeap[output_atlas_tex_id];
 #endif
 
+#ifdef IRRADIANCE
+	groupshared uint probe_change;
+
+	// Largest change of the probe texels, positive floats keep their order as uints
+	void WriteProbeChange(uint probe_id, uint group_index, float change)
+	{
+		if (group_index == 0)
+			probe_change = 0;
+		GroupMemoryBarrierWithGroupSync();
+		InterlockedMax(probe_change, asuint(change));
+		GroupMemoryBarrierWithGroupSync();
+		if (group_index == 0)
+		{
+			RWByteAddressBuffer probe_changes = ResourceDescriptorHeap[probe_changes_buffer_id];
+			probe_changes.Store(probe_id * 4, probe_change);
+		}
+	}
+
+	// Disabled probes keep their irradiance, group returns together
+	void ClearProbeChange(uint probe_id, uint group_index)
+	{
+		if (group_index == 0)
+		{
+			RWByteAddressBuffer probe_changes = ResourceDescriptorHeap[probe_changes_buffer_id];
+			probe_changes.Store(probe_id * 4, 0);
+		}
+	}
+#endif
+
 struct CSInput
 {
 	uint3 dispatch_thread_id : SV_DispatchThreadID;
@@ -69,7 +99,12 @@ void CSMain(CSInput input)
 	float3 texel_direction = GetOctahedralDirection(oct_coord);
 
 	if (IsProbeDisabled(volume, probe_coord, cascade_id))
+	{
+		#ifdef IRRADIANCE
+			ClearProbeChange(probe_id, input.group_index);
+		#endif
 		return;
+	}
 
 	uint ray_index = 0;
 	#if USE_FIXED_RAYS
@@ -97,7 +132,10 @@ void CSMain(CSInput input)
 			{
 				back_face_count++;
 				if (back_face_count >= max_back_faces)
+				{
+					ClearProbeChange(probe_id, input.group_index);
 					return;
+				}
 				continue;
 			}
 			float3 ray_direction = GetProbeRayDirection(ray_index, volume);
@@ -123,6 +161,11 @@ void CSMain(CSInput input)
 
 		float3 result = lerp(prev, irradiance_average, blend_weight);
 		output_atlas[texel_coord] = float4(result, 1);
+
+		// Cleared probes count as fully changed
+		float prev_luminance = Luminance(prev);
+		float change = prev_luminance > 0.0 ? abs(Luminance(result) - prev_luminance) / max(prev_luminance, 1e-4f) : 1.0;
+		WriteProbeChange(probe_id, input.group_index, saturate(change));
 		//output_atlas[texel_coord] = float4(pow(cascade / 5.0f, 2.0), 0, 0, 1);
 		//output_atlas[texel_coord] = float4(probe_coord / 16.0f, 1);
 	#else
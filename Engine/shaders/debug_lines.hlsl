@@ -1,29 +1,59 @@
 #include "common.h"
 
-struct VSInput {
-    float4 position : POSITION;
-    float3 color : COLOR;
-};
-
 struct VSOutput {
     float4 position : SV_POSITION;
     float3 color : COLOR;
 };
 
-VSOutput VSMain(VSInput input)
+cbuffer PrimitivesConstants : register(b1)
 {
-    VSOutput output;
+	uint primitives_buffer_id;
+	uint primitives_offset; // byte offset of the first primitive of the type
+	uint primitive_type;
+};
 
-    bool is_screenspace = input.position.a > 0;
+static const uint box_edges[24] =
+{
+    0, 1, 1, 3, 3, 2, 2, 0,
+    4, 5, 5, 7, 7, 6, 6, 4,
+    0, 4, 1, 5, 2, 6, 3, 7
+};
 
-    if (is_screenspace)
-    {
-        output.position = float4(input.position.xyz, 1.0f);
-    } else
+// Line list of the unit shape, one line per two vertices
+float3 getPrimitiveVertex(uint type, uint vertex_id)
+{
+    if (type == DEBUG_PRIMITIVE_LINE)
+        return float3(vertex_id, 0, 0);
+
+    if (type == DEBUG_PRIMITIVE_BOX)
     {
-        output.position = mul(view_projection_unjittered, float4(input.position.xyz, 1.0f));
+        uint corner = box_edges[vertex_id];
+        return float3(corner & 1, (corner >> 1) & 1, (corner >> 2) & 1) * 2 - 1;
     }
-    output.color = input.color;
+
+    // Sphere: circles around the three axes
+    uint segment = vertex_id / 2 + (vertex_id & 1);
+    uint circle = vertex_id / (2 * DEBUG_SPHERE_SEGMENTS);
+    float angle = 2 * PI * float(segment % DEBUG_SPHERE_SEGMENTS) / DEBUG_SPHERE_SEGMENTS;
+    float2 p = float2(cos(angle), sin(angle));
+    if (circle == 0)
+        return float3(p, 0);
+    if (circle == 1)
+        return float3(p.x, 0, p.y);
+    return float3(0, p);
+}
+
+VSOutput VSPrimitives(uint vertex_id : SV_VertexID, uint instance_id : SV_InstanceID)
+{
+    ByteAddressBuffer primitives = ResourceDescriptorHeap[primitives_buffer_id];
+    float4x4 transform;
+    float4 color;
+    loadDebugPrimitive(primitives, primitives_offset + instance_id * DEBUG_PRIMITIVE_SIZE, transform, color);
+
+    VSOutput output;
+    float3 position = mul(transform, float4(getPrimitiveVertex(primitive_type, vertex_id), 1.0f)).xyz;
+    output.position = mul(view_projection_unjittered, float4(position, 1.0f));
+    output.color = color.rgb;
     return output;
 }
 
@@ -41,8 +71,22 @@ PSOutput PSMain(VSOutput input)
 cbuffer Uniforms : register(b0)
 {
 	uint lines_draw_args_buffer_id;
+	uint box_draw_args_buffer_id;
+	uint sphere_draw_args_buffer_id;
+	uint line_primitives_draw_args_buffer_id;
 };
 
+void writePrimitivesDrawArgs(RWByteAddressBuffer gpu_primitives, uint type, uint draw_args_buffer_id, uint vertex_count)
+{
+    uint primitives_count = min(gpu_primitives.Load(type * 4), MAX_GPU_DEBUG_PRIMITIVES);
+    gpu_primitives.Store(type * 4, 0);
+
+    RWStructuredBuffer<DrawIndirect> draw_args = ResourceDescriptorHeap[draw_args_buffer_id];
+    draw_args[0] = (DrawIndirect)0;
+    draw_args[0].vertex_count_per_instance = vertex_count;
+    draw_args[0].instance_count = primitives_count;
+}
+
 [numthreads(1, 1, 1)]
 void CSGenerateDrawCalls(uint3 dispatchID : SV_DispatchThreadID)
 {
@@ -54,6 +98,11 @@ void CSGenerateDrawCalls(uint3 dispatchID : SV_DispatchThreadID)
     draw_args[0] = (DrawIndirect)0;
     draw_args[0].vertex_count_per_instance = 2 * lines_count;
     draw_args[0].instance_count = 1;
+
+    RWByteAddressBuffer gpu_primitives = ResourceDescriptorHeap[debug_primitives_gpu_buffer_id];
+    writePrimitivesDrawArgs(gpu_primitives, DEBUG_PRIMITIVE_LINE, line_primitives_draw_args_buffer_id, 2);
+    writePrimitivesDrawArgs(gpu_primitives, DEBUG_PRIMITIVE_BOX, box_draw_args_buffer_id, 24);
+    writePrimitivesDrawArgs(gpu_primitives, DEBUG_PRIMITIVE_SPHERE, sphere_draw_args_buffer_id, 3 * 2 * DEBUG_SPHERE_SEGMENTS);
 }
 
 VSOutput VSGpuLines(uint vertex_id : SV_VertexID)
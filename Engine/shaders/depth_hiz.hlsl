@@ -1,29 +1,157 @@
 #include "common.h"
 
+// Single pass HiZ: every group reduces a 64x64 tile of mip 0 down to mip 6 (1x1),
+// then the last group to finish a layer reduces mip 6 of all tiles down to the last mip.
+// Mip 0 texel is max of 2x2 depth texels around its center (footprint of Gather), texel of next mips is max of its 2x2 texels.
+// Texels outside of a mip are 0, which doesn't change max. Keep in sync with HiZ::buildReference
+#define TILE_SIZE 64
+#define TAIL_VALUES_PER_LAYER (TILE_SIZE * TILE_SIZE)
+
 cbuffer Uniforms : register(b0)
 {
-    uint output_tex_id;
-    uint depth_tex_id;
-    int2 texture_size;
-    uint convert_reverse_z; // for first mip converting
+    int2 depth_size;
+    int2 hiz_size; // mip 0, power of two
+    uint mip_levels;
+    uint convert_reverse_z; // HiZ always stores standard-z
+    uint atomics_buffer_id; // MAX_LAYERS counters, then mip 6 of every tile per layer
+    uint pad;
+    uint4 texture_ids[MAX_LAYERS * 4]; // per layer: depth SRV, then UAV of every mip
 };
 
-static RWTexture2D<float> output_texture = ResourceDescriptorHeap[output_tex_id];
-static Texture2D depth_texture = ResourceDescriptorHeap[depth_tex_id];
+DECLARE_COHERENT_RW_BYTE_ADDRESS_BUFFER(atomics, atomics_buffer_id)
+
+groupshared float shared_values[16 * 16];
+groupshared uint shared_is_last;
+
+uint getTextureId(uint layer, uint index)
+{
+    return texture_ids[layer * 4 + index / 4][index % 4];
+}
+
+uint2 getMipSize(uint mip)
+{
+    return max(uint2(hiz_size) >> mip, 1u);
+}
+
+uint getTailOffset(uint layer, uint2 tile)
+{
+    return (MAX_LAYERS + layer * TAIL_VALUES_PER_LAYER + tile.y * TILE_SIZE + tile.x) * 4;
+}
 
-// HiZ always stores standard-z
-[numthreads(THREADGROUP_SIZE, THREADGROUP_SIZE, 1)]
-void CSMain(uint3 dispatchID : SV_DispatchThreadID)
+float computeMip0(uint layer, uint2 coord)
 {
-    uint3 coord = dispatchID;
+    Texture2D depth_texture = ResourceDescriptorHeap[getTextureId(layer, 0)];
 
-    if (coord.x >= texture_size.x || coord.y >= texture_size.y) return;
+    // Integer form of floor((coord + 0.5) / hiz_size * depth_size - 0.5), hiz is never larger than depth
+    uint2 size = uint2(depth_size);
+    uint2 base = ((2 * coord + 1) * size - uint2(hiz_size)) / (2 * uint2(hiz_size));
+    uint2 next = min(base + 1, size - 1);
 
-    float2 uv = (coord.xy + float2(0.5, 0.5)) / float2(texture_size);
-    float4 gather = depth_texture.Gather(point_clamp_sampler, uv);
+    float4 depth = float4(depth_texture.Load(int3(base.x, base.y, 0)).r,
+                          depth_texture.Load(int3(next.x, base.y, 0)).r,
+                          depth_texture.Load(int3(base.x, next.y, 0)).r,
+                          depth_texture.Load(int3(next.x, next.y, 0)).r);
     if (convert_reverse_z)
-        gather = 1.0 - gather;
-    float result = max(gather.x, max(gather.y, max(gather.z, gather.w)));
+        depth = 1.0f - depth;
+    return max(max(depth.x, depth.y), max(depth.z, depth.w));
+}
+
+float loadBase(uint layer, uint base_mip, uint2 coord)
+{
+    if (any(coord >= getMipSize(base_mip)))
+        return 0.0f;
+    if (base_mip == 0)
+        return computeMip0(layer, coord);
+    return asfloat(atomics.Load(getTailOffset(layer, coord)));
+}
+
+void storeMip(uint layer, uint mip, uint2 coord, float value)
+{
+    if (mip >= mip_levels || any(coord >= getMipSize(mip)))
+        return;
+    RWTexture2D<float> output_texture = ResourceDescriptorHeap[getTextureId(layer, 1 + mip)];
+    output_texture[coord] = value;
+}
+
+// Reduces a 64x64 tile of base_mip to 6 next mips, returns the value of base_mip + 6
+float downsampleTile(uint layer, uint base_mip, uint2 tile, uint2 thread)
+{
+    // Every thread reduces 4x4 texels to one texel of base_mip + 2 in registers
+    float mip2_value = 0.0f;
+    for (uint j = 0; j < 2; j++)
+    {
+        for (uint i = 0; i < 2; i++)
+        {
+            uint2 mip1_coord = tile * 32 + thread * 2 + uint2(i, j);
+            float mip1_value = 0.0f;
+            for (uint b = 0; b < 2; b++)
+            {
+                for (uint a = 0; a < 2; a++)
+                {
+                    uint2 coord = mip1_coord * 2 + uint2(a, b);
+                    float value = loadBase(layer, base_mip, coord);
+                    if (base_mip == 0)
+                        storeMip(layer, 0, coord, value);
+                    mip1_value = max(mip1_value, value);
+                }
+            }
+            storeMip(layer, base_mip + 1, mip1_coord, mip1_value);
+            mip2_value = max(mip2_value, mip1_value);
+        }
+    }
+    storeMip(layer, base_mip + 2, tile * 16 + thread, mip2_value);
+
+    // The rest goes through shared memory, a quarter of threads stays active every mip
+    uint index = thread.y * 16 + thread.x;
+    shared_values[index] = mip2_value;
+    GroupMemoryBarrierWithGroupSync();
+
+    float value = mip2_value;
+    uint size = 8;
+    for (uint level = 3; level <= 6; level++)
+    {
+        bool is_active = all(thread < size);
+        if (is_active)
+        {
+            uint source = thread.y * 2 * 16 + thread.x * 2;
+            value = max(max(shared_values[source], shared_values[source + 1]),
+                        max(shared_values[source + 16], shared_values[source + 17]));
+            storeMip(layer, base_mip + level, tile * size + thread, value);
+        }
+        GroupMemoryBarrierWithGroupSync();
+        if (is_active)
+            shared_values[index] = value;
+        GroupMemoryBarrierWithGroupSync();
+        size /= 2;
+    }
+    return shared_values[0];
+}
+
+[numthreads(16, 16, 1)]
+void CSMain(uint3 group_id : SV_GroupID, uint3 group_thread_id : SV_GroupThreadID, uint group_index : SV_GroupIndex)
+{
+    uint layer = group_id.z;
+    float tile_value = downsampleTile(layer, 0, group_id.xy, group_thread_id.xy);
+    if (mip_levels <= 7)
+        return;
+
+    if (group_index == 0)
+    {
+        atomics.Store(getTailOffset(layer, group_id.xy), asuint(tile_value));
+        DeviceMemoryBarrier();
+
+        uint2 tiles = (uint2(hiz_size) + TILE_SIZE - 1) / TILE_SIZE;
+        uint finished;
+        atomics.InterlockedAdd(layer * 4, 1, finished);
+        shared_is_last = finished == tiles.x * tiles.y - 1 ? 1 : 0;
+    }
+    GroupMemoryBarrierWithGroupSync();
+    if (shared_is_last == 0)
+        return;
 
-    output_texture[coord.xy] = result;
-}
\ No newline at end of file
+    // Counter is ready for the next dispatch
+    if (group_index == 0)
+        atomics.Store(layer * 4, 0);
+    DeviceMemoryBarrier();
+    downsampleTile(layer, 6, uint2(0, 0), group_thread_id.xy);
+}
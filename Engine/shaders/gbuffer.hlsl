@@ -13,7 +13,7 @@
 struct VertexInput
 {
 	uint instance_id : INSTANCE_ID;
-	uint local_vertex_id : SV_VertexID;
+	uint corner_id : SV_VertexID;
 };
 
 struct PixelInput
@@ -89,29 +89,20 @@ void MSMainMeshlet(uint group_index : SV_GroupIndex, uint group_id : SV_GroupID,
 		verts[i] = vert;
 	}
 
-	uint triangle_data_offset = draw.geometry_base + draw.meshlet.triangle_offset;
-
 	for (uint j = group_index; j < triangle_count; j += 32)
-	{
-		uint triangle_offset = j * 3;
-		uint3 tri;
-		tri.x = meshlets_geometry_buffer.Load<uint>(triangle_data_offset + sizeof(uint) * (triangle_offset + 0));
-		tri.y = meshlets_geometry_buffer.Load<uint>(triangle_data_offset + sizeof(uint) * (triangle_offset + 1));
-		tri.z = meshlets_geometry_buffer.Load<uint>(triangle_data_offset + sizeof(uint) * (triangle_offset + 2));
-
-		indices[j] = tri;
-	}
+		indices[j] = loadMeshletTriangle(j, draw);
 }
 
 PixelInput VSMainMeshlet(VertexInput IN)
 {
 	MeshletDraw draw = fetchMeshletDraw(IN.instance_id);
 
-	RawVertexData raw_vertex = loadMeshletVertex(IN.local_vertex_id, draw);
+	uint local_vertex_id = loadMeshletCornerVertex(IN.corner_id, draw);
+	RawVertexData raw_vertex = loadMeshletVertex(local_vertex_id, draw);
 	PixelInput output = transformVertex(raw_vertex, draw.instance, draw.mesh.attribute_flags);
 
 	#if VISUALIZE_TRIANGLES
-		output.meshlet_id = IN.local_vertex_id;
+		output.meshlet_id = local_vertex_id;
 	#elif VISUALIZE_MESHLETS
 		output.meshlet_id = draw.candidate.meshlet_id;
 	#elif VISUALIZE_MESHLETS_GROUPS
@@ -153,6 +144,15 @@ PixelOutput PSMain(PixelInput IN)
 	PixelOutput output;
 	Material material = getMaterial(IN.material_id);
 
+	float2 uv_dx = ddx(IN.uv);
+	float2 uv_dy = ddy(IN.uv);
+	uint2 pixel = uint2(IN.position.xy);
+	WriteTextureFeedback(material.albedo_tex_id, uv_dx, uv_dy, pixel);
+	WriteTextureFeedback(material.normal_tex_id, uv_dx, uv_dy, pixel);
+	WriteTextureFeedback(material.metalness_tex_id, uv_dx, uv_dy, pixel);
+	WriteTextureFeedback(material.roughness_tex_id, uv_dx, uv_dy, pixel);
+	WriteTextureFeedback(material.specular_tex_id, uv_dx, uv_dy, pixel);
+
 	output.color = (material.albedo_tex_id > 0)
 		? SampleTexture(material.albedo_tex_id, IN.uv)
 		: material.albedo;
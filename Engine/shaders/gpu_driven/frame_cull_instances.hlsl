@@ -15,13 +15,14 @@ struct FrustumData
 	float4x4 view_projection;
 	uint pass_mask;
 	bool is_ortho;
-	uint pad[2];
+	uint dynamic_pass_mask;
+	uint pad;
 };
 
 static StructuredBuffer<FrustumData> frustums_buffer = ResourceDescriptorHeap[frustums_buffer_id];
 static RWByteAddressBuffer pass_mask_buffer = ResourceDescriptorHeap[instances_pass_mask_buffer_id];
 
-uint Cull(float3 bound_center, float3 bound_extent)
+uint Cull(float3 bound_center, float3 bound_extent, bool is_dynamic)
 {
 	uint pass_mask = 0;
 	for (int i = 0; i < frustums_count; i++)
@@ -35,7 +36,7 @@ uint Cull(float3 bound_center, float3 bound_extent)
 			cull_data = getFrustumCullData(bound_center, bound_extent, frustum.view_projection);
 
 		if (cull_data.is_visible)
-			pass_mask |= frustum.pass_mask;
+			pass_mask |= is_dynamic ? frustum.dynamic_pass_mask : frustum.pass_mask;
 	}
 	return pass_mask;
 }
@@ -61,6 +62,6 @@ void CS_CullInstances(uint3 dispatchID : SV_DispatchThreadID)
 	float3 bound_extent = instance.bound_extent.xyz;
 	transformBoundBox(bound_center, bound_extent, instance.world_transform);
 
-	uint pass_mask = Cull(bound_center, bound_extent);
+	uint pass_mask = Cull(bound_center, bound_extent, (instance.flags & INSTANCE_FLAG_DYNAMIC) != 0);
 	pass_mask_buffer.Store(id * sizeof(uint), pass_mask);
 }
\ No newline at end of file
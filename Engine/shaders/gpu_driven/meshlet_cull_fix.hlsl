@@ -6,8 +6,8 @@ cbuffer Uniforms : register(b0)
 
 	uint visible_meshlets_buffer_id;
 	uint visible_meshlets_count_buffer_id;
-	uint draw_indexed_args_buffer_id;
-	uint draw_indexed_count_buffer_id;
+	uint draw_args_buffer_id;
+	uint draw_count_buffer_id;
 	uint draw_calls_indirect_instances_buffer_id;
 
 	uint occluded_meshlets_buffer_id;
@@ -27,8 +27,8 @@ static RWStructuredBuffer<MeshletCandidate> occluded_meshlets = ResourceDescript
 static RWByteAddressBuffer occluded_meshlets_count = ResourceDescriptorHeap[occluded_meshlets_count_buffer_id];
 
 #if !USE_MESH_SHADERS
-	static RWStructuredBuffer<DrawIndexedIndirect> draw_args = ResourceDescriptorHeap[draw_indexed_args_buffer_id];
-	static RWByteAddressBuffer draw_count = ResourceDescriptorHeap[draw_indexed_count_buffer_id];
+	static RWStructuredBuffer<DrawIndirect> draw_args = ResourceDescriptorHeap[draw_args_buffer_id];
+	static RWByteAddressBuffer draw_count = ResourceDescriptorHeap[draw_count_buffer_id];
 	static RWByteAddressBuffer indirect_instances = ResourceDescriptorHeap[draw_calls_indirect_instances_buffer_id];
 #endif
 
@@ -44,9 +44,6 @@ void CSMain(uint3 dispatch_id : SV_DispatchThreadID)
 
 	MeshletCandidate candidate = occluded_meshlets[id];
 	Instance instance = getInstance(candidate.instance_id);
-	Mesh mesh = getMesh(instance.mesh_id);
-	uint residency_base = mesh.group_residency_offset;
-
 	Meshlet meshlet = getMeshlet(candidate.meshlet_id, group_residency_buffer_id);
 
 	HizParams hiz = { hiz_tex_id, hiz_width, hiz_height, hiz_mips };
@@ -56,6 +53,6 @@ void CSMain(uint3 dispatch_id : SV_DispatchThreadID)
 
 	uint slot = appendVisibleMeshlet(candidate, visible_meshlets, visible_meshlets_count);
 	#if !USE_MESH_SHADERS
-		writeIndirectDraw(slot, meshlet, residency_base, group_residency, draw_args, draw_count, indirect_instances);
+		writeIndirectDraw(slot, meshlet, draw_args, draw_count, indirect_instances);
 	#endif
 }
@@ -8,17 +8,21 @@ cbuffer Uniforms : register(b0)
 	uint group_residency_buffer_id;
 	uint stream_requests_buffer_id;
 	uint group_ages_buffer_id;
+	uint report_offset;
+	uint group_errors_buffer_id;
 };
 
 [numthreads(64, 1, 1)]
 void CSMain(uint3 dispatchID : SV_DispatchThreadID)
 {
-	uint flat_index = dispatchID.x;
-	if (flat_index >= group_count) return;
+	if (dispatchID.x >= group_count) return;
+	// Only MAX_UNLOAD_REQUESTS stale groups fit the report, CPU rotates where the scan starts so all of them get reported over frames
+	uint flat_index = (dispatchID.x + report_offset) % group_count;
 
 	RWByteAddressBuffer group_residency = ResourceDescriptorHeap[group_residency_buffer_id];
 	RWByteAddressBuffer group_ages = ResourceDescriptorHeap[group_ages_buffer_id];
 	RWByteAddressBuffer stream_requests = ResourceDescriptorHeap[stream_requests_buffer_id];
+	RWByteAddressBuffer group_errors = ResourceDescriptorHeap[group_errors_buffer_id];
 
 	GroupResidency residency = group_residency.Load<GroupResidency>(flat_index * sizeof(GroupResidency));
 	if (residency.geometry_buffer_offset >= GROUP_NON_RESIDENT_ADDRESS_START)
@@ -27,14 +31,26 @@ void CSMain(uint3 dispatchID : SV_DispatchThreadID)
 	uint age = group_ages.Load(flat_index * 4);
 	if (age == PINNED_GROUP_AGE) return; // never evict coarsest LOD
 
+	// Used this frame: its error of this frame becomes the last used one, traversal takes the max again next frame
+	if (age == 0)
+	{
+		group_errors.Store(flat_index * 8 + 4, group_errors.Load(flat_index * 8));
+		group_errors.Store(flat_index * 8, 0);
+	}
+
 	age++;
 	group_ages.Store(flat_index * 4, age);
 
-	if (age > age_threshold)
+	// Stale groups are eviction candidates, CPU evicts them only when over the memory budget
+	if (age >= age_threshold)
 	{
 		uint slot;
 		stream_requests.InterlockedAdd(4, 1, slot);
 		if (slot < MAX_UNLOAD_REQUESTS)
+		{
 			stream_requests.Store(8 + MAX_STREAMING_REQUESTS * 4 + slot * 4, flat_index);
+			stream_requests.Store(8 + MAX_STREAMING_REQUESTS * 4 + MAX_UNLOAD_REQUESTS * 4 + slot * 4, age);
+			stream_requests.Store(8 + MAX_STREAMING_REQUESTS * 4 + MAX_UNLOAD_REQUESTS * 8 + slot * 4, group_errors.Load(flat_index * 8 + 4));
+		}
 	}
 }
@@ -10,8 +10,8 @@ cbuffer Uniforms : register(b0)
 
 	uint visible_meshlets_buffer_id;
 	uint visible_meshlets_count_buffer_id;
-	uint draw_indexed_args_buffer_id;
-	uint draw_indexed_count_buffer_id;
+	uint draw_args_buffer_id;
+	uint draw_count_buffer_id;
 	uint draw_calls_indirect_instances_buffer_id;
 	uint max_queue_size;
 
@@ -26,6 +26,7 @@ cbuffer Uniforms : register(b0)
 	uint group_residency_buffer_id;
 	uint stream_requests_buffer_id;
 	uint group_ages_buffer_id;
+	uint group_errors_buffer_id;
 };
 
 DECLARE_COHERENT_RW_STRUCTURED_BUFFER(queue, TraversalItem, queue_buffer_id)
@@ -36,14 +37,15 @@ static RWStructuredBuffer<MeshletCandidate> occluded_meshlets = ResourceDescript
 static RWByteAddressBuffer occluded_meshlets_count = ResourceDescriptorHeap[occluded_meshlets_count_buffer_id];
 
 #if !USE_MESH_SHADERS
-	static RWStructuredBuffer<DrawIndexedIndirect> draw_args = ResourceDescriptorHeap[draw_indexed_args_buffer_id];
-	static RWByteAddressBuffer draw_count = ResourceDescriptorHeap[draw_indexed_count_buffer_id];
+	static RWStructuredBuffer<DrawIndirect> draw_args = ResourceDescriptorHeap[draw_args_buffer_id];
+	static RWByteAddressBuffer draw_count = ResourceDescriptorHeap[draw_count_buffer_id];
 	static RWByteAddressBuffer indirect_instances = ResourceDescriptorHeap[draw_calls_indirect_instances_buffer_id];
 #endif
 
 static RWByteAddressBuffer group_residency = ResourceDescriptorHeap[group_residency_buffer_id];
 static RWByteAddressBuffer stream_requests = ResourceDescriptorHeap[stream_requests_buffer_id];
 DECLARE_COHERENT_RW_BYTE_ADDRESS_BUFFER(group_ages, group_ages_buffer_id)
+static RWByteAddressBuffer group_errors = ResourceDescriptorHeap[group_errors_buffer_id];
 
 void resetAge(uint group_id, uint group_residency_offset)
 {
@@ -157,6 +159,13 @@ void processSubTask(TraversalItem item, uint sub_id, bool is_valid)
 
 		resetAge(group_id, residency_base);
 
+		// Screen error in pixels for the residency policy, once per group. Positive floats keep their order as uints
+		if (is_valid && sub_id == 0)
+		{
+			float screen_error = getLODGroupError(group_id, mesh.meshlet_lod_groups_offset, instance.world_transform, scale) / error_threshold;
+			group_errors.InterlockedMax((residency_base + group_id) * 8, asuint(screen_error));
+		}
+
 		HizParams hiz = { hiz_tex_id, hiz_width, hiz_height, hiz_mips };
 		FrustumCullData cull;
 		bool is_occluded = !cullMeshletVisibility(meshlet, instance.world_transform, frustum_view_projection, hiz, cull);
@@ -180,7 +189,7 @@ void processSubTask(TraversalItem item, uint sub_id, bool is_valid)
 		{
 			uint slot = appendVisibleMeshlet(candidate, visible_meshlets, visible_meshlets_count);
 			#if !USE_MESH_SHADERS
-				writeIndirectDraw(slot, meshlet, residency_base, group_residency, draw_args, draw_count, indirect_instances);
+				writeIndirectDraw(slot, meshlet, draw_args, draw_count, indirect_instances);
 			#endif
 		}
 		#if !IS_FIX
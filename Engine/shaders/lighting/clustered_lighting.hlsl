@@ -0,0 +1,72 @@
+#include "../bindless.h"
+#include "../shading.h"
+#include "point_light.h"
+
+// Must match LightClusters
+#define CLUSTER_GRID_X 16
+#define CLUSTER_GRID_Y 9
+#define CLUSTER_GRID_Z 24
+
+struct ClusterRange
+{
+	uint offset;
+	uint count;
+};
+
+cbuffer UBO : register(b0)
+{
+	uint albedo_tex_id;
+	uint normal_tex_id;
+	uint depth_tex_id;
+	uint shading_tex_id;
+	uint lights_buffer_id;
+	uint cluster_ranges_buffer_id;
+	uint light_indices_buffer_id;
+	float cluster_slice_scale;
+	float cluster_slice_bias;
+	float shadow_z_near;
+};
+
+struct VSInput
+{
+	float2 uv : TEXCOORD0;
+};
+
+struct PSOutput
+{
+	float3 outDiffuse : SV_Target0;
+	float3 outSpecular : SV_Target1;
+};
+
+PSOutput PSMain(VSInput input)
+{
+	PSOutput output;
+	output.outDiffuse = 0;
+	output.outSpecular = 0;
+
+	float2 uv = input.uv;
+	float depth = SampleTexture(depth_tex_id, uv, point_clamp_sampler).r;
+	if (depth == 0.0)
+		return output;
+
+	PointLightSurface surface = getPointLightSurface(SampleTexture(albedo_tex_id, uv).rgb, SampleTexture(shading_tex_id, uv),
+													 unpackGBufferNormal(SampleTexture(normal_tex_id, uv, point_clamp_sampler).rgb), GetWSPosition(uv, depth));
+
+	// Find cluster of the pixel
+	float view_depth = -mul(view, float4(surface.P, 1.0)).z;
+	uint slice = (uint)clamp(floor(log(view_depth) * cluster_slice_scale + cluster_slice_bias), 0, CLUSTER_GRID_Z - 1);
+	uint2 tile = min(uint2(uv * float2(CLUSTER_GRID_X, CLUSTER_GRID_Y)), uint2(CLUSTER_GRID_X - 1, CLUSTER_GRID_Y - 1));
+	uint cluster_index = (slice * CLUSTER_GRID_Y + tile.y) * CLUSTER_GRID_X + tile.x;
+
+	StructuredBuffer<PointLight> lights = ResourceDescriptorHeap[lights_buffer_id];
+	StructuredBuffer<ClusterRange> cluster_ranges = ResourceDescriptorHeap[cluster_ranges_buffer_id];
+	StructuredBuffer<uint> light_indices = ResourceDescriptorHeap[light_indices_buffer_id];
+
+	ClusterRange range = cluster_ranges[cluster_index];
+	for (uint i = 0; i < range.count; i++)
+	{
+		PointLight light = lights[light_indices[range.offset + i]];
+		addPointLight(light, surface, USE_SHADOWS == 1, shadow_z_near, output.outDiffuse, output.outSpecular);
+	}
+	return output;
+}
@@ -0,0 +1,109 @@
+// Point light shading shared by clustered and tiled lighting. Must match PointLightGPU
+struct PointLight
+{
+	float4 position;
+	float4 intensity;
+	float attenuation_radius_sqr;
+	float shadow_z_far;
+	uint shadow_map_tex_id;
+	uint pad;
+};
+
+static const float3 sampling_offsets[20] = {
+	float3(1, 1, 1), float3(1, -1, 1), float3(-1, -1, 1), float3(-1, 1, 1),
+	float3(1, 1, -1), float3(1, -1, -1), float3(-1, -1, -1), float3(-1, 1, -1),
+	float3(1, 1, 0), float3(1, -1, 0), float3(-1, -1, 0), float3(-1, 1, 0),
+	float3(1, 0, 1), float3(-1, 0, 1), float3(1, 0, -1), float3(-1, 0, -1),
+	float3(0, 1, 1), float3(0, -1, 1), float3(0, -1, -1), float3(0, 1, -1)
+};
+
+float get_shadow_point(PointLight light, float3 frag_pos, float bias, float shadow_z_near)
+{
+	TextureCube shadow_map = ResourceDescriptorHeap[light.shadow_map_tex_id];
+	float3 frag_to_light = frag_pos - light.position.xyz;
+
+	// Max of sampling coordinates for cubemap is the cube face axis, so the value itself is the view depth
+	float view_depth = max(abs(frag_to_light.x), max(abs(frag_to_light.y), abs(frag_to_light.z)));
+	float current_depth = (light.shadow_z_far / (light.shadow_z_far - shadow_z_near)) * (1.0 - shadow_z_near / view_depth);
+
+	float shadow = 0.0;
+	int samples = 20;
+	float sampling_radius = 0.003;
+	for (int i = 0; i < samples; i++)
+	{
+		float closest_depth = shadow_map.SampleLevel(point_wrap_sampler, frag_to_light + sampling_offsets[i] * sampling_radius, 0).r;
+		shadow += current_depth - bias < closest_depth ? 1.0 : 0.0;
+	}
+	return saturate(shadow / float(samples));
+}
+
+float get_attenuation(PointLight light, float3 pos)
+{
+	float3 delta = light.position.xyz - pos;
+	float sqr_distance = dot(delta, delta);
+	float factor = sqr_distance / light.attenuation_radius_sqr;
+	float smooth_factor = saturate(1.0 - factor * factor);
+	return smooth_factor * smooth_factor / max(sqr_distance, 0.0001);
+}
+
+// GBuffer values of a pixel that point light shading needs
+struct PointLightSurface
+{
+	float3 P;
+	float3 N;
+	float3 V;
+	float NdotV;
+	float3 diffuse_color;
+	float3 F0;
+	float F90;
+	float perceptual_roughness;
+	float alpha;
+};
+
+PointLightSurface getPointLightSurface(float3 albedo, float4 shading, float3 N, float3 P)
+{
+	PointLightSurface surface;
+	float metalness = shading.r;
+	surface.perceptual_roughness = max(saturate(shading.g), MIN_PERCEPTUAL_ROUGHNESS);
+	surface.alpha = surface.perceptual_roughness * surface.perceptual_roughness;
+	float specular = shading.b;
+
+	surface.diffuse_color = albedo * (1.0f - metalness);
+	surface.F0 = computeF0(albedo, metalness, specular);
+	surface.F90 = 1.0f;
+
+	surface.P = P;
+	surface.N = N;
+	surface.V = normalize(camera_position.xyz - P);
+	surface.NdotV = saturate(abs(dot(N, surface.V)));
+	return surface;
+}
+
+void addPointLight(PointLight light, PointLightSurface surface, bool use_shadows, float shadow_z_near, inout float3 diffuse_light, inout float3 specular_light)
+{
+	float3 L = normalize(light.position.xyz - surface.P);
+	float NdotL = saturate(dot(surface.N, L));
+	float light_attenuation = get_attenuation(light, surface.P);
+	if (NdotL <= 0.0 || light_attenuation <= 0.0)
+		return;
+
+	float shadow = 1.0f;
+	if (use_shadows)
+		shadow = get_shadow_point(light, surface.P, 0.002, shadow_z_near);
+
+	float3 H = normalize(surface.V + L);
+	float NdotH = saturate(dot(surface.N, H));
+	float LdotH = saturate(dot(L, H));
+
+	float F_diffuse = Fr_DisneyDiffuse(surface.NdotV, NdotL, LdotH, surface.perceptual_roughness);
+	float3 diffuse = surface.diffuse_color * F_diffuse / PI;
+
+	float3 F = FresnelSchlick(surface.F0, surface.F90, LdotH);
+	float D = D_GGX(NdotH, surface.alpha * surface.alpha);
+	float Viz = V_SmithGGXCorrelated(surface.NdotV, NdotL, surface.alpha);
+	float3 F_specular = D * F * Viz;
+
+	float3 radiance = shadow * NdotL * light_attenuation * light.intensity.rgb;
+	diffuse_light += diffuse * radiance;
+	specular_light += F_specular * radiance;
+}
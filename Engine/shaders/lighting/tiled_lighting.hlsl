@@ -0,0 +1,165 @@
+#include "../bindless.h"
+#include "../shading.h"
+#include "point_light.h"
+
+// Must match LightTiles, TILE_SIZE and MAX_LIGHTS_PER_TILE are defined by the renderer
+#define TILE_STRIDE (MAX_LIGHTS_PER_TILE + 1)
+#define GROUP_SIZE (TILE_SIZE * TILE_SIZE)
+#define GROUP_MASK_WORDS ((GROUP_SIZE + 31) / 32)
+
+cbuffer UBO : register(b0)
+{
+	float4 tile_slopes;
+	float4 tile_depth;
+	float2 resolution;
+	uint tiles_count_x;
+	uint lights_count;
+	uint light_spheres_buffer_id;
+	uint lights_buffer_id;
+	uint tile_lights_buffer_id;
+	uint tile_lights_offset; // In uints
+	uint depth_tex_id;
+	uint albedo_tex_id;
+	uint normal_tex_id;
+	uint shading_tex_id;
+	uint diffuse_tex_id;
+	uint specular_tex_id;
+	float shadow_z_near;
+};
+
+groupshared uint tile_min_depth;
+groupshared uint tile_max_depth;
+groupshared uint tile_lights[MAX_LIGHTS_PER_TILE];
+groupshared uint chunk_mask[GROUP_MASK_WORDS];
+
+float getLinearDepth(float hardware_depth)
+{
+	return -(hardware_depth * tile_depth.x + tile_depth.y) / (hardware_depth * tile_depth.z + tile_depth.w);
+}
+
+// Same operations in the same order as LightTiles::isSphereInTile
+bool isSphereInTile(uint2 tile, float near_depth, float far_depth, float4 sphere)
+{
+	float x0 = float(tile.x * TILE_SIZE);
+	float x1 = min(float((tile.x + 1) * TILE_SIZE), resolution.x);
+	float y0 = float(tile.y * TILE_SIZE);
+	float y1 = min(float((tile.y + 1) * TILE_SIZE), resolution.y);
+
+	float left = (x0 / resolution.x * 2.0f - 1.0f) * tile_slopes.x + tile_slopes.y;
+	float right = (x1 / resolution.x * 2.0f - 1.0f) * tile_slopes.x + tile_slopes.y;
+	float top = (1.0f - y0 / resolution.y * 2.0f) * tile_slopes.z + tile_slopes.w;
+	float bottom = (1.0f - y1 / resolution.y * 2.0f) * tile_slopes.z + tile_slopes.w;
+
+	float3 center = sphere.xyz;
+	float radius = sphere.w;
+
+	if (center.x - left * center.z < -radius * sqrt(1.0f + left * left))
+		return false;
+	if (right * center.z - center.x < -radius * sqrt(1.0f + right * right))
+		return false;
+	if (center.y - bottom * center.z < -radius * sqrt(1.0f + bottom * bottom))
+		return false;
+	if (top * center.z - center.y < -radius * sqrt(1.0f + top * top))
+		return false;
+
+	float3 box_min = float3(min(left * near_depth, left * far_depth), min(bottom * near_depth, bottom * far_depth), near_depth);
+	float3 box_max = float3(max(right * near_depth, right * far_depth), max(top * near_depth, top * far_depth), far_depth);
+	float3 delta = max(max(box_min - center, center - box_max), 0.0f);
+	return dot(delta, delta) <= radius * radius;
+}
+
+[numthreads(TILE_SIZE, TILE_SIZE, 1)]
+void CSMain(uint3 dispatch_id : SV_DispatchThreadID, uint3 group_id : SV_GroupID, uint group_index : SV_GroupIndex)
+{
+	if (group_index == 0)
+	{
+		tile_min_depth = 0xFFFFFFFF;
+		tile_max_depth = 0;
+	}
+	GroupMemoryBarrierWithGroupSync();
+
+	// Depth range of the tile without sky, positive floats keep their order as uints
+	uint2 pixel = dispatch_id.xy;
+	bool is_inside = pixel.x < (uint)resolution.x && pixel.y < (uint)resolution.y;
+	Texture2D depth_texture = ResourceDescriptorHeap[depth_tex_id];
+	float depth = is_inside ? depth_texture.Load(int3(pixel, 0)).r : 0.0f;
+	if (depth > 0.0f)
+	{
+		InterlockedMin(tile_min_depth, asuint(depth));
+		InterlockedMax(tile_max_depth, asuint(depth));
+	}
+	GroupMemoryBarrierWithGroupSync();
+
+	// Reverse-z: the largest depth is the nearest. Sky tiles test no lights, the bound is the same for the whole group
+	bool has_depth = tile_max_depth != 0;
+	float near_depth = getLinearDepth(asfloat(tile_max_depth));
+	float far_depth = getLinearDepth(asfloat(tile_min_depth));
+	uint tested_lights = has_depth ? lights_count : 0;
+
+	// Every thread tests one light of a chunk and gets its slot from the mask of the lights before it,
+	// so the list keeps the lowest light indices in order, like LightTiles::binReference, when the tile has too many
+	StructuredBuffer<float4> light_spheres = ResourceDescriptorHeap[light_spheres_buffer_id];
+	uint tile_lights_count = 0;
+	for (uint chunk = 0; chunk < tested_lights; chunk += GROUP_SIZE)
+	{
+		if (group_index < GROUP_MASK_WORDS)
+			chunk_mask[group_index] = 0;
+		GroupMemoryBarrierWithGroupSync();
+
+		uint light = chunk + group_index;
+		bool is_in_tile = light < tested_lights && isSphereInTile(group_id.xy, near_depth, far_depth, light_spheres[light]);
+		uint word = group_index / 32;
+		uint bit = 1u << (group_index % 32);
+		if (is_in_tile)
+			InterlockedOr(chunk_mask[word], bit);
+		GroupMemoryBarrierWithGroupSync();
+
+		uint slot = tile_lights_count + countbits(chunk_mask[word] & (bit - 1));
+		for (uint i = 0; i < GROUP_MASK_WORDS; i++)
+		{
+			uint bits = countbits(chunk_mask[i]);
+			slot += i < word ? bits : 0;
+			tile_lights_count += bits;
+		}
+		if (is_in_tile && slot < MAX_LIGHTS_PER_TILE)
+			tile_lights[slot] = light;
+		GroupMemoryBarrierWithGroupSync();
+	}
+
+	uint count = min(tile_lights_count, MAX_LIGHTS_PER_TILE);
+
+	// Light lists are kept for debugging and validation
+	RWByteAddressBuffer tile_lights_buffer = ResourceDescriptorHeap[tile_lights_buffer_id];
+	uint tile_offset = tile_lights_offset + (group_id.y * tiles_count_x + group_id.x) * TILE_STRIDE;
+	if (group_index == 0)
+		tile_lights_buffer.Store(tile_offset * 4, tile_lights_count);
+	for (uint i = group_index; i < count; i += GROUP_SIZE)
+		tile_lights_buffer.Store((tile_offset + 1 + i) * 4, tile_lights[i]);
+
+#if BIN_ONLY == 0
+	if (!is_inside)
+		return;
+
+	float3 diffuse_light = 0;
+	float3 specular_light = 0;
+	if (depth != 0.0)
+	{
+		Texture2D albedo_texture = ResourceDescriptorHeap[albedo_tex_id];
+		Texture2D normal_texture = ResourceDescriptorHeap[normal_tex_id];
+		Texture2D shading_texture = ResourceDescriptorHeap[shading_tex_id];
+
+		float2 uv = (float2(pixel) + 0.5) / resolution;
+		PointLightSurface surface = getPointLightSurface(albedo_texture.Load(int3(pixel, 0)).rgb, shading_texture.Load(int3(pixel, 0)),
+														 unpackGBufferNormal(normal_texture.Load(int3(pixel, 0)).rgb), GetWSPosition(uv, depth));
+
+		StructuredBuffer<PointLight> lights = ResourceDescriptorHeap[lights_buffer_id];
+		for (uint i = 0; i < count; i++)
+			addPointLight(lights[tile_lights[i]], surface, USE_SHADOWS == 1, shadow_z_near, diffuse_light, specular_light);
+	}
+
+	RWTexture2D<float4> diffuse_texture = ResourceDescriptorHeap[diffuse_tex_id];
+	RWTexture2D<float4> specular_texture = ResourceDescriptorHeap[specular_tex_id];
+	diffuse_texture[pixel] = float4(diffuse_light, 0.0);
+	specular_texture[pixel] = float4(specular_light, 0.0);
+#endif
+}
@@ -72,3 +72,21 @@ RawVertexData loadMeshletVertex(uint local_vertex_id, MeshletDraw draw)
 
 	return vertex;
 }
+
+// Triangles are packed uint8 local indices, 3 bytes per triangle (see GeometryStreaming fill_group_data).
+// Group data is padded with a guard word, so one aligned Load2 always covers the triangle.
+uint3 loadMeshletTriangle(uint triangle_index, MeshletDraw draw)
+{
+	uint byte_offset = draw.geometry_base + draw.meshlet.triangle_offset + triangle_index * 3;
+	uint aligned_offset = byte_offset & ~3u;
+	uint shift = (byte_offset - aligned_offset) * 8;
+	uint2 words = meshlets_geometry_buffer.Load2(aligned_offset);
+	uint packed = shift == 0 ? words.x : (words.x >> shift) | (words.y << (32 - shift));
+	return uint3(packed & 0xFF, (packed >> 8) & 0xFF, (packed >> 16) & 0xFF);
+}
+
+// Meshlets are drawn non-indexed (uint8 indices can't be bound as an index buffer), vertex id walks the triangle corners
+uint loadMeshletCornerVertex(uint corner_id, MeshletDraw draw)
+{
+	return loadMeshletTriangle(corner_id / 3, draw)[corner_id % 3];
+}
@@ -0,0 +1,23 @@
+#include "common.h"
+
+// Copies the first channel of a texture to a buffer as raw floats, row by row
+cbuffer Uniforms : register(b0)
+{
+    uint texture_id;
+    uint output_buffer_id;
+    uint output_offset; // In floats
+    uint width;
+    uint height;
+};
+
+[numthreads(8, 8, 1)]
+void CSMain(uint3 dispatch_id : SV_DispatchThreadID)
+{
+    if (dispatch_id.x >= width || dispatch_id.y >= height)
+        return;
+
+    Texture2D input_texture = ResourceDescriptorHeap[texture_id];
+    RWByteAddressBuffer output_buffer = ResourceDescriptorHeap[output_buffer_id];
+    float value = input_texture.Load(int3(dispatch_id.xy, 0)).r;
+    output_buffer.Store((output_offset + dispatch_id.y * width + dispatch_id.x) * 4, asuint(value));
+}
@@ -5,15 +5,22 @@
 #include "Rendering/Renderer.h"
 #include "Rendering/GlobalBufferCache.h"
 #include "Rendering/UploadManager.h"
+#include "RHI/RHIUploadBatch.h"
 #include "Assets/AssetManager.h"
 #include "Scene/Scene.h"
+#include "Scene/Components.h"
 #include "Core/Platform.h"
 #include "FrameGraph/TransientResources.h"
 #include "Physics/PhysXWrapper.h"
+#include "Core/Benchmark.h"
+#include "Rendering/MeshletTraversal.h"
+#include "Renderers/HiZ.h"
+#include "Utils/Camera.h"
 
 #include "RHI/Vulkan/VulkanDynamicRHI.h"
 #include "RHI/DX12/DX12DynamicRHI.h"
 #include "RHI/DX12/DX12Utils.h"
+#include "RHI/Null/NullDynamicRHI.h"
 
 #include "Demos/CubesDemo.h"
 #include "Demos/TowerGame.h"
@@ -29,31 +36,8 @@ UploadManager *gUploadManager = nullptr;
 
 static TowerGame tower_game;
 
-Application::Application(int argc, char *argv[])
+static GraphicsAPI parse_command_line(int argc, char *argv[])
 {
-	// Create Window
-	glfwInit();
-	glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
-	window = glfwCreateWindow(1920, 1080, "RenderingEngine", nullptr, nullptr);
-	glfwSwapInterval(0);
-
-	glfwSetWindowUserPointer(window, this);
-	glfwSetFramebufferSizeCallback(window, [](GLFWwindow *window, int width, int height)
-	{
-		static_cast<Application *>(glfwGetWindowUserPointer(window))->framebuffer_resize_callback(window, width, height);
-	});
-
-	glfwSetKeyCallback(window, [](GLFWwindow *window, int key, int scancode, int action, int mods)
-	{
-		static_cast<Application *>(glfwGetWindowUserPointer(window))->key_callback(window, key, scancode, action, mods);
-	});
-
-	Platform::configureNativeWindow(window);
-
-	// Init subsystems
-	gInput.init(window);
-	Log::init();
-
 	GraphicsAPI gapi = GRAPHICS_API_NONE;
 
 	for (int i = 1; i < argc; i++)
@@ -96,8 +80,86 @@ Application::Application(int argc, char *argv[])
 		} else if (arg == "-reimport_assets")
 		{
 			engine_assets_reimport = true;
+		} else if (arg == "-benchmark" || arg == "-benchmark_cpu")
+		{
+			engine_benchmark = true;
+			engine_benchmark_cpu_only = arg == "-benchmark_cpu";
+			// Optional camera path, turntable without it
+			if (i + 1 < argc && argv[i + 1][0] != '-')
+			{
+				engine_benchmark_camera_path = argv[i + 1];
+				i++;
+			}
+		} else if (arg == "-benchmark_frames")
+		{
+			if (i + 1 < argc)
+			{
+				engine_benchmark_frames = std::stoi(argv[i + 1]);
+				i++;
+			}
+		} else if (arg == "-benchmark_warmup")
+		{
+			if (i + 1 < argc)
+			{
+				engine_benchmark_warmup_frames = std::stoi(argv[i + 1]);
+				i++;
+			}
+		} else if (arg == "-benchmark_timestep")
+		{
+			if (i + 1 < argc)
+			{
+				engine_benchmark_timestep = std::stof(argv[i + 1]);
+				i++;
+			}
+		} else if (arg == "-benchmark_output")
+		{
+			if (i + 1 < argc)
+			{
+				engine_benchmark_output = argv[i + 1];
+				i++;
+			}
 		}
 	}
+	return gapi;
+}
+
+Application::Application(int argc, char *argv[])
+{
+	Log::init();
+	GraphicsAPI gapi = parse_command_line(argc, argv);
+	Benchmark::init();
+
+	if (Benchmark::isCpuOnly())
+	{
+		// No window and device, only subsystems that can run on CPU
+		gDynamicRHI = new NullDynamicRHI();
+		gDynamicRHI->init();
+		AssetManager::init();
+		PhysXWrapper::init();
+		return;
+	}
+
+	// Create Window
+	glfwInit();
+	glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
+	window = glfwCreateWindow(1920, 1080, "RenderingEngine", nullptr, nullptr);
+	glfwSwapInterval(0);
+
+	glfwSetWindowUserPointer(window, this);
+	glfwSetFramebufferSizeCallback(window, [](GLFWwindow *window, int width, int height)
+	{
+		static_cast<Application *>(glfwGetWindowUserPointer(window))->framebuffer_resize_callback(window, width, height);
+	});
+
+	glfwSetKeyCallback(window, [](GLFWwindow *window, int key, int scancode, int action, int mods)
+	{
+		static_cast<Application *>(glfwGetWindowUserPointer(window))->key_callback(window, key, scancode, action, mods);
+	});
+
+	Platform::configureNativeWindow(window);
+
+	// Init subsystems
+	gInput.init(window);
 
 	if (gapi == GRAPHICS_API_VULKAN)
 		gDynamicRHI = new VulkanDynamicRHI();
@@ -133,6 +195,12 @@ static DEMO current_demo = DEMO_NONE;
 
 void Application::run()
 {
+	if (Benchmark::isCpuOnly())
+	{
+		run_cpu_only();
+		return;
+	}
+
 	double prev_time = glfwGetTime();
 	float delta_seconds = 0.0f;
 
@@ -142,8 +210,12 @@ void Application::run()
 	{
 		FrameMark;
 		glfwPollEvents();
+		Benchmark::beginFrame();
 
-		gDynamicRHI->beginFrame();
+		{
+			Benchmark::Scope benchmark_scope("Begin Frame");
+			gDynamicRHI->beginFrame();
+		}
 
 		if (is_first_frame)
 		{
@@ -165,6 +237,7 @@ void Application::run()
 			ImGuiWrapper::begin();
 			{
 				PROFILE_CPU_SCOPE("Application::update");
+				Benchmark::Scope benchmark_scope("Update");
 				update(delta_seconds);
 				updateBuffers(delta_seconds);
 			}
@@ -174,9 +247,15 @@ void Application::run()
 		}
 
 		// Record commands
-		render(gDynamicRHI->getCmdList());
+		{
+			Benchmark::Scope benchmark_scope("Record Commands");
+			render(gDynamicRHI->getCmdList());
+		}
 
-		gDynamicRHI->endFrame();
+		{
+			Benchmark::Scope benchmark_scope("End Frame");
+			gDynamicRHI->endFrame();
+		}
 
 		if (framebuffer_resized)
 		{
@@ -184,13 +263,95 @@ void Application::run()
 			recreate_swapchain();
 		}
 
-		delta_seconds = glfwGetTime() - prev_time;
+		delta_seconds = Benchmark::isActive() ? Benchmark::getTimestep() : glfwGetTime() - prev_time;
 		prev_time = glfwGetTime();
+
+		if (Benchmark::endFrame())
+			glfwSetWindowShouldClose(window, GLFW_TRUE);
 	}
 
 	cleanup();
 }
 
+void Application::run_cpu_only()
+{
+	eastl::string scene_path = "assets/scenes/" + engine_startup_scene.get() + ".scene";
+	if (!std::filesystem::exists(scene_path.c_str()))
+	{
+		CORE_ERROR("Benchmark scene {} doesn't exist", scene_path.c_str());
+		return;
+	}
+
+	Camera camera(glm::vec3(0, 2, 0));
+	camera.setAspect(16.0f / 9.0f);
+	Renderer::setCamera(&camera);
+	Ref<Scene> scene = Scene::loadScene(scene_path);
+
+	// Same LOD cut and frustum culling as the GPU traversal of a 1080p view, meshes are fully resident
+	eastl::vector<MeshletTraversal::Instance> instances;
+	MeshletTraversal::Result result;
+	bool is_finished = false;
+	while (!is_finished)
+	{
+		FrameMark;
+		Benchmark::beginFrame();
+		Benchmark::updateCamera(camera);
+
+		{
+			PROFILE_CPU_SCOPE("Gather Instances");
+			Benchmark::Scope benchmark_scope("Gather Instances");
+			instances.clear();
+			for (auto [entity, transform, mesh_renderer] : scene->getEntitiesWith<TransformComponent, MeshRendererComponent>().each())
+			{
+				for (MeshRendererComponent::MeshId &mesh_id : mesh_renderer.meshes)
+				{
+					Engine::Mesh *mesh = mesh_id.getMesh();
+					if (!mesh || !mesh->useMeshlets())
+						continue;
+
+					MeshletTraversal::Instance &instance = instances.emplace_back();
+					instance.geometry = &*mesh->meshlet_data;
+					instance.world_transform = transform.getWorldTransform();
+					instance.bound_box = mesh->bound_box;
+					instance.instance_id = instances.size() - 1;
+				}
+			}
+		}
+
+		{
+			PROFILE_CPU_SCOPE("Meshlet Traversal");
+			Benchmark::Scope benchmark_scope("Meshlet Traversal");
+			MeshletTraversal::View view;
+			view.view_projection = camera.getViewProj();
+			view.camera_position = camera.getPosition();
+			view.z_near = camera.getNear();
+			view.error_threshold = MeshletTraversal::View::computeErrorThreshold(glm::radians(camera.getFov()), 1080.0f);
+			MeshletTraversal::traverse(view, eastl::span<const MeshletTraversal::Instance>(instances.data(), instances.size()), result);
+		}
+
+		Benchmark::setCounter("Culling Instances", instances.size());
+		Benchmark::setCounter("Culling Culled Instances", result.culled_instances);
+		Benchmark::setCounter("Culling Visited Nodes", result.visited_nodes);
+		Benchmark::setCounter("Culling Visited Groups", result.visited_groups);
+		Benchmark::setCounter("Culling Selected Meshlets", result.meshlets.size());
+		Benchmark::setCounter("Streaming Group Requests", result.stream_requests.size());
+
+		is_finished = Benchmark::endFrame();
+	}
+
+	Renderer::setCamera(nullptr);
+	Scene::closeScene();
+	PhysXWrapper::shutdown();
+	GlobalBufferCache::shutdown();
+	AssetManager::shutdown();
+	RHIUploadBatch::shutdown();
+
+	gDynamicRHI->shutdown();
+	delete gDynamicRHI;
+	gDynamicRHI = nullptr;
+	Log::shutdown();
+}
+
 void Application::render(RHICommandList *cmd_list)
 {
 	PROFILE_CPU_FUNCTION();
@@ -231,6 +392,7 @@ void Application::cleanup()
 
 	gDynamicRHI->waitGPU();
 
+	HiZ::shutdown();
 	GlobalBufferCache::shutdown();
 	AssetManager::shutdown();
 	TransientResources::cleanup();
@@ -243,6 +405,8 @@ void Application::cleanup()
 	delete gUploadManager;
 	gUploadManager = nullptr;
 
+	RHIUploadBatch::shutdown();
+
 	delete gGlobalPipeline;
 	gGlobalPipeline = nullptr;
 
@@ -252,6 +416,7 @@ void Application::cleanup()
 	gDynamicRHI->shutdown();
 	delete gDynamicRHI;
 	gDynamicRHI = nullptr;
+	Log::shutdown();
 }
 
 void Application::recreate_swapchain()
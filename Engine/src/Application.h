@@ -23,6 +23,8 @@ protected:
 	virtual void cleanupResources() {}
 private:
 	void render(RHICommandList *cmd_list);
+	// Benchmark without window and device, see Benchmark
+	void run_cpu_only();
 
 	void cleanup();
 
@@ -32,7 +34,7 @@ private:
 	void framebuffer_resize_callback(GLFWwindow *window, int width, int height) { framebuffer_resized = true; }
 	virtual void key_callback(GLFWwindow *window, int key, int scancode, int action, int mods) {}
 protected:
-	GLFWwindow *window;
+	GLFWwindow *window = nullptr;
 private:
 	bool framebuffer_resized = false;
 };
@@ -46,6 +46,8 @@ struct AssetMetadata
 
 	template<typename T>
 	const T &getImportSettings() const { return *(const T *)importSettings.data(); }
+	template<typename T>
+	T &getImportSettings() { return *(T *)importSettings.data(); }
 };
 
 struct AssetTypeInfo
@@ -1,9 +1,12 @@
 #include "pch.h"
 #include "AssetManager.h"
+#include "AssetRegistry.h"
 #include "RHI/RHITexture.h"
 #include "Rendering/Model.h"
 #include "Core/Filesystem.h"
 #include "Core/Variables.h"
+#include <atomic>
+#include <thread>
 
 eastl::unordered_map<Engine::GUID, AssetMetadata> AssetManager::guid_to_metadata;
 eastl::unordered_map<Engine::GUID, Ref<Asset>> AssetManager::guid_to_asset;
@@ -11,6 +14,7 @@ eastl::unordered_map<eastl::string, Engine::GUID> AssetManager::path_to_guid;
 std::filesystem::path AssetManager::assets_root = "assets";
 entt::sigh<void(Asset *)> AssetManager::pre_reimport_signal;
 entt::sigh<void(Asset *)> AssetManager::post_reimport_signal;
+entt::sigh<void(Engine::GUID)> AssetManager::pre_runtime_recreate_signal;
 
 static AssetMetadata invalid_metadata;
 
@@ -20,9 +24,8 @@ static std::filesystem::path calc_meta_path(const std::filesystem::path &source_
 	return path.replace_extension(source_path.extension().string() + ".meta");
 }
 
-static bool read_metadata_file(const std::filesystem::path &meta_path, const std::filesystem::path &source_path, AssetMetadata &out)
+static bool parse_metadata(const YAML::Node &node, const std::filesystem::path &source_path, AssetMetadata &out)
 {
-	YAML::Node node = YAML::LoadFile(meta_path.string());
 	out.guid = node["guid"].as<uint64_t>(0);
 	out.runtimeGuid = node["runtime_guid"].as<uint64_t>(0);
 	out.runtimeVersion = node["runtime_version"].as<uint32_t>(0);
@@ -41,6 +44,116 @@ static bool read_metadata_file(const std::filesystem::path &meta_path, const std
 	return true;
 }
 
+static bool read_metadata_file(const std::filesystem::path &meta_path, const std::filesystem::path &source_path, AssetMetadata &out)
+{
+	return parse_metadata(YAML::LoadFile(meta_path.string()), source_path, out);
+}
+
+namespace
+{
+struct MetaFile
+{
+	std::filesystem::path path;
+	int64_t write_time = 0;
+	uint64_t size = 0;
+	bool has_source = false;
+};
+
+struct RefreshEntry
+{
+	enum class State
+	{
+		NoMeta,
+		Invalid,
+		FromRegistry,
+		Parsed
+	};
+
+	std::filesystem::path source_path;
+	eastl::string registry_key;
+	const MetaFile *meta = nullptr;
+
+	// Filled by refresh workers
+	eastl::string path_key;
+	State state = State::NoMeta;
+	AssetRegistry::Record record;
+};
+
+// Record of a .meta written on this run, so the next refresh takes it from the registry
+bool make_written_record(const AssetMetadata &metadata, AssetRegistry::Record &record)
+{
+	std::filesystem::path meta_path = calc_meta_path(metadata.sourcePath);
+	std::ifstream file(meta_path, std::ios::binary);
+	if (!file)
+		return false;
+	std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+	std::error_code error;
+	record.guid = metadata.guid;
+	record.runtimeGuid = metadata.runtimeGuid;
+	record.runtimeVersion = metadata.runtimeVersion;
+	record.typeName = metadata.type->name;
+	record.importSettings = metadata.importSettings;
+	record.metaWriteTime = std::filesystem::last_write_time(meta_path, error).time_since_epoch().count();
+	record.metaSize = content.size();
+	record.metaHash = AssetRegistry::calcHash(content.data(), content.size());
+	return !error;
+}
+
+// Valid registry record is reused as is, otherwise .meta is read and parsed
+void refresh_entry(RefreshEntry &entry, const AssetRegistry &registry)
+{
+	entry.path_key = Filesystem::canonicalPath(entry.source_path);
+	if (!entry.meta)
+		return;
+
+	const MetaFile &meta = *entry.meta;
+	const AssetRegistry::Record *cached = registry.find(entry.registry_key);
+	if (cached && cached->metaWriteTime == meta.write_time && cached->metaSize == meta.size)
+	{
+		entry.record = *cached;
+		entry.state = RefreshEntry::State::FromRegistry;
+		return;
+	}
+
+	entry.state = RefreshEntry::State::Invalid;
+	std::ifstream file(meta.path, std::ios::binary);
+	if (!file)
+		return;
+	std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+	// Touched but not changed (checkout, copy)
+	uint32_t hash = AssetRegistry::calcHash(content.data(), content.size());
+	if (cached && cached->metaSize == content.size() && cached->metaHash == hash)
+	{
+		entry.record = *cached;
+		entry.record.metaWriteTime = meta.write_time;
+		entry.state = RefreshEntry::State::Parsed;
+		return;
+	}
+
+	AssetMetadata metadata;
+	try
+	{
+		if (!parse_metadata(YAML::Load(content), entry.source_path, metadata))
+			return;
+	} catch (const YAML::Exception &)
+	{
+		return;
+	}
+
+	entry.record.guid = metadata.guid;
+	entry.record.runtimeGuid = metadata.runtimeGuid;
+	entry.record.runtimeVersion = metadata.runtimeVersion;
+	entry.record.typeName = metadata.type->name;
+	entry.record.importSettings = eastl::move(metadata.importSettings);
+	entry.record.metaWriteTime = meta.write_time;
+	entry.record.metaSize = content.size();
+	entry.record.metaHash = hash;
+	entry.state = RefreshEntry::State::Parsed;
+}
+}
+
 template<class T, class Loader>
 Ref<T> AssetManager::get_or_load(const std::filesystem::path &path, Loader &&loader)
 {
@@ -77,39 +190,154 @@ void AssetManager::init()
 
 void AssetManager::refresh()
 {
+	PROFILE_CPU_FUNCTION();
+
 	if (!std::filesystem::exists(assets_root))
 		return;
 
-	eastl::vector<std::filesystem::path> junk_metas;
+	auto start_time = std::chrono::steady_clock::now();
 
-	for (auto it = std::filesystem::recursive_directory_iterator(assets_root); it != std::filesystem::recursive_directory_iterator(); ++it)
+	std::filesystem::path registry_path = assets_root / ".runtimes" / "registry.bin";
+	AssetRegistry registry;
+	if (!engine_assets_reimport)
+		registry.load(registry_path);
+
+	// Listing is cheap (write time and size come with directory entries), parsing is not.
+	// Directories are always listed, their write time doesn't change when a .meta inside is edited
+	eastl::vector<RefreshEntry> entries;
+	eastl::hash_map<eastl::string, MetaFile> metas;
 	{
-		if (it->is_directory())
+		PROFILE_CPU_SCOPE("List Assets");
+		std::error_code error;
+		for (auto it = std::filesystem::recursive_directory_iterator(assets_root); it != std::filesystem::recursive_directory_iterator(); ++it)
 		{
-			if (it->path().filename() == ".runtimes")
-				it.disable_recursion_pending();
+			if (it->is_directory())
+			{
+				if (it->path().filename() == ".runtimes")
+					it.disable_recursion_pending();
+				continue;
+			}
+
+			if (it->path().extension() == ".meta")
+			{
+				std::filesystem::path source_path = it->path();
+				source_path.replace_extension();
+
+				MetaFile &meta = metas[source_path.generic_string().c_str()];
+				meta.path = it->path();
+				meta.write_time = it->last_write_time(error).time_since_epoch().count();
+				meta.size = it->file_size(error);
+				continue;
+			}
+
+			RefreshEntry &entry = entries.push_back();
+			entry.source_path = it->path();
+			entry.registry_key = entry.source_path.generic_string().c_str();
+		}
+	}
+
+	for (RefreshEntry &entry : entries)
+	{
+		auto it = metas.find(entry.registry_key);
+		if (it == metas.end())
+			continue;
+		it->second.has_source = true;
+		entry.meta = &it->second;
+	}
+
+	{
+		PROFILE_CPU_SCOPE("Read Metas");
+		std::atomic<size_t> next_entry = 0;
+		auto worker = [&]()
+		{
+			for (size_t i = next_entry++; i < entries.size(); i = next_entry++)
+				refresh_entry(entries[i], registry);
+		};
+
+		int threads_count;
+		if (engine_assets_refresh_threads > 0)
+			threads_count = engine_assets_refresh_threads;
+		else
+			threads_count = std::max(1u, std::thread::hardware_concurrency());
+		threads_count = eastl::min(threads_count, (int)entries.size());
+
+		eastl::vector<std::thread> threads(eastl::max(threads_count - 1, 0));
+		for (auto &t : threads)
+			t = std::thread(worker);
+		worker(); // main thread also executes
+
+		for (auto &t : threads)
+			t.join();
+	}
+
+	// Maps and new metas (generated guids, file writes) are done on the main thread
+	AssetRegistry new_registry;
+	uint32_t from_registry = 0, parsed = 0, created = 0;
+	for (RefreshEntry &entry : entries)
+	{
+		if (entry.state == RefreshEntry::State::Invalid)
+		{
+			CORE_WARN("Invalid asset metadata for {}", entry.source_path.string());
 			continue;
 		}
 
-		if (it->path().extension() == ".meta")
+		if (entry.state == RefreshEntry::State::NoMeta)
 		{
-			std::filesystem::path source_path = it->path();
-			source_path.replace_extension();
-			if (!std::filesystem::exists(source_path))
-				junk_metas.push_back(it->path());
+			if (path_to_guid.find(entry.path_key) == path_to_guid.end() && findTypeInfoByExtension(entry.source_path.extension().string().c_str()))
+			{
+				const AssetMetadata &metadata = getOrCreateMetadata(entry.source_path);
+				if (metadata.isValid() && make_written_record(metadata, entry.record))
+					new_registry.set(entry.registry_key, eastl::move(entry.record));
+				created++;
+			}
 			continue;
 		}
 
-		getOrCreateMetadata(it->path());
+		if (entry.state == RefreshEntry::State::FromRegistry)
+			from_registry++;
+		else
+			parsed++;
+
+		// Already known metadata can have unsaved changes, it is kept
+		if (path_to_guid.find(entry.path_key) == path_to_guid.end())
+		{
+			const AssetTypeInfo *type = findTypeInfoByName(entry.record.typeName.c_str());
+			if (!type)
+				continue;
+
+			AssetMetadata &stored = guid_to_metadata[entry.record.guid];
+			stored.guid = entry.record.guid;
+			stored.runtimeGuid = entry.record.runtimeGuid;
+			stored.runtimeVersion = entry.record.runtimeVersion;
+			stored.sourcePath = entry.source_path;
+			stored.type = type;
+			stored.importSettings = entry.record.importSettings;
+			path_to_guid[entry.path_key] = stored.guid;
+		}
+		new_registry.set(entry.registry_key, eastl::move(entry.record));
+	}
+
+	for (const auto &[source_path, meta] : metas)
+	{
+		if (!meta.has_source)
+			std::filesystem::remove(meta.path);
 	}
 
-	for (const std::filesystem::path &meta : junk_metas)
-		std::filesystem::remove(meta);
+	if (parsed > 0 || created > 0 || new_registry.size() != registry.size())
+		new_registry.save(registry_path);
+
+	if (parsed > 0 || created > 0)
+	{
+		double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_time).count();
+		CORE_INFO("Refreshed {} assets in {:.1f} ms: {} metas from registry, {} parsed, {} created", entries.size(), milliseconds, from_registry, parsed, created);
+	}
 }
 
 void AssetManager::shutdown()
 {
 	guid_to_asset.clear();
+	path_to_guid.clear();
+	guid_to_metadata.clear();
 }
 
 Ref<Asset> AssetManager::getAsset(const std::filesystem::path &path, const AssetTypeInfo *type)
@@ -164,6 +392,7 @@ void AssetManager::reimport(const std::filesystem::path &source_path)
 	auto it = guid_to_asset.find(metadata.guid);
 	if (it == guid_to_asset.end())
 	{
+		pre_runtime_recreate_signal.publish(metadata.guid);
 		recreateRuntime(source_path);
 		return;
 	}
@@ -40,6 +40,9 @@ public:
 	static void notifyChanged(Asset *asset) { post_reimport_signal.publish(asset); }
 	static entt::sink<entt::sigh<void (Asset *)>> onPreReimport() { return {pre_reimport_signal}; }
 	static entt::sink<entt::sigh<void (Asset *)>> onPostReimport() { return {post_reimport_signal}; }
+	// Reimport of an asset that is not loaded, only its runtime file is recreated.
+	// Published before the old runtime file is removed, so users can close their mappings of it
+	static entt::sink<entt::sigh<void (Engine::GUID)>> onPreRuntimeRecreate() { return {pre_runtime_recreate_signal}; }
 
 	static AssetMetadata &getOrCreateMetadata(const std::filesystem::path &source_path);
 	static AssetMetadata &getMetadata(const std::filesystem::path &source_path);
@@ -82,6 +85,8 @@ public:
 
 	static const eastl::unordered_map<Engine::GUID, AssetMetadata> &getAllMetadata() { return guid_to_metadata; }
 	static const std::filesystem::path &getAssetsRoot() { return assets_root; }
+	// Must be set before init()
+	static void setAssetsRoot(const std::filesystem::path &root) { assets_root = root; }
 private:
 	AssetManager() = delete;
 
@@ -104,4 +109,5 @@ private:
 
 	static entt::sigh<void (Asset *)> pre_reimport_signal;
 	static entt::sigh<void (Asset *)> post_reimport_signal;
+	static entt::sigh<void (Engine::GUID)> pre_runtime_recreate_signal;
 };
@@ -0,0 +1,189 @@
+#include "pch.h"
+#include "AssetRegistry.h"
+#include "AssetManager.h"
+#include "Utils/BinaryArchive.h"
+#include "Utils/Hashing.h"
+
+namespace
+{
+constexpr uint32_t REGISTRY_MAGIC = 0x47455241; // "AREG"
+constexpr uint32_t REGISTRY_VERSION = 1;
+
+struct RegistryHeader
+{
+	uint32_t magic = REGISTRY_MAGIC;
+	uint32_t version = REGISTRY_VERSION;
+	uint32_t typesHash = 0;
+	uint32_t recordsCount = 0;
+};
+
+// Fixed size part of a record, followed by source path, type name and import settings
+struct RecordFields
+{
+	uint64_t guid;
+	uint64_t runtimeGuid;
+	int64_t metaWriteTime;
+	uint64_t metaSize;
+	uint32_t runtimeVersion;
+	uint32_t metaHash;
+};
+
+bool read_string(BinaryArchive &archive, size_t size, eastl::string &string)
+{
+	uint32_t length = 0;
+	if (archive.tell() + sizeof(length) > size)
+		return false;
+	archive << length;
+	if (archive.tell() + length > size)
+		return false;
+	const char *chars = archive.map<char>(length);
+	string.assign(chars, chars + length);
+	return true;
+}
+
+void write_string(BinaryArchive &archive, const eastl::string &string)
+{
+	uint32_t length = string.size();
+	archive << length;
+	archive.array(string.data(), length);
+}
+
+uint32_t combine_hash(uint32_t hash, const void *data, size_t size)
+{
+	return hash * 31 + crc::crc32((const uint8_t *)data, size);
+}
+}
+
+bool AssetRegistry::load(const std::filesystem::path &path)
+{
+	records.clear();
+
+	std::ifstream file(path, std::ios::binary | std::ios::ate);
+	if (!file)
+		return false;
+
+	size_t size = file.tellg();
+	if (size < sizeof(RegistryHeader))
+		return false;
+
+	eastl::vector<uint8_t> data(size);
+	file.seekg(0);
+	file.read((char *)data.data(), size);
+
+	BinaryArchive archive = BinaryArchive::createForLoading(data.data(), size, 0);
+	RegistryHeader header;
+	archive << header;
+	if (header.magic != REGISTRY_MAGIC || header.version != REGISTRY_VERSION || header.typesHash != calc_types_hash())
+		return false;
+
+	records.reserve(header.recordsCount);
+	for (uint32_t i = 0; i < header.recordsCount; i++)
+	{
+		eastl::string source_path;
+		Record record;
+		RecordFields fields;
+		uint32_t settings_size = 0;
+		if (!read_string(archive, size, source_path) || !read_string(archive, size, record.typeName)
+			|| archive.tell() + sizeof(fields) + sizeof(settings_size) > size)
+		{
+			records.clear();
+			return false;
+		}
+
+		archive << fields << settings_size;
+		if (archive.tell() + settings_size > size)
+		{
+			records.clear();
+			return false;
+		}
+		archive.array(record.importSettings, settings_size);
+
+		record.guid = fields.guid;
+		record.runtimeGuid = fields.runtimeGuid;
+		record.runtimeVersion = fields.runtimeVersion;
+		record.metaWriteTime = fields.metaWriteTime;
+		record.metaSize = fields.metaSize;
+		record.metaHash = fields.metaHash;
+		records[eastl::move(source_path)] = eastl::move(record);
+	}
+	return true;
+}
+
+bool AssetRegistry::save(const std::filesystem::path &path) const
+{
+	std::filesystem::create_directories(path.parent_path());
+
+	// Written next to the registry and then swapped, so a crash never leaves a half written file
+	std::filesystem::path temp_path = path;
+	temp_path += ".tmp";
+	{
+		std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+		if (!file)
+			return false;
+
+		BinaryArchive archive = BinaryArchive::createForSaving(file);
+		RegistryHeader header;
+		header.typesHash = calc_types_hash();
+		header.recordsCount = records.size();
+		archive << header;
+
+		for (const auto &[source_path, record] : records)
+		{
+			RecordFields fields;
+			fields.guid = record.guid;
+			fields.runtimeGuid = record.runtimeGuid;
+			fields.metaWriteTime = record.metaWriteTime;
+			fields.metaSize = record.metaSize;
+			fields.runtimeVersion = record.runtimeVersion;
+			fields.metaHash = record.metaHash;
+			uint32_t settings_size = record.importSettings.size();
+
+			write_string(archive, source_path);
+			write_string(archive, record.typeName);
+			archive << fields << settings_size;
+			archive.array(record.importSettings.data(), settings_size);
+		}
+
+		if (!file)
+			return false;
+	}
+
+	std::error_code error;
+	std::filesystem::rename(temp_path, path, error);
+	return !error;
+}
+
+const AssetRegistry::Record *AssetRegistry::find(const eastl::string &source_path) const
+{
+	auto it = records.find(source_path);
+	return it != records.end() ? &it->second : nullptr;
+}
+
+uint32_t AssetRegistry::calcHash(const void *data, size_t size)
+{
+	return crc::crc32((const uint8_t *)data, size);
+}
+
+uint32_t AssetRegistry::calc_types_hash()
+{
+	eastl::vector<const AssetTypeInfo *> types = AssetManager::getTypeInfos();
+	eastl::sort(types.begin(), types.end(), [](const AssetTypeInfo *a, const AssetTypeInfo *b) { return strcmp(a->name, b->name) < 0; });
+
+	uint32_t hash = 0;
+	for (const AssetTypeInfo *type : types)
+	{
+		hash = combine_hash(hash, type->name, strlen(type->name));
+		const StructInfo *info = type->importSettingsInfo;
+		if (!info)
+			continue;
+
+		hash = combine_hash(hash, &info->size, sizeof(info->size));
+		for (int i = 0; i < info->fieldsCount; i++)
+		{
+			const FieldInfo &field = info->fields[i];
+			hash = combine_hash(hash, field.name, strlen(field.name));
+			hash = combine_hash(hash, &field.offset, sizeof(field.offset));
+		}
+	}
+	return hash;
+}
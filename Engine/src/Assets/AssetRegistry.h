@@ -0,0 +1,42 @@
+#pragma once
+#include "Core/GUID.h"
+#include <EASTL/hash_map.h>
+#include <filesystem>
+
+// Binary cache of all .meta files, saved by AssetManager::refresh() next to runtimes.
+// A record is valid while its .meta has the same write time and size, or the same content hash when only the time changed,
+// so only new and edited metas are parsed on startup.
+class AssetRegistry
+{
+public:
+	struct Record
+	{
+		Engine::GUID guid = 0;
+		Engine::GUID runtimeGuid = 0;
+		uint32_t runtimeVersion = 0;
+		eastl::string typeName;
+		eastl::vector<uint8_t> importSettings;
+
+		int64_t metaWriteTime = 0;
+		uint64_t metaSize = 0;
+		uint32_t metaHash = 0;
+	};
+
+	// Fails (and stays empty) when the file is missing, corrupted or written with different asset types
+	bool load(const std::filesystem::path &path);
+	bool save(const std::filesystem::path &path) const;
+
+	// Key is the generic source path as enumerated from the assets root
+	const Record *find(const eastl::string &source_path) const;
+	void set(const eastl::string &source_path, Record record) { records[source_path] = eastl::move(record); }
+	void clear() { records.clear(); }
+	size_t size() const { return records.size(); }
+
+	static uint32_t calcHash(const void *data, size_t size);
+
+private:
+	// Registered types and layouts of their import settings, records are raw copies of settings
+	static uint32_t calc_types_hash();
+
+	eastl::hash_map<eastl::string, Record> records;
+};
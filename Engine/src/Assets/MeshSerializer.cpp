@@ -5,6 +5,8 @@
 #include "Rendering/Material.h"
 #include "Rendering/ShaderStructs.h"
 #include "Math/EngineMath.h"
+#include "Core/Variables.h"
+#include "RHI/RHIUploadBatch.h"
 #include "meshoptimizer.h"
 #include <fstream>
 
@@ -26,11 +28,11 @@ static MeshFormat::MeshEntry make_mesh_entry(const Engine::Mesh *mesh, uint64_t
 	e.index_count = mesh->indexed ? mesh->indexed->indices.size() : 0;
 	e.meshlet_vertex_count = build_data ? build_data->vertex_count : 0;
 	e.meshlet_triangle_count = build_data ? build_data->triangles.size() : 0;
-	e.meshlet_count = mesh->meshlet_data ? mesh->meshlet_data->meshlets.size() : 0;
-	e.lod_group_count = mesh->meshlet_data ? mesh->meshlet_data->meshlet_lod_groups.size() : 0;
-	e.lod_node_count = mesh->meshlet_data ? mesh->meshlet_data->lod_nodes.size() : 0;
-	e.lod_level_count = mesh->meshlet_data ? mesh->meshlet_data->meshlet_lod_levels.size() : 0;
-	e.meshlet_root_group_local_offset = mesh->meshlet_data ? mesh->meshlet_data->meshlet_root_group_local_offset : 0;
+	e.meshlet_count = build_data ? build_data->meshlets.size() : 0;
+	e.lod_group_count = build_data ? build_data->lod_groups.size() : 0;
+	e.lod_node_count = build_data ? build_data->lod_nodes.size() : 0;
+	e.lod_level_count = build_data ? build_data->lod_levels.size() : 0;
+	e.meshlet_root_group_local_offset = build_data ? build_data->root_group_local_offset : 0;
 	e.attribute_flags = mesh->attribute_flags;
 	memcpy(e.bbox_min, &mesh->bound_box.min, 12);
 	memcpy(e.bbox_max, &mesh->bound_box.max, 12);
@@ -68,39 +70,33 @@ static void serialize_mesh_block(BinaryArchive &ar, Engine::Mesh *mesh, const Me
 
 		if (entry.meshlet_count > 0)
 		{
-			mesh->meshlet_data.emplace();
-			eastl::vector<MeshFormat::DiskMeshlet> disk_meshlets;
-			ar.array(disk_meshlets, entry.meshlet_count);
-			mesh->meshlet_data->meshlets.resize(entry.meshlet_count);
-			for (size_t i = 0; i < entry.meshlet_count; i++)
-				mesh->meshlet_data->meshlets[i] = MeshFormat::decodeMeshlet(disk_meshlets[i]);
-			ar.array(mesh->meshlet_data->meshlet_lod_groups, entry.lod_group_count);
-			ar.array(mesh->meshlet_data->lod_nodes, entry.lod_node_count);
-			ar.array(mesh->meshlet_data->meshlet_lod_levels, entry.lod_level_count);
+			// Every array starts at ALIGNMENT, so the mapped pointers are aligned for the types
+			Engine::MeshletGeometry &meshlet_geom = mesh->meshlet_data.emplace();
+			meshlet_geom.meshlets = {ar.map<MeshFormat::DiskMeshlet>(entry.meshlet_count), entry.meshlet_count};
+			meshlet_geom.meshlet_lod_groups = {ar.map<LODGroup>(entry.lod_group_count), entry.lod_group_count};
+			meshlet_geom.lod_nodes = {ar.map<LodNode>(entry.lod_node_count), entry.lod_node_count};
+			meshlet_geom.meshlet_lod_levels = {ar.map<LODLevel>(entry.lod_level_count), entry.lod_level_count};
 		}
 	} else
 	{
 		static const Engine::IndexedGeometry empty_traditional_geom;
-		static const Engine::MeshletGeometry empty_meshlet_geom;
+		static const MeshletBuildData empty_build_data;
 		const Engine::IndexedGeometry &traditional_geom = mesh->indexed ? *mesh->indexed : empty_traditional_geom;
-		const Engine::MeshletGeometry &meshlet_geom = mesh->meshlet_data ? *mesh->meshlet_data : empty_meshlet_geom;
+		const MeshletBuildData &meshlet_geom = build_data ? *build_data : empty_build_data;
 
 		ar.array(const_cast<Engine::Vertex *>(traditional_geom.vertices.data()), traditional_geom.vertices.size());
 		ar.array(const_cast<uint32_t *>(traditional_geom.indices.data()), traditional_geom.indices.size());
 
-		if (build_data)
-		{
-			ar.array(const_cast<uint8_t *>(build_data->vertices.data()), build_data->vertices.size());
-			ar.array(const_cast<uint8_t *>(build_data->triangles.data()), build_data->triangles.size());
-		}
+		ar.array(meshlet_geom.vertices.data(), meshlet_geom.vertices.size());
+		ar.array(meshlet_geom.triangles.data(), meshlet_geom.triangles.size());
 
 		eastl::vector<MeshFormat::DiskMeshlet> disk_meshlets(meshlet_geom.meshlets.size());
 		for (size_t i = 0; i < disk_meshlets.size(); i++)
 			disk_meshlets[i] = MeshFormat::encodeMeshlet(meshlet_geom.meshlets[i]);
 		ar.array(disk_meshlets.data(), disk_meshlets.size());
-		ar.array(const_cast<LODGroup *>(meshlet_geom.meshlet_lod_groups.data()), meshlet_geom.meshlet_lod_groups.size());
-		ar.array(const_cast<LodNode *>(meshlet_geom.lod_nodes.data()), meshlet_geom.lod_nodes.size());
-		ar.array(const_cast<LODLevel *>(meshlet_geom.meshlet_lod_levels.data()), meshlet_geom.meshlet_lod_levels.size());
+		ar.array(meshlet_geom.lod_groups.data(), meshlet_geom.lod_groups.size());
+		ar.array(meshlet_geom.lod_nodes.data(), meshlet_geom.lod_nodes.size());
+		ar.array(meshlet_geom.lod_levels.data(), meshlet_geom.lod_levels.size());
 	}
 }
 
@@ -305,6 +301,8 @@ bool MeshSerializer::load(Model *model, const char *filepath)
 	if (!model->mesh_file_memory.open(filepath, true, 0))
 		return false;
 
+	// All meshes of the model go into one copy submission
+	RHIUploadBatch::Scope upload_scope;
 	return load_from_memory(model, static_cast<const uint8_t *>(model->mesh_file_memory.getData()), static_cast<uint64_t>(model->mesh_file_memory.getSize()));
 }
 
@@ -330,6 +328,7 @@ bool MeshSerializer::load_from_memory(Model *model, const uint8_t *data, uint64_
 
 	eastl::vector<Ref<Engine::Mesh>> meshes;
 	meshes.reserve(header->mesh_count);
+	uint64_t mapped_metadata_bytes = 0;
 	for (uint32_t i = 0; i < header->mesh_count; i++)
 	{
 		const MeshFormat::MeshEntry &entry = mesh_entries[i];
@@ -348,7 +347,7 @@ bool MeshSerializer::load_from_memory(Model *model, const uint8_t *data, uint64_
 			Engine::MeshletGeometry &meshlet_geom = *mesh->meshlet_data;
 			meshlet_geom.meshlet_root_group_local_offset = entry.meshlet_root_group_local_offset;
 
-			// Reconstruct group data info from meshlets
+			// Reconstruct group data info, meshlet offsets are relative to the group so its last meshlet ends the group
 			meshlet_geom.meshlet_lod_group_data_info.resize(entry.lod_group_count);
 			uint32_t current_vert = 0;
 			uint32_t current_tri = 0;
@@ -358,19 +357,22 @@ bool MeshSerializer::load_from_memory(Model *model, const uint8_t *data, uint64_
 				Engine::MeshletGeometry::LODGroupDataInfo &gdi = meshlet_geom.meshlet_lod_group_data_info[j];
 				gdi.cpu_vertex_offset = current_vert;
 				gdi.cpu_triangle_offset = current_tri;
-				uint32_t vert_count = 0;
-				uint32_t tri_count = 0;
-				for (uint32_t k = lod.first_meshlet; k < lod.first_meshlet + lod.meshlet_count; k++)
+				gdi.cpu_vertex_count = 0;
+				gdi.cpu_triangle_count = 0;
+				if (lod.meshlet_count > 0)
 				{
-					vert_count += meshlet_geom.meshlets[k].vertex_count;
-					tri_count += meshlet_geom.meshlets[k].triangle_count * 3;
+					const MeshFormat::DiskMeshlet &last = meshlet_geom.meshlets[lod.first_meshlet + lod.meshlet_count - 1];
+					gdi.cpu_vertex_count = last.vertex_offset + last.vertex_count;
+					gdi.cpu_triangle_count = last.triangle_offset + last.triangle_count * 3;
 				}
-				gdi.cpu_vertex_count = vert_count;
-				gdi.cpu_triangle_count = tri_count;
-				current_vert += vert_count;
-				current_tri += tri_count;
+				current_vert += gdi.cpu_vertex_count;
+				current_tri += gdi.cpu_triangle_count;
 			}
+			mapped_metadata_bytes += entry.meshlet_count * sizeof(Meshlet) + entry.lod_group_count * sizeof(LODGroup)
+				+ entry.lod_node_count * sizeof(LodNode) + entry.lod_level_count * sizeof(LODLevel);
 			mesh->initMeshleted();
+			if (engine_ray_tracing)
+				mesh->initRayTracingProxy(model->file_views[mesh->id], (uint32_t)eastl::max(engine_ray_tracing_proxy_triangles.get(), 1));
 		} else
 		{
 			mesh->initTraditional(std::move(mesh->indexed->vertices), std::move(mesh->indexed->indices));
@@ -415,6 +417,7 @@ bool MeshSerializer::load_from_memory(Model *model, const uint8_t *data, uint64_
 	model->root_node = nodes[0];
 	model->linear_nodes = nodes;
 
-	CORE_INFO("Loaded .mesh: {} nodes, {} meshes, {} materials", header->node_count, header->mesh_count, header->material_count);
+	CORE_INFO("Loaded .mesh: {} nodes, {} meshes, {} materials, {:.3f} MB meshlet metadata mapped instead of copied",
+		header->node_count, header->mesh_count, header->material_count, mapped_metadata_bytes / (1024.0 * 1024.0));
 	return true;
 }
@@ -1,11 +1,29 @@
 #pragma once
 #include "Core/ReflectionSerialization.h"
 
+enum TextureCompression
+{
+	TEXTURE_COMPRESSION_AUTO = 0, // picked by the first material slot that uses the texture
+	TEXTURE_COMPRESSION_NONE,
+	TEXTURE_COMPRESSION_COLOR, // BC7 sRGB
+	TEXTURE_COMPRESSION_COLOR_OPAQUE, // BC1 sRGB
+	TEXTURE_COMPRESSION_NORMAL, // BC5
+	TEXTURE_COMPRESSION_MASK, // BC4
+};
+inline const char *const texture_compression_items[] = {"Auto", "None", "Color (BC7)", "Opaque Color (BC1)", "Normal Map (BC5)", "Mask (BC4)"};
+
 struct TextureImportSettings
 {
 	bool generate_mipmaps = true;
+	TextureCompression compression = TEXTURE_COMPRESSION_AUTO;
+	// Written by materials, used when compression is Auto
+	TextureCompression slot_compression = TEXTURE_COMPRESSION_NONE;
+
+	TextureCompression getCompression() const { return compression == TEXTURE_COMPRESSION_AUTO ? slot_compression : compression; }
 };
 
 REFLECT_BEGIN(TextureImportSettings)
 	REFLECT_FIELD(generate_mipmaps),
+	REFLECT_FIELD(compression).items(texture_compression_items),
+	REFLECT_FIELD(slot_compression).label("Material Slot Compression").items(texture_compression_items).readOnly(),
 REFLECT_END()
@@ -0,0 +1,306 @@
+#include "pch.h"
+#include "AsyncLogSink.h"
+#include <string_view>
+
+// Queue is a bounded ring where every cell has a sequence number (D. Vyukov's bounded queue).
+// Cell is free for position p when its sequence is p and filled when it is p + 1,
+// producers claim positions with CAS and the logger thread reads cells in order without atomics on the position.
+AsyncLogSink::AsyncLogSink(std::vector<spdlog::sink_ptr> sinks, uint32_t queue_size): sinks(std::move(sinks))
+{
+	uint64_t capacity = 1;
+	while (capacity < queue_size)
+		capacity *= 2;
+	mask = capacity - 1;
+
+	cells = std::make_unique<Cell[]>(capacity);
+	for (uint64_t i = 0; i < capacity; i++)
+		cells[i].sequence.store(i, std::memory_order_relaxed);
+
+	repeat_slots = std::make_unique<std::atomic<uint64_t>[]>(REPEAT_SLOTS);
+	for (uint32_t i = 0; i < REPEAT_SLOTS; i++)
+		repeat_slots[i].store(0, std::memory_order_relaxed);
+
+	worker = std::thread([this]() { worker_loop(); });
+}
+
+AsyncLogSink::~AsyncLogSink()
+{
+	is_stopping.store(true);
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		wake_condition.notify_one();
+	}
+	worker.join();
+}
+
+void AsyncLogSink::log(const spdlog::details::log_msg &msg)
+{
+	bool is_important = msg.level >= spdlog::level::err;
+
+	uint32_t suppressed = 0;
+	if (!is_important)
+	{
+		bool is_suppressed = false;
+		suppressed = check_repeats(msg, is_suppressed);
+		if (is_suppressed)
+		{
+			suppressed_count.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+	}
+
+	while (!try_push(msg, suppressed))
+	{
+		if (!is_important)
+		{
+			dropped_count.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+
+		// Errors wait for the logger thread instead
+		wake_logger();
+		std::this_thread::yield();
+	}
+	wake_logger();
+}
+
+void AsyncLogSink::flush()
+{
+	uint64_t ticket = request_flush();
+	std::unique_lock<std::mutex> lock(mutex);
+	flushed_condition.wait(lock, [&]() { return flush_completed.load() >= ticket; });
+}
+
+bool AsyncLogSink::flush(std::chrono::milliseconds timeout)
+{
+	uint64_t ticket = flush_requested.fetch_add(1) + 1;
+	return wait_flushed(ticket, timeout);
+}
+
+bool AsyncLogSink::logOnCrash(const spdlog::details::log_msg &msg, std::chrono::milliseconds timeout)
+{
+	if (!try_push(msg, 0))
+		dropped_count.fetch_add(1, std::memory_order_relaxed);
+	if (std::this_thread::get_id() == worker.get_id())
+		return false;
+	return flush(timeout);
+}
+
+void AsyncLogSink::set_pattern(const std::string &pattern)
+{
+	for (auto &sink : sinks)
+		sink->set_pattern(pattern);
+}
+
+void AsyncLogSink::set_formatter(std::unique_ptr<spdlog::formatter> sink_formatter)
+{
+	for (auto &sink : sinks)
+		sink->set_formatter(sink_formatter->clone());
+}
+
+uint32_t AsyncLogSink::check_repeats(const spdlog::details::log_msg &msg, bool &is_suppressed)
+{
+	// Slot is hash (32 bits), second (16 bits) and count in that second (16 bits), so it is updated with one CAS.
+	// Message that repeats keeps its slot for the second, others with the same slot index are not limited meanwhile
+	uint64_t hash = std::hash<std::string_view>()(std::string_view(msg.payload.data(), msg.payload.size())) ^ (uint64_t(msg.level) * 0x9E3779B97F4A7C15ull);
+	uint64_t tag = (hash >> 32) ^ (hash & 0xFFFFFFFF);
+	uint64_t second = uint64_t(std::chrono::duration_cast<std::chrono::seconds>(msg.time.time_since_epoch()).count()) & 0xFFFF;
+	std::atomic<uint64_t> &slot = repeat_slots[hash % REPEAT_SLOTS];
+
+	uint64_t old_value = slot.load(std::memory_order_relaxed);
+	while (true)
+	{
+		uint64_t old_tag = old_value >> 32;
+		uint64_t old_second = (old_value >> 16) & 0xFFFF;
+		uint64_t old_count = old_value & 0xFFFF;
+
+		if (old_tag != tag && old_second == second && old_count > 1)
+		{
+			is_suppressed = false;
+			return 0;
+		}
+
+		uint64_t count = 1;
+		uint32_t suppressed = 0;
+		if (old_tag == tag && old_second == second)
+		{
+			count = eastl::min<uint64_t>(old_count + 1, 0xFFFF);
+		} else if (old_tag == tag && old_count > REPEAT_LIMIT)
+		{
+			suppressed = uint32_t(old_count - REPEAT_LIMIT);
+		}
+
+		uint64_t new_value = (tag << 32) | (second << 16) | count;
+		if (slot.compare_exchange_weak(old_value, new_value, std::memory_order_relaxed))
+		{
+			is_suppressed = count > REPEAT_LIMIT;
+			return suppressed;
+		}
+	}
+}
+
+bool AsyncLogSink::try_push(const spdlog::details::log_msg &msg, uint32_t suppressed)
+{
+	uint64_t position = enqueue_position.load(std::memory_order_relaxed);
+	Cell *cell;
+	while (true)
+	{
+		cell = &cells[position & mask];
+		uint64_t sequence = cell->sequence.load(std::memory_order_acquire);
+		int64_t difference = int64_t(sequence) - int64_t(position);
+		if (difference == 0)
+		{
+			if (enqueue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+				break;
+		} else if (difference < 0)
+		{
+			return false; // Full, logger thread hasn't read this cell yet
+		} else
+		{
+			position = enqueue_position.load(std::memory_order_relaxed);
+		}
+	}
+
+	cell->msg = spdlog::details::log_msg_buffer(msg);
+	cell->suppressed = suppressed;
+	cell->sequence.store(position + 1, std::memory_order_release);
+	return true;
+}
+
+bool AsyncLogSink::has_pending() const
+{
+	return cells[dequeue_position & mask].sequence.load() == dequeue_position + 1;
+}
+
+uint64_t AsyncLogSink::request_flush()
+{
+	uint64_t ticket = flush_requested.fetch_add(1) + 1;
+	wake_logger();
+	return ticket;
+}
+
+bool AsyncLogSink::wait_flushed(uint64_t ticket, std::chrono::milliseconds timeout)
+{
+	// Polls instead of waiting on flushed_condition, the mutex could be held by a crashed thread.
+	// Logger thread is woken only when the mutex is free, otherwise it wakes up by itself within 100 ms
+	auto deadline = std::chrono::steady_clock::now() + timeout;
+	while (flush_completed.load() < ticket)
+	{
+		if (std::chrono::steady_clock::now() >= deadline)
+			return false;
+		{
+			std::unique_lock<std::mutex> lock(mutex, std::try_to_lock);
+			if (lock.owns_lock())
+				wake_condition.notify_one();
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	return true;
+}
+
+void AsyncLogSink::wake_logger()
+{
+	// Pairs with is_waiting store and queue check in worker_loop, one of them sees the other
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (is_waiting.load(std::memory_order_relaxed))
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		wake_condition.notify_one();
+	}
+}
+
+void AsyncLogSink::worker_loop()
+{
+	auto last_flush_time = std::chrono::steady_clock::now();
+	bool has_unflushed = false;
+
+	while (true)
+	{
+		// Read before the queue, so everything logged before the request gets written
+		uint64_t requested = flush_requested.load();
+
+		bool has_written = false;
+		bool is_flush_needed = false;
+		while (has_pending())
+		{
+			Cell &cell = cells[dequeue_position & mask];
+			write(cell.msg, cell.suppressed);
+			is_flush_needed |= cell.msg.level >= spdlog::level::err;
+			cell.sequence.store(dequeue_position + mask + 1, std::memory_order_release);
+			dequeue_position++;
+			has_written = true;
+		}
+		if (dropped_count.load(std::memory_order_relaxed) != reported_dropped_count)
+		{
+			write_dropped_count();
+			has_written = true;
+		}
+		has_unflushed |= has_written;
+
+		// Other messages are flushed at least once a second
+		auto now = std::chrono::steady_clock::now();
+		bool is_flush_requested = requested != flush_completed.load();
+		if (is_flush_needed || is_flush_requested || (has_unflushed && now - last_flush_time >= std::chrono::seconds(1)))
+		{
+			for (auto &sink : sinks)
+				sink->flush();
+			last_flush_time = now;
+			has_unflushed = false;
+		}
+		if (is_flush_requested)
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			flush_completed.store(requested);
+			flushed_condition.notify_all();
+		}
+
+		if (has_written)
+			continue;
+
+		std::unique_lock<std::mutex> lock(mutex);
+		is_waiting.store(true);
+		if (is_stopping.load() && !has_pending())
+			break;
+		if (!has_pending() && flush_requested.load() == flush_completed.load())
+			wake_condition.wait_for(lock, std::chrono::milliseconds(100));
+		is_waiting.store(false);
+	}
+
+	for (auto &sink : sinks)
+		sink->flush();
+}
+
+void AsyncLogSink::write(const spdlog::details::log_msg &msg, uint32_t suppressed)
+{
+	if (suppressed > 0)
+	{
+		std::string payload = fmt::format("{} more repeats were suppressed: {}", suppressed, std::string_view(msg.payload.data(), msg.payload.size()));
+		spdlog::details::log_msg note(msg.time, msg.source, msg.logger_name, msg.level, payload);
+		note.thread_id = msg.thread_id;
+		for (auto &sink : sinks)
+		{
+			if (sink->should_log(note.level))
+				sink->log(note);
+		}
+	}
+
+	for (auto &sink : sinks)
+	{
+		if (sink->should_log(msg.level))
+			sink->log(msg);
+	}
+}
+
+void AsyncLogSink::write_dropped_count()
+{
+	uint64_t dropped = dropped_count.load(std::memory_order_relaxed);
+	std::string payload = fmt::format("Log queue was full, {} messages were dropped", dropped - reported_dropped_count);
+	reported_dropped_count = dropped;
+
+	spdlog::details::log_msg msg(spdlog::source_loc(), "Log", spdlog::level::warn, payload);
+	for (auto &sink : sinks)
+	{
+		if (sink->should_log(msg.level))
+			sink->log(msg);
+	}
+}
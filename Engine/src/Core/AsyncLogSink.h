@@ -0,0 +1,81 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <spdlog/sinks/sink.h>
+#include <spdlog/details/log_msg_buffer.h>
+
+// Sink that hands messages to a logger thread, which writes them to the wrapped sinks.
+// Calling thread only copies the formatted payload into a bounded lock-free queue (many producers, one consumer),
+// so logging never waits for console or file. Repeats of the same message below error level are limited
+// per second and messages that don't fit into a full queue are dropped, both are counted and reported.
+// Error and critical are never limited or dropped, sinks are flushed right after them.
+class AsyncLogSink : public spdlog::sinks::sink
+{
+public:
+	AsyncLogSink(std::vector<spdlog::sink_ptr> sinks, uint32_t queue_size = 8192);
+	~AsyncLogSink() override;
+
+	void log(const spdlog::details::log_msg &msg) override;
+	// Blocks until everything logged before the call is written and flushed
+	void flush() override;
+	// Same as flush, but gives up after timeout and never waits for the mutex
+	bool flush(std::chrono::milliseconds timeout);
+	// For crash handlers: the message gets one push attempt and the queue is flushed with timeout.
+	// Nothing is waited for on the logger thread, it could be the one that crashed
+	bool logOnCrash(const spdlog::details::log_msg &msg, std::chrono::milliseconds timeout);
+
+	void set_pattern(const std::string &pattern) override;
+	void set_formatter(std::unique_ptr<spdlog::formatter> sink_formatter) override;
+
+	const std::vector<spdlog::sink_ptr> &getSinks() const { return sinks; }
+	uint64_t getSuppressedCount() const { return suppressed_count.load(std::memory_order_relaxed); }
+	uint64_t getDroppedCount() const { return dropped_count.load(std::memory_order_relaxed); }
+
+	// Same message is logged at most this many times per second
+	static constexpr uint32_t REPEAT_LIMIT = 10;
+
+private:
+	struct Cell
+	{
+		std::atomic<uint64_t> sequence;
+		spdlog::details::log_msg_buffer msg;
+		uint32_t suppressed; // Repeats of this message suppressed before it
+	};
+
+	uint32_t check_repeats(const spdlog::details::log_msg &msg, bool &is_suppressed);
+	bool try_push(const spdlog::details::log_msg &msg, uint32_t suppressed);
+	bool has_pending() const;
+	uint64_t request_flush();
+	bool wait_flushed(uint64_t ticket, std::chrono::milliseconds timeout);
+	void wake_logger();
+	void worker_loop();
+	void write(const spdlog::details::log_msg &msg, uint32_t suppressed);
+	void write_dropped_count();
+
+	std::vector<spdlog::sink_ptr> sinks;
+
+	std::unique_ptr<Cell[]> cells;
+	uint64_t mask;
+	alignas(64) std::atomic<uint64_t> enqueue_position{0};
+	alignas(64) uint64_t dequeue_position = 0; // Logger thread only
+
+	// Packed hash, second and count of a message, see check_repeats
+	static constexpr uint32_t REPEAT_SLOTS = 1024;
+	std::unique_ptr<std::atomic<uint64_t>[]> repeat_slots;
+
+	std::atomic<uint64_t> suppressed_count{0};
+	std::atomic<uint64_t> dropped_count{0};
+	uint64_t reported_dropped_count = 0;
+
+	std::mutex mutex;
+	std::condition_variable wake_condition;
+	std::condition_variable flushed_condition;
+	std::atomic<bool> is_waiting{false};
+	std::atomic<bool> is_stopping{false};
+	std::atomic<uint64_t> flush_requested{0};
+	std::atomic<uint64_t> flush_completed{0};
+
+	std::thread worker;
+};
@@ -0,0 +1,382 @@
+#include "pch.h"
+#include "Benchmark.h"
+#include "Core/Variables.h"
+#include "Utils/Camera.h"
+#include "json.hpp"
+#include <fstream>
+
+namespace
+{
+constexpr float TURNTABLE_DURATION = 10.0f; // seconds for a full turn when no camera path is given
+
+struct Percentiles
+{
+	double p50 = 0.0;
+	double p95 = 0.0;
+	double p99 = 0.0;
+	double mean = 0.0;
+	double max = 0.0;
+};
+
+// Nearest rank, values are sorted in place
+Percentiles calc_percentiles(eastl::vector<double> &values)
+{
+	Percentiles result;
+	if (values.empty())
+		return result;
+
+	eastl::sort(values.begin(), values.end());
+	auto rank = [&](double p)
+	{
+		size_t index = (size_t)ceil(p * values.size());
+		return values[eastl::clamp<size_t>(index, 1, values.size()) - 1];
+	};
+	result.p50 = rank(0.50);
+	result.p95 = rank(0.95);
+	result.p99 = rank(0.99);
+	result.max = values.back();
+	for (double value : values)
+		result.mean += value;
+	result.mean /= values.size();
+	return result;
+}
+
+nlohmann::json percentiles_to_json(const Percentiles &p)
+{
+	return {{"p50", p.p50}, {"p95", p.p95}, {"p99", p.p99}, {"mean", p.mean}, {"max", p.max}};
+}
+
+eastl::string csv_escape(const eastl::string &value)
+{
+	if (value.find_first_of(",\"") == eastl::string::npos)
+		return value;
+	eastl::string result = "\"";
+	for (char c : value)
+	{
+		if (c == '"')
+			result += '"';
+		result += c;
+	}
+	return result + "\"";
+}
+}
+
+void Benchmark::init()
+{
+	is_active = engine_benchmark.get();
+	if (!is_active)
+		return;
+
+	eastl::string camera_path = engine_benchmark_camera_path.get();
+	if (!camera_path.empty() && !load_camera_path(camera_path))
+		CORE_WARN("Benchmark: can't load camera path {}, using turntable", camera_path.c_str());
+
+	float duration = camera_keys.empty() ? TURNTABLE_DURATION : camera_keys.back().time;
+	int frames_count = engine_benchmark_frames.get();
+	recorded_frames = frames_count > 0 ? frames_count : (uint32_t)ceil(duration / getTimestep()) + 1;
+	warmup_frames = eastl::max(engine_benchmark_warmup_frames.get(), 0);
+
+	frames.clear();
+	frames.reserve(recorded_frames);
+	start_time = std::chrono::steady_clock::now();
+
+	CORE_INFO("Benchmark: {} frames ({} warmup), timestep {:.4f} s, {}", recorded_frames, warmup_frames, getTimestep(),
+		camera_keys.empty() ? "turntable" : camera_path.c_str());
+}
+
+bool Benchmark::isCpuOnly()
+{
+	return engine_benchmark.get() && engine_benchmark_cpu_only.get();
+}
+
+float Benchmark::getTimestep()
+{
+	return eastl::max(engine_benchmark_timestep.get(), 0.0001f);
+}
+
+bool Benchmark::load_camera_path(const eastl::string &path)
+{
+	std::ifstream file(path.c_str());
+	if (!file)
+		return false;
+
+	nlohmann::json root = nlohmann::json::parse(file, nullptr, false);
+	if (root.is_discarded() || !root.contains("keys") || !root["keys"].is_array())
+		return false;
+
+	// {"keys": [{"time": 0.0, "position": [x, y, z], "rotation": [pitch, yaw]}, ...]}, rotation in degrees
+	camera_keys.clear();
+	for (const nlohmann::json &key : root["keys"])
+	{
+		CameraKey camera_key;
+		camera_key.time = key.value("time", 0.0f);
+		const nlohmann::json &position = key["position"];
+		const nlohmann::json &rotation = key["rotation"];
+		camera_key.position = glm::vec3(position[0].get<float>(), position[1].get<float>(), position[2].get<float>());
+		camera_key.rotation = glm::vec2(rotation[0].get<float>(), rotation[1].get<float>());
+		camera_keys.push_back(camera_key);
+	}
+	eastl::sort(camera_keys.begin(), camera_keys.end(), [](const CameraKey &a, const CameraKey &b) { return a.time < b.time; });
+	return !camera_keys.empty();
+}
+
+void Benchmark::updateCamera(Camera &camera)
+{
+	if (!is_active)
+		return;
+
+	float time = frame_index < warmup_frames ? 0.0f : (frame_index - warmup_frames) * getTimestep();
+
+	if (camera_keys.empty())
+	{
+		if (!has_start_pose)
+		{
+			has_start_pose = true;
+			start_pose.position = camera.getPosition();
+			start_pose.rotation = glm::degrees(glm::vec2(camera.getRotation()));
+		}
+		camera.setPosition(start_pose.position);
+		camera.setRotation(glm::vec3(start_pose.rotation.x, start_pose.rotation.y + 360.0f * time / TURNTABLE_DURATION, 0.0f));
+		return;
+	}
+
+	// Catmull-Rom for positions so the path has no velocity jumps at keys, angles are linear
+	size_t next = 0;
+	while (next < camera_keys.size() && camera_keys[next].time <= time)
+		next++;
+	size_t i1 = next == 0 ? 0 : next - 1;
+	size_t i2 = eastl::min(next, camera_keys.size() - 1);
+	size_t i0 = i1 == 0 ? 0 : i1 - 1;
+	size_t i3 = eastl::min(i2 + 1, camera_keys.size() - 1);
+
+	const CameraKey &k1 = camera_keys[i1];
+	const CameraKey &k2 = camera_keys[i2];
+	float t = k2.time > k1.time ? glm::clamp((time - k1.time) / (k2.time - k1.time), 0.0f, 1.0f) : 0.0f;
+
+	const glm::vec3 &p0 = camera_keys[i0].position;
+	const glm::vec3 &p3 = camera_keys[i3].position;
+	float t2 = t * t;
+	float t3 = t2 * t;
+	glm::vec3 position = 0.5f * ((2.0f * k1.position) + (-p0 + k2.position) * t
+		+ (2.0f * p0 - 5.0f * k1.position + 4.0f * k2.position - p3) * t2
+		+ (-p0 + 3.0f * k1.position - 3.0f * k2.position + p3) * t3);
+	glm::vec2 rotation = glm::mix(k1.rotation, k2.rotation, t);
+
+	camera.setPosition(position);
+	camera.setRotation(glm::vec3(rotation, 0.0f));
+}
+
+void Benchmark::beginFrame()
+{
+	if (!is_active)
+		return;
+	current_frame = Frame();
+	current_frame.start_us = get_time_us();
+}
+
+bool Benchmark::endFrame()
+{
+	if (!is_active)
+		return false;
+
+	if (is_recording())
+	{
+		current_frame.duration_us = get_time_us() - current_frame.start_us;
+		frames.push_back(eastl::move(current_frame));
+	}
+	frame_index++;
+
+	if (frames.size() < recorded_frames)
+		return false;
+
+	write_reports();
+	is_active = false;
+	return true;
+}
+
+void Benchmark::setCounter(const char *name, double value)
+{
+	if (!is_recording())
+		return;
+
+	uint32_t index = get_name_index(counter_names, counter_indices, name);
+	if (current_frame.counters.size() <= index)
+		current_frame.counters.resize(index + 1, NAN);
+	current_frame.counters[index] = value;
+}
+
+Benchmark::Scope::Scope(const char *name)
+{
+	if (!is_recording())
+		return;
+	this->name = name;
+	start = std::chrono::steady_clock::now();
+}
+
+Benchmark::Scope::~Scope()
+{
+	if (!name || !is_recording())
+		return;
+
+	auto end = std::chrono::steady_clock::now();
+
+	Sample sample;
+	sample.name = get_name_index(scope_names, scope_indices, name);
+	sample.start_us = std::chrono::duration<double, std::micro>(start - start_time).count();
+	sample.duration_us = std::chrono::duration<double, std::micro>(end - start).count();
+	current_frame.samples.push_back(sample);
+}
+
+uint32_t Benchmark::get_name_index(eastl::vector<eastl::string> &names, eastl::hash_map<eastl::string, uint32_t> &indices, const char *name)
+{
+	auto it = indices.find_as(name);
+	if (it != indices.end())
+		return it->second;
+
+	uint32_t index = names.size();
+	names.push_back(name);
+	indices[names.back()] = index;
+	return index;
+}
+
+double Benchmark::get_time_us()
+{
+	return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start_time).count();
+}
+
+bool Benchmark::is_recording()
+{
+	return is_active && frame_index >= warmup_frames;
+}
+
+void Benchmark::write_reports()
+{
+	PROFILE_CPU_FUNCTION();
+	std::filesystem::path output = engine_benchmark_output.get().c_str();
+	std::filesystem::create_directories(output);
+
+	// Time of every scope summed per frame, frames where it didn't run are NAN
+	eastl::vector<eastl::vector<double>> scope_ms(scope_names.size(), eastl::vector<double>(frames.size(), NAN));
+	eastl::vector<double> frame_ms(frames.size());
+	for (size_t f = 0; f < frames.size(); f++)
+	{
+		frame_ms[f] = frames[f].duration_us / 1000.0;
+		for (const Sample &sample : frames[f].samples)
+		{
+			double &value = scope_ms[sample.name][f];
+			value = (std::isnan(value) ? 0.0 : value) + sample.duration_us / 1000.0;
+		}
+	}
+
+	auto get_counter = [](const Frame &frame, size_t index)
+	{
+		return index < frame.counters.size() ? frame.counters[index] : NAN;
+	};
+
+	// CSV
+	{
+		std::ofstream csv(output / "frames.csv");
+		csv << "frame,frame_ms";
+		for (const eastl::string &name : scope_names)
+			csv << "," << csv_escape(name).c_str();
+		for (const eastl::string &name : counter_names)
+			csv << "," << csv_escape(name).c_str();
+		csv << "\n";
+
+		for (size_t f = 0; f < frames.size(); f++)
+		{
+			csv << f << "," << frame_ms[f];
+			for (size_t s = 0; s < scope_names.size(); s++)
+			{
+				csv << ",";
+				if (!std::isnan(scope_ms[s][f]))
+					csv << scope_ms[s][f];
+			}
+			for (size_t c = 0; c < counter_names.size(); c++)
+			{
+				csv << ",";
+				double value = get_counter(frames[f], c);
+				if (!std::isnan(value))
+					csv << value;
+			}
+			csv << "\n";
+		}
+	}
+
+	// Summary
+	eastl::vector<eastl::pair<uint32_t, Percentiles>> scope_summaries;
+	for (uint32_t s = 0; s < scope_names.size(); s++)
+	{
+		eastl::vector<double> values;
+		for (double value : scope_ms[s])
+			if (!std::isnan(value))
+				values.push_back(value);
+		scope_summaries.push_back({s, calc_percentiles(values)});
+	}
+	eastl::vector<double> sorted_frame_ms = frame_ms;
+	Percentiles frame_summary = calc_percentiles(sorted_frame_ms);
+
+	// JSON
+	{
+		nlohmann::json report;
+		report["scene"] = engine_startup_scene.get().c_str();
+		report["camera_path"] = engine_benchmark_camera_path.get().c_str();
+		report["cpu_only"] = isCpuOnly();
+		report["timestep"] = getTimestep();
+		report["warmup_frames"] = warmup_frames;
+		report["frames_count"] = frames.size();
+
+		nlohmann::json &summary = report["summary"];
+		summary["frame"] = percentiles_to_json(frame_summary);
+		for (const auto &[index, percentiles] : scope_summaries)
+			summary["scopes"][scope_names[index].c_str()] = percentiles_to_json(percentiles);
+
+		nlohmann::json &frames_json = report["frames"];
+		frames_json = nlohmann::json::array();
+		for (size_t f = 0; f < frames.size(); f++)
+		{
+			nlohmann::json frame_json;
+			frame_json["frame_ms"] = frame_ms[f];
+			for (size_t s = 0; s < scope_names.size(); s++)
+				if (!std::isnan(scope_ms[s][f]))
+					frame_json["scopes"][scope_names[s].c_str()] = scope_ms[s][f];
+			for (size_t c = 0; c < counter_names.size(); c++)
+				if (!std::isnan(get_counter(frames[f], c)))
+					frame_json["counters"][counter_names[c].c_str()] = get_counter(frames[f], c);
+			frames_json.push_back(std::move(frame_json));
+		}
+
+		std::ofstream(output / "report.json") << report.dump(1, '\t');
+	}
+
+	// Chrome trace, scopes are complete events, counters get a track each
+	{
+		nlohmann::json events = nlohmann::json::array();
+		for (size_t f = 0; f < frames.size(); f++)
+		{
+			const Frame &frame = frames[f];
+			events.push_back({{"name", "Frame"}, {"ph", "X"}, {"pid", 0}, {"tid", 0}, {"ts", frame.start_us}, {"dur", frame.duration_us}, {"args", {{"frame", f}}}});
+			for (const Sample &sample : frame.samples)
+				events.push_back({{"name", scope_names[sample.name].c_str()}, {"ph", "X"}, {"pid", 0}, {"tid", 0}, {"ts", sample.start_us}, {"dur", sample.duration_us}});
+			for (size_t c = 0; c < counter_names.size(); c++)
+			{
+				double value = get_counter(frame, c);
+				if (!std::isnan(value))
+					events.push_back({{"name", counter_names[c].c_str()}, {"ph", "C"}, {"pid", 0}, {"ts", frame.start_us}, {"args", {{"value", value}}}});
+			}
+		}
+
+		nlohmann::json trace;
+		trace["traceEvents"] = std::move(events);
+		trace["displayTimeUnit"] = "ms";
+		std::ofstream(output / "trace.json") << trace.dump();
+	}
+
+	eastl::sort(scope_summaries.begin(), scope_summaries.end(), [](const auto &a, const auto &b) { return a.second.p50 > b.second.p50; });
+
+	CORE_INFO("Benchmark finished, {} frames, reports are in {}", frames.size(), std::filesystem::absolute(output).string());
+	CORE_INFO("{:<48} {:>9} {:>9} {:>9}", "ms", "p50", "p95", "p99");
+	CORE_INFO("{:<48} {:>9.3f} {:>9.3f} {:>9.3f}", "Frame", frame_summary.p50, frame_summary.p95, frame_summary.p99);
+	for (const auto &[index, percentiles] : scope_summaries)
+		CORE_INFO("{:<48} {:>9.3f} {:>9.3f} {:>9.3f}", scope_names[index].c_str(), percentiles.p50, percentiles.p95, percentiles.p99);
+}
@@ -0,0 +1,95 @@
+#pragma once
+#include <EASTL/string.h>
+#include <EASTL/vector.h>
+#include <EASTL/hash_map.h>
+#include <chrono>
+#include <glm/glm.hpp>
+
+class Camera;
+
+// Scripted run for repeatable measurements (-benchmark). The camera plays a path with a fixed timestep,
+// CPU time of every frame graph pass and other scopes plus subsystem counters are recorded per frame.
+// After the last frame reports are written to engine.benchmark.output:
+//   frames.csv   - one row per frame, summed time of every scope (ms) and counters
+//   report.json  - run settings, p50/p95/p99 per scope and all frames
+//   trace.json   - Chrome trace (chrome://tracing, Perfetto)
+class Benchmark
+{
+public:
+	// Reads engine.benchmark.* variables and the camera path, does nothing if benchmark is disabled
+	static void init();
+	static bool isActive() { return is_active; }
+	static bool isCpuOnly();
+	static float getTimestep();
+
+	// Places camera on the path for the current frame, warmup frames stay at the start
+	static void updateCamera(Camera &camera);
+
+	static void beginFrame();
+	// Returns true after the last recorded frame, reports are written by then
+	static bool endFrame();
+
+	// Value is kept for the current frame, counters are columns in the same order as first set
+	static void setCounter(const char *name, double value);
+
+	// Measures CPU time between construction and destruction, free when benchmark is not active
+	class Scope
+	{
+	public:
+		Scope(const char *name);
+		~Scope();
+
+		Scope(const Scope &) = delete;
+		Scope &operator=(const Scope &) = delete;
+
+	private:
+		const char *name = nullptr;
+		std::chrono::steady_clock::time_point start;
+	};
+
+private:
+	struct CameraKey
+	{
+		float time;
+		glm::vec3 position;
+		glm::vec2 rotation; // pitch, yaw in degrees
+	};
+
+	struct Sample
+	{
+		uint32_t name;
+		double start_us;
+		double duration_us;
+	};
+
+	struct Frame
+	{
+		double start_us = 0.0;
+		double duration_us = 0.0;
+		eastl::vector<Sample> samples;
+		eastl::vector<double> counters;
+	};
+
+	static bool load_camera_path(const eastl::string &path);
+	static uint32_t get_name_index(eastl::vector<eastl::string> &names, eastl::hash_map<eastl::string, uint32_t> &indices, const char *name);
+	static double get_time_us();
+	static bool is_recording();
+	static void write_reports();
+
+	inline static bool is_active = false;
+	inline static uint32_t frame_index = 0;
+	inline static uint32_t warmup_frames = 0;
+	inline static uint32_t recorded_frames = 0;
+
+	inline static eastl::vector<CameraKey> camera_keys;
+	inline static bool has_start_pose = false;
+	inline static CameraKey start_pose;
+
+	inline static std::chrono::steady_clock::time_point start_time;
+	inline static Frame current_frame;
+	inline static eastl::vector<Frame> frames;
+	inline static eastl::vector<eastl::string> scope_names;
+	inline static eastl::hash_map<eastl::string, uint32_t> scope_indices;
+	inline static eastl::vector<eastl::string> counter_names;
+	inline static eastl::hash_map<eastl::string, uint32_t> counter_indices;
+};
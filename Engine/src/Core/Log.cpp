@@ -1,17 +1,101 @@
 #include "pch.h"
 #include "Core/Log.h"
+#include "Core/AsyncLogSink.h"
+#include <csignal>
 
 std::shared_ptr<spdlog::logger> Log::core_logger;
+std::shared_ptr<AsyncLogSink> Log::async_sink;
+
+namespace
+{
+std::terminate_handler previous_terminate_handler = nullptr;
+
+void flush_on_crash(const char *reason)
+{
+	Log::logCrash(fmt::format("Crash: {}", reason));
+}
+
+void on_signal(int signal)
+{
+	flush_on_crash(signal == SIGSEGV ? "segmentation fault" : signal == SIGABRT ? "abort" : signal == SIGFPE ? "floating point exception" : "illegal instruction");
+	std::signal(signal, SIG_DFL);
+	std::raise(signal);
+}
+
+void on_terminate()
+{
+	flush_on_crash("terminate");
+	if (previous_terminate_handler)
+		previous_terminate_handler();
+	std::abort();
+}
+
+#ifdef _WIN32
+LONG WINAPI on_unhandled_exception(EXCEPTION_POINTERS *exception)
+{
+	Log::logCrash(fmt::format("Crash: unhandled exception 0x{:08X}", uint32_t(exception->ExceptionRecord->ExceptionCode)));
+	return EXCEPTION_CONTINUE_SEARCH;
+}
+#endif
+}
 
 void Log::init()
 {
-	eastl::vector<spdlog::sink_ptr> log_sinks;
+	std::vector<spdlog::sink_ptr> log_sinks;
 	log_sinks.emplace_back(std::make_shared<spdlog::sinks::stdout_color_sink_mt>());
 	log_sinks.emplace_back(std::make_shared<spdlog::sinks::basic_file_sink_mt>("Logs.log", true));
+	async_sink = std::make_shared<AsyncLogSink>(log_sinks);
 
-	core_logger = std::make_shared<spdlog::logger>("Core Logger", log_sinks.begin(), log_sinks.end());
+	core_logger = std::make_shared<spdlog::logger>("Core Logger", async_sink);
 	spdlog::register_logger(core_logger);
 	core_logger->set_level(spdlog::level::trace);
-	core_logger->flush_on(spdlog::level::trace);
+	core_logger->flush_on(spdlog::level::critical);
 	core_logger->set_pattern("[%T] [%^%l%$] %n: %v");
+
+	previous_terminate_handler = std::set_terminate(on_terminate);
+	for (int signal : {SIGSEGV, SIGABRT, SIGFPE, SIGILL})
+		std::signal(signal, on_signal);
+#ifdef _WIN32
+	SetUnhandledExceptionFilter(on_unhandled_exception);
+#endif
+}
+
+void Log::shutdown()
+{
+	if (!async_sink)
+		return;
+
+	uint64_t suppressed = async_sink->getSuppressedCount();
+	uint64_t dropped = async_sink->getDroppedCount();
+	if (suppressed > 0 || dropped > 0)
+		core_logger->info("Log: {} repeated messages suppressed, {} dropped", suppressed, dropped);
+
+	// Destroying the sink writes the rest of the queue
+	std::vector<spdlog::sink_ptr> log_sinks = async_sink->getSinks();
+	core_logger->sinks() = log_sinks;
+	async_sink.reset();
+}
+
+bool Log::logCrash(const std::string &message, std::chrono::milliseconds timeout)
+{
+	if (!async_sink)
+	{
+		core_logger->error(message);
+		core_logger->flush();
+		return true;
+	}
+
+	// Goes around the logger, errors wait for a free cell there
+	spdlog::details::log_msg msg(spdlog::source_loc(), core_logger->name(), spdlog::level::err, message);
+	return async_sink->logOnCrash(msg, timeout);
+}
+
+bool Log::flush(std::chrono::milliseconds timeout)
+{
+	if (!async_sink)
+	{
+		core_logger->flush();
+		return true;
+	}
+	return async_sink->flush(timeout);
 }
@@ -3,12 +3,23 @@
 #include <spdlog/sinks/stdout_color_sinks.h>
 #include <spdlog/sinks/basic_file_sink.h>
 
+class AsyncLogSink;
+
+// Console and Logs.log are written by a logger thread, see AsyncLogSink. Critical messages wait until they are written,
+// errors are flushed without waiting and crashes (signals, terminate, unhandled exceptions) flush what is left in the queue.
 class Log
 {
 private:
 	static std::shared_ptr<spdlog::logger> core_logger;
+	static std::shared_ptr<AsyncLogSink> async_sink;
 public:
 	static void init();
+	// Stops the logger thread, messages logged after it are written directly
+	static void shutdown();
+	// Writes everything logged so far, waits at most timeout
+	static bool flush(std::chrono::milliseconds timeout = std::chrono::milliseconds(1000));
+	// Logs an error from a crash handler and flushes, never blocks longer than timeout
+	static bool logCrash(const std::string &message, std::chrono::milliseconds timeout = std::chrono::milliseconds(1000));
 	static std::shared_ptr<spdlog::logger> getCoreLogger() { return core_logger; }
 };
 
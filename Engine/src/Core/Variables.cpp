@@ -7,6 +7,7 @@ RenderSettings gRenderSettings;
 AutoConVarBool engine_rhi_validation("engine.rhi.validation", "RHI Validation Enabled", false, ConVarFlag::CON_VAR_FLAG_HIDDEN);
 AutoConVarBool engine_rhi_validation_break("engine.rhi.validation_break", "RHI Validation Break Enabled", false, ConVarFlag::CON_VAR_FLAG_HIDDEN);
 AutoConVarBool engine_ray_tracing("engine.ray_tracing", "Ray Tracing Enabled", true, ConVarFlag::CON_VAR_FLAG_HIDDEN);
+AutoConVarInt engine_ray_tracing_proxy_triangles("engine.ray_tracing.proxy_triangles", "Max Triangles of Ray Tracing Proxies of Meshlet Meshes", 16384, ConVarFlag::CON_VAR_FLAG_HIDDEN);
 AutoConVarBool engine_assets_reimport("engine.assets.reimport", "Force reimport all assets from source, ignoring binary cache", false, ConVarFlag::CON_VAR_FLAG_HIDDEN);
 AutoConVarBool engine_shader_debug_info("engine.shader.debug_info", "Embed debug info into shaders (slower shaders compilation)", false, ConVarFlag::CON_VAR_FLAG_HIDDEN);
 AutoConVarBool engine_streamline("engine.streamline", "Initialize Streamline (DLSS and other features) at startup", true, ConVarFlag::CON_VAR_FLAG_HIDDEN);
@@ -16,6 +17,8 @@ AutoConVarString engine_startup_scene("engine.startup_scene", "Scene opened at s
 AutoConVarBool render_vsync("render.vsync", "VSync", false);
 AutoConVarBool render_path_tracing_first_frame("render.path_tracing.first_frame", "Is Path Tracing First Frame", true, ConVarFlag::CON_VAR_FLAG_HIDDEN);
 AutoConVarBool render_lighting_only("render.debug.lighting_only", "Lighting Only", false);
+AutoConVarBool render_lighting_clustered("render.lighting.clustered", "Clustered Lighting", true);
+AutoConVarBool render_lighting_tiled("render.lighting.tiled", "Tiled Compute Lighting, replaces clustered lighting", false);
 AutoConVarBool render_ddgi_visualize("render.ddgi.visualize", "DDGI Visualize", false);
 AutoConVarInt render_ddgi_visualize_mode("render.ddgi.visualize_mode", "DDGI Visualize Mode", 0, ConVarFlag::CON_VAR_FLAG_HIDDEN);
 AutoConVarBool render_debug_rendering("render.debug.rendering", "Debug Rendering", false, ConVarFlag::CON_VAR_FLAG_HIDDEN);
@@ -26,6 +29,26 @@ AutoConVarBool render_culling_freeze("render.culling.freeze", "Freeze Culling",
 AutoConVarBool render_meshlets_mesh_shaders("render.meshlets.mesh_shaders", "Mesh Shaders", true);
 AutoConVarBool render_meshlets_bvh_visualize("render.meshlets.bvh_visualize", "Draw BVH Spheres", false);
 AutoConVarInt render_meshlets_bvh_visualize_depth("render.meshlets.bvh_visualize_depth", "BVH Depth", -1);
+AutoConVarInt render_shadows_update_budget("render.shadows.update_budget", "Shadow Views Updated Per Frame", 8);
+AutoConVarInt render_streaming_budget_mb("render.streaming.budget_mb", "Geometry Streaming Budget (MB)", 1024);
+AutoConVarInt render_streaming_stale_age("render.streaming.stale_age", "Frames Before Group Can Be Evicted", 4);
+AutoConVarInt render_streaming_texture_budget_mb("render.streaming.texture_budget_mb", "Texture Streaming Budget (MB)", 1024);
+
+// Physics
+AutoConVarFloat physics_fixed_timestep("physics.fixed_timestep", "Physics Fixed Timestep", 1.0f / 60.0f);
+AutoConVarInt physics_max_steps_per_frame("physics.max_steps_per_frame", "Physics Max Steps Per Frame", 4);
 
 // high thread counts leads to more maximum used RAM on importing
 AutoConVarInt engine_gltf_import_threads("engine.gltf.import_threads", "glTF Import Threads", 10);
+AutoConVarInt engine_texture_cook_threads("engine.texture.cook_threads", "Texture Compression Threads (0 - all cores)", 0);
+AutoConVarInt engine_assets_refresh_threads("engine.assets.refresh_threads", "Asset Metadata Read Threads (0 - all cores)", 0);
+AutoConVarInt engine_mitsuba_export_threads("engine.mitsuba.export_threads", "Mitsuba Mesh Export Threads (0 - all cores)", 0);
+
+// Benchmark
+AutoConVarBool engine_benchmark("engine.benchmark", "Play camera path with fixed timestep, write reports and exit", false, ConVarFlag::CON_VAR_FLAG_HIDDEN);
+AutoConVarBool engine_benchmark_cpu_only("engine.benchmark.cpu_only", "Benchmark CPU subsystems without creating a device", false, ConVarFlag::CON_VAR_FLAG_HIDDEN);
+AutoConVarString engine_benchmark_camera_path("engine.benchmark.camera_path", "Benchmark camera path (.json), empty - turntable", "", ConVarFlag::CON_VAR_FLAG_HIDDEN);
+AutoConVarString engine_benchmark_output("engine.benchmark.output", "Benchmark reports directory", "benchmark", ConVarFlag::CON_VAR_FLAG_HIDDEN);
+AutoConVarInt engine_benchmark_frames("engine.benchmark.frames", "Benchmark Recorded Frames (0 - whole camera path)", 0, ConVarFlag::CON_VAR_FLAG_HIDDEN);
+AutoConVarInt engine_benchmark_warmup_frames("engine.benchmark.warmup_frames", "Benchmark Warmup Frames", 60, ConVarFlag::CON_VAR_FLAG_HIDDEN);
+AutoConVarFloat engine_benchmark_timestep("engine.benchmark.timestep", "Benchmark Fixed Timestep", 1.0f / 60.0f, ConVarFlag::CON_VAR_FLAG_HIDDEN);
@@ -179,6 +179,8 @@ struct DDGISettings
 	glm::ivec3 size = glm::ivec3(16, 8, 16);
 	glm::vec3 spacing = glm::vec3(0.5f, 1.0f, 0.5f);
 	int probes_per_frame = 1024;
+	bool adaptive_update = true;
+	int max_probe_age = 64;
 	bool use_relocation = true;
 	bool use_classification = true;
 	bool use_fixed_rays = false;
@@ -194,6 +196,8 @@ REFLECT_BEGIN(DDGISettings)
 	REFLECT_FIELD(spacing).range(0.05f, 5.0f).format("%.2f m").EDIT_IF(owner.enabled),
 	REFLECT_CATEGORY("DDGI - Update"),
 	REFLECT_FIELD(probes_per_frame).range(16.0f, 16384.0f).logarithmic().tooltip("Must be a power of two").EDIT_IF(owner.enabled),
+	REFLECT_FIELD(adaptive_update).tooltip("Spend the budget on probes with changing irradiance and near scene changes instead of round robin").EDIT_IF(owner.enabled),
+	REFLECT_FIELD(max_probe_age).range(1.0f, 1024.0f).logarithmic().tooltip("Frames a probe can wait for an update with adaptive update").EDIT_IF(owner.enabled && owner.adaptive_update),
 	REFLECT_FIELD(use_relocation).EDIT_IF(owner.enabled),
 	REFLECT_FIELD(use_classification).EDIT_IF(owner.enabled),
 	REFLECT_FIELD(use_fixed_rays).EDIT_IF(owner.enabled),
@@ -236,6 +240,7 @@ extern RenderSettings gRenderSettings;
 extern AutoConVarBool engine_rhi_validation;
 extern AutoConVarBool engine_rhi_validation_break;
 extern AutoConVarBool engine_ray_tracing;
+extern AutoConVarInt engine_ray_tracing_proxy_triangles;
 extern AutoConVarBool engine_assets_reimport;
 extern AutoConVarBool engine_shader_debug_info;
 extern AutoConVarBool engine_streamline;
@@ -245,6 +250,8 @@ extern AutoConVarString engine_startup_scene;
 extern AutoConVarBool render_vsync;
 extern AutoConVarBool render_path_tracing_first_frame;
 extern AutoConVarBool render_lighting_only;
+extern AutoConVarBool render_lighting_clustered;
+extern AutoConVarBool render_lighting_tiled;
 extern AutoConVarBool render_ddgi_visualize;
 extern AutoConVarInt render_ddgi_visualize_mode;
 extern AutoConVarBool render_debug_rendering;
@@ -255,6 +262,26 @@ extern AutoConVarBool render_culling_freeze;
 extern AutoConVarBool render_meshlets_mesh_shaders;
 extern AutoConVarBool render_meshlets_bvh_visualize;
 extern AutoConVarInt render_meshlets_bvh_visualize_depth;
+extern AutoConVarInt render_shadows_update_budget;
+extern AutoConVarInt render_streaming_budget_mb;
+extern AutoConVarInt render_streaming_stale_age;
+extern AutoConVarInt render_streaming_texture_budget_mb;
+
+// Physics
+extern AutoConVarFloat physics_fixed_timestep;
+extern AutoConVarInt physics_max_steps_per_frame;
 
 // Asset import
 extern AutoConVarInt engine_gltf_import_threads;
+extern AutoConVarInt engine_texture_cook_threads;
+extern AutoConVarInt engine_assets_refresh_threads;
+extern AutoConVarInt engine_mitsuba_export_threads;
+
+// Benchmark (set by -benchmark command line arguments)
+extern AutoConVarBool engine_benchmark;
+extern AutoConVarBool engine_benchmark_cpu_only;
+extern AutoConVarString engine_benchmark_camera_path;
+extern AutoConVarString engine_benchmark_output;
+extern AutoConVarInt engine_benchmark_frames;
+extern AutoConVarInt engine_benchmark_warmup_frames;
+extern AutoConVarFloat engine_benchmark_timestep;
@@ -3,6 +3,8 @@
 #include "UI.h"
 #include "Rendering/Renderer.h"
 #include "Rendering/GlobalBufferCache.h"
+#include "Renderers/HiZ.h"
+#include "Renderers/DefferedLightingRenderer.h"
 #include "Core/Variables.h"
 
 // Test reflection and serialized types
@@ -127,6 +129,13 @@ void DebugPanel::renderImGui(EditorContext &context)
 		UI::convar(render_lighting_only.getDescription());
 		UI::convar(render_culling_freeze.getDescription());
 		UI::convar(render_culling_hiz_debug.getDescription());
+		if (ImGui::Button("Validate HiZ"))
+			HiZ::requestValidation();
+		UI::convar(render_lighting_tiled.getDescription());
+		ImGui::BeginDisabled(!render_lighting_tiled);
+		if (ImGui::Button("Validate Tiled Light Binning"))
+			DefferedLightingRenderer::requestTiledValidation();
+		ImGui::EndDisabled();
 		UI::convar(render_meshlets_bvh_visualize.getDescription());
 		ImGui::BeginDisabled(!render_meshlets_bvh_visualize);
 		UI::convar(render_meshlets_bvh_visualize_depth.getDescription());
@@ -156,10 +165,14 @@ void DebugPanel::renderImGui(EditorContext &context)
 			ImGui::SeparatorText("Streaming");
 			float resident_fraction = s.total_groups > 0 ? (float)s.resident_groups / s.total_groups : 0.0f;
 			UI::text("Resident Groups", "%u / %u (%.1f%%)", s.resident_groups, s.total_groups, resident_fraction * 100.0f);
+			UI::text("Resident / Budget", "%.1f / %.0f MB", toMB(s.resident_bytes), toMB(s.budget_bytes));
 			UI::text("Meshes Registered", "%u", s.registered_mesh_count);
 			UI::text("Pending Loads", "%u", s.pending_load_queue_size);
 			UI::text("Pending Frees", "%u", s.pending_frees_count);
 
+			UI::convar(render_streaming_budget_mb.getDescription());
+			UI::convar(render_streaming_stale_age.getDescription());
+
 			ImGui::SeparatorText("This Frame");
 			UI::text("Loads", "%u (%.2f MB)", s.loads_last_frame, toMB(s.bytes_loaded_last_frame));
 			UI::text("Unloads", "%u (%.2f MB)", s.unloads_last_frame, toMB(s.bytes_unloaded_last_frame));
@@ -171,6 +184,42 @@ void DebugPanel::renderImGui(EditorContext &context)
 		UI::endSection();
 	}
 
+	if (texture_streaming && UI::beginSection("Texture Streaming"))
+	{
+		auto toMB = [](uint64_t bytes) { return bytes / (1024.0f * 1024.0f); };
+
+		const auto &s = texture_streaming->getStats();
+		UI::text("Textures", "%u", s.streamed_textures);
+		UI::text("Resident / Budget", "%.1f / %.0f MB", toMB(s.resident_bytes), toMB(s.budget_bytes));
+		UI::text("All Mips", "%.1f MB", toMB(s.all_mips_bytes));
+		UI::text("Sources Mapped / Heap", "%.1f / %.1f MB", toMB(s.source_mapped_bytes), toMB(s.source_heap_bytes));
+		UI::text("Pending Releases", "%u", s.pending_releases);
+
+		UI::convar(render_streaming_texture_budget_mb.getDescription());
+
+		ImGui::SeparatorText("This Frame");
+		UI::text("Upgrades", "%u", s.upgrades_last_frame);
+		UI::text("Downgrades", "%u", s.downgrades_last_frame);
+		UI::text("Uploaded", "%.2f MB", toMB(s.bytes_uploaded_last_frame));
+
+		ImGui::SeparatorText("Cumulative");
+		UI::text("Upgrades", "%llu", s.total_upgrades);
+		UI::text("Downgrades", "%llu", s.total_downgrades);
+		UI::text("Uploaded", "%.1f MB", toMB(s.total_bytes_uploaded));
+		UI::endSection();
+	}
+
+	if (shadow_renderer && UI::beginSection("Shadow Cache"))
+	{
+		const auto &s = shadow_renderer->getStats();
+		UI::text("Views Rendered", "%u", s.views_rendered);
+		UI::text("Views Composited", "%u", s.views_composited);
+		UI::text("Views Skipped", "%u", s.views_skipped);
+		UI::text("Views Deferred", "%u", s.views_deferred);
+		UI::text("Stale Lights", "%u", s.stale_lights);
+		UI::endSection();
+	}
+
 	if (UI::beginSection("Debug Info"))
 	{
 		auto info = Renderer::getDebugInfo();
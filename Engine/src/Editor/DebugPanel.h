@@ -4,6 +4,8 @@
 #include "imgui.h"
 #include "ImGuizmo.h"
 #include "Rendering/GeometryStreaming.h"
+#include "Rendering/TextureStreaming.h"
+#include "Renderers/ShadowRenderer.h"
 #include "MitsubaBridge.h"
 
 class DebugPanel
@@ -13,5 +15,7 @@ public:
 
 	DebugRenderer *debug_renderer;
 	GeometryStreaming *geometry_streaming;
+	TextureStreaming *texture_streaming;
+	ShadowRenderer *shadow_renderer;
 	MitsubaBridge *mitsuba_bridge;
 };
@@ -2,11 +2,149 @@
 #include "HierarchyPanel.h"
 #include "imgui.h"
 #include "imgui/IconsFontAwesome6.h"
+#include "Scene/Prefab.h"
+#include "Assets/AssetManager.h"
+
+static const char *displayName(const TransformComponent &transform)
+{
+	return transform.name.empty() ? "(Empty)" : transform.name.c_str();
+}
+
+// Pattern is lower case
+static bool containsCaseInsensitive(const char *text, const eastl::string &pattern)
+{
+	for (; *text; text++)
+	{
+		size_t i = 0;
+		while (i < pattern.size() && text[i] && (char)tolower((unsigned char)text[i]) == pattern[i])
+			i++;
+		if (i == pattern.size())
+			return true;
+	}
+	return pattern.empty();
+}
+
+void HierarchyPanel::rebuild_tree(Scene *scene)
+{
+	PROFILE_CPU_FUNCTION();
+	auto view = scene->getEntitiesWith<TransformComponent>();
+	tree.clear();
+	tree.reserve(view.size());
+
+	// Depth first without recursion, imported scenes can be deep
+	struct StackEntry
+	{
+		entt::entity entity;
+		uint32_t depth;
+	};
+	eastl::vector<StackEntry> stack;
+	eastl::vector<uint32_t> open_items;
+	eastl::hash_set<entt::entity> expanded;
+
+	for (entt::entity root : view)
+	{
+		if (view.get<TransformComponent>(root).parent != entt::null)
+			continue;
+
+		stack.push_back({root, 0});
+		while (!stack.empty())
+		{
+			StackEntry entry = stack.back();
+			stack.pop_back();
+
+			// Items at the same depth or deeper have no more descendants
+			while (!open_items.empty() && tree[open_items.back()].depth >= entry.depth)
+			{
+				tree[open_items.back()].subtree_end = tree.size();
+				open_items.pop_back();
+			}
+
+			bool is_expanded = expanded_entities.find(entry.entity) != expanded_entities.end();
+			if (is_expanded)
+				expanded.insert(entry.entity);
+			open_items.push_back(tree.size());
+			tree.push_back({entry.entity, entry.depth, 0, is_expanded});
+
+			const eastl::vector<entt::entity> &children = view.get<TransformComponent>(entry.entity).children;
+			for (size_t i = children.size(); i > 0; i--)
+				stack.push_back({children[i - 1], entry.depth + 1});
+		}
+	}
+	for (uint32_t item : open_items)
+		tree[item].subtree_end = tree.size();
+
+	// Destroyed entities are forgotten
+	expanded_entities = eastl::move(expanded);
+	tree_version = scene->getHierarchyVersion();
+
+	rows.clear();
+	append_rows(0, tree.size(), rows);
+}
+
+void HierarchyPanel::append_rows(uint32_t begin, uint32_t end, eastl::vector<uint32_t> &out) const
+{
+	for (uint32_t i = begin; i < end;)
+	{
+		out.push_back(i);
+		i = tree[i].is_expanded ? i + 1 : tree[i].subtree_end;
+	}
+}
+
+void HierarchyPanel::set_expanded(uint32_t row, bool is_expanded)
+{
+	uint32_t index = rows[row];
+	TreeItem &item = tree[index];
+	if (item.is_expanded == is_expanded)
+		return;
+	item.is_expanded = is_expanded;
+
+	// Only rows of the subtree change, the rest of the list stays
+	if (is_expanded)
+	{
+		expanded_entities.insert(item.entity);
+		eastl::vector<uint32_t> subtree_rows;
+		append_rows(index + 1, item.subtree_end, subtree_rows);
+		rows.insert(rows.begin() + row + 1, subtree_rows.begin(), subtree_rows.end());
+	} else
+	{
+		expanded_entities.erase(item.entity);
+		auto subtree_rows_end = eastl::lower_bound(rows.begin() + row + 1, rows.end(), item.subtree_end);
+		rows.erase(rows.begin() + row + 1, subtree_rows_end);
+	}
+}
+
+void HierarchyPanel::rebuild_filtered_rows(Scene *scene)
+{
+	PROFILE_CPU_FUNCTION();
+	auto view = scene->getEntitiesWith<TransformComponent>();
+	filtered_rows.clear();
+	for (uint32_t i = 0; i < tree.size(); i++)
+	{
+		if (containsCaseInsensitive(displayName(view.get<TransformComponent>(tree[i].entity)), filter))
+			filtered_rows.push_back(i);
+	}
+}
 
 void HierarchyPanel::renderImGui(EditorContext &context)
 {
 	ImGui::Begin((eastl::string(ICON_FA_LIST_UL) + " Hierarchy###Hierarchy").c_str());
-	auto view = Scene::getCurrentScene()->getEntitiesWith<TransformComponent>();
+	Scene *scene = Scene::getCurrentScene();
+	auto view = scene->getEntitiesWith<TransformComponent>();
+
+	if (tree_version != scene->getHierarchyVersion())
+		rebuild_tree(scene);
+
+	ImGui::SetNextItemWidth(-FLT_MIN);
+	ImGui::InputTextWithHint("##filter", ICON_FA_MAGNIFYING_GLASS " Filter", filter_buf, sizeof(filter_buf));
+	eastl::string new_filter = filter_buf;
+	new_filter.make_lower();
+	if (new_filter != filter || filter_version != tree_version)
+	{
+		filter = new_filter;
+		filter_version = tree_version;
+		if (!filter.empty())
+			rebuild_filtered_rows(scene);
+	}
 
 	auto is_selected = [&](entt::entity entity)
 	{
@@ -20,29 +158,14 @@ void HierarchyPanel::renderImGui(EditorContext &context)
 
 	auto select_range = [&](entt::entity clicked)
 	{
-		// Flat list for shift selection
-		eastl::vector<entt::entity> flat_list;
-		eastl::function<void(entt::entity)> build_flat = [&](entt::entity id)
-		{
-			flat_list.push_back(id);
-			for (entt::entity child_id : view.get<TransformComponent>(id).children)
-				build_flat(child_id);
-		};
-
-		for (entt::entity entity : view)
-		{
-			if (view.get<TransformComponent>(entity).parent == entt::null)
-				build_flat(entity);
-		}
-
-
+		// Tree order for shift selection, collapsed entities included
 		entt::entity begin = (start_entity != entt::null) ? start_entity : clicked;
 		int begin_id = -1, end_id = -1;
-		for (int i = 0; i < flat_list.size(); i++)
+		for (int i = 0; i < tree.size(); i++)
 		{
-			if (flat_list[i] == begin)
+			if (tree[i].entity == begin)
 				begin_id = i;
-			if (flat_list[i] == clicked)
+			if (tree[i].entity == clicked)
 				end_id = i;
 		}
 		if (begin_id == -1 || end_id == -1)
@@ -52,7 +175,7 @@ void HierarchyPanel::renderImGui(EditorContext &context)
 
 		context.selected_entities.clear();
 		for (int i = begin_id; i <= end_id; i++)
-			context.selected_entities.push_back(flat_list[i]);
+			context.selected_entities.push_back(tree[i].entity);
 	};
 
 	auto toggle_selected = [&](entt::entity entity)
@@ -69,83 +192,107 @@ void HierarchyPanel::renderImGui(EditorContext &context)
 	};
 
 	eastl::vector<entt::entity> entities_to_delete;
-	eastl::function<void(TransformComponent &transform)> add_entity_tree = [&](TransformComponent &transform)
+	int toggled_row = -1;
+	bool is_filtered = !filter.empty();
+	const eastl::vector<uint32_t> &shown_rows = is_filtered ? filtered_rows : rows;
+
+	// Only visible rows are submitted, filtered rows are shown flat
+	ImGui::BeginChild("##rows", ImVec2(0, -ImGui::GetFrameHeightWithSpacing()));
+	ImGuiListClipper clipper;
+	clipper.Begin((int)shown_rows.size());
+	while (clipper.Step())
 	{
+		for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; row++)
+		{
+			uint32_t index = shown_rows[row];
+			const TreeItem &item = tree[index];
+			TransformComponent &transform = view.get<TransformComponent>(item.entity);
+			bool is_leaf = is_filtered || item.subtree_end == index + 1;
 
-		ImGui::PushID((int)transform.owner);
-		ImGuiTreeNodeFlags flags = ImGuiTreeNodeFlags_SpanFullWidth | ImGuiTreeNodeFlags_SpanAvailWidth;
+			ImGui::PushID((int)item.entity);
+			ImGuiTreeNodeFlags flags = ImGuiTreeNodeFlags_SpanFullWidth | ImGuiTreeNodeFlags_SpanAvailWidth | ImGuiTreeNodeFlags_NoTreePushOnOpen;
 
-		// Collapsable or not
-		flags |= transform.children.empty() ? ImGuiTreeNodeFlags_Leaf : ImGuiTreeNodeFlags_OpenOnArrow;
-		// Highlighted or not
-		flags |= is_selected(transform.owner) ? ImGuiTreeNodeFlags_Selected : 0;
+			// Collapsable or not
+			flags |= is_leaf ? ImGuiTreeNodeFlags_Leaf : ImGuiTreeNodeFlags_OpenOnArrow;
+			// Highlighted or not
+			flags |= is_selected(item.entity) ? ImGuiTreeNodeFlags_Selected : 0;
 
-		eastl::string name = transform.name;
-		if (name.empty())
-			name = "(Empty)";
+			if (!is_filtered)
+				ImGui::SetCursorPosX(ImGui::GetCursorPosX() + item.depth * ImGui::GetStyle().IndentSpacing);
+			if (!is_leaf)
+				ImGui::SetNextItemOpen(item.is_expanded);
+			ImGui::TreeNodeEx((void *)(uintptr_t)item.entity, flags, "%s", displayName(transform));
 
-		bool opened = ImGui::TreeNodeEx(&transform.owner, flags, name.c_str());
+			if (!is_leaf && ImGui::IsItemToggledOpen())
+				toggled_row = row;
 
-		if (ImGui::IsItemClicked() && !ImGui::IsItemToggledOpen())
-		{
-			ImGuiIO &io = ImGui::GetIO();
-			if (io.KeyShift)
-			{
-				select_range(transform.owner);
-			} else if (io.KeyCtrl)
-			{
-				toggle_selected(transform.owner);
-				start_entity = transform.owner;
-			} else
+			if (ImGui::IsItemClicked() && !ImGui::IsItemToggledOpen())
 			{
-				context.selected_entities.clear();
-				context.selected_entities.push_back(transform.owner);
-				start_entity = transform.owner;
+				ImGuiIO &io = ImGui::GetIO();
+				if (io.KeyShift)
+				{
+					select_range(item.entity);
+				} else if (io.KeyCtrl)
+				{
+					toggle_selected(item.entity);
+					start_entity = item.entity;
+				} else
+				{
+					context.selected_entities.clear();
+					context.selected_entities.push_back(item.entity);
+					start_entity = item.entity;
+				}
+				context.selected_entity = Entity(item.entity);
+				context.selection_type = EditorSelectionType::Entity;
 			}
-			context.selected_entity = Entity(transform.owner);
-			context.selection_type = EditorSelectionType::Entity;
-		}
 
-		if (ImGui::BeginPopupContextItem())
-		{
-			if (ImGui::MenuItem("Remove"))
+			if (ImGui::BeginPopupContextItem())
 			{
-				if (is_selected(transform.owner))
+				if (ImGui::MenuItem("Remove"))
 				{
-					for (entt::entity id : context.selected_entities)
-						entities_to_delete.push_back(id);
-				} else
+					if (is_selected(item.entity))
+					{
+						for (entt::entity id : context.selected_entities)
+							entities_to_delete.push_back(id);
+					} else
+					{
+						entities_to_delete.push_back(item.entity);
+					}
+				}
+				if (ImGui::MenuItem("Save as Prefab"))
 				{
-					entities_to_delete.push_back(transform.owner);
+					std::filesystem::path path;
+					for (int index = 0; path.empty() || std::filesystem::exists(path); index++)
+						path = AssetManager::getAssetsRoot() / fmt::format("{}{}.prefab", transform.name.empty() ? "Prefab" : transform.name.c_str(), index > 0 ? std::to_string(index) : "");
+
+					Prefab::createFromEntity(Entity(item.entity))->save(path);
+					AssetManager::getOrCreateMetadata(path);
+					context.selected_path = path;
+					context.selection_type = EditorSelectionType::Asset;
 				}
+				ImGui::EndPopup();
 			}
-			ImGui::EndPopup();
+			ImGui::PopID();
 		}
-
-		if (opened)
-		{
-			for (entt::entity child_id : transform.children)
-				add_entity_tree(view.get<TransformComponent>(child_id));
-			ImGui::TreePop();
-		}
-		ImGui::PopID();
-	};
-
-	for (entt::entity entity : view)
-	{
-		TransformComponent &transform = view.get<TransformComponent>(entity);
-		if (transform.parent == entt::null)
-			add_entity_tree(transform);
 	}
+	ImGui::EndChild();
+
+	// Rows change after the clipper is done with them
+	if (toggled_row != -1)
+		set_expanded(toggled_row, !tree[rows[toggled_row]].is_expanded);
 
-	if (ImGui::IsWindowFocused() && ImGui::IsKeyPressed(ImGuiKey_Delete))
+	if (ImGui::IsWindowFocused(ImGuiFocusedFlags_ChildWindows) && ImGui::IsKeyPressed(ImGuiKey_Delete))
 	{
 		for (entt::entity id : context.selected_entities)
 			entities_to_delete.push_back(id);
 	}
 
+	// Children are destroyed with their parents, they can be selected too
 	for (entt::entity entity_id : entities_to_delete)
-		Scene::getCurrentScene()->destroyEntity(entity_id);
+	{
+		if (Entity(entity_id))
+			scene->destroyEntity(entity_id);
+	}
 
 	if (!entities_to_delete.empty())
 	{
@@ -155,7 +302,7 @@ void HierarchyPanel::renderImGui(EditorContext &context)
 	}
 
 	if (ImGui::Button(ICON_FA_PLUS " Create Entity", ImVec2(-FLT_MIN, 0)))
-		Scene::getCurrentScene()->createEntity("New Entity");
+		scene->createEntity("New Entity");
 
 	ImGui::End();
 }
@@ -9,5 +9,30 @@ public:
 	void renderImGui(EditorContext &context);
 
 private:
+	// Entities in tree order, rebuilt only when the scene hierarchy version changes
+	struct TreeItem
+	{
+		entt::entity entity;
+		uint32_t depth;
+		uint32_t subtree_end; // index after the last descendant
+		bool is_expanded;
+	};
+
+	void rebuild_tree(Scene *scene);
+	// Rows of the expanded items in [begin, end), collapsed subtrees are skipped
+	void append_rows(uint32_t begin, uint32_t end, eastl::vector<uint32_t> &out) const;
+	void set_expanded(uint32_t row, bool is_expanded);
+	void rebuild_filtered_rows(Scene *scene);
+
+	eastl::vector<TreeItem> tree;
+	eastl::vector<uint32_t> rows; // tree indices shown without a filter
+	eastl::vector<uint32_t> filtered_rows;
+	eastl::hash_set<entt::entity> expanded_entities; // kept over rebuilds
+	uint32_t tree_version = 0;
+
+	char filter_buf[128] = {};
+	eastl::string filter; // lower case, filtered_rows are built for it
+	uint32_t filter_version = 0;
+
 	entt::entity start_entity = entt::null;
 };
@@ -5,8 +5,11 @@
 #include "Core/Variables.h"
 #include "imgui/ImGuiWrapper.h"
 #include "UI.h"
-#include "json.hpp"
-#include <fstream>
+
+MitsubaBridge::~MitsubaBridge()
+{
+	shutdown();
+}
 
 void MitsubaBridge::renderImGui(EditorContext &context)
 {
@@ -16,8 +19,24 @@ void MitsubaBridge::renderImGui(EditorContext &context)
 	UI::sliderFloat("Render Scale", &render_scale, 0.1f, 1.0f);
 	UI::sliderInt("Max Depth", &max_depth, 2, 16);
 
+	ImGui::BeginDisabled(isRunning());
 	if (ImGui::Button("Render (M)", ImVec2(-FLT_MIN, 0)))
 		runRender(context);
+	ImGui::EndDisabled();
+
+	if (isRunning())
+	{
+		if (job_state == JobState::Exporting)
+		{
+			uint32_t done = progress.meshes_done;
+			uint32_t count = progress.meshes_count;
+			eastl::string overlay = eastl::string().sprintf("Exporting meshes %u / %u", done, count);
+			ImGui::ProgressBar(count > 0 ? (float)done / count : 0.0f, ImVec2(-FLT_MIN, 0), overlay.c_str());
+		} else
+		{
+			ImGui::TextUnformatted("Rendering...");
+		}
+	}
 
 	if (!status.empty())
 		ImGui::TextUnformatted(status.c_str());
@@ -34,21 +53,55 @@ void MitsubaBridge::renderImGui(EditorContext &context)
 
 void MitsubaBridge::runRender(EditorContext &context)
 {
+	if (isRunning())
+		return;
+
 	std::filesystem::path directory = get_mitsuba_path();
 	std::filesystem::path scene_path = directory / "scene_export.json";
-	std::filesystem::path output_path = directory / "gt_output.png";
+	output_path = directory / "gt_output.png";
+
+	// Scene, assets and renderer settings are only read here, the job works with the copy
+	capture_scene(context);
+
+	job_state = JobState::Exporting;
+	job = std::thread([this, directory, scene_path]()
+	{
+		int threads_count = engine_mitsuba_export_threads;
+		if (!exporter.exportScene(scene_path, directory / "meshes", threads_count, &progress))
+		{
+			job_state = JobState::ExportFailed;
+			return;
+		}
+
+		job_state = JobState::Rendering;
+		job_state = launch_mitsuba(directory, scene_path, output_path) ? JobState::Finished : JobState::LaunchFailed;
+	});
+}
+
+void MitsubaBridge::update()
+{
+	JobState state = job_state;
+	if (!isRunning() || state == JobState::Exporting || state == JobState::Rendering)
+		return;
 
-	if (!export_scene(context, scene_path))
+	job.join();
+	// Meshes are released on the main thread, same as everywhere else
+	exporter.instances.clear();
+
+	const MitsubaExporter::Stats &stats = exporter.getStats();
+	eastl::string export_status = eastl::string().sprintf("%u instances of %u meshes, %u written, %u cached",
+														  stats.instances, stats.unique_meshes, stats.written_meshes, stats.cached_meshes);
+	if (state == JobState::ExportFailed)
 	{
 		status = "Export failed";
 		return;
 	}
-
-	if (!launch_mitsuba(scene_path, output_path))
+	if (state == JobState::LaunchFailed)
 	{
-		status = "Failed to launch Mitsuba";
+		status = "Failed to launch Mitsuba. Exported " + export_status;
 		return;
 	}
+	status = "Exported " + export_status;
 
 	TextureDescription description{};
 	description.format = FORMAT_R8G8B8A8_UNORM;
@@ -57,48 +110,12 @@ void MitsubaBridge::runRender(EditorContext &context)
 	result_texture->load(output_path.string().c_str());
 }
 
-static nlohmann::json mat4_to_json_transform(const glm::mat4 &m)
-{
-	nlohmann::json values = nlohmann::json::array();
-	for (int row = 0; row < 4; row++)
-		for (int col = 0; col < 4; col++)
-			values.push_back(m[col][row]);
-	return {{"type", "matrix"}, {"value", values}};
-}
-
-// Export in simplest binary format (.ply)
-static bool export_ply(const Engine::Mesh *mesh, const std::filesystem::path &path)
+void MitsubaBridge::shutdown()
 {
-	const eastl::vector<Engine::Vertex> &vertices = mesh->indexed->vertices;
-	const eastl::vector<uint32_t> &indices = mesh->indexed->indices;
-
-	std::ofstream file(path, std::ios::binary);
-	if (!file)
-		return false;
-
-	file << "ply\n";
-	file << "format binary_little_endian 1.0\n";
-	file << "element vertex " << vertices.size() << "\n";
-	file << "property float x\nproperty float y\nproperty float z\n";
-	file << "property float nx\nproperty float ny\nproperty float nz\n";
-	file << "property float u\nproperty float v\n";
-	file << "element face " << indices.size() / 3 << "\n";
-	file << "property list uchar int vertex_indices\n";
-	file << "end_header\n";
-
-	for (const Engine::Vertex &vertex : vertices)
-	{
-		float attributes[8] = {vertex.pos.x, vertex.pos.y, vertex.pos.z, vertex.normal.x, vertex.normal.y, vertex.normal.z, vertex.uv.x, vertex.uv.y};
-		file.write((char *)attributes, sizeof(attributes));
-	}
-	for (size_t i = 0; i + 2 < indices.size(); i += 3)
-	{
-		uint8_t count = 3;
-		uint32_t triangle[3] = {indices[i], indices[i + 1], indices[i + 2]};
-		file.write((char *)&count, 1);
-		file.write((char *)triangle, sizeof(triangle));
-	}
-	return true;
+	if (job.joinable())
+		job.join();
+	exporter.instances.clear();
+	result_texture = nullptr;
 }
 
 static nlohmann::json material_to_json_bsdf(Material *material)
@@ -189,7 +206,7 @@ static int write_lights(nlohmann::json &scene)
 	return count;
 }
 
-bool MitsubaBridge::export_scene(EditorContext &context, const std::filesystem::path &scene_path)
+void MitsubaBridge::capture_scene(EditorContext &context)
 {
 	Camera &cam = context.editor_camera;
 	glm::vec3 cam_pos = cam.getPosition();
@@ -226,14 +243,12 @@ bool MitsubaBridge::export_scene(EditorContext &context, const std::filesystem::
 	{
 		std::filesystem::path hdri_path = std::filesystem::absolute(AssetManager::getPath(GFXOPTIONS(sky).hdri));
 		glm::mat4 to_world = glm::rotate(glm::mat4(1), glm::radians(-90.0f), glm::vec3(0, 1, 0));
-		scene["environment"] = {{"type", "envmap"}, {"filename", hdri_path.generic_string()}, {"scale", GFXOPTIONS(sky).getIntensity()}, {"to_world", mat4_to_json_transform(to_world)}};
+		scene["environment"] = {{"type", "envmap"}, {"filename", hdri_path.generic_string()}, {"scale", GFXOPTIONS(sky).getIntensity()}, {"to_world", MitsubaExporter::toJsonTransform(to_world)}};
 	}
 
-	// Meshes
-	std::filesystem::path mesh_dir = scene_path.parent_path() / "meshes";
-	std::filesystem::create_directories(mesh_dir);
-
-	int exported = 0;
+	// Meshes, the job keeps them alive
+	exporter.scene = std::move(scene);
+	exporter.instances.clear();
 	int skipped = 0;
 	auto view = Scene::getCurrentScene()->getEntitiesWith<TransformComponent, MeshRendererComponent>();
 	for (entt::entity entity_id : view)
@@ -249,38 +264,21 @@ bool MitsubaBridge::export_scene(EditorContext &context, const std::filesystem::
 				continue;
 			}
 
-			std::filesystem::path ply_path = mesh_dir / ("mesh_" + std::to_string(exported) + ".ply");
-			if (!export_ply(mesh, ply_path))
-			{
-				skipped++;
-				continue;
-			}
-
-			Material *material = mesh_renderer.getMaterial(i);
-			glm::mat4 world = transform.getWorldTransform() * mesh->root_transform;
-			scene["mesh_" + std::to_string(exported)] = {
-				{"type", "ply"},
-				{"filename", ply_path.generic_string()},
-				{"to_world", mat4_to_json_transform(world)},
-				{"bsdf_json", material_to_json_bsdf(material)},
-			};
-			exported++;
+			MitsubaExporter::MeshInstance &instance = exporter.instances.push_back();
+			instance.mesh = mesh;
+			instance.model_guid = mesh_renderer.meshes[i].model_asset.guid;
+			instance.mesh_id = mesh_renderer.meshes[i].mesh_id;
+			instance.to_world = transform.getWorldTransform() * mesh->root_transform;
+			instance.bsdf = material_to_json_bsdf(mesh_renderer.getMaterial(i));
 		}
 	}
 
-	status = eastl::string("Exported ") + std::to_string(exported).c_str() + " meshes, " + std::to_string(lights).c_str() + " lights, skipped " + std::to_string(skipped).c_str();
-
-	std::ofstream file(scene_path);
-	if (!file)
-		return false;
-
-	file << scene.dump(1, '\t');
-	return true;
+	status = eastl::string("Captured ") + std::to_string(exporter.instances.size()).c_str() + " meshes, " + std::to_string(lights).c_str() + " lights, skipped " + std::to_string(skipped).c_str();
 }
 
-bool MitsubaBridge::launch_mitsuba(const std::filesystem::path &scene_path, const std::filesystem::path &output_path)
+bool MitsubaBridge::launch_mitsuba(const std::filesystem::path &directory, const std::filesystem::path &scene_path, const std::filesystem::path &output_path)
 {
-	std::filesystem::path script = get_mitsuba_path() / "render.py";
+	std::filesystem::path script = directory / "render.py";
 	if (!std::filesystem::exists(script))
 		return false;
 
@@ -1,22 +1,53 @@
 #pragma once
 #include <filesystem>
+#include <thread>
 #include "RHI/RHITexture.h"
+#include "MitsubaExporter.h"
 
 struct EditorContext;
 
+// Renders the current view with Mitsuba. Scene is captured on the main thread,
+// export and render run on a background job and the result is picked up in update
 class MitsubaBridge
 {
 public:
+	MitsubaBridge() = default;
+	~MitsubaBridge();
+	MitsubaBridge(const MitsubaBridge &) = delete;
+	MitsubaBridge &operator=(const MitsubaBridge &) = delete;
+
 	void renderImGui(EditorContext &context);
+	// Ignored while previous render is running
 	void runRender(EditorContext &context);
+	void update();
+	// Waits for the running job
+	void shutdown();
+
+	bool isRunning() const { return job.joinable(); }
+
 private:
-	bool export_scene(EditorContext &context, const std::filesystem::path &scene_path);
-	bool launch_mitsuba(const std::filesystem::path &scene_path, const std::filesystem::path &output_path);
+	enum class JobState
+	{
+		Exporting,
+		Rendering,
+		Finished,
+		ExportFailed,
+		LaunchFailed
+	};
+
+	void capture_scene(EditorContext &context);
+	static bool launch_mitsuba(const std::filesystem::path &directory, const std::filesystem::path &scene_path, const std::filesystem::path &output_path);
 	std::filesystem::path get_mitsuba_path();
 
 	RHITextureRef result_texture;
 	eastl::string status;
 
+	std::thread job;
+	std::atomic<JobState> job_state = JobState::Finished;
+	MitsubaExporter exporter; // Owned by the job while it runs
+	MitsubaExporter::Progress progress;
+	std::filesystem::path output_path;
+
 	float render_scale = 0.5f;
 	int max_depth = 8;
 };
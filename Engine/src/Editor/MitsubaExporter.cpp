@@ -0,0 +1,211 @@
+#include "pch.h"
+#include "MitsubaExporter.h"
+#include <fstream>
+#include <thread>
+
+namespace
+{
+constexpr size_t PLY_VERTEX_SIZE = 8 * sizeof(float);
+constexpr size_t PLY_FACE_SIZE = sizeof(uint8_t) + 3 * sizeof(uint32_t);
+
+struct UniqueMesh
+{
+	const Engine::Mesh *mesh = nullptr;
+	std::filesystem::path path;
+	bool is_written = false;
+	bool is_failed = false;
+};
+
+uint64_t hash_bytes(const uint8_t *data, size_t size)
+{
+	uint64_t hash = 0xCBF29CE484222325ull ^ size;
+	size_t i = 0;
+	for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t))
+	{
+		uint64_t word;
+		memcpy(&word, data + i, sizeof(word));
+		hash = (hash ^ (word * 0x9E3779B97F4A7C15ull)) * 0xFF51AFD7ED558CCDull;
+		hash ^= hash >> 32;
+	}
+	for (; i < size; i++)
+		hash = (hash ^ data[i]) * 0x100000001B3ull;
+	return hash;
+}
+
+bool write_file(const std::filesystem::path &path, const eastl::vector<uint8_t> &data)
+{
+	std::ofstream file(path, std::ios::binary);
+	if (!file)
+		return false;
+	file.write((const char *)data.data(), data.size());
+	return file.good();
+}
+}
+
+nlohmann::json MitsubaExporter::toJsonTransform(const glm::mat4 &matrix)
+{
+	nlohmann::json values = nlohmann::json::array();
+	for (int row = 0; row < 4; row++)
+		for (int col = 0; col < 4; col++)
+			values.push_back(matrix[col][row]);
+	return {{"type", "matrix"}, {"value", values}};
+}
+
+bool MitsubaExporter::exportScene(const std::filesystem::path &scene_path, const std::filesystem::path &mesh_directory, int threads_count, Progress *progress)
+{
+	PROFILE_CPU_FUNCTION();
+
+	stats = {};
+	stats.instances = (uint32_t)instances.size();
+
+	std::error_code error;
+	std::filesystem::create_directories(mesh_directory, error);
+
+	// Instances of the same mesh are written once, meshes without asset are keyed by pointer
+	eastl::vector<UniqueMesh> unique_meshes;
+	eastl::vector<uint32_t> instance_unique_index(instances.size());
+	eastl::map<eastl::pair<uint64_t, uint64_t>, uint32_t> unique_indices;
+	for (size_t i = 0; i < instances.size(); i++)
+	{
+		const MeshInstance &instance = instances[i];
+		eastl::pair<uint64_t, uint64_t> key(0, (uintptr_t)instance.mesh.getReference());
+		if (instance.model_guid.isValid())
+			key = {instance.model_guid, instance.mesh_id};
+
+		auto it = unique_indices.find(key);
+		if (it == unique_indices.end())
+		{
+			it = unique_indices.insert({key, (uint32_t)unique_meshes.size()}).first;
+			unique_meshes.push_back({instance.mesh.getReference()});
+		}
+		instance_unique_index[i] = it->second;
+	}
+
+	if (progress)
+	{
+		progress->meshes_done = 0;
+		progress->meshes_count = (uint32_t)unique_meshes.size();
+	}
+
+	// Files are named by content, existing file of the right size was written by a previous export.
+	// Different meshes with the same content end up with the same name, each writes its own temp file
+	std::atomic<size_t> next_index = 0;
+	auto worker = [&]()
+	{
+		eastl::vector<uint8_t> data;
+		while (true)
+		{
+			size_t index = next_index.fetch_add(1);
+			if (index >= unique_meshes.size())
+				break;
+
+			UniqueMesh &unique_mesh = unique_meshes[index];
+			buildPly(unique_mesh.mesh, data);
+			uint64_t hash = hash_bytes(data.data(), data.size());
+			unique_mesh.path = mesh_directory / fmt::format("mesh_{:016x}.ply", hash);
+
+			std::error_code file_error;
+			uintmax_t existing_size = std::filesystem::file_size(unique_mesh.path, file_error);
+			if (file_error || existing_size != data.size())
+			{
+				std::filesystem::path temp_path = unique_mesh.path;
+				temp_path += ".tmp" + std::to_string(index);
+				if (write_file(temp_path, data))
+				{
+					std::filesystem::rename(temp_path, unique_mesh.path, file_error);
+					unique_mesh.is_written = !file_error;
+				}
+				unique_mesh.is_failed = !unique_mesh.is_written;
+				if (unique_mesh.is_failed)
+					std::filesystem::remove(temp_path, file_error);
+			}
+
+			if (progress)
+				progress->meshes_done.fetch_add(1);
+		}
+	};
+
+	if (threads_count <= 0)
+		threads_count = std::max(1u, std::thread::hardware_concurrency());
+	threads_count = eastl::min(threads_count, (int)unique_meshes.size());
+
+	eastl::vector<std::thread> threads(eastl::max(threads_count - 1, 0));
+	for (auto &t : threads)
+		t = std::thread(worker);
+	worker(); // current thread also executes
+
+	for (auto &t : threads)
+		t.join();
+
+	eastl::hash_set<eastl::string> unique_paths;
+	for (const UniqueMesh &unique_mesh : unique_meshes)
+	{
+		if (unique_mesh.is_failed)
+		{
+			CORE_ERROR("Mitsuba export: can't write {}", unique_mesh.path.string());
+			return false;
+		}
+		if (!unique_paths.insert(unique_mesh.path.generic_string().c_str()).second)
+			continue;
+		if (unique_mesh.is_written)
+			stats.written_meshes++;
+		else
+			stats.cached_meshes++;
+	}
+	stats.unique_meshes = (uint32_t)unique_paths.size();
+
+	nlohmann::json scene_json = scene;
+	for (size_t i = 0; i < instances.size(); i++)
+	{
+		scene_json["mesh_" + std::to_string(i)] = {
+			{"type", "ply"},
+			{"filename", unique_meshes[instance_unique_index[i]].path.generic_string()},
+			{"to_world", toJsonTransform(instances[i].to_world)},
+			{"bsdf_json", instances[i].bsdf},
+		};
+	}
+
+	std::ofstream file(scene_path);
+	if (!file)
+		return false;
+
+	file << scene_json.dump(1, '\t');
+	return file.good();
+}
+
+void MitsubaExporter::buildPly(const Engine::Mesh *mesh, eastl::vector<uint8_t> &data)
+{
+	const eastl::vector<Engine::Vertex> &vertices = mesh->indexed->vertices;
+	const eastl::vector<uint32_t> &indices = mesh->indexed->indices;
+	size_t faces_count = indices.size() / 3;
+
+	std::string header = fmt::format(
+		"ply\n"
+		"format binary_little_endian 1.0\n"
+		"element vertex {}\n"
+		"property float x\nproperty float y\nproperty float z\n"
+		"property float nx\nproperty float ny\nproperty float nz\n"
+		"property float u\nproperty float v\n"
+		"element face {}\n"
+		"property list uchar int vertex_indices\n"
+		"end_header\n", vertices.size(), faces_count);
+
+	data.resize(header.size() + vertices.size() * PLY_VERTEX_SIZE + faces_count * PLY_FACE_SIZE);
+	uint8_t *output = data.data();
+	memcpy(output, header.data(), header.size());
+	output += header.size();
+
+	for (const Engine::Vertex &vertex : vertices)
+	{
+		float attributes[8] = {vertex.pos.x, vertex.pos.y, vertex.pos.z, vertex.normal.x, vertex.normal.y, vertex.normal.z, vertex.uv.x, vertex.uv.y};
+		memcpy(output, attributes, PLY_VERTEX_SIZE);
+		output += PLY_VERTEX_SIZE;
+	}
+
+	for (size_t i = 0; i < faces_count; i++)
+	{
+		*output = 3;
+		memcpy(output + 1, &indices[i * 3], 3 * sizeof(uint32_t));
+		output += PLY_FACE_SIZE;
+	}
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <atomic>
+#include <filesystem>
+#include "Rendering/Mesh.h"
+#include "json.hpp"
+
+// Writes a Mitsuba scene from a snapshot that is taken on the main thread, so it can run on a background
+// thread and without editor or GPU. Meshes are written as binary .ply in parallel, once per distinct content:
+// instances of a mesh (same model GUID and mesh id) share a file and files are named by content hash,
+// so meshes that didn't change since the previous export are not written again.
+class MitsubaExporter
+{
+public:
+	struct MeshInstance
+	{
+		Ref<Engine::Mesh> mesh;
+		Engine::GUID model_guid; // 0 for meshes that are not from a model asset, then the mesh itself is the key
+		size_t mesh_id = 0;
+		glm::mat4 to_world = glm::mat4(1.0f);
+		nlohmann::json bsdf;
+	};
+
+	struct Progress
+	{
+		std::atomic<uint32_t> meshes_done{0};
+		std::atomic<uint32_t> meshes_count{0};
+	};
+
+	struct Stats
+	{
+		uint32_t instances = 0;
+		uint32_t unique_meshes = 0;
+		uint32_t written_meshes = 0;
+		uint32_t cached_meshes = 0;
+	};
+
+	// Everything but meshes: integrator, sensor, lights, environment
+	nlohmann::json scene;
+	eastl::vector<MeshInstance> instances;
+
+	// threads_count 0 - all cores. Progress is optional and can be read from other threads
+	bool exportScene(const std::filesystem::path &scene_path, const std::filesystem::path &mesh_directory, int threads_count, Progress *progress = nullptr);
+	const Stats &getStats() const { return stats; }
+
+	static nlohmann::json toJsonTransform(const glm::mat4 &matrix);
+
+	// Whole file is built in memory: header, then x y z nx ny nz u v per vertex, then faces
+	static void buildPly(const Engine::Mesh *mesh, eastl::vector<uint8_t> &data);
+
+private:
+	Stats stats;
+};
@@ -4,6 +4,7 @@
 #include "Rendering/Model.h"
 #include "imgui/ImGuiWrapper.h"
 #include "Scene/Components.h"
+#include "Scene/Prefab.h"
 #include "AssetBrowserPanel.h"
 
 static eastl::string componentTitle(const char *type_name)
@@ -159,6 +160,14 @@ bool ParametersPanel::renderImGui(EditorContext &context, DebugRenderer &debug_r
 			}
 		});
 
+		drawComponent<PrefabInstanceComponent>(entity, [&](PrefabInstanceComponent &prefab_instance) {
+			if (UI::drawStruct(prefab_instance))
+				entity.markDirty(DIRTY_RENDER_STATE);
+
+			if (Prefab *prefab = prefab_instance.getPrefab())
+				UI::text("Parts", "%u in %u nodes", (uint32_t)prefab->getParts().size(), (uint32_t)prefab->nodes.size());
+		});
+
 		drawComponent<LightComponent>(entity, [](LightComponent &light) {
 			UI::drawStruct(light);
 
@@ -8,6 +8,7 @@
 #include "Application.h"
 #include "Rendering/Model.h"
 #include "Assets/AssetManager.h"
+#include "Scene/Prefab.h"
 
 static void drawStatsBar(float delta_time, ImVec2 pos)
 {
@@ -52,6 +53,111 @@ static void drawStatsBar(float delta_time, ImVec2 pos)
 	ImGui::End();
 }
 
+// Closest hit with the mesh triangles (meshlet meshes are tested against their ray tracing proxy).
+// Direction is not normalized in mesh space, so distances stay in world units
+static bool intersectMeshTriangles(Engine::Mesh *mesh, glm::vec3 local_origin, glm::vec3 local_direction, float &distance)
+{
+	const Engine::IndexedGeometry *geometry = mesh ? mesh->getRayTracingGeometry() : nullptr;
+	if (!geometry)
+		return false;
+
+	// Moller-Trumbore, both faces
+	bool is_hit = false;
+	for (size_t i = 0; i + 2 < geometry->indices.size(); i += 3)
+	{
+		glm::vec3 p0 = geometry->vertices[geometry->indices[i]].pos;
+		glm::vec3 edge1 = glm::vec3(geometry->vertices[geometry->indices[i + 1]].pos) - p0;
+		glm::vec3 edge2 = glm::vec3(geometry->vertices[geometry->indices[i + 2]].pos) - p0;
+		glm::vec3 p = glm::cross(local_direction, edge2);
+		float determinant = glm::dot(edge1, p);
+		if (fabsf(determinant) < 1e-12f)
+			continue;
+
+		float inverse_determinant = 1.0f / determinant;
+		glm::vec3 s = local_origin - p0;
+		float u = glm::dot(s, p) * inverse_determinant;
+		if (u < 0.0f || u > 1.0f)
+			continue;
+		glm::vec3 q = glm::cross(s, edge1);
+		float v = glm::dot(local_direction, q) * inverse_determinant;
+		if (v < 0.0f || u + v > 1.0f)
+			continue;
+
+		float t = glm::dot(edge2, q) * inverse_determinant;
+		if (t > 0.0f && t < distance)
+		{
+			distance = t;
+			is_hit = true;
+		}
+	}
+	return is_hit;
+}
+
+static bool hasPickableMeshes(Entity entity)
+{
+	return entity.hasComponent<MeshRendererComponent>() || entity.hasComponent<PrefabInstanceComponent>();
+}
+
+// Closest hit with the triangles of the entity meshes or of its prefab parts
+static bool intersectEntityTriangles(Entity entity, glm::vec3 origin, glm::vec3 direction, float &distance)
+{
+	const glm::mat4 &inverse_transform = entity.getTransform().getInverseWorldTransform();
+	glm::vec3 local_origin = glm::vec3(inverse_transform * glm::vec4(origin, 1.0f));
+	glm::vec3 local_direction = glm::mat3(inverse_transform) * direction;
+
+	bool is_hit = false;
+	if (entity.hasComponent<PrefabInstanceComponent>())
+	{
+		PrefabInstanceComponent &prefab_instance = entity.getComponent<PrefabInstanceComponent>();
+		Prefab *prefab = prefab_instance.getPrefab();
+		for (uint32_t i = 0; prefab && i < prefab->getParts().size(); i++)
+		{
+			if (prefab_instance.isHidden(i))
+				continue;
+
+			const Prefab::Part &part = prefab->getParts()[i];
+			glm::vec3 part_origin = glm::vec3(part.inverse_transform * glm::vec4(local_origin, 1.0f));
+			glm::vec3 part_direction = glm::mat3(part.inverse_transform) * local_direction;
+			is_hit |= intersectMeshTriangles(prefab->getMesh(i), part_origin, part_direction, distance);
+		}
+		return is_hit;
+	}
+
+	for (MeshRendererComponent::MeshId &mesh_id : entity.getComponent<MeshRendererComponent>().meshes)
+		is_hit |= intersectMeshTriangles(mesh_id.getMesh(), local_origin, local_direction, distance);
+	return is_hit;
+}
+
+static entt::entity pickEntity(Scene *scene, glm::vec3 origin, glm::vec3 direction)
+{
+	PROFILE_CPU_FUNCTION();
+	direction = glm::normalize(direction);
+	eastl::vector<SceneSpatialIndex::RayHit> hits;
+	scene->getSpatialIndex().raycast(origin, direction, FLT_MAX, hits);
+
+	// Boxes are sorted by entry distance, no box further than the closest triangle can have a closer one
+	entt::entity picked = entt::null;
+	float picked_distance = FLT_MAX;
+	for (const SceneSpatialIndex::RayHit &hit : hits)
+	{
+		if (hit.distance >= picked_distance)
+			break;
+
+		Entity entity(hit.entity);
+		if (hasPickableMeshes(entity))
+		{
+			if (intersectEntityTriangles(entity, origin, direction, picked_distance))
+				picked = hit.entity;
+		} else
+		{
+			// Entities without meshes are picked by their box
+			picked = hit.entity;
+			picked_distance = hit.distance;
+		}
+	}
+	return picked;
+}
+
 bool ViewportPanel::renderImGui(EditorContext &context, float delta_time)
 {
 	ImGui::PushStyleVar(ImGuiStyleVar_WindowPadding, ImVec2(0, 0));
@@ -84,6 +190,7 @@ bool ViewportPanel::renderImGui(EditorContext &context, float delta_time)
 
 	if (viewport_texture)
 		ImGui::Image(ImGuiWrapper::getTextureId(viewport_texture), viewport_size);
+	bool is_viewport_clicked = ImGui::IsItemClicked(ImGuiMouseButton_Left);
 
 	Renderer::setOutputResolution({viewport_size.x, viewport_size.y});
 	context.editor_camera.setAspect(viewport_size.x / viewport_size.y);
@@ -128,13 +235,37 @@ bool ViewportPanel::renderImGui(EditorContext &context, float delta_time)
 		}
 	}
 
+	// Click without dragging picks, dragging rotates the camera
+	if (is_viewport_clicked && !ImGuizmo::IsOver())
+		is_picking = true;
+	if (is_picking && ImGui::IsMouseReleased(ImGuiMouseButton_Left))
+	{
+		is_picking = false;
+		Scene *scene = Scene::getCurrentScene();
+		if (scene && !ImGui::IsMouseDragPastThreshold(ImGuiMouseButton_Left))
+		{
+			ImVec2 mouse_pos = ImGui::GetMousePos();
+			glm::vec2 ndc = glm::vec2((mouse_pos.x - viewport_pos.x) / viewport_size.x, (mouse_pos.y - viewport_pos.y) / viewport_size.y) * 2.0f - 1.0f;
+			glm::vec4 target = glm::inverse(context.editor_camera.getViewProj()) * glm::vec4(ndc.x, -ndc.y, 0.5f, 1.0f);
+			glm::vec3 origin = context.editor_camera.getPosition();
+			entt::entity picked = pickEntity(scene, origin, glm::vec3(target) / target.w - origin);
+
+			context.selected_entities.clear();
+			if (picked != entt::null)
+				context.selected_entities.push_back(picked);
+			context.selected_entity = picked != entt::null ? Entity(picked) : Entity();
+			context.selection_type = EditorSelectionType::Entity;
+		}
+	}
+
 	if (ImGui::BeginDragDropTarget())
 	{
 		if (const ImGuiPayload *payload = ImGui::AcceptDragDropPayload("DND_ASSET_PATH", ImGuiDragDropFlags_AcceptPeekOnly))
 		{
 			const char *payload_str = (const char *)payload->Data;
 			eastl::string extension = std::filesystem::path(payload_str).extension().string().c_str();
-			if (AssetManager::findTypeInfoByExtension(extension) == AssetManager::getTypeInfo<Model>())
+			const AssetTypeInfo *type = AssetManager::findTypeInfoByExtension(extension);
+			if (type == AssetManager::getTypeInfo<Model>())
 			{
 				if (payload = ImGui::AcceptDragDropPayload("DND_ASSET_PATH"))
 				{
@@ -142,6 +273,14 @@ bool ViewportPanel::renderImGui(EditorContext &context, float delta_time)
 					Entity entity = model->createEntity(model);
 					entity.getTransform().setLocalScale(glm::vec3(0.01));
 				}
+			} else if (type == AssetManager::getTypeInfo<Prefab>())
+			{
+				if (payload = ImGui::AcceptDragDropPayload("DND_ASSET_PATH"))
+				{
+					std::filesystem::path path = payload_str;
+					Entity entity = Scene::getCurrentScene()->createEntity(path.stem().string().c_str());
+					entity.addComponent<PrefabInstanceComponent>().prefab_asset = AssetReference(path);
+				}
 			}
 		}
 		ImGui::EndDragDropTarget();
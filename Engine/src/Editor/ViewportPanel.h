@@ -12,4 +12,5 @@ public:
 	RHITextureRef viewport_texture;
 private:
 	ImGuizmo::OPERATION guizmo_tool_type = ImGuizmo::TRANSLATE;
+	bool is_picking = false;
 };
@@ -18,6 +18,9 @@
 #include "FrameGraph/FrameGraphRHIResources.h"
 #include "FrameGraph/FrameGraphUtils.h"
 #include "Physics/PhysXWrapper.h"
+#include "Core/Benchmark.h"
+#include "RHI/RHIUploadBatch.h"
+#include "Rendering/UploadManager.h"
 
 using namespace physx;
 
@@ -30,9 +33,40 @@ EditorApplication::EditorApplication(int argc, char *argv[]) : Application(argc,
 
 static const eastl::string scenes_directory = "assets/scenes/";
 
+static void set_benchmark_counters(const SceneRenderer &scene_renderer)
+{
+	constexpr double MB = 1024.0 * 1024.0;
+
+	const auto &geometry = scene_renderer.geometry_streaming.getStats();
+	Benchmark::setCounter("Geometry Resident MB", geometry.resident_bytes / MB);
+	Benchmark::setCounter("Geometry Loads", geometry.loads_last_frame);
+	Benchmark::setCounter("Geometry Unloads", geometry.unloads_last_frame);
+	Benchmark::setCounter("Geometry Pending Loads", geometry.pending_load_queue_size);
+
+	const auto &textures = scene_renderer.texture_streaming.getStats();
+	Benchmark::setCounter("Texture Resident MB", textures.resident_bytes / MB);
+	Benchmark::setCounter("Texture Upgrades", textures.upgrades_last_frame);
+	Benchmark::setCounter("Texture Downgrades", textures.downgrades_last_frame);
+	Benchmark::setCounter("Texture Uploaded MB", textures.bytes_uploaded_last_frame / MB);
+
+	const auto &uploads = RHIUploadBatch::getStats();
+	Benchmark::setCounter("Upload Frame Staged MB", gUploadManager->getStagedBytes() / MB);
+	Benchmark::setCounter("Upload Batch Submissions", uploads.total_submissions);
+	Benchmark::setCounter("Upload Batch Total MB", uploads.total_bytes / MB);
+	Benchmark::setCounter("Upload Batches In Flight", uploads.in_flight_batches);
+
+	// GPU culling results are not read back, shadow view caching is the CPU side of it
+	const auto &shadows = scene_renderer.shadow_renderer.getStats();
+	Benchmark::setCounter("Shadow Views Rendered", shadows.views_rendered);
+	Benchmark::setCounter("Shadow Views Composited", shadows.views_composited);
+	Benchmark::setCounter("Shadow Views Skipped", shadows.views_skipped);
+	Benchmark::setCounter("Draw Calls", Renderer::getDebugInfo().drawcalls);
+}
+
 void EditorApplication::init()
 {
 	shaders_watcher.addPath(L"shaders", true);
+	assets_watcher.addPath(AssetManager::getAssetsRoot().wstring().c_str(), true);
 
 	context.editor_camera = Camera(glm::vec3(0, 2, 0));
 	Renderer::setCamera(&context.editor_camera);
@@ -42,6 +76,8 @@ void EditorApplication::init()
 
 	debug_panel.debug_renderer = &scene_renderer->debug_renderer;
 	debug_panel.geometry_streaming = &scene_renderer->geometry_streaming;
+	debug_panel.texture_streaming = &scene_renderer->texture_streaming;
+	debug_panel.shadow_renderer = &scene_renderer->shadow_renderer;
 	debug_panel.mitsuba_bridge = &mitsuba_bridge;
 
 	asset_browser_panel.init();
@@ -64,24 +100,39 @@ void EditorApplication::openScene(const eastl::string &path)
 void EditorApplication::update(float delta_time)
 {
 	//ImGui::ShowDemoWindow();
-	bool is_window_focused = glfwGetWindowAttrib(window, GLFW_FOCUSED);
-	if (is_window_focused && !was_window_focused)
+	if (!Benchmark::isActive())
 	{
-		AssetManager::refresh();
-		asset_browser_panel.refreshCache();
+		assets_watcher.checkUpdates([this](const eastl::vector<FileWatcher::Change> &changes)
+		{
+			// Runtimes and the registry are written by the asset manager itself
+			bool has_source_changes = eastl::any_of(changes.begin(), changes.end(), [](const FileWatcher::Change &change)
+			{
+				return change.path.find(L".runtimes") == eastl::wstring::npos;
+			});
+			if (!has_source_changes)
+				return;
+
+			AssetManager::refresh();
+			asset_browser_panel.refreshCache();
+		});
 	}
-	was_window_focused = is_window_focused;
 
 	if (auto_refresh_shaders)
 	{
-		shaders_watcher.checkUpdates([](eastl::wstring path)
+		shaders_watcher.checkUpdates([](const eastl::vector<FileWatcher::Change> &changes)
 		{
-			auto all_shaders = RHIShader::getAllShadersAtPath(path);
-			for (RHIShader *shader : all_shaders)
+			for (const FileWatcher::Change &change : changes)
 			{
-				shader->recompile();
+				if (change.type == FileWatcher::ChangeType::Removed)
+					continue;
+
+				auto all_shaders = RHIShader::getAllShadersAtPath(change.path);
+				for (RHIShader *shader : all_shaders)
+				{
+					shader->recompile();
+				}
+				CORE_INFO("Shader recompiled {}", std::filesystem::path(change.path.c_str()).string());
 			}
-			CORE_INFO("Shader recompiled {}", std::filesystem::path(path.c_str()).string());
 		});
 	}
 
@@ -184,10 +235,14 @@ void EditorApplication::update(float delta_time)
 
 	if (ImGui::IsKeyPressed(ImGuiKey_M, false) && !ImGui::GetIO().WantTextInput)
 		mitsuba_bridge.runRender(context);
+	mitsuba_bridge.update();
 
 	viewport_panel.update();
 
-	if (!ImGuizmo::IsUsing() && is_viewport_focused)
+	if (Benchmark::isActive())
+	{
+		Benchmark::updateCamera(context.editor_camera);
+	} else if (!ImGuizmo::IsUsing() && is_viewport_focused)
 	{
 		double mouse_x, mouse_y;
 		glfwGetCursorPos(window, &mouse_x, &mouse_y);
@@ -217,10 +272,12 @@ void EditorApplication::update(float delta_time)
 	}
 
 
-	Scene::getCurrentScene()->physics_scene->draw_debug(&scene_renderer->debug_renderer);
 	if (is_play)
 	{
-		Scene::getCurrentScene()->updateRuntime();
+		Scene::getCurrentScene()->updateRuntime(delta_time, &scene_renderer->debug_renderer);
+	} else
+	{
+		Scene::getCurrentScene()->physics_scene->draw_debug(&scene_renderer->debug_renderer);
 	}
 }
 
@@ -262,6 +319,9 @@ void EditorApplication::recordCommands(RHICommandList *cmd_list)
 
 	auto current_cmd_list = gDynamicRHI->getCmdList();
 	frameGraph.execute(current_cmd_list);
+
+	if (Benchmark::isActive())
+		set_benchmark_counters(*scene_renderer);
 }
 
 void EditorApplication::cleanupResources()
@@ -274,5 +334,5 @@ void EditorApplication::cleanupResources()
 	scene_renderer = nullptr;
 	viewport_panel.viewport_texture = nullptr;
 	asset_browser_panel = {};
-	mitsuba_bridge = {};
+	mitsuba_bridge.shutdown();
 }
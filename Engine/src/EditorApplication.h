@@ -45,8 +45,8 @@ protected:
 	void cleanupResources() override;
 private:
 	bool auto_refresh_shaders = true;
-	bool was_window_focused = true;
 	FileWatcher shaders_watcher;
+	FileWatcher assets_watcher;
 
 	Ref<RayTracingScene> ray_tracing_scene;
 
@@ -1,6 +1,7 @@
 #include "pch.h"
 #include "FrameGraph.h"
 #include "Rendering/Renderer.h"
+#include "Core/Benchmark.h"
 
 void FrameGraph::compile()
 {
@@ -102,6 +103,7 @@ void FrameGraph::execute(RHICommandList *cmd_list)
 
 		PROFILE_CPU_SCOPE_VAR(pass.getName().c_str());
 		PROFILE_GPU_SCOPE_VAR(cmd_list, pass.getName().c_str());
+		Benchmark::Scope benchmark_scope(pass.getName().c_str());
 
 		for (const auto &id : pass.texture_creates)
 			getFrameGraphTexture(id)->create();
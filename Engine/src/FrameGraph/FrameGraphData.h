@@ -20,12 +20,14 @@
 #define GroupResidencyBuffer
 #define StreamRequestsBuffer
 #define GroupAgesBuffer
+#define GroupErrorsBuffer
+#define TextureFeedbackBuffer
 
 #define DispatchMeshIndirectArgs
 #define MeshletFixDispatchArgs
 #define InstanceFixDispatchArgs
-#define DrawIndexedArgs
-#define DrawIndexedCount
+#define MeshletDrawArgs
+#define MeshletDrawCount
 #define DrawCallsInstances
 
 #define TraditionalDrawArgs
@@ -40,6 +42,7 @@
 
 #define HiZTexture
 #define CascadeHiZ
+#define HiZAtomics
 
 #define SSAONoiseTexture
 #define SSAORaw
@@ -47,6 +50,7 @@
 
 #define DiffuseLight
 #define SpecularLight
+#define TiledLightLists
 
 #define SSR
 
@@ -70,6 +74,8 @@
 
 #define DebugLinesBuffer
 #define DebugLinesDrawArgsBuffer
+#define DebugPrimitivesBuffer
+#define DebugPrimitivesDrawArgsBuffer
 
 struct ShadowPasses
 {
@@ -52,7 +52,7 @@ public:
 
 
 	uint32_t getId() const { return id; }
-	eastl::string getName() const { return name; }
+	const eastl::string &getName() const { return name; }
 	uint32_t getRefCount() const { return ref_count; }
 
 private:
@@ -13,9 +13,11 @@ public:
 
 	FrameGraphTextureId readTexture(GraphicsResourceName texture);
 	FrameGraphTextureId readDepthTexture(GraphicsResourceName texture);
+	FrameGraphTextureId readCopyTexture(GraphicsResourceName texture);
 
 	FrameGraphTextureId writeTexture(GraphicsResourceName name);
 	FrameGraphTextureId writeUAVTexture(GraphicsResourceName name);
+	FrameGraphTextureId writeCopyTexture(GraphicsResourceName name);
 
 	FrameGraphBufferId writeBuffer(GraphicsResourceName name);
 	FrameGraphBufferId readBuffer(GraphicsResourceName name);
@@ -3,6 +3,7 @@
 #include "Scene/Scene.h"
 #include "Scene/Entity.h"
 #include "Scene/Components.h"
+#include "Core/Variables.h"
 
 using namespace physx;
 
@@ -15,39 +16,130 @@ PhysicsScene::PhysicsScene(Scene *scene)
 
 	scene_desc.cpuDispatcher = PhysXWrapper::getDispatcher();
 	scene_desc.filterShader = PxDefaultSimulationFilterShader;
+	scene_desc.flags |= PxSceneFlag::eENABLE_ACTIVE_ACTORS;
 	px_scene = PhysXWrapper::getPhysics()->createScene(scene_desc);
 }
 
 PhysicsScene::~PhysicsScene()
 {
+	// Scene can't be touched while step is in flight
+	if (is_simulating)
+		px_scene->fetchResults(true);
+
 	// TODO: revert
 	//PX_RELEASE(px_scene);
 }
 
-void PhysicsScene::simulate()
+void PhysicsScene::simulate(float delta_time, DebugRenderer *debug_renderer)
 {
-	px_scene->simulate(1.0 / 200.0f);
+	PROFILE_CPU_FUNCTION();
+
+	// Step kicked last frame had whole frame to run, usually it is already done here
+	if (is_simulating)
+		fetch_results();
+
+	const float fixed_step = glm::max(physics_fixed_timestep.get(), 0.001f);
+	const int max_steps = glm::max(physics_max_steps_per_frame.get(), 1);
+
+	// Clamp to avoid spiral of death after hitches
+	accumulator = glm::min(accumulator + delta_time, fixed_step * max_steps);
+
+	// Catch up synchronously if more than one step is due
+	while (accumulator >= fixed_step * 2.0f)
+	{
+		px_scene->simulate(fixed_step);
+		is_simulating = true;
+		fetch_results();
+		accumulator -= fixed_step;
+	}
+
+	// PhysX scene can't be read while the step below is in flight
+	if (debug_renderer)
+		draw_debug(debug_renderer);
+
+	// Last step runs in the background while the frame is rendered
+	if (accumulator >= fixed_step)
+	{
+		px_scene->simulate(fixed_step);
+		is_simulating = true;
+		accumulator -= fixed_step;
+	}
+
+	// Interpolate between the two last completed steps, by time left after the kicked step
+	write_interpolated_transforms(accumulator / fixed_step);
+}
+
+void PhysicsScene::fetch_results()
+{
+	PROFILE_CPU_FUNCTION();
 	px_scene->fetchResults(true);
+	is_simulating = false;
+	step_index++;
 
-	uint32_t nb_active_actors;
-	//PxActor **actors = px_scene->getActiveActors(nb_active_actors);
+	PxU32 nb_active_actors = 0;
+	PxActor **active_actors = px_scene->getActiveActors(nb_active_actors);
 
-	nb_active_actors = px_scene->getNbActors(PxActorTypeFlag::eRIGID_DYNAMIC | PxActorTypeFlag::eRIGID_STATIC);
-	PxArray<PxRigidActor *> actors(nb_active_actors);
-	px_scene->getActors(PxActorTypeFlag::eRIGID_DYNAMIC | PxActorTypeFlag::eRIGID_STATIC, reinterpret_cast<PxActor **>(&actors[0]), nb_active_actors);
-	for (int i = 0; i < nb_active_actors; i++)
+	for (PxU32 i = 0; i < nb_active_actors; i++)
 	{
-		TransformComponent *t = (TransformComponent *)actors[i]->userData;
-		PxRigidActor *actor = reinterpret_cast<PxRigidActor *>(actors[i]);
-		const PxTransform pose = actor->getGlobalPose();
-		
-		t->setPosition(fromPXVec(pose.p));
-		t->setLocalRotation(fromPXQuat(pose.q));
+		PxRigidActor *actor = static_cast<PxRigidActor *>(active_actors[i]);
+		BodyState &body = bodies[(uint32_t)(uintptr_t)actor->userData];
+		body.previous_pose = body.current_pose;
+		body.current_pose = actor->getGlobalPose();
+		body.last_active_step = step_index;
 	}
+
+	// Bodies which stopped moving still need their final pose written once
+	for (uint32_t body_index : moving_bodies)
+	{
+		BodyState &body = bodies[body_index];
+		if (body.last_active_step != step_index)
+		{
+			body.previous_pose = body.current_pose;
+			settled_bodies.push_back(body_index);
+		}
+	}
+
+	moving_bodies.clear();
+	for (PxU32 i = 0; i < nb_active_actors; i++)
+		moving_bodies.push_back((uint32_t)(uintptr_t)active_actors[i]->userData);
+}
+
+void PhysicsScene::write_interpolated_transforms(float alpha)
+{
+	PROFILE_CPU_FUNCTION();
+	alpha = glm::clamp(alpha, 0.0f, 1.0f);
+
+	eastl::vector<Scene::LocalTransformWrite> writes;
+	writes.reserve(moving_bodies.size() + settled_bodies.size());
+
+	for (uint32_t body_index : settled_bodies)
+	{
+		const BodyState &body = bodies[body_index];
+		writes.push_back({body.entity, fromPXVec(body.current_pose.p), fromPXQuat(body.current_pose.q)});
+	}
+	settled_bodies.clear();
+
+	for (uint32_t body_index : moving_bodies)
+	{
+		const BodyState &body = bodies[body_index];
+		glm::vec3 position = glm::mix(fromPXVec(body.previous_pose.p), fromPXVec(body.current_pose.p), alpha);
+		glm::quat rotation = glm::slerp(fromPXQuat(body.previous_pose.q), fromPXQuat(body.current_pose.q), alpha);
+		writes.push_back({body.entity, position, rotation});
+	}
+
+	scene->writeLocalTransforms(writes);
 }
 
 void PhysicsScene::reinit()
 {
+	if (is_simulating)
+		fetch_results();
+
+	bodies.clear();
+	moving_bodies.clear();
+	settled_bodies.clear();
+	accumulator = 0.0f;
+
 	auto rbs = scene->getEntitiesWith<RigidBodyComponent>();
 	for (auto [e, rb] : rbs.each())
 	{
@@ -69,8 +161,13 @@ void PhysicsScene::reinit()
 			dynamic_actor->setActorFlag(PxActorFlag::eDISABLE_GRAVITY, rb.gravity == false);
 			actor = dynamic_actor;
 		}
-		actor->userData = &t;
+		actor->userData = (void *)(uintptr_t)bodies.size();
 		entity_body[e] = actor;
+
+		BodyState &body = bodies.push_back();
+		body.entity = e;
+		body.previous_pose = transform;
+		body.current_pose = transform;
 		px_scene->addActor(*actor);
 	}
 
@@ -90,12 +187,15 @@ void PhysicsScene::reinit()
 
 void PhysicsScene::draw_debug(DebugRenderer *debug_renderer)
 {
+	// Drawn by simulate() before the step is kicked while running
+	if (is_simulating)
+		return;
+
 	uint32_t nb_actors = px_scene->getNbActors(PxActorTypeFlag::eRIGID_DYNAMIC | PxActorTypeFlag::eRIGID_STATIC);
 	PxArray<PxRigidActor *> actors(nb_actors);
 	px_scene->getActors(PxActorTypeFlag::eRIGID_DYNAMIC | PxActorTypeFlag::eRIGID_STATIC, reinterpret_cast<PxActor **>(&actors[0]), nb_actors);
 	for (int i = 0; i < nb_actors; i++)
 	{
-		TransformComponent *t = (TransformComponent *)actors[i]->userData;
 		PxRigidActor *actor = reinterpret_cast<PxRigidActor *>(actors[i]);
 
 		PxShape *shapes[128];
@@ -11,13 +11,36 @@ public:
 	PhysicsScene(Scene *scene);
 	~PhysicsScene();
 	
-	void simulate();
+	// Advances simulation by fixed steps, last step runs overlapped with rendering.
+	// Debug shapes are drawn before that step is kicked
+	void simulate(float delta_time, DebugRenderer *debug_renderer = nullptr);
 	void reinit();
 
 	void draw_debug(DebugRenderer *debug_renderer);
 private:
+	void fetch_results();
+	void write_interpolated_transforms(float alpha);
+
+	struct BodyState
+	{
+		entt::entity entity = entt::null;
+		physx::PxTransform previous_pose;
+		physx::PxTransform current_pose;
+		uint64_t last_active_step = 0;
+	};
+
 	Scene *scene;
 	physx::PxScene *px_scene = nullptr;
 	eastl::unordered_map<entt::entity, physx::PxRigidActor *> entity_body;
-};
 
+	// Actor userData stores index into this array
+	eastl::vector<BodyState> bodies;
+	// Bodies that moved during last completed step, only they are interpolated
+	eastl::vector<uint32_t> moving_bodies;
+	// Bodies that fell asleep, written once with final pose
+	eastl::vector<uint32_t> settled_bodies;
+
+	float accumulator = 0.0f;
+	uint64_t step_index = 0;
+	bool is_simulating = false;
+};
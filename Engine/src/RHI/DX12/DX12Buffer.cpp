@@ -2,6 +2,7 @@
 #include "DX12Buffer.h"
 #include "DX12DynamicRHI.h"
 #include "DX12Utils.h"
+#include "RHI/RHIUploadBatch.h"
 
 static D3D12_RESOURCE_STATES toDX12ResourceState(ResourceState state)
 {
@@ -70,40 +71,14 @@ void DX12Buffer::fill(const void *sourceData)
 	ENGINE_ASSERT(sourceData);
 	PROFILE_CPU_FUNCTION();
 
-	auto *native_rhi = DX12Utils::getNativeRHI();
 	uint64_t buffer_size = description.size;
 
 	if (description.use_staging_buffer && !hasAnyFlags(description.usage, BufferUsage::STAGING_BUFFER))
 	{
-		ComPtr<ID3D12Resource> intermediate_resource;
-		native_rhi->device->CreateCommittedResource(&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD), D3D12_HEAP_FLAG_NONE, &CD3DX12_RESOURCE_DESC::Buffer(buffer_size),
-										D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&intermediate_resource));
-		D3D12_SUBRESOURCE_DATA subresourceData = {};
-		subresourceData.pData = sourceData;
-		subresourceData.RowPitch = buffer_size;
-		subresourceData.SlicePitch = subresourceData.RowPitch;
-
-
-		RHICommandList *copy_cmd_list = native_rhi->getCmdListCopy();
-		// Upload buffer data.
-		copy_cmd_list->open();
-
-		UpdateSubresources(native_rhi->cmd_list_copy->cmd_list.Get(),
-						   resource->resource, intermediate_resource.Get(),
-						   0, 0, 1, &subresourceData);
-
-		copy_cmd_list->close();
-		native_rhi->getCmdQueueCopy()->execute(copy_cmd_list);
-
-		// Wait queue
-		auto last_fence = native_rhi->getCmdQueueCopy()->getLastFenceValue();
-		native_rhi->getCmdQueueCopy()->signal(last_fence + 1);
-		native_rhi->getCmdQueueCopy()->wait(last_fence + 1);
-
-		// According to https://learn.microsoft.com/en-us/windows/win32/direct3d12/using-resource-barriers-to-synchronize-resource-states-in-direct3d-12#implicit-state-transitions
-		current_state = ResourceState::SHADER_RESOURCE;
-
-		intermediate_resource.Reset();
+		// Upload batch of one, use RHIUploadBatch directly to not wait
+		RHIUploadBatch batch;
+		batch.uploadBuffer(this, sourceData, buffer_size);
+		RHIUploadBatch::wait(batch.submit());
 	} else
 	{
 		// For CPU-visible (upload) buffers, map and write directly.
@@ -156,6 +131,15 @@ RHIBufferView *DX12Buffer::getUnorderedAccessView(bool force_raw)
 	return unordered_access_view;
 }
 
+void DX12Buffer::recordUpload(RHICommandList *cmd_list, RHIBuffer *staging, uint64_t staging_offset, uint64_t size)
+{
+	DX12CommandList *native_cmd_list = (DX12CommandList *)cmd_list;
+	native_cmd_list->cmd_list->CopyBufferRegion(resource->resource, 0, ((DX12Buffer *)staging)->getResource(), staging_offset, size);
+
+	// According to https://learn.microsoft.com/en-us/windows/win32/direct3d12/using-resource-barriers-to-synchronize-resource-states-in-direct3d-12#implicit-state-transitions
+	current_state = ResourceState::SHADER_RESOURCE;
+}
+
 void DX12Buffer::transitState(ResourceState new_state)
 {
 	DX12CommandList *native_cmd_list = (DX12CommandList *)gDynamicRHI->getCmdList();
@@ -25,6 +25,7 @@ public:
 	}
 
 	void transitState(ResourceState new_state) override;
+	void recordUpload(RHICommandList *cmd_list, RHIBuffer *staging, uint64_t staging_offset, uint64_t size) override;
 
 	bool isValid() const override { return resource != nullptr; }
 
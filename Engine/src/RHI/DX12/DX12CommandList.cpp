@@ -220,6 +220,29 @@ void DX12CommandList::copyBuffer(RHIBuffer *src, RHIBuffer *dest, uint64_t src_o
 	cmd_list->CopyBufferRegion(native_dst_buffer->getResource(), dest_offset, native_src_buffer->getResource(), src_offset, size);
 }
 
+void DX12CommandList::copyTexture(RHITexture *src, RHITexture *dest, uint32_t src_layer, uint32_t dest_layer)
+{
+	DX12Texture *native_src_texture = (DX12Texture *)src;
+	DX12Texture *native_dst_texture = (DX12Texture *)dest;
+
+	native_src_texture->transitLayout(this, TEXTURE_LAYOUT_TRANSFER_SRC);
+	native_dst_texture->transitLayout(this, TEXTURE_LAYOUT_TRANSFER_DST);
+
+	auto get_array_size = [](RHITexture *texture) { return texture->getDescription().is_cube ? 6u : texture->getArrayLevels(); };
+
+	D3D12_TEXTURE_COPY_LOCATION src_location = {};
+	src_location.pResource = native_src_texture->getResource();
+	src_location.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+	src_location.SubresourceIndex = D3D12CalcSubresource(0, src_layer, 0, src->getMipLevels(), get_array_size(src));
+
+	D3D12_TEXTURE_COPY_LOCATION dst_location = {};
+	dst_location.pResource = native_dst_texture->getResource();
+	dst_location.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+	dst_location.SubresourceIndex = D3D12CalcSubresource(0, dest_layer, 0, dest->getMipLevels(), get_array_size(dest));
+
+	cmd_list->CopyTextureRegion(&dst_location, 0, 0, 0, &src_location, nullptr);
+}
+
 
 void DX12CommandList::beginDebugLabel(const char *label, glm::vec3 color, uint32_t line, const char* source, size_t source_size, const char* function, size_t function_size)
 {
@@ -40,14 +40,19 @@ public:
 	{
 	}
 
-	uint32_t getLastFenceValue() override
+	uint64_t getLastFenceValue() override
 	{
 		return last_fence_value;
 	}
 
+	uint64_t getCompletedFenceValue() override
+	{
+		return fence->GetCompletedValue();
+	}
+
 	ComPtr<ID3D12CommandQueue> cmd_queue;
 	ID3D12Fence *fence;
 	HANDLE fence_event;
 
-	uint32_t last_fence_value = 0;
+	uint64_t last_fence_value = 0;
 };
\ No newline at end of file
@@ -478,6 +478,8 @@ void DX12DynamicRHI::endFrame()
 
 	gDynamicRHI->getCmdList()->close();
 
+	// GPU side wait for the uploads submitted to the copy queue
+	cmd_queue->cmd_queue->Wait(cmd_queue_copy->fence, cmd_queue_copy->getLastFenceValue());
 	cmd_queue->execute(cmd_lists[frame_in_flight]);
 
 	swapchain->swap_chain->Present(render_vsync ? 1 : 0, 0);
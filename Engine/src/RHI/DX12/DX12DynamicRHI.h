@@ -50,6 +50,7 @@ public:
 
 	RHICommandList *getCmdList() override { return cmd_lists[frame_in_flight]; };
 	RHICommandList *getCmdListCopy() override { return cmd_list_copy; };
+	RHICommandList *createCmdListCopy() override { return new DX12CommandList(device, D3D12_COMMAND_LIST_TYPE_COPY); }
 
 	Upscaler *getUpscaler() override { return &dlss_upscaler; }
 	StreamlineAdapter *getStreamline() override { return &streamline; }
@@ -2,6 +2,7 @@
 #include "DX12Texture.h"
 #include "DX12DynamicRHI.h"
 #include "DX12Utils.h"
+#include "RHI/RHIUploadBatch.h"
 #include "Rendering/GlobalPipeline.h"
 
 DX12Texture::~DX12Texture()
@@ -88,58 +89,68 @@ void DX12Texture::fill()
 void DX12Texture::fill(const void *sourceData)
 {
 	fill();
-	DX12DynamicRHI *native_rhi = (DX12DynamicRHI *)rhi;
 
-	ComPtr<ID3D12Resource> intermediate_resource;
+	// Upload batch of one, use RHIUploadBatch directly to not wait
+	RHIUploadBatch batch;
+	batch.uploadTexture(this, sourceData);
+	RHIUploadBatch::wait(batch.submit());
 
-	int subresources_count = description.is_cube ? 6 : description.array_levels;
-	subresources_count *= description.mip_levels;
-	const UINT64 uploadBufferSize = GetRequiredIntermediateSize(resource->resource, 0, subresources_count);
+	resource->resource->SetName(L"FILLED TEXTURE");
+}
 
-	native_rhi->device->CreateCommittedResource(&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD), D3D12_HEAP_FLAG_NONE, &CD3DX12_RESOURCE_DESC::Buffer(uploadBufferSize),
-												D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&intermediate_resource));
+uint64_t DX12Texture::get_upload_footprints(uint64_t base_offset, D3D12_PLACED_SUBRESOURCE_FOOTPRINT *layouts, UINT *rows_count, UINT64 *row_sizes) const
+{
+	DX12DynamicRHI *native_rhi = (DX12DynamicRHI *)rhi;
+	D3D12_RESOURCE_DESC resource_desc = resource->resource->GetDesc();
 
+	UINT64 total_size = 0;
+	native_rhi->device->GetCopyableFootprints(&resource_desc, 0, get_subresources_count(), base_offset, layouts, rows_count, row_sizes, &total_size);
+	return total_size;
+}
 
-	uint32_t format_size = getFormatSize(description.format);
+uint64_t DX12Texture::getUploadSize() const
+{
+	return get_upload_footprints(0, nullptr, nullptr, nullptr);
+}
 
-	size_t current_offset = 0;
-	
-	eastl::vector<D3D12_SUBRESOURCE_DATA> subresources_data(subresources_count);
-	for (int i = 0; i < subresources_count; i++)
+void DX12Texture::writeUploadData(uint8_t *dst, const void *source_data) const
+{
+	uint32_t subresources_count = get_subresources_count();
+	eastl::vector<D3D12_PLACED_SUBRESOURCE_FOOTPRINT> layouts(subresources_count);
+	eastl::vector<UINT> rows_count(subresources_count);
+	eastl::vector<UINT64> row_sizes(subresources_count);
+	get_upload_footprints(0, layouts.data(), rows_count.data(), row_sizes.data());
+
+	// Source subresources are tightly packed, face after face with all mips (same order as subresource indices)
+	const uint8_t *src = (const uint8_t *)source_data;
+	for (uint32_t i = 0; i < subresources_count; i++)
 	{
-		int cur_face = i / description.mip_levels;
 		int cur_mip = i % description.mip_levels;
+		size_t src_row_pitch = get_row_size(description.format, getWidth(cur_mip));
 
-		int cur_width = description.width >> cur_mip;
-		int cur_height = description.height >> cur_mip;
-		size_t row_pitch = get_row_size(description.format, cur_width);
-		size_t cur_size = get_slice_size(description.format, cur_width, cur_height);
+		uint8_t *dst_subresource = dst + layouts[i].Offset;
+		for (UINT row = 0; row < rows_count[i]; row++)
+			memcpy(dst_subresource + row * layouts[i].Footprint.RowPitch, src + row * src_row_pitch, row_sizes[i]);
 
-		uint32_t subresource_index = D3D12CalcSubresource(cur_mip, cur_face, 0, description.mip_levels, description.is_cube ? 6 : 1);
-		uint8_t *data = (uint8_t *)sourceData;
-		subresources_data[i].pData = &data[current_offset];
-		subresources_data[i].RowPitch = row_pitch; // Bytes per row
-		subresources_data[i].SlicePitch = cur_size; // Bytes per face
-		
-		current_offset += cur_size;
+		src += get_slice_size(description.format, getWidth(cur_mip), getHeight(cur_mip));
 	}
+}
 
+void DX12Texture::recordUpload(RHICommandList *cmd_list, RHIBuffer *staging, uint64_t staging_offset)
+{
+	DX12CommandList *native_cmd_list = (DX12CommandList *)cmd_list;
 
-	RHICommandList *copy_cmd_list = rhi->getCmdListCopy();
-	// Upload buffer data.
-	copy_cmd_list->open();
-
-	UpdateSubresources(native_rhi->cmd_list_copy->cmd_list.Get(), resource->resource, intermediate_resource.Get(), 0, 0, subresources_data.size(), subresources_data.data());
-
-	copy_cmd_list->close();
-	rhi->getCmdQueueCopy()->execute(copy_cmd_list);
-
-	// Wait queue
-	auto last_fence = rhi->getCmdQueueCopy()->getLastFenceValue();
-	rhi->getCmdQueueCopy()->signal(last_fence + 1);
-	rhi->getCmdQueueCopy()->wait(last_fence + 1);
+	uint32_t subresources_count = get_subresources_count();
+	eastl::vector<D3D12_PLACED_SUBRESOURCE_FOOTPRINT> layouts(subresources_count);
+	get_upload_footprints(staging_offset, layouts.data(), nullptr, nullptr);
 
-	resource->resource->SetName(L"FILLED TEXTURE");
+	// Texture is in common state, copy queue promotes it to copy dest and it decays back after execution
+	for (uint32_t i = 0; i < subresources_count; i++)
+	{
+		CD3DX12_TEXTURE_COPY_LOCATION dst_location(resource->resource, i);
+		CD3DX12_TEXTURE_COPY_LOCATION src_location(((DX12Buffer *)staging)->getResource(), layouts[i]);
+		native_cmd_list->cmd_list->CopyTextureRegion(&dst_location, 0, 0, 0, &src_location, nullptr);
+	}
 }
 
 void DX12Texture::clear(const glm::vec4 &color)
@@ -176,7 +187,8 @@ void DX12Texture::load(const char *path)
 	if (description.format == FORMAT_UNDEFINED || image.isCompressedFormat())
 		description.format = image.getFormat();
 	set_native_format();
-	fill(image.getRawData().data());
+	fill();
+	RHIUploadBatch::enqueueTexture(this, image.getData().data());
 
 	this->path = path;
 }
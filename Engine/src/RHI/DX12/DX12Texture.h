@@ -36,6 +36,10 @@ public:
 
 	void transitLayout(RHICommandList *cmd_list, TextureLayoutType new_layout_type, int mip = -1) override;
 
+	uint64_t getUploadSize() const override;
+	void writeUploadData(uint8_t *dst, const void *source_data) const override;
+	void recordUpload(RHICommandList *cmd_list, RHIBuffer *staging, uint64_t staging_offset) override;
+
 	void generateMipmaps(RHICommandList *cmd_list);
 
 	bool isValid() const override { return resource != nullptr; }
@@ -110,6 +114,10 @@ protected:
 
 	void set_native_format();
 
+	uint32_t get_subresources_count() const { return (description.is_cube ? 6 : description.array_levels) * description.mip_levels; }
+	// Placement of every subresource inside an upload buffer, rows are padded to D3D12_TEXTURE_DATA_PITCH_ALIGNMENT
+	uint64_t get_upload_footprints(uint64_t base_offset, D3D12_PLACED_SUBRESOURCE_FOOTPRINT *layouts, UINT *rows_count, UINT64 *row_sizes) const;
+
 	DXGI_FORMAT native_format = DXGI_FORMAT_UNKNOWN;
 
 	TextureLayoutType current_layout = TEXTURE_LAYOUT_GENERAL;
@@ -43,6 +43,9 @@ public:
 			case FORMAT_BC3: return DXGI_FORMAT_BC3_UNORM;
 			case FORMAT_BC5: return DXGI_FORMAT_BC5_UNORM;
 			case FORMAT_BC7: return DXGI_FORMAT_BC7_UNORM;
+			case FORMAT_BC1_SRGB: return DXGI_FORMAT_BC1_UNORM_SRGB;
+			case FORMAT_BC4: return DXGI_FORMAT_BC4_UNORM;
+			case FORMAT_BC7_SRGB: return DXGI_FORMAT_BC7_UNORM_SRGB;
 		}
 	}
 };
\ No newline at end of file
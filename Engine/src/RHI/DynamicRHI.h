@@ -57,6 +57,8 @@ public:
 
 	virtual RHICommandList *getCmdList() = 0;
 	virtual RHICommandList *getCmdListCopy() = 0;
+	// New command list for the copy queue, owned by the caller
+	virtual RHICommandList *createCmdListCopy() = 0;
 
 	virtual class Upscaler *getUpscaler() { return nullptr; }
 	virtual class StreamlineAdapter *getStreamline() { return nullptr; }
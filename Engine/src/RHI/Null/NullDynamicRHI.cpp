@@ -0,0 +1,38 @@
+#include "pch.h"
+#include "NullDynamicRHI.h"
+
+NullBuffer::NullBuffer(BufferDescription description): RHIBuffer(description)
+{
+	memory.reset(new uint8_t[description.size]);
+	view = new RHIBufferView(BufferViewDescription(this, BufferViewType::SHADER_RESOURCE_STORAGE));
+}
+
+void NullBuffer::fill(const void *sourceData)
+{
+	if (sourceData)
+		memcpy(memory.get(), sourceData, description.size);
+}
+
+void NullDynamicRHI::init()
+{
+	graphics_api = GRAPHICS_API_NONE;
+	CORE_INFO("Null RHI initialized, rendering is disabled");
+}
+
+void NullDynamicRHI::shutdown()
+{
+	// Everything is released right away, there are no frames in flight
+	release_gpu_resources(UINT64_MAX);
+}
+
+void NullDynamicRHI::beginFrame()
+{
+	release_gpu_resources(frame);
+}
+
+void NullDynamicRHI::endFrame()
+{
+	cmd_queue.signal(frame);
+	frame_in_flight = (frame_in_flight + 1) % MAX_FRAMES_IN_FLIGHT;
+	frame++;
+}
@@ -0,0 +1,127 @@
+#pragma once
+#include "RHI/DynamicRHI.h"
+#include "RHI/RHIBuffer.h"
+
+// RHI without a device, lets CPU side of the engine (benchmarks, tools) run on machines without a GPU.
+// Buffers live in system memory so code that stages, maps and fills them works as usual, commands are ignored.
+// Textures, shaders, pipelines and acceleration structures are not supported and are null.
+
+class NullBuffer final: public RHIBuffer
+{
+public:
+	NullBuffer(BufferDescription description);
+
+	void fill(const void *sourceData) override;
+	void map(void **data) override { *data = memory.get(); }
+	void unmap() override {}
+
+	void setDebugName(const char *name) override {}
+	uint64_t getGPUAddress() const override { return 0; }
+
+	void transitState(ResourceState new_state) override {}
+	void recordUpload(RHICommandList *cmd_list, RHIBuffer *staging, uint64_t staging_offset, uint64_t size) override {}
+
+	RHIBufferView *getShaderResourceView() override { return view; }
+	RHIBufferView *getUnorderedAccessView(bool force_raw = false) override { return view; }
+
+private:
+	std::unique_ptr<uint8_t[]> memory; // not cleared like GPU memory, big staging buffers are paged in only where written
+	Ref<RHIBufferView> view;
+};
+
+class NullCommandList final: public RHICommandList
+{
+public:
+	void open() override {}
+	void close() override {}
+
+	void setRenderTargets(const eastl::vector<RHITexture *> &color_attachments, RHITexture *depth_attachment, int layer, int mip, bool clear, float depth_clear_value = 0.0f) override {}
+	void resetRenderTargets() override {}
+	eastl::vector<RHITexture *> &getCurrentRenderTargets() override { return render_targets; }
+
+	void setPipeline(RHIPipeline *pipeline) override {}
+
+	void setVertexBuffer(RHIBuffer *buffer, uint32_t offset, uint32_t stride, uint32_t slot = 0) override {}
+	void setIndexBuffer(RHIBuffer *buffer, uint32_t offset, IndexFormat format = IndexFormat::UINT32) override {}
+	void drawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex, int32_t vertexOffset, uint32_t firstInstance) override {}
+	void drawInstanced(uint32_t vertex_count_per_instance, uint32_t instance_count, uint32_t firstVertex, uint32_t firstInstance) override {}
+
+	void drawIndexedIndirect(RHIBuffer *args_buffer, uint32_t max_draw_count, RHIBuffer *count_buffer) override {}
+	void drawIndexedIndirect(RHIBuffer *args_buffer, uint32_t draw_count) override {}
+	void drawIndirect(RHIBuffer *args_buffer, uint32_t draw_count) override {}
+	void drawIndirect(RHIBuffer *args_buffer, uint32_t max_draw_count, RHIBuffer *count_buffer) override {}
+
+	void dispatch(uint32_t group_x, uint32_t group_y, uint32_t group_z) override {}
+	void dispatchIndirect(RHIBuffer *args_buffer, uint32_t dispatch_count) override {}
+	void dispatchRays(uint32_t width, uint32_t height, uint32_t depth) override {}
+	void dispatchMesh(uint32_t group_x, uint32_t group_y, uint32_t group_z) override {}
+	void dispatchMeshIndirect(RHIBuffer *args_buffer, uint32_t draw_count) override {}
+
+	void copyBuffer(RHIBuffer *src, RHIBuffer *dest, uint64_t src_offset, uint64_t dest_offset, uint64_t size) override {}
+	void copyTexture(RHITexture *src, RHITexture *dest, uint32_t src_layer, uint32_t dest_layer) override {}
+	void fillBuffer(RHIBuffer *buffer, uint32_t value) override {}
+
+	void beginDebugLabel(const char *label, glm::vec3 color, uint32_t line, const char* source, size_t source_size, const char* function, size_t function_size) override {}
+	void endDebugLabel() override {}
+
+private:
+	eastl::vector<RHITexture *> render_targets;
+};
+
+// Work is done as soon as it's executed, signaled values are complete right away
+class NullCommandQueue final: public RHICommandQueue
+{
+public:
+	void execute(RHICommandList *cmd_list) override {}
+	void signal(uint64_t fence_value) override { this->fence_value = fence_value; }
+	void wait(uint64_t fence_value) override {}
+	void waitIdle() override {}
+	uint64_t getLastFenceValue() override { return fence_value; }
+	uint64_t getCompletedFenceValue() override { return fence_value; }
+
+private:
+	uint64_t fence_value = 0;
+};
+
+class NullDynamicRHI final: public DynamicRHI
+{
+public:
+	void init() override;
+	void shutdown() override;
+	const char *getName() override { return "Null"; }
+
+	RHISwapchainRef createSwapchain(GLFWwindow *window) override { return nullptr; }
+	RHIShaderRef createShader(eastl::wstring path, ShaderType type, eastl::string entry_point = "") override { return nullptr; }
+	RHIShaderRef createShader(eastl::wstring path, ShaderType type, eastl::string entry_point, eastl::vector<eastl::pair<const char *, const char *>> defines) override { return nullptr; }
+	RHIPipelineRef createPipeline() override { return nullptr; }
+	RHIBufferRef createBuffer(BufferDescription description) override { return new NullBuffer(description); }
+	RHITextureRef createTexture(TextureDescription description) override { return nullptr; }
+	RHIBottomLevelAccelerationStructureRef createBottomLevelAccelerationStructure() override { return nullptr; }
+	RHITopLevelAccelerationStructureRef createTopLevelAccelerationStructure() override { return nullptr; }
+
+	RHICommandList *getCmdList() override { return &cmd_list; }
+	RHICommandList *getCmdListCopy() override { return &cmd_list; }
+	RHICommandList *createCmdListCopy() override { return new NullCommandList(); }
+
+	RHICommandQueue *getCmdQueue() override { return &cmd_queue; }
+	RHICommandQueue *getCmdQueueCopy() override { return &cmd_queue_copy; }
+
+	RHIBindlessResources *getBindlessResources() override { return nullptr; }
+
+	RHITextureRef getSwapchainTexture(int index) override { return nullptr; }
+	RHITextureRef getCurrentSwapchainTexture() override { return nullptr; }
+
+	void waitGPU() override {}
+
+	void beginFrame() override;
+	void endFrame() override;
+
+	void prepareRenderCall() override {}
+	void setConstantBufferData(unsigned int binding, void *params_struct, size_t params_size) override {}
+	void setConstantBufferDataPerFrame(unsigned int binding, void *params_struct, size_t params_size) override {}
+
+private:
+	NullCommandList cmd_list;
+	NullCommandQueue cmd_queue;
+	NullCommandQueue cmd_queue_copy;
+};
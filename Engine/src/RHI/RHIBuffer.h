@@ -2,6 +2,7 @@
 #include "RHIDefinitions.h"
 
 class RHIBufferView;
+class RHICommandList;
 class RHIBuffer : public RefCounted
 {
 public:
@@ -21,6 +22,9 @@ public:
 
 	virtual void transitState(ResourceState new_state) = 0;
 
+	// Records a copy from upload staging memory, cmd_list is a copy queue list (see RHIUploadBatch)
+	virtual void recordUpload(RHICommandList *cmd_list, RHIBuffer *staging, uint64_t staging_offset, uint64_t size) = 0;
+
 	virtual bool isValid() const { return true; }
 
 	virtual RHIBufferView *getShaderResourceView() = 0;
@@ -9,5 +9,6 @@ public:
 	virtual void signal(uint64_t fence_value) = 0;
 	virtual void wait(uint64_t fence_value) = 0;
 	virtual void waitIdle() = 0;
-	virtual uint32_t getLastFenceValue() = 0;
+	virtual uint64_t getLastFenceValue() = 0;
+	virtual uint64_t getCompletedFenceValue() = 0;
 };
\ No newline at end of file
@@ -164,6 +164,9 @@ enum Format
 	FORMAT_BC3,
 	FORMAT_BC5,
 	FORMAT_BC7,
+	FORMAT_BC1_SRGB,
+	FORMAT_BC4,
+	FORMAT_BC7_SRGB,
 };
 
 inline uint32_t getFormatSize(Format format)
@@ -201,10 +204,28 @@ inline uint32_t getFormatSize(Format format)
 		case FORMAT_BC3: return 0;
 		case FORMAT_BC5: return 0;
 		case FORMAT_BC7: return 0;
+		case FORMAT_BC1_SRGB: return 0;
+		case FORMAT_BC4: return 0;
+		case FORMAT_BC7_SRGB: return 0;
 	}
 	return 0;
 }
 
+inline bool isCompressedFormat(Format format)
+{
+	switch (format)
+	{
+		case FORMAT_BC1:
+		case FORMAT_BC1_SRGB:
+		case FORMAT_BC3:
+		case FORMAT_BC4:
+		case FORMAT_BC5:
+		case FORMAT_BC7:
+		case FORMAT_BC7_SRGB: return true;
+	}
+	return false;
+}
+
 inline const char *getFormatName(Format format)
 {
 	switch (format)
@@ -229,6 +250,9 @@ inline const char *getFormatName(Format format)
 		case FORMAT_BC3: return "BC3";
 		case FORMAT_BC5: return "BC5";
 		case FORMAT_BC7: return "BC7";
+		case FORMAT_BC1_SRGB: return "BC1_SRGB";
+		case FORMAT_BC4: return "BC4";
+		case FORMAT_BC7_SRGB: return "BC7_SRGB";
 	}
 	return "UNDEFINED";
 }
@@ -4,8 +4,6 @@
 #include "Utils/Image.h"
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
-#define TINYDDSLOADER_IMPLEMENTATION
-#include "tinyddsloader.h"
 #include "Utils/Math.h"
 #include "Assets/TextureImportSettings.h"
 
@@ -26,9 +24,12 @@ uint32_t RHITexture::get_block_size(Format format) const
 	switch (format)
 	{
 		case FORMAT_BC1:
+		case FORMAT_BC1_SRGB:
 		case FORMAT_BC3:
+		case FORMAT_BC4:
 		case FORMAT_BC5:
-		case FORMAT_BC7: return 4;
+		case FORMAT_BC7:
+		case FORMAT_BC7_SRGB: return 4;
 	}
 	return 0;
 }
@@ -37,10 +38,13 @@ uint32_t RHITexture::get_block_stride(Format format) const
 {
 	switch (format)
 	{
-		case FORMAT_BC1: return 8;
+		case FORMAT_BC1:
+		case FORMAT_BC1_SRGB:
+		case FORMAT_BC4: return 8;
 		case FORMAT_BC3:
 		case FORMAT_BC5:
-		case FORMAT_BC7: return 16;
+		case FORMAT_BC7:
+		case FORMAT_BC7_SRGB: return 16;
 	}
 	return 0;
 }
@@ -74,16 +78,40 @@ static Ref<Asset> load_texture(const std::filesystem::path &path)
 	return texture;
 }
 
+static Format get_compressed_format(TextureCompression compression)
+{
+	switch (compression)
+	{
+		case TEXTURE_COMPRESSION_COLOR: return FORMAT_BC7_SRGB;
+		case TEXTURE_COMPRESSION_COLOR_OPAQUE: return FORMAT_BC1_SRGB;
+		case TEXTURE_COMPRESSION_NORMAL: return FORMAT_BC5;
+		case TEXTURE_COMPRESSION_MASK: return FORMAT_BC4;
+	}
+	return FORMAT_UNDEFINED;
+}
+
 static void cook_texture(const AssetMetadata &metadata, const std::filesystem::path &runtime_path)
 {
+	const TextureImportSettings &settings = metadata.getImportSettings<TextureImportSettings>();
 	Ref<Image> image = new Image(metadata.sourcePath.string().c_str());
-	if (metadata.getImportSettings<TextureImportSettings>().generate_mipmaps)
+	if (settings.generate_mipmaps)
 		image->createMipmaps();
 
+	// Sources that are already compressed are kept as is
+	Format compressed_format = get_compressed_format(settings.getCompression());
+	if (compressed_format != FORMAT_UNDEFINED && !image->isCompressedFormat())
+		image->compress(compressed_format);
+
 	image->save(runtime_path);
 }
 
+static uint32_t texture_runtime_version(const AssetMetadata &metadata)
+{
+	// Material slots can change the compression of Auto textures, runtime is recooked then
+	return 1 | metadata.getImportSettings<TextureImportSettings>().getCompression() << 4;
+}
+
 static const AssetTypeInfo *registered_texture_type = AssetManager::registerType<RHITexture>({
 	"Texture", {".dds", ".png", ".jpg", ".jpeg", ".hdr", ".tga"}, load_texture,
-	".dds", cook_texture, &Reflected<TextureImportSettings>::getInfo(),
+	".dds", cook_texture, &Reflected<TextureImportSettings>::getInfo(), texture_runtime_version,
 });
@@ -51,13 +51,19 @@ public:
 
 	virtual void transitLayout(RHICommandList *cmd_list, TextureLayoutType new_layout_type, int mip = -1) {}
 
+	// Batched uploads (see RHIUploadBatch). Source data has the same layout as in fill(sourceData),
+	// staging data is written in the layout the backend copies from.
+	virtual uint64_t getUploadSize() const { return 0; }
+	virtual void writeUploadData(uint8_t *dst, const void *source_data) const {}
+	virtual void recordUpload(RHICommandList *cmd_list, RHIBuffer *staging, uint64_t staging_offset) {}
+
 	void generateMipmaps(RHICommandList *cmd_list) {}
 
 	uint32_t getUsageFlags() const { return description.usage_flags; }
 
 	bool isCompressedFormat() const
 	{ 
-		return description.format >= FORMAT_BC1 && description.format <= FORMAT_BC7;
+		return ::isCompressedFormat(description.format);
 	}
 
 	bool isDepthTexture() const
@@ -0,0 +1,251 @@
+#include "pch.h"
+#include "RHIUploadBatch.h"
+#include "RHI/DynamicRHI.h"
+#include "RHI/RHIBuffer.h"
+#include "RHI/RHITexture.h"
+
+namespace
+{
+	constexpr uint64_t BUFFER_PLACEMENT_ALIGNMENT = 16;
+	constexpr uint64_t TEXTURE_PLACEMENT_ALIGNMENT = 512; // D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT, also enough for Vulkan texel blocks
+
+	// Submitted batch, resources are kept alive until the copy queue reaches fence_value
+	struct InFlightBatch
+	{
+		uint64_t fence_value;
+		RHICommandList *cmd_list;
+		eastl::vector<RHIBufferRef> staging_buffers;
+		eastl::vector<RHIBufferRef> buffers;
+		eastl::vector<RHITextureRef> textures;
+	};
+
+	eastl::vector<InFlightBatch> in_flight_batches;
+	eastl::vector<RHICommandList *> free_cmd_lists;
+	thread_local RHIUploadBatch *current_batch = nullptr;
+	RHIUploadBatch::Stats stats;
+}
+
+RHIUploadBatch::RHIUploadBatch(uint64_t staging_chunk_size): staging_chunk_size(staging_chunk_size)
+{
+}
+
+RHIUploadBatch::~RHIUploadBatch()
+{
+	if (!isEmpty())
+		submit();
+}
+
+uint8_t *RHIUploadBatch::allocate(uint64_t size, uint64_t alignment, RHIBuffer *&staging, uint64_t &staging_offset)
+{
+	StagingChunk *chunk = chunks.empty() ? nullptr : &chunks.back();
+	uint64_t offset = chunk ? Math::alignedSize(chunk->offset, alignment) : 0;
+	if (!chunk || offset + size > chunk->buffer->getSize())
+	{
+		BufferDescription description;
+		description.size = eastl::max(size, staging_chunk_size);
+		description.use_staging_buffer = false;
+
+		chunk = &chunks.emplace_back();
+		chunk->buffer = gDynamicRHI->createBuffer(description);
+		chunk->buffer->setDebugName("Upload Batch Staging");
+		chunk->buffer->map((void **)&chunk->mapped);
+		offset = 0;
+	}
+
+	chunk->offset = offset + size;
+	staging = chunk->buffer.getReference();
+	staging_offset = offset;
+	pending_bytes += size;
+	return chunk->mapped + offset;
+}
+
+void RHIUploadBatch::uploadBuffer(RHIBuffer *dst, const void *data, uint64_t size)
+{
+	ENGINE_ASSERT(dst && data && size <= dst->getSize());
+	if (size == 0)
+		return;
+
+	const BufferDescription &description = dst->getDescription();
+	if (!description.use_staging_buffer || hasAnyFlags(description.usage, BufferUsage::STAGING_BUFFER))
+	{
+		// CPU visible memory is written directly
+		void *mapped;
+		dst->map(&mapped);
+		memcpy(mapped, data, size);
+		dst->unmap();
+		return;
+	}
+
+	BufferUpload &upload = buffer_uploads.emplace_back();
+	uint8_t *staged = allocate(size, BUFFER_PLACEMENT_ALIGNMENT, upload.staging, upload.staging_offset);
+	memcpy(staged, data, size);
+	upload.dst = dst;
+	upload.size = size;
+
+	if (pending_bytes >= MAX_PENDING_BYTES)
+		submit();
+}
+
+void RHIUploadBatch::uploadTexture(RHITexture *dst, const void *data)
+{
+	// Texture memory must already be allocated with fill()
+	ENGINE_ASSERT(dst && data && dst->isValid());
+
+	uint64_t size = dst->getUploadSize();
+	TextureUpload &upload = texture_uploads.emplace_back();
+	uint8_t *staged = allocate(size, TEXTURE_PLACEMENT_ALIGNMENT, upload.staging, upload.staging_offset);
+	dst->writeUploadData(staged, data);
+	upload.dst = dst;
+
+	if (pending_bytes >= MAX_PENDING_BYTES)
+		submit();
+}
+
+RHIUploadToken RHIUploadBatch::submit()
+{
+	if (isEmpty())
+		return last_token;
+	PROFILE_CPU_FUNCTION();
+
+	RHICommandList *cmd_list;
+	if (free_cmd_lists.empty())
+	{
+		cmd_list = gDynamicRHI->createCmdListCopy();
+	} else
+	{
+		cmd_list = free_cmd_lists.back();
+		free_cmd_lists.pop_back();
+	}
+
+	InFlightBatch batch;
+	batch.cmd_list = cmd_list;
+	batch.buffers.reserve(buffer_uploads.size());
+	batch.textures.reserve(texture_uploads.size());
+
+	cmd_list->open();
+	for (BufferUpload &upload : buffer_uploads)
+	{
+		upload.dst->recordUpload(cmd_list, upload.staging, upload.staging_offset, upload.size);
+		batch.buffers.push_back(eastl::move(upload.dst));
+	}
+	for (TextureUpload &upload : texture_uploads)
+	{
+		upload.dst->recordUpload(cmd_list, upload.staging, upload.staging_offset);
+		batch.textures.push_back(eastl::move(upload.dst));
+	}
+	cmd_list->close();
+
+	RHICommandQueue *queue = gDynamicRHI->getCmdQueueCopy();
+	queue->execute(cmd_list);
+	batch.fence_value = queue->getLastFenceValue() + 1;
+	queue->signal(batch.fence_value);
+
+	for (StagingChunk &chunk : chunks)
+	{
+		chunk.buffer->unmap();
+		batch.staging_buffers.push_back(eastl::move(chunk.buffer));
+	}
+
+	last_token.fence_value = batch.fence_value;
+	in_flight_batches.push_back(eastl::move(batch));
+
+	stats.total_submissions++;
+	stats.total_bytes += pending_bytes;
+	stats.in_flight_batches = in_flight_batches.size();
+
+	chunks.clear();
+	buffer_uploads.clear();
+	texture_uploads.clear();
+	pending_bytes = 0;
+	return last_token;
+}
+
+bool RHIUploadBatch::isComplete(RHIUploadToken token)
+{
+	return !token.isValid() || gDynamicRHI->getCmdQueueCopy()->getCompletedFenceValue() >= token.fence_value;
+}
+
+void RHIUploadBatch::wait(RHIUploadToken token)
+{
+	if (!isComplete(token))
+	{
+		PROFILE_CPU_FUNCTION();
+		gDynamicRHI->getCmdQueueCopy()->wait(token.fence_value);
+	}
+	releaseCompleted();
+}
+
+void RHIUploadBatch::enqueueBuffer(RHIBuffer *dst, const void *data, uint64_t size)
+{
+	if (current_batch)
+	{
+		current_batch->uploadBuffer(dst, data, size);
+		return;
+	}
+
+	RHIUploadBatch batch;
+	batch.uploadBuffer(dst, data, size);
+	batch.submit();
+}
+
+void RHIUploadBatch::enqueueTexture(RHITexture *dst, const void *data)
+{
+	if (current_batch)
+	{
+		current_batch->uploadTexture(dst, data);
+		return;
+	}
+
+	RHIUploadBatch batch;
+	batch.uploadTexture(dst, data);
+	batch.submit();
+}
+
+RHIUploadBatch::Scope::Scope()
+{
+	if (current_batch)
+		return;
+	batch = std::make_unique<RHIUploadBatch>();
+	current_batch = batch.get();
+}
+
+RHIUploadBatch::Scope::~Scope()
+{
+	if (!batch)
+		return;
+	current_batch = nullptr;
+	batch->submit();
+}
+
+void RHIUploadBatch::releaseCompleted()
+{
+	if (in_flight_batches.empty())
+		return;
+
+	uint64_t completed_value = gDynamicRHI->getCmdQueueCopy()->getCompletedFenceValue();
+	auto it = eastl::remove_if(in_flight_batches.begin(), in_flight_batches.end(), [completed_value](const InFlightBatch &batch)
+	{
+		if (batch.fence_value > completed_value)
+			return false;
+		free_cmd_lists.push_back(batch.cmd_list);
+		return true;
+	});
+	in_flight_batches.erase(it, in_flight_batches.end());
+	stats.in_flight_batches = in_flight_batches.size();
+}
+
+const RHIUploadBatch::Stats &RHIUploadBatch::getStats()
+{
+	return stats;
+}
+
+void RHIUploadBatch::shutdown()
+{
+	if (!in_flight_batches.empty())
+		gDynamicRHI->getCmdQueueCopy()->wait(in_flight_batches.back().fence_value);
+	releaseCompleted();
+
+	for (RHICommandList *cmd_list : free_cmd_lists)
+		delete cmd_list;
+	free_cmd_lists.clear();
+}
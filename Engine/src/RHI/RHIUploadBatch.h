@@ -0,0 +1,99 @@
+#pragma once
+#include <EASTL/vector.h>
+#include "RHI/RHIDefinitions.h"
+
+// Copy queue fence value that signals when a batch of uploads is finished
+struct RHIUploadToken
+{
+	uint64_t fence_value = 0;
+
+	bool isValid() const { return fence_value != 0; }
+};
+
+// Collects uploads of many buffers and textures into one copy queue submission.
+// Source data is copied into staging memory right away, so it can be freed after the call.
+// Destinations must be new resources that are not used by the graphics queue yet.
+// Frames wait on the GPU for the last submitted batch, so the CPU never has to wait before rendering.
+class RHIUploadBatch
+{
+public:
+	RHIUploadBatch(uint64_t staging_chunk_size = 64 * 1024 * 1024);
+	~RHIUploadBatch();
+
+	void uploadBuffer(RHIBuffer *dst, const void *data, uint64_t size);
+	void uploadTexture(RHITexture *dst, const void *data);
+
+	// Records all pending uploads into one command list and submits it, returns the last submitted token if nothing is pending
+	RHIUploadToken submit();
+
+	bool isEmpty() const { return buffer_uploads.empty() && texture_uploads.empty(); }
+	uint64_t getPendingBytes() const { return pending_bytes; }
+
+	static bool isComplete(RHIUploadToken token);
+	static void wait(RHIUploadToken token);
+
+	// Uploads go to the batch of the innermost open scope, or are submitted right away without a scope. Never waits.
+	static void enqueueBuffer(RHIBuffer *dst, const void *data, uint64_t size);
+	static void enqueueTexture(RHITexture *dst, const void *data);
+
+	// Groups everything uploaded inside into one submission, nested scopes join the outer one
+	class Scope
+	{
+	public:
+		Scope();
+		~Scope();
+
+		Scope(const Scope &) = delete;
+		Scope &operator=(const Scope &) = delete;
+
+	private:
+		std::unique_ptr<RHIUploadBatch> batch; // null when joined an outer scope
+	};
+
+	// Frees staging memory and command lists of finished batches
+	static void releaseCompleted();
+	static void shutdown();
+
+	struct Stats
+	{
+		uint64_t total_submissions = 0;
+		uint64_t total_bytes = 0;
+		uint32_t in_flight_batches = 0;
+	};
+	static const Stats &getStats();
+
+	// Submit early when this much data is staged, so big scenes don't keep everything in staging memory
+	static constexpr uint64_t MAX_PENDING_BYTES = 256 * 1024 * 1024;
+
+private:
+	struct StagingChunk
+	{
+		RHIBufferRef buffer;
+		uint8_t *mapped = nullptr;
+		uint64_t offset = 0;
+	};
+
+	struct BufferUpload
+	{
+		RHIBufferRef dst;
+		RHIBuffer *staging;
+		uint64_t staging_offset;
+		uint64_t size;
+	};
+
+	struct TextureUpload
+	{
+		RHITextureRef dst;
+		RHIBuffer *staging;
+		uint64_t staging_offset;
+	};
+
+	uint8_t *allocate(uint64_t size, uint64_t alignment, RHIBuffer *&staging, uint64_t &staging_offset);
+
+	uint64_t staging_chunk_size;
+	uint64_t pending_bytes = 0;
+	eastl::vector<StagingChunk> chunks;
+	eastl::vector<BufferUpload> buffer_uploads;
+	eastl::vector<TextureUpload> texture_uploads;
+	RHIUploadToken last_token;
+};
@@ -3,7 +3,8 @@
 
 void RayTracingScene::setInstance(uint32_t slot, Engine::Mesh *mesh, const glm::mat4 &transform)
 {
-	if (!mesh->indexed)
+	// Meshlet meshes are traced through their resident proxy
+	if (!mesh->getRayTracingGeometry())
 		return;
 	instances[slot] = {mesh, transform};
 }
@@ -24,17 +25,18 @@ RHIBottomLevelAccelerationStructureRef RayTracingScene::ensure_blas(Engine::Mesh
 	if (it != blases.end())
 		return it->second;
 
+	const Engine::IndexedGeometry *source = mesh->getRayTracingGeometry();
 	eastl::vector<RayTracingGeometry> geometries;
 	RayTracingGeometry &geometry = geometries.emplace_back();
-	geometry.vertex_buffer = mesh->indexed->vertex_buffer;
+	geometry.vertex_buffer = source->vertex_buffer;
 	geometry.vertex_buffer_offset = 0;
 	geometry.vertex_buffer_stride = sizeof(Engine::Vertex);
-	geometry.vertex_count = mesh->indexed->vertices.size();
+	geometry.vertex_count = source->vertices.size();
 	geometry.vertex_format = FORMAT_R32G32B32_SFLOAT;
 
-	geometry.index_buffer = mesh->indexed->index_buffer;
+	geometry.index_buffer = source->index_buffer;
 	geometry.index_buffer_offset = 0;
-	geometry.index_count = mesh->indexed->indices.size();
+	geometry.index_count = source->indices.size();
 	geometry.index_format = FORMAT_R32_UINT;
 
 	auto blas = gDynamicRHI->createBottomLevelAccelerationStructure();
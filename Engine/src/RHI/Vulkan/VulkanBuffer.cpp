@@ -3,6 +3,7 @@
 #include "VulkanBuffer.h"
 #include "VulkanUtils.h"
 #include "VulkanDynamicRHI.h"
+#include "RHI/RHIUploadBatch.h"
 
 VulkanBuffer::VulkanBuffer(BufferDescription description) : RHIBuffer(description)
 {
@@ -60,26 +61,10 @@ void VulkanBuffer::fill(const void *sourceData)
 
 	if (description.use_staging_buffer && !hasAnyFlags(description.usage, BufferUsage::STAGING_BUFFER))
 	{
-		// Staging buffer
-		BufferDescription staging_buffer_description;
-		staging_buffer_description.size = description.size;
-		staging_buffer_description.alignment = description.alignment;
-		staging_buffer_description.use_staging_buffer = false;
-		RHIBufferRef staging_buffer = gDynamicRHI->createBuffer(staging_buffer_description);
-
-		// Map buffer memory to CPU accessible memory
-		void* data;
-		staging_buffer->map(&data);
-		memcpy(data, sourceData, buffer_size);
-		staging_buffer->unmap();
-
-		// Copy from staging to buffer
-		RHICommandList *copy_cmd_list = gDynamicRHI->getCmdListCopy();
-		copy_cmd_list->open();
-		copy_cmd_list->copyBuffer(staging_buffer, this, 0, 0, buffer_size);
-		copy_cmd_list->close();
-		gDynamicRHI->getCmdQueueCopy()->execute(copy_cmd_list);
-		gDynamicRHI->getCmdQueueCopy()->waitIdle();
+		// Upload batch of one, use RHIUploadBatch directly to not wait
+		RHIUploadBatch batch;
+		batch.uploadBuffer(this, sourceData, buffer_size);
+		RHIUploadBatch::wait(batch.submit());
 	}
 	else
 	{
@@ -91,6 +76,20 @@ void VulkanBuffer::fill(const void *sourceData)
 	}
 }
 
+void VulkanBuffer::recordUpload(RHICommandList *cmd_list, RHIBuffer *staging, uint64_t staging_offset, uint64_t size)
+{
+	VulkanCommandList *native_cmd_list = (VulkanCommandList *)cmd_list;
+
+	VkBufferCopy region{};
+	region.srcOffset = staging_offset;
+	region.dstOffset = 0;
+	region.size = size;
+	vkCmdCopyBuffer(native_cmd_list->cmd_buffer, ((VulkanBuffer *)staging)->getBuffer(), buffer->resource, 1, &region);
+
+	// Frames wait for the copy queue, next transition only has to leave the copy state
+	current_state = ResourceState::COPY_DST;
+}
+
 void VulkanBuffer::map(void **data)
 {
 	ENGINE_ASSERT(data);
@@ -19,6 +19,7 @@ public:
 	uint64_t getGPUAddress() const override;
 
 	void transitState(ResourceState new_state) override;
+	void recordUpload(RHICommandList *cmd_list, RHIBuffer *staging, uint64_t staging_offset, uint64_t size) override;
 
 	bool isValid() const override { return buffer != nullptr; }
 
@@ -250,6 +250,27 @@ void VulkanCommandList::copyBuffer(RHIBuffer *src, RHIBuffer *dest, uint64_t src
 	vkCmdCopyBuffer(cmd_buffer, native_src_buffer->getBuffer(), native_dst_buffer->getBuffer(), 1, &copyRegion);
 }
 
+void VulkanCommandList::copyTexture(RHITexture *src, RHITexture *dest, uint32_t src_layer, uint32_t dest_layer)
+{
+	VulkanTexture *native_src_texture = (VulkanTexture *)src;
+	VulkanTexture *native_dst_texture = (VulkanTexture *)dest;
+
+	native_src_texture->transitLayout(this, TEXTURE_LAYOUT_TRANSFER_SRC);
+	native_dst_texture->transitLayout(this, TEXTURE_LAYOUT_TRANSFER_DST);
+
+	VkImageAspectFlags aspect = src->isDepthTexture() ? VK_IMAGE_ASPECT_DEPTH_BIT : VK_IMAGE_ASPECT_COLOR_BIT;
+
+	VkImageCopy region{};
+	region.srcSubresource.aspectMask = aspect;
+	region.srcSubresource.mipLevel = 0;
+	region.srcSubresource.baseArrayLayer = src_layer;
+	region.srcSubresource.layerCount = 1;
+	region.dstSubresource = region.srcSubresource;
+	region.dstSubresource.baseArrayLayer = dest_layer;
+	region.extent = {src->getWidth(), src->getHeight(), 1};
+	vkCmdCopyImage(cmd_buffer, native_src_texture->getImage(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, native_dst_texture->getImage(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+}
+
 
 void VulkanCommandList::beginDebugLabel(const char *label, glm::vec3 color, uint32_t line, const char *source, size_t source_size, const char *function, size_t function_size)
 {
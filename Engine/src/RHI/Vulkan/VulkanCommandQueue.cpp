@@ -4,24 +4,29 @@
 #include "VulkanUtils.h"
 #include "VulkanDynamicRHI.h"
 
-VulkanCommandQueue::VulkanCommandQueue(VkQueue queue, bool create_fence): queue(queue)
+VulkanCommandQueue::VulkanCommandQueue(VkQueue queue, bool create_timeline): queue(queue)
 {
-	if (create_fence)
+	if (create_timeline)
 	{
-		VkFenceCreateInfo fenceInfo = {};
-		fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-		fenceInfo.flags = 0; // unsignaled initially
-		vkCreateFence(VulkanUtils::getNativeRHI()->device->logicalHandle, &fenceInfo, nullptr, &fence);
-		VulkanUtils::setDebugName(VK_OBJECT_TYPE_FENCE, (uint64_t)fence, "Command Queue Fence");
+		VkSemaphoreTypeCreateInfo type_info{};
+		type_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+		type_info.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+		type_info.initialValue = 0;
+
+		VkSemaphoreCreateInfo semaphore_info{};
+		semaphore_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+		semaphore_info.pNext = &type_info;
+		vkCreateSemaphore(VulkanUtils::getNativeRHI()->device->logicalHandle, &semaphore_info, nullptr, &timeline_semaphore);
+		VulkanUtils::setDebugName(VK_OBJECT_TYPE_SEMAPHORE, (uint64_t)timeline_semaphore, "Command Queue Timeline");
 	}
 }
 
 VulkanCommandQueue::~VulkanCommandQueue()
 {
-	if (fence)
+	if (timeline_semaphore)
 	{
-		vkDestroyFence(VulkanUtils::getNativeRHI()->device->logicalHandle, fence, nullptr);
-		fence = nullptr;
+		vkDestroySemaphore(VulkanUtils::getNativeRHI()->device->logicalHandle, timeline_semaphore, nullptr);
+		timeline_semaphore = VK_NULL_HANDLE;
 	}
 }
 
@@ -34,7 +39,8 @@ void VulkanCommandQueue::execute(RHICommandList *cmd_list, VkSubmitInfo submit_i
 	submit_info.pCommandBuffers = &native_cmd_list->cmd_buffer;
 
 	// Reset fence before submission.
-	vkResetFences(VulkanUtils::getNativeRHI()->device->logicalHandle, 1, &fence);
+	if (fence)
+		vkResetFences(VulkanUtils::getNativeRHI()->device->logicalHandle, 1, &fence);
 	vkQueueSubmit(queue, 1, &submit_info, fence);
 }
 
@@ -46,8 +52,49 @@ void VulkanCommandQueue::execute(RHICommandList *cmd_list)
 	execute(cmd_list, submitInfo);
 }
 
+void VulkanCommandQueue::signal(uint64_t fence_value)
+{
+	// Set fence value on execution end
+	last_fence_value = fence_value;
+	if (!timeline_semaphore)
+		return;
+
+	VkTimelineSemaphoreSubmitInfo timeline_info{};
+	timeline_info.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+	timeline_info.signalSemaphoreValueCount = 1;
+	timeline_info.pSignalSemaphoreValues = &fence_value;
+
+	VkSubmitInfo submit_info{};
+	submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+	submit_info.pNext = &timeline_info;
+	submit_info.signalSemaphoreCount = 1;
+	submit_info.pSignalSemaphores = &timeline_semaphore;
+	vkQueueSubmit(queue, 1, &submit_info, VK_NULL_HANDLE);
+}
+
 void VulkanCommandQueue::wait(uint64_t fence_value)
 {
+	if (timeline_semaphore)
+	{
+		VkSemaphoreWaitInfo wait_info{};
+		wait_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+		wait_info.semaphoreCount = 1;
+		wait_info.pSemaphores = &timeline_semaphore;
+		wait_info.pValues = &fence_value;
+		vkWaitSemaphores(VulkanUtils::getNativeRHI()->device->logicalHandle, &wait_info, UINT64_MAX);
+		return;
+	}
+
 	// Wait for fence to complete
 	vkWaitForFences(VulkanUtils::getNativeRHI()->device->logicalHandle, 1, &fence, VK_TRUE, UINT64_MAX);
 }
+
+uint64_t VulkanCommandQueue::getCompletedFenceValue()
+{
+	if (!timeline_semaphore)
+		return last_fence_value;
+
+	uint64_t value = 0;
+	vkGetSemaphoreCounterValue(VulkanUtils::getNativeRHI()->device->logicalHandle, timeline_semaphore, &value);
+	return value;
+}
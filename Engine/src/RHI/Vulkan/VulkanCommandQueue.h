@@ -4,19 +4,15 @@
 class VulkanCommandQueue final: public RHICommandQueue
 {
 public:
-	VulkanCommandQueue(VkQueue queue, bool create_fence = true);
+	VulkanCommandQueue(VkQueue queue, bool create_timeline = true);
 	~VulkanCommandQueue();
 
 	void execute(RHICommandList *cmd_list, VkSubmitInfo submit_info);
 
 	void execute(RHICommandList *cmd_list) override;
 
-	void signal(uint64_t fence_value) override
-	{
-		// Set fence value on execution end
-		last_fence_value = fence_value;
-	}
-	
+	void signal(uint64_t fence_value) override;
+
 	void wait(uint64_t fence_value) override;
 
 	void waitIdle() override
@@ -24,13 +20,16 @@ public:
 		vkQueueWaitIdle(queue);
 	}
 
-	uint32_t getLastFenceValue() override
+	uint64_t getLastFenceValue() override
 	{
 		return last_fence_value;
 	}
 
+	uint64_t getCompletedFenceValue() override;
+
 	VkQueue queue;
-	VkFence fence;
+	VkFence fence = VK_NULL_HANDLE; // Binary fence set by the owner for each submission (frame queue)
+	VkSemaphore timeline_semaphore = VK_NULL_HANDLE; // Signaled with fence values (copy queue)
 
-	uint32_t last_fence_value = 0;
+	uint64_t last_fence_value = 0;
 };
\ No newline at end of file
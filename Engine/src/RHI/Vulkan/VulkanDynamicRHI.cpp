@@ -450,10 +450,16 @@ void VulkanDynamicRHI::endFrame()
 	VkSubmitInfo submit_info{};
 	submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
 
-	// Wait when semaphore when image will get acquired
-	VkSemaphore wait_semaphores[] = {imageAvailableSemaphores[frame_in_flight]};
-	VkPipelineStageFlags wait_stages[] = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
-	submit_info.waitSemaphoreCount = 1;
+	// Wait when semaphore when image will get acquired and for the uploads submitted to the copy queue
+	VkSemaphore wait_semaphores[] = {imageAvailableSemaphores[frame_in_flight], cmd_copy_queue->timeline_semaphore};
+	VkPipelineStageFlags wait_stages[] = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT};
+	uint64_t wait_values[] = {0, cmd_copy_queue->getLastFenceValue()}; // Value of binary semaphore is ignored
+	VkTimelineSemaphoreSubmitInfo timeline_info{};
+	timeline_info.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+	timeline_info.waitSemaphoreValueCount = 2;
+	timeline_info.pWaitSemaphoreValues = wait_values;
+	submit_info.pNext = &timeline_info;
+	submit_info.waitSemaphoreCount = 2;
 	submit_info.pWaitSemaphores = wait_semaphores;
 	submit_info.pWaitDstStageMask = wait_stages;
 	submit_info.commandBufferCount = 1;
@@ -44,6 +44,7 @@ public:
 
 	RHICommandList *getCmdList() override { return cmd_lists[frame_in_flight]; };
 	RHICommandList *getCmdListCopy() override { return cmd_list_immediate; };
+	RHICommandList *createCmdListCopy() override { return new VulkanCommandList(); }
 
 	Upscaler *getUpscaler() override { return &dlss_upscaler; }
 	StreamlineAdapter *getStreamline() override { return &streamline; }
@@ -2,6 +2,7 @@
 #include "VulkanTexture.h"
 #include "VulkanUtils.h"
 #include "VulkanDynamicRHI.h"
+#include "RHI/RHIUploadBatch.h"
 #include "Rendering/GlobalPipeline.h"
 
 
@@ -69,41 +70,19 @@ void VulkanTexture::fill(const void *sourceData)
 {
 	fill();
 
-	// Create staging buffer
-	VkDeviceSize image_size = get_image_size();
-	VkBuffer stagingBuffer;
-	VmaAllocation stagingAllocation;
-	VulkanUtils::createBuffer(image_size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VmaMemoryUsage::VMA_MEMORY_USAGE_CPU_ONLY, 0, stagingBuffer, stagingAllocation);
-
-	// Copy data to staging
-	void *data;
-	vmaMapMemory(VulkanUtils::getNativeRHI()->allocator, stagingAllocation, &data);
-	memcpy(data, sourceData, static_cast<size_t>(image_size));
-	vmaUnmapMemory(VulkanUtils::getNativeRHI()->allocator, stagingAllocation);
-
-
-	{
-		VulkanDynamicRHI *rhi = (VulkanDynamicRHI *)gDynamicRHI;
-		RHICommandList *copy_cmd_list = gDynamicRHI->getCmdListCopy();
-		VulkanCommandList *native_copy_cmd_list = (VulkanCommandList *)copy_cmd_list;
-		// Upload buffer data.
-		copy_cmd_list->open();
-
-		transitLayout(copy_cmd_list, TEXTURE_LAYOUT_TRANSFER_DST);
-
-		copy_buffer_to_image(native_copy_cmd_list->cmd_buffer, stagingBuffer);
-
-		transitLayout(copy_cmd_list, TEXTURE_LAYOUT_SHADER_READ);
-
-		copy_cmd_list->close();
+	// Upload batch of one, use RHIUploadBatch directly to not wait
+	RHIUploadBatch batch;
+	batch.uploadTexture(this, sourceData);
+	RHIUploadBatch::wait(batch.submit());
+}
 
-		gDynamicRHI->getCmdQueueCopy()->execute(copy_cmd_list);
-		gDynamicRHI->getCmdQueueCopy()->waitIdle();
-	}
+void VulkanTexture::recordUpload(RHICommandList *cmd_list, RHIBuffer *staging, uint64_t staging_offset)
+{
+	VulkanCommandList *native_cmd_list = (VulkanCommandList *)cmd_list;
 
-	// Destroy unused buffers
-	vkDestroyBuffer(VulkanUtils::getNativeRHI()->device->logicalHandle, stagingBuffer, nullptr);
-	vmaFreeMemory(VulkanUtils::getNativeRHI()->allocator, stagingAllocation);
+	transitLayout(cmd_list, TEXTURE_LAYOUT_TRANSFER_DST);
+	copy_buffer_to_image(native_cmd_list->cmd_buffer, ((VulkanBuffer *)staging)->getBuffer(), staging_offset);
+	transitLayout(cmd_list, TEXTURE_LAYOUT_SHADER_READ);
 }
 
 void VulkanTexture::clear(const glm::vec4 &color)
@@ -135,7 +114,8 @@ void VulkanTexture::load(const char *path)
 	if (description.format == FORMAT_UNDEFINED || image.isCompressedFormat())
 		description.format = image.getFormat();
 	set_native_format();
-	fill(image.getRawData().data());
+	fill();
+	RHIUploadBatch::enqueueTexture(this, image.getData().data());
 
 	this->path = path;
 }
@@ -27,6 +27,10 @@ public:
 
 	void transitLayout(RHICommandList *cmd_list, TextureLayoutType new_layout_type, int mip = -1) override;
 
+	uint64_t getUploadSize() const override { return get_image_size(); }
+	void writeUploadData(uint8_t *dst, const void *source_data) const override { memcpy(dst, source_data, get_image_size()); }
+	void recordUpload(RHICommandList *cmd_list, RHIBuffer *staging, uint64_t staging_offset) override;
+
 	void generateMipmaps(RHICommandList *cmd_list);
 
 	bool isValid() const override { return image != nullptr; }
@@ -52,12 +56,12 @@ protected:
 		image->resource = *reinterpret_cast<VkImage *>(raw_resource);
 	}
 
-	void copy_buffer_to_image(VkCommandBuffer command_buffer, VkBuffer buffer)
+	void copy_buffer_to_image(VkCommandBuffer command_buffer, VkBuffer buffer, VkDeviceSize buffer_offset = 0)
 	{
 		eastl::vector<VkBufferImageCopy> regions;
 		regions.reserve(description.mip_levels);
 
-		int offset = 0;
+		VkDeviceSize offset = buffer_offset;
 		for (int i = 0; i < description.mip_levels; i++)
 		{
 			VkBufferImageCopy &region = regions.emplace_back();
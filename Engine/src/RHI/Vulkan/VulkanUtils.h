@@ -103,6 +103,9 @@ public:
 			case FORMAT_BC3: return VK_FORMAT_BC3_UNORM_BLOCK;
 			case FORMAT_BC5: return VK_FORMAT_BC5_UNORM_BLOCK;
 			case FORMAT_BC7: return VK_FORMAT_BC7_UNORM_BLOCK;
+			case FORMAT_BC1_SRGB: return VK_FORMAT_BC1_RGB_SRGB_BLOCK;
+			case FORMAT_BC4: return VK_FORMAT_BC4_UNORM_BLOCK;
+			case FORMAT_BC7_SRGB: return VK_FORMAT_BC7_SRGB_BLOCK;
 		}
 	}
 
@@ -141,6 +144,9 @@ public:
 			case FORMAT_BC3: return 0;
 			case FORMAT_BC5: return 0;
 			case FORMAT_BC7: return 0;
+			case FORMAT_BC1_SRGB: return 0;
+			case FORMAT_BC4: return 0;
+			case FORMAT_BC7_SRGB: return 0;
 		}
 	}
 
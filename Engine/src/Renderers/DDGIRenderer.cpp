@@ -129,6 +129,21 @@ void DDGIRenderer::addPasses(FrameGraph & fg, Ref<RayTracingScene> rt_scene)
 		volume.probes_to_update_buffer_id = probes_to_update_buffer->getShaderResourceView()->getBindlessIndex();
 	}
 
+	int probe_changes_size = sizeof(uint32_t) * volume.getProbesCount();
+	if (!probe_changes_buffer || probe_changes_buffer->getSize() != probe_changes_size)
+	{
+		BufferDescription desc;
+		desc.size = probe_changes_size;
+		desc.usage = BufferUsage::SHADER_WRITE_BUFFER;
+		desc.use_staging_buffer = false;
+		probe_changes_buffer = gDynamicRHI->createBuffer(desc);
+		probe_changes_buffer->setDebugName("DDGI Probe Changes Buffer");
+
+		// Reports of the previous layout don't match the probes anymore
+		probe_changes_readbacks.clear();
+		scheduler.reset(volume.getProbesCount());
+	}
+
 	fg.importTexture(GFXRID(DDGIDistance), distance_atlas_texture);
 	fg.importTexture(GFXRID(DDGIIrradiance), irradiance_atlas_texture);
 	fg.importTexture(GFXRID(DDGIMetadata), metadata_atlas_texture);
@@ -176,6 +191,14 @@ void DDGIRenderer::addPasses(FrameGraph & fg, Ref<RayTracingScene> rt_scene)
 
 	volume_buffer->fill(&volume);
 
+	// Probes moved, everything they have is from other places
+	if (scheduled_origin != volume.origin || scheduled_spacing != volume.spacing)
+	{
+		scheduled_origin = volume.origin;
+		scheduled_spacing = volume.spacing;
+		is_all_scene_changed = true;
+	}
+
 	if (!Math::isPowerOfTwo(ddgi.probes_per_frame))
 	{
 		CORE_ERROR("DDGIRenderer::addPasses() skipped because probes_per_frame must be power of two!");
@@ -192,9 +215,19 @@ void DDGIRenderer::addPasses(FrameGraph & fg, Ref<RayTracingScene> rt_scene)
 		addResetClassificationPass(fg);
 	prev_use_classification = ddgi.use_classification;
 
+	if (ddgi.adaptive_update)
+	{
+		read_probe_changes();
+		mark_changed_probes();
+	}
+	changed_bounds.clear();
+	is_all_scene_changed = false;
+
 	update_probes();
 	addTraceRaysPass(fg, rt_scene);
 	addUpdatePass(fg);
+	if (ddgi.adaptive_update)
+		addProbeChangesReadbackPass(fg);
 
 	if (ddgi.use_relocation)
 		addRelocationPass(fg);
@@ -264,6 +297,10 @@ void DDGIRenderer::update_probes()
 	{
 		for (int i = 0; i < volume.getProbesCount(); i++)
 			probes_to_update.push_back(i);
+	} else if (GFXOPTIONS(ddgi).adaptive_update)
+	{
+		scheduler.max_age = eastl::max(GFXOPTIONS(ddgi).max_probe_age, 1);
+		scheduler.schedule(GFXOPTIONS(ddgi).probes_per_frame, probes_to_update);
 	} else
 	{
 		uint32_t budget_per_cascade = GFXOPTIONS(ddgi).probes_per_frame / volume.cascades_count;
@@ -284,6 +321,97 @@ void DDGIRenderer::update_probes()
 	probes_to_update_buffer->fill(probes_to_update.data());	
 }
 
+void DDGIRenderer::mark_changed_probes()
+{
+	PROFILE_CPU_FUNCTION();
+
+	if (is_all_scene_changed)
+	{
+		scheduler.markAllSceneChanged();
+		return;
+	}
+
+	// Probes of the cells the bounds touch and one more around, their rays reach the change
+	for (const BoundBox &bounds : changed_bounds)
+	{
+		for (uint32_t c = 0; c < volume.cascades_count; c++)
+		{
+			glm::vec3 cascade_min = glm::vec3(volume.cascades[c].min);
+			glm::vec3 spacing = glm::vec3(volume.cascades[c].spacing);
+			glm::ivec3 size = glm::ivec3(volume.size);
+			glm::ivec3 first = glm::clamp(glm::ivec3(glm::ceil((bounds.min - cascade_min) / spacing)) - 1, glm::ivec3(0), size - 1);
+			glm::ivec3 last = glm::clamp(glm::ivec3(glm::floor((bounds.max - cascade_min) / spacing)) + 1, glm::ivec3(0), size - 1);
+			if (bounds.max.x < cascade_min.x - spacing.x || bounds.min.x > cascade_min.x + spacing.x * size.x
+				|| bounds.max.y < cascade_min.y - spacing.y || bounds.min.y > cascade_min.y + spacing.y * size.y
+				|| bounds.max.z < cascade_min.z - spacing.z || bounds.min.z > cascade_min.z + spacing.z * size.z)
+				continue;
+
+			// Same layout as GetProbeIndex in ddgi_common.hlsl
+			for (int y = first.y; y <= last.y; y++)
+				for (int z = first.z; z <= last.z; z++)
+					for (int x = first.x; x <= last.x; x++)
+						scheduler.markSceneChanged(c * volume.size.w + y * size.x * size.z + z * size.x + x);
+		}
+	}
+}
+
+void DDGIRenderer::read_probe_changes()
+{
+	PROFILE_CPU_FUNCTION();
+
+	for (ProbeChangesReadback &readback : probe_changes_readbacks)
+	{
+		if (!readback.is_pending || gDynamicRHI->getFrame() - readback.frame <= MAX_FRAMES_IN_FLIGHT)
+			continue;
+
+		void *mapped;
+		readback.buffer->map(&mapped);
+		const float *changes = (const float *)mapped;
+		for (uint32_t probe : readback.probes)
+			scheduler.reportChange(probe, changes[probe]);
+		readback.buffer->unmap();
+		readback.is_pending = false;
+	}
+}
+
+void DDGIRenderer::addProbeChangesReadbackPass(FrameGraph &fg)
+{
+	// Slot is taken now, so probes of this frame are kept with it
+	ProbeChangesReadback *readback = nullptr;
+	for (ProbeChangesReadback &slot : probe_changes_readbacks)
+	{
+		if (!slot.is_pending)
+		{
+			readback = &slot;
+			break;
+		}
+	}
+	if (!readback)
+	{
+		readback = &probe_changes_readbacks.push_back();
+		BufferDescription desc;
+		desc.size = probe_changes_buffer->getSize();
+		desc.usage = BufferUsage::READBACK_BUFFER;
+		desc.use_staging_buffer = false;
+		readback->buffer = gDynamicRHI->createBuffer(desc);
+		readback->buffer->setDebugName("DDGI Probe Changes Readback");
+	}
+	readback->probes = probes_to_update;
+	readback->frame = gDynamicRHI->getFrame();
+	readback->is_pending = true;
+
+	RHIBuffer *readback_buffer = readback->buffer;
+	fg.addCallbackPass("DDGI Probe Changes Readback Pass",
+	[&](RenderPassBuilder &builder)
+	{
+		builder.setSideEffect(true);
+	},
+	[=](const RenderPassResources &resources, RHICommandList *cmd_list)
+	{
+		cmd_list->copyBuffer(probe_changes_buffer, readback_buffer, 0, 0, probe_changes_buffer->getSize());
+	});
+}
+
 void DDGIRenderer::addTraceRaysPass(FrameGraph &fg, Ref<RayTracingScene> rt_scene)
 {
 	fg.addCallbackPass("DDGI Trace Rays Pass",
@@ -326,8 +454,14 @@ void DDGIRenderer::addUpdatePass(FrameGraph & fg)
 		gGlobalPipeline->setupComputePipeline(gDynamicRHI->createShader(L"shaders/ddgi/ddgi_update_probe.hlsl", COMPUTE_SHADER, "CSMain", calculateDefines({{"NUM_TEXELS", "8"}, {"IRRADIANCE", "1"}})));
 		gGlobalPipeline->flushAndBind(cmd_list);
 
-		uint32_t irradiance_uav_id = resources.getReadWriteTexture(GFXRID(DDGIIrradiance));
-		gDynamicRHI->setConstantBufferData(1, &irradiance_uav_id, sizeof(uint32_t));
+		struct
+		{
+			uint32_t output_atlas_tex_id;
+			uint32_t probe_changes_buffer_id;
+		} constants;
+		constants.output_atlas_tex_id = resources.getReadWriteTexture(GFXRID(DDGIIrradiance));
+		constants.probe_changes_buffer_id = probe_changes_buffer->getUnorderedAccessView()->getBindlessIndex();
+		gDynamicRHI->setConstantBufferData(1, &constants, sizeof(constants));
 
 		cmd_list->dispatch(probes_to_update.size(), 1, 1);
 		gDynamicRHI->waitGPU();
@@ -2,6 +2,8 @@
 #include "FrameGraph/FrameGraph.h"
 #include "RHI/RayTracing/RayTracingScene.h"
 #include "Rendering/Mesh.h"
+#include "Rendering/DDGIProbeScheduler.h"
+#include "Math/BoundBox.h"
 
 class DDGIRenderer
 {
@@ -39,12 +41,19 @@ public:
 	void addPasses(FrameGraph &fg, Ref<RayTracingScene> rt_scene);
 	void addVisualizePass(FrameGraph &fg);
 
+	// Geometry or lights changed in the bounds, probes around them are updated sooner
+	void markSceneChanged(const BoundBox &bounds) { changed_bounds.push_back(bounds); }
+	void markAllSceneChanged() { is_all_scene_changed = true; }
+
 	DDGIVolumeGPU getVolume() const { return volume; }
 	uint32_t getVolumeBufferId() const { return volume_buffer->getShaderResourceView()->getBindlessIndex(); }
 private:
 	eastl::vector<eastl::pair<const char *, const char *>> calculateDefines(eastl::vector<eastl::pair<const char *, const char *>> additional = {});
 
 	void update_probes();
+	void mark_changed_probes();
+	void read_probe_changes();
+	void addProbeChangesReadbackPass(FrameGraph &fg);
 
 	void addTraceRaysPass(FrameGraph &fg, Ref<RayTracingScene> rt_scene);
 	void addUpdatePass(FrameGraph &fg);
@@ -65,6 +74,23 @@ private:
 	};
 	eastl::vector<CascadeUpdateData> cascades_update {5};
 
+	DDGIProbeScheduler scheduler;
+	eastl::vector<BoundBox> changed_bounds;
+	bool is_all_scene_changed = false;
+	glm::vec3 scheduled_origin = glm::vec3(0.0f);
+	glm::vec3 scheduled_spacing = glm::vec3(0.0f);
+
+	// Irradiance changes reported by the update pass, read back MAX_FRAMES_IN_FLIGHT frames later
+	struct ProbeChangesReadback
+	{
+		RHIBufferRef buffer;
+		eastl::vector<uint32_t> probes;
+		uint64_t frame = 0;
+		bool is_pending = false;
+	};
+	RHIBufferRef probe_changes_buffer;
+	eastl::vector<ProbeChangesReadback> probe_changes_readbacks;
+
 	RHIBufferRef ray_data_buffer;
 	RHITextureRef distance_atlas_texture;
 	RHITextureRef irradiance_atlas_texture;
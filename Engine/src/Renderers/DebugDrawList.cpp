@@ -0,0 +1,87 @@
+#include "pch.h"
+#include "DebugDrawList.h"
+#include "RHI/DynamicRHI.h"
+
+void DebugDrawList::addLine(glm::vec3 p0, glm::vec3 p1, glm::vec3 color)
+{
+	// Unit line goes along x, y and z axes are not used
+	glm::mat4 transform(1.0f);
+	transform[0] = glm::vec4(p1 - p0, 0.0f);
+	transform[3] = glm::vec4(p0, 1.0f);
+	addPrimitive(DEBUG_PRIMITIVE_LINE, transform, color);
+}
+
+void DebugDrawList::addBox(glm::vec3 half_extents, const glm::mat4 &transform, glm::vec3 color)
+{
+	addPrimitive(DEBUG_PRIMITIVE_BOX, transform * glm::scale(glm::mat4(1.0f), half_extents), color);
+}
+
+void DebugDrawList::addBoundBox(const BoundBox &bbox, glm::vec3 color)
+{
+	addBox(bbox.getSize() / 2.0f, glm::translate(glm::mat4(1.0f), bbox.getCenter()), color);
+}
+
+void DebugDrawList::addSphere(glm::vec3 center, float radius, glm::vec3 color)
+{
+	glm::mat4 transform(radius);
+	transform[3] = glm::vec4(center, 1.0f);
+	addPrimitive(DEBUG_PRIMITIVE_SPHERE, transform, color);
+}
+
+void DebugDrawList::clear()
+{
+	for (eastl::vector<DebugPrimitiveGPU> &type_primitives : primitives)
+		type_primitives.clear();
+	is_dirty = true;
+}
+
+uint32_t DebugDrawList::getTotalCount() const
+{
+	uint32_t count = 0;
+	for (const eastl::vector<DebugPrimitiveGPU> &type_primitives : primitives)
+		count += type_primitives.size();
+	return count;
+}
+
+void DebugDrawList::upload()
+{
+	if (!is_dirty)
+		return;
+	is_dirty = false;
+
+	uint32_t count = getTotalCount();
+	if (count == 0)
+		return;
+
+	current_buffer = (current_buffer + 1) % MAX_FRAMES_IN_FLIGHT;
+	uint64_t size = uint64_t(count) * sizeof(DebugPrimitiveGPU);
+	RHIBufferRef &buffer = buffers[current_buffer];
+	if (!buffer || buffer->getSize() < size)
+	{
+		// Host visible, shaders read it in place
+		BufferDescription desc;
+		desc.size = eastl::max(size, buffer ? buffer->getSize() * 2 : 0);
+		desc.storage_stride = sizeof(uint32_t);
+		desc.use_staging_buffer = false;
+		desc.usage = BufferUsage::SHADER_READ_BUFFER;
+		buffer = gDynamicRHI->createBuffer(desc);
+		buffer->setDebugName("Debug Primitives Buffer");
+		buffer->map((void **)&buffers_data[current_buffer]);
+	}
+
+	uint32_t offset = 0;
+	for (uint32_t type = 0; type < DEBUG_PRIMITIVE_TYPES_COUNT; type++)
+	{
+		offsets[type] = offset;
+		uint32_t type_size = primitives[type].size() * sizeof(DebugPrimitiveGPU);
+		if (type_size > 0)
+			memcpy(buffers_data[current_buffer] + offset, primitives[type].data(), type_size);
+		offset += type_size;
+	}
+	uploads_count++;
+}
+
+uint32_t DebugDrawList::getBindlessIndex() const
+{
+	return buffers[current_buffer]->getShaderResourceView()->getBindlessIndex();
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include "RHI/RHIBuffer.h"
+#include "Math/BoundBox.h"
+#include "Rendering/ShaderStructs.h"
+#include <EASTL/array.h>
+
+// Wireframe primitives drawn instanced, one draw per primitive type.
+// A list keeps its primitives in a GPU buffer until they change, so a retained list costs nothing per frame while
+// it stays the same. DebugRenderer has one list that is refilled every frame for immediate drawing
+class DebugDrawList
+{
+public:
+	void addLine(glm::vec3 p0, glm::vec3 p1, glm::vec3 color = glm::vec3(0, 0, 0));
+	void addBox(glm::vec3 half_extents, const glm::mat4 &transform, glm::vec3 color = glm::vec3(0, 0, 0));
+	void addBoundBox(const BoundBox &bbox, glm::vec3 color = glm::vec3(0, 0, 0));
+	void addSphere(glm::vec3 center, float radius, glm::vec3 color = glm::vec3(0, 0, 0));
+	// Transform of the unit primitive
+	void addPrimitive(uint32_t type, const glm::mat4 &transform, glm::vec3 color)
+	{
+		primitives[type].push_back({transform, glm::vec4(color, 1.0f)});
+		is_dirty = true;
+	}
+
+	void reserve(uint32_t type, uint32_t count) { primitives[type].reserve(count); }
+	void clear();
+
+	bool isEmpty() const { return getTotalCount() == 0; }
+	uint32_t getCount(uint32_t type) const { return primitives[type].size(); }
+	uint32_t getTotalCount() const;
+
+	// Copies primitives into the next buffer if they changed since the last upload, call once per frame at most
+	void upload();
+	// Raw buffer with primitives of the last upload
+	uint32_t getBindlessIndex() const;
+	// Byte offset of the first primitive of the type
+	uint32_t getOffset(uint32_t type) const { return offsets[type]; }
+	// Number of uploads that copied primitives
+	uint32_t getUploadsCount() const { return uploads_count; }
+
+private:
+	eastl::array<eastl::vector<DebugPrimitiveGPU>, DEBUG_PRIMITIVE_TYPES_COUNT> primitives;
+	bool is_dirty = false;
+
+	// Written buffers rotate, so frames in flight keep reading the previous ones
+	RHIBufferRef buffers[MAX_FRAMES_IN_FLIGHT];
+	uint8_t *buffers_data[MAX_FRAMES_IN_FLIGHT] = {};
+	uint32_t current_buffer = 0;
+	eastl::array<uint32_t, DEBUG_PRIMITIVE_TYPES_COUNT> offsets = {};
+	uint32_t uploads_count = 0;
+};
@@ -7,26 +7,32 @@
 
 #define MAX_NUM_LINES 731072
 
+// PrimitivesConstants in shaders
+struct PrimitivesConstants
+{
+	uint32_t primitives_buffer_id;
+	uint32_t primitives_offset; // byte offset of the first primitive of the type
+	uint32_t primitive_type;
+};
+
+static uint32_t get_primitive_vertex_count(uint32_t type)
+{
+	switch (type)
+	{
+		case DEBUG_PRIMITIVE_LINE: return 2;
+		case DEBUG_PRIMITIVE_BOX: return 24;
+		default: return 3 * 2 * DEBUG_SPHERE_SEGMENTS;
+	}
+}
+
 DebugRenderer::DebugRenderer()
 {
-	vertex_shader_lines = gDynamicRHI->createShader(L"shaders/debug_lines.hlsl", VERTEX_SHADER);
+	vertex_shader_primitives = gDynamicRHI->createShader(L"shaders/debug_lines.hlsl", VERTEX_SHADER, "VSPrimitives");
 	fragment_shader_lines = gDynamicRHI->createShader(L"shaders/debug_lines.hlsl", FRAGMENT_SHADER);
 
 	vertex_shader_gpu_lines = gDynamicRHI->createShader(L"shaders/debug_lines.hlsl", VERTEX_SHADER, "VSGpuLines");
 
 	BufferDescription desc;
-
-	vertices = new LineVertex[MAX_NUM_LINES];
-	
-	desc.size = sizeof(LineVertex) * MAX_NUM_LINES;
-	desc.storage_stride = sizeof(LineVertex);
-	desc.use_staging_buffer = false;
-	desc.usage = BufferUsage::VERTEX_BUFFER;
-
-	lines_vertex_buffer = gDynamicRHI->createBuffer(desc);
-	lines_vertex_buffer->map((void **)&vertices);
-	lines_vertex_buffer->setDebugName("Lines Vertex Buffer");
-
 	desc.size = sizeof(uint32_t) + sizeof(LineVertex) * MAX_NUM_LINES;
 	desc.storage_stride = sizeof(uint32_t);
 	desc.use_staging_buffer = true;
@@ -34,12 +40,22 @@ DebugRenderer::DebugRenderer()
 	lines_gpu_buffer = gDynamicRHI->createBuffer(desc);
 	lines_gpu_buffer->setDebugName("Lines GPU Vertex Buffer");
 
+	desc.size = DEBUG_PRIMITIVE_TYPES_COUNT * sizeof(uint32_t) + DEBUG_PRIMITIVE_TYPES_COUNT * MAX_GPU_DEBUG_PRIMITIVES * sizeof(DebugPrimitiveGPU);
+	primitives_gpu_buffer = gDynamicRHI->createBuffer(desc);
+	primitives_gpu_buffer->setDebugName("Debug Primitives GPU Buffer");
+
 	desc.size = sizeof(DrawIndirect);
 	desc.storage_stride = sizeof(DrawIndirect);
 	desc.use_staging_buffer = true;
 	desc.usage = BufferUsage::INDIRECT_ARGS_BUFFER | BufferUsage::SHADER_WRITE_BUFFER;
 	lines_draw_args_buffer = gDynamicRHI->createBuffer(desc);
 	lines_draw_args_buffer->setDebugName("Lines GPU Draw Args Buffer");
+
+	for (uint32_t type = 0; type < DEBUG_PRIMITIVE_TYPES_COUNT; type++)
+	{
+		primitives_draw_args_buffers[type] = gDynamicRHI->createBuffer(desc);
+		primitives_draw_args_buffers[type]->setDebugName("Debug Primitives GPU Draw Args Buffer");
+	}
 }
 
 DebugRenderer::~DebugRenderer()
@@ -61,57 +77,13 @@ void DebugRenderer::addPasses(FrameGraph &fg)
 void DebugRenderer::addBox(glm::vec3 half_extents, glm::mat4 transform, glm::vec3 color)
 {
 	if (!isEnabled()) return;
-	glm::vec3 corners[8] =
-	{
-		glm::vec3(-half_extents.x, -half_extents.y, -half_extents.z),
-		glm::vec3( half_extents.x, -half_extents.y, -half_extents.z),
-		glm::vec3( half_extents.x,  half_extents.y, -half_extents.z),
-		glm::vec3(-half_extents.x,  half_extents.y, -half_extents.z),
-		glm::vec3(-half_extents.x, -half_extents.y,  half_extents.z),
-		glm::vec3( half_extents.x, -half_extents.y,  half_extents.z),
-		glm::vec3( half_extents.x,  half_extents.y,  half_extents.z),
-		glm::vec3(-half_extents.x,  half_extents.y,  half_extents.z) 
-	};
-
-	for (int i = 0; i < 8; ++i)
-	{
-		corners[i] = glm::vec3(transform * glm::vec4(corners[i], 1.0f));
-	}
-
-	int edges[12][2] =
-	{
-		{0, 1}, {1, 2}, {2, 3}, {3, 0},
-		{4, 5}, {5, 6}, {6, 7}, {7, 4},
-		{0, 4}, {1, 5}, {2, 6}, {3, 7}
-	};
-
-	for (int i = 0; i < 12; ++i)
-	{
-		glm::vec3 p0 = corners[edges[i][0]];
-		glm::vec3 p1 = corners[edges[i][1]];
-		addLine(p0, p1, color);
-	}
+	frame_list.addBox(half_extents, transform, color);
 }
 
-void DebugRenderer::addBoundBox(BoundBox bbox)
+void DebugRenderer::addBoundBox(BoundBox bbox, glm::vec3 color)
 {
 	if (!isEnabled()) return;
-	addLine(bbox.min, glm::vec3(bbox.max.x, bbox.min.y, bbox.min.z));
-	addLine(bbox.min, glm::vec3(bbox.min.x, bbox.max.y, bbox.min.z));
-	addLine(bbox.min, glm::vec3(bbox.min.x, bbox.min.y, bbox.max.z));
-
-	addLine(bbox.max, glm::vec3(bbox.min.x, bbox.max.y, bbox.max.z));
-	addLine(bbox.max, glm::vec3(bbox.max.x, bbox.min.y, bbox.max.z));
-	addLine(bbox.max, glm::vec3(bbox.max.x, bbox.max.y, bbox.min.z));
-
-	addLine(glm::vec3(bbox.min.x, bbox.max.y, bbox.min.z), glm::vec3(bbox.min.x, bbox.max.y, bbox.max.z));
-	addLine(glm::vec3(bbox.min.x, bbox.max.y, bbox.min.z), glm::vec3(bbox.max.x, bbox.max.y, bbox.min.z));
-
-	addLine(glm::vec3(bbox.max.x, bbox.max.y, bbox.min.z), glm::vec3(bbox.max.x, bbox.min.y, bbox.min.z));
-	addLine(glm::vec3(bbox.max.x, bbox.min.y, bbox.min.z), glm::vec3(bbox.max.x, bbox.min.y, bbox.max.z));
-
-	addLine(glm::vec3(bbox.min.x, bbox.min.y, bbox.max.z), glm::vec3(bbox.max.x, bbox.min.y, bbox.max.z));
-	addLine(glm::vec3(bbox.min.x, bbox.min.y, bbox.max.z), glm::vec3(bbox.min.x, bbox.max.y, bbox.max.z));
+	frame_list.addBoundBox(bbox, color);
 }
 
 void DebugRenderer::addFrustum(glm::mat4 frustum, glm::vec3 color)
@@ -147,32 +119,10 @@ void DebugRenderer::addFrustum(glm::mat4 frustum, glm::vec3 color)
 	addLine(corners[3], corners[7], color);
 }
 
-void DebugRenderer::addSphere(glm::vec3 center, float radius, int segments, glm::vec3 color)
+void DebugRenderer::addSphere(glm::vec3 center, float radius, glm::vec3 color)
 {
 	if (!isEnabled()) return;
-	if (segments < 3) segments = 3;
-	
-	addCirlce(center, glm::vec3(0, 0, 1), radius, segments, color);
-	addCirlce(center, glm::vec3(0, 1, 0), radius, segments, color);
-	addCirlce(center, glm::vec3(1, 0, 0), radius, segments, color);
-	
-	glm::vec3 diagonal_normal = glm::normalize(glm::vec3(1, 1, 0));
-	if (glm::length(diagonal_normal) > 0.001f)
-	{
-		addCirlce(center, diagonal_normal, radius, segments, color);
-	}
-	
-	diagonal_normal = glm::normalize(glm::vec3(1, 0, 1));
-	if (glm::length(diagonal_normal) > 0.001f)
-	{
-		addCirlce(center, diagonal_normal, radius, segments, color);
-	}
-	
-	diagonal_normal = glm::normalize(glm::vec3(0, 1, 1));
-	if (glm::length(diagonal_normal) > 0.001f)
-	{
-		addCirlce(center, diagonal_normal, radius, segments, color);
-	}
+	frame_list.addSphere(center, radius, color);
 }
 
 eastl::vector<glm::vec3> DebugRenderer::addCirlce(glm::vec3 center, glm::vec3 normal, float radius, int segments, glm::vec3 color)
@@ -242,6 +192,31 @@ void DebugRenderer::addArrow(glm::vec3 p0, glm::vec3 p1, float arrow_size)
 	addLine(p1, arrowhead_point4);
 }
 
+void DebugRenderer::addDrawList(DebugDrawList *list)
+{
+	if (!isEnabled()) return;
+	frame_lists.push_back(list);
+}
+
+void DebugRenderer::draw_list(RHICommandList *cmd_list, DebugDrawList &list)
+{
+	list.upload();
+
+	PrimitivesConstants constants;
+
+	for (uint32_t type = 0; type < DEBUG_PRIMITIVE_TYPES_COUNT; type++)
+	{
+		if (list.getCount(type) == 0)
+			continue;
+
+		constants.primitives_buffer_id = list.getBindlessIndex();
+		constants.primitives_offset = list.getOffset(type);
+		constants.primitive_type = type;
+		gDynamicRHI->setConstantBufferData(1, &constants, sizeof(constants));
+		cmd_list->drawInstanced(get_primitive_vertex_count(type), list.getCount(type), 0, 0);
+	}
+}
+
 void DebugRenderer::addTextureDebugPass(FrameGraph &fg)
 {
 	fg.addCallbackPass("Debug Pass",
@@ -319,6 +294,9 @@ void DebugRenderer::addVisualizerPass(FrameGraph & fg)
 {
 	fg.importBuffer(GFXRID(DebugLinesBuffer), lines_gpu_buffer);
 	fg.importBuffer(GFXRID(DebugLinesDrawArgsBuffer), lines_draw_args_buffer);
+	fg.importBuffer(GFXRID(DebugPrimitivesBuffer), primitives_gpu_buffer);
+	for (uint32_t type = 0; type < DEBUG_PRIMITIVE_TYPES_COUNT; type++)
+		fg.importBuffer(GFXRID_ID(DebugPrimitivesDrawArgsBuffer, type), primitives_draw_args_buffers[type]);
 
 	fg.addCallbackPass("Debug Visualizer Pass",
 	[&](RenderPassBuilder &builder)
@@ -333,19 +311,19 @@ void DebugRenderer::addVisualizerPass(FrameGraph & fg)
 		cmd_list->setRenderTargets({final}, nullptr, -1, 0, false);
 
 		auto &p = gGlobalPipeline;
-		VertexInputsDescription input_desc;
-		input_desc.inputs.push_back({"POSITION", 0, FORMAT_R32G32B32A32_SFLOAT});
-		input_desc.inputs.push_back({"COLOR", 0, FORMAT_R32G32B32_SFLOAT});
-		p->setupGraphicsPipeline(cmd_list, vertex_shader_lines, fragment_shader_lines,
-								 input_desc, false, false, CULL_MODE_NONE);
+		p->setupGraphicsPipeline(cmd_list, vertex_shader_primitives, fragment_shader_lines,
+								 {}, false, false, CULL_MODE_NONE);
 		p->setPrimitiveTopology(TOPOLOGY_LINE_LIST);
 		p->flushAndBind(cmd_list);
 
-		cmd_list->setVertexBuffer(lines_vertex_buffer, 0, sizeof(LineVertex));
-		cmd_list->drawInstanced(lines_index_count, 1, 0, 0);
+		// Retained lists are uploaded only when changed, immediate one is refilled every frame
+		draw_list(cmd_list, frame_list);
+		for (DebugDrawList *list : frame_lists)
+			draw_list(cmd_list, *list);
 		cmd_list->resetRenderTargets();
 
-		lines_index_count = 0;
+		frame_list.clear();
+		frame_lists.clear();
 	});
 
 
@@ -354,14 +332,23 @@ void DebugRenderer::addVisualizerPass(FrameGraph & fg)
 	{
 		builder.writeBuffer(GFXRID(DebugLinesBuffer));
 		builder.writeBuffer(GFXRID(DebugLinesDrawArgsBuffer));
+		builder.writeBuffer(GFXRID(DebugPrimitivesBuffer));
+		for (uint32_t type = 0; type < DEBUG_PRIMITIVE_TYPES_COUNT; type++)
+			builder.writeBuffer(GFXRID_ID(DebugPrimitivesDrawArgsBuffer, type));
 	},
 	[=](const RenderPassResources &resources, RHICommandList *cmd_list)
 	{
 		struct Constants
 		{
 			uint32_t lines_draw_args_buffer_id;
+			uint32_t box_draw_args_buffer_id;
+			uint32_t sphere_draw_args_buffer_id;
+			uint32_t line_primitives_draw_args_buffer_id;
 		} constants;
 		constants.lines_draw_args_buffer_id = lines_draw_args_buffer->getUnorderedAccessView()->getBindlessIndex();
+		constants.box_draw_args_buffer_id = primitives_draw_args_buffers[DEBUG_PRIMITIVE_BOX]->getUnorderedAccessView()->getBindlessIndex();
+		constants.sphere_draw_args_buffer_id = primitives_draw_args_buffers[DEBUG_PRIMITIVE_SPHERE]->getUnorderedAccessView()->getBindlessIndex();
+		constants.line_primitives_draw_args_buffer_id = primitives_draw_args_buffers[DEBUG_PRIMITIVE_LINE]->getUnorderedAccessView()->getBindlessIndex();
 
 		gGlobalPipeline->setupComputePipeline(gDynamicRHI->createShader(L"shaders/debug_lines.hlsl", COMPUTE_SHADER, "CSGenerateDrawCalls"));
 		gGlobalPipeline->flushAndBind(cmd_list);
@@ -376,6 +363,9 @@ void DebugRenderer::addVisualizerPass(FrameGraph & fg)
 		builder.writeTexture(GFXRID(FinalTexture));
 		builder.readBuffer(GFXRID(DebugLinesBuffer));
 		builder.readIndirectArgsBuffer(GFXRID(DebugLinesDrawArgsBuffer));
+		builder.readBuffer(GFXRID(DebugPrimitivesBuffer));
+		for (uint32_t type = 0; type < DEBUG_PRIMITIVE_TYPES_COUNT; type++)
+			builder.readIndirectArgsBuffer(GFXRID_ID(DebugPrimitivesDrawArgsBuffer, type));
 		builder.setSideEffect(true);
 	},
 	[=](const RenderPassResources &resources, RHICommandList *cmd_list)
@@ -391,8 +381,22 @@ void DebugRenderer::addVisualizerPass(FrameGraph & fg)
 		p->flushAndBind(cmd_list);
 
 		cmd_list->drawIndirect(lines_draw_args_buffer, 1);
-		cmd_list->resetRenderTargets();
 
-		lines_index_count = 0;
+		// Primitives appended by shaders, instance counts come from the counters
+		p->setupGraphicsPipeline(cmd_list, vertex_shader_primitives, fragment_shader_lines,
+								 {}, false, false, CULL_MODE_NONE);
+		p->setPrimitiveTopology(TOPOLOGY_LINE_LIST);
+		p->flushAndBind(cmd_list);
+
+		PrimitivesConstants constants;
+		for (uint32_t type = 0; type < DEBUG_PRIMITIVE_TYPES_COUNT; type++)
+		{
+			constants.primitives_buffer_id = primitives_gpu_buffer->getShaderResourceView()->getBindlessIndex();
+			constants.primitives_offset = DEBUG_PRIMITIVE_TYPES_COUNT * sizeof(uint32_t) + type * MAX_GPU_DEBUG_PRIMITIVES * sizeof(DebugPrimitiveGPU);
+			constants.primitive_type = type;
+			gDynamicRHI->setConstantBufferData(1, &constants, sizeof(constants));
+			cmd_list->drawIndirect(primitives_draw_args_buffers[type], 1);
+		}
+		cmd_list->resetRenderTargets();
 	});
 }
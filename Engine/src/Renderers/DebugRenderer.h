@@ -6,6 +6,7 @@
 #include "Utils/Camera.h"
 #include "FrameGraph/FrameGraphData.h"
 #include "FrameGraph/FrameGraphRHIResources.h"
+#include "DebugDrawList.h"
 
 class DebugRenderer : public RendererBase
 {
@@ -37,50 +38,51 @@ public:
 	bool isEnabled() const;
 
 	RHIBufferRef getLinesGpuBuffer() { return lines_gpu_buffer; }
+	RHIBufferRef getPrimitivesGpuBuffer() { return primitives_gpu_buffer; }
 
 	void addPasses(FrameGraph &fg);
 
+	// Immediate primitives are drawn once, in the current frame
 	void addLine(glm::vec3 p0, glm::vec3 p1, glm::vec3 color = glm::vec3(0, 0, 0))
 	{
 		if (!isEnabled()) return;
-
-		LineVertex &vertex_0 = vertices[lines_index_count];
-		LineVertex &vertex_1 = vertices[lines_index_count + 1];
-		vertex_0.pos = glm::vec4(p0, 0.0);
-		vertex_0.color = color;
-
-		vertex_1.pos = glm::vec4(p1, 0.0);
-		vertex_1.color = color;
-		lines_index_count += 2;
+		frame_list.addLine(p0, p1, color);
 	}
 
 	void addBox(glm::vec3 half_extents, glm::mat4 transform, glm::vec3 color = glm::vec3(0, 0, 0));
-	void addBoundBox(BoundBox bbox);
+	void addBoundBox(BoundBox bbox, glm::vec3 color = glm::vec3(0, 0, 0));
 	void addFrustum(glm::mat4 frustum, glm::vec3 color = glm::vec3(0, 0, 0));
-	void addSphere(glm::vec3 center, float radius, int segments = 32, glm::vec3 color = glm::vec3(0, 0, 0));
+	void addSphere(glm::vec3 center, float radius, glm::vec3 color = glm::vec3(0, 0, 0));
 
 	eastl::vector<glm::vec3> addCirlce(glm::vec3 center, glm::vec3 normal, float radius, int segments, glm::vec3 color = glm::vec3(0, 0, 0));
 	void addArrow(glm::vec3 p0, glm::vec3 p1, float arrow_size);
+
+	// Retained list is drawn in the current frame, it is uploaded only if it changed. It must live until the frame is rendered
+	void addDrawList(DebugDrawList *list);
 private:
 	void addTextureDebugPass(FrameGraph &fg);
 	void addVisualizerPass(FrameGraph &fg);
 
-	RHIShaderRef vertex_shader_lines;
+	void draw_list(RHICommandList *cmd_list, DebugDrawList &list);
+
+	RHIShaderRef vertex_shader_primitives;
 	RHIShaderRef fragment_shader_lines;
 
 	RHIShaderRef vertex_shader_gpu_lines;
 
+	DebugDrawList frame_list;
+	eastl::vector<DebugDrawList *> frame_lists;
+
+	// GpuLine in shaders
 	struct LineVertex
 	{
 		glm::vec4 pos;
 		glm::vec3 color;
 	};
-	LineVertex *vertices;
-	RHIBufferRef lines_vertex_buffer;
-
 	RHIBufferRef lines_gpu_buffer;
 	RHIBufferRef lines_draw_args_buffer;
 
-	int lines_index_count = 0;
+	// Appended by shaders: counters of every type, then MAX_GPU_DEBUG_PRIMITIVES primitives of every type
+	RHIBufferRef primitives_gpu_buffer;
+	RHIBufferRef primitives_draw_args_buffers[DEBUG_PRIMITIVE_TYPES_COUNT];
 };
-
@@ -7,11 +7,54 @@
 #include "Rendering/Model.h"
 #include "Core/Variables.h"
 #include "Scene/Components.h"
+#include "Rendering/GlobalPipeline.h"
+
+namespace
+{
+constexpr uint32_t TILED_VALIDATION_LIGHTS = 1024;
+constexpr float TILED_VALIDATION_MAX_DEPTH = 200.0f;
+
+struct TiledUBO
+{
+	glm::vec4 tile_slopes;
+	glm::vec4 tile_depth;
+	glm::vec2 resolution;
+	uint32_t tiles_count_x;
+	uint32_t lights_count;
+	uint32_t light_spheres_buffer_id;
+	uint32_t lights_buffer_id;
+	uint32_t tile_lights_buffer_id;
+	uint32_t tile_lights_offset;
+	uint32_t depth_tex_id;
+	uint32_t albedo_tex_id;
+	uint32_t normal_tex_id;
+	uint32_t shading_tex_id;
+	uint32_t diffuse_tex_id;
+	uint32_t specular_tex_id;
+	float shadow_z_near;
+};
+
+void set_tiled_projection(TiledUBO &tiled_ubo, const LightTiles::Projection &projection)
+{
+	tiled_ubo.tile_slopes = projection.slopes;
+	tiled_ubo.tile_depth = projection.depth;
+	tiled_ubo.resolution = projection.resolution;
+	tiled_ubo.tiles_count_x = LightTiles::getTilesCount(glm::uvec2(projection.resolution)).x;
+}
+}
+
+bool DefferedLightingRenderer::is_tiled_validation_requested = false;
 
 DefferedLightingRenderer::DefferedLightingRenderer()
 {
 	auto model = AssetManager::getModelAsset("assets/icosphere_3.fbx");
 	icosphere_mesh = model->getRootNode()->children[0]->primitives[0].mesh;
+
+	point_lights_table.init("Point Lights Buffer", 64, ReplicationPolicy::Copy);
+	cluster_ranges_table.init("Light Cluster Ranges Buffer", LightClusters::CLUSTERS_COUNT, ReplicationPolicy::Copy);
+	light_indices_table.init("Light Cluster Indices Buffer", 4096, ReplicationPolicy::Copy);
+	light_spheres_table.init("Tiled Light Spheres Buffer", 64, ReplicationPolicy::Copy);
+	validation_spheres_table.init("Tiled Validation Spheres Buffer", TILED_VALIDATION_LIGHTS, ReplicationPolicy::Copy);
 }
 
 DefferedLightingRenderer::~DefferedLightingRenderer()
@@ -30,13 +73,35 @@ void DefferedLightingRenderer::renderLights(FrameGraph &fg)
 
 	auto *shadow_passes_data = fg.getBlackboard().tryGet<ShadowPasses>();
 
+	check_tiled_validation();
+
+	// Tiled lighting is done in a compute pass before the directional lights
+	bool use_tiles = render_lighting_tiled;
+	bool use_clusters = render_lighting_clustered && !use_tiles;
+	if (use_tiles || use_clusters)
+		collect_point_lights();
+	if (use_tiles)
+	{
+		update_tiles(fg);
+		add_tiled_pass(fg);
+		if (is_tiled_validation_requested)
+		{
+			is_tiled_validation_requested = false;
+			add_tiled_validation_pass(fg);
+		}
+	}
+	if (use_clusters)
+		update_clusters(fg);
+
 	fg.addCallbackPass("Deffered Lighting Pass",
 	[&](RenderPassBuilder &builder)
 	{
-		builder.createTexture(GFXRID(DiffuseLight), Renderer::getRenderWidth(), Renderer::getRenderHeight(), FORMAT_R32G32B32A32_SFLOAT);
+		if (!use_tiles)
+		{
+			builder.createTexture(GFXRID(DiffuseLight), Renderer::getRenderWidth(), Renderer::getRenderHeight(), FORMAT_R32G32B32A32_SFLOAT);
+			builder.createTexture(GFXRID(SpecularLight), Renderer::getRenderWidth(), Renderer::getRenderHeight(), FORMAT_R32G32B32A32_SFLOAT);
+		}
 		builder.writeTexture(GFXRID(DiffuseLight));
-
-		builder.createTexture(GFXRID(SpecularLight), Renderer::getRenderWidth(), Renderer::getRenderHeight(), FORMAT_R32G32B32A32_SFLOAT);
 		builder.writeTexture(GFXRID(SpecularLight));
 
 		builder.readTexture(GFXRID(GBufferAlbedo));
@@ -60,7 +125,8 @@ void DefferedLightingRenderer::renderLights(FrameGraph &fg)
 		auto diffuse = resources.getTexture(GFXRID(DiffuseLight));
 		auto specular = resources.getTexture(GFXRID(SpecularLight));
 
-		cmd_list->setRenderTargets({diffuse, specular}, nullptr, -1, 0, true);
+		// Tiled pass has already written point lights
+		cmd_list->setRenderTargets({diffuse, specular}, nullptr, -1, 0, !use_tiles);
 
 		ubo.albedo_tex_id = resources.getReadTexture(GFXRID(GBufferAlbedo));
 		ubo.normal_tex_id = resources.getReadTexture(GFXRID(GBufferNormal));
@@ -72,6 +138,9 @@ void DefferedLightingRenderer::renderLights(FrameGraph &fg)
 
 		bool has_ray_traced_visibility = Renderer::isRayTracedShadowsEnabled() && resources.has(GFXRID(RayTracedVisibility));
 
+		if (use_clusters)
+			render_clustered(resources, cmd_list);
+
 		eastl::vector<eastl::pair<const char *, const char *>> shader_defines;
 
 		auto entities_id = Scene::getCurrentScene()->getEntitiesWith<LightComponent>();
@@ -81,6 +150,9 @@ void DefferedLightingRenderer::renderLights(FrameGraph &fg)
 			auto &light = entity.getComponent<LightComponent>();
 
 			bool is_directional = light.getType() == LIGHT_TYPE_DIRECTIONAL;
+			if ((use_clusters || use_tiles) && !is_directional)
+				continue;
+
 			bool use_ray_traced_shadows = has_ray_traced_visibility && is_directional;
 
 			shader_defines.clear();
@@ -143,3 +215,364 @@ void DefferedLightingRenderer::renderLights(FrameGraph &fg)
 	});
 }
 
+void DefferedLightingRenderer::collect_point_lights()
+{
+	PROFILE_CPU_FUNCTION();
+
+	point_lights.clear();
+
+	auto entities_id = Scene::getCurrentScene()->getEntitiesWith<LightComponent>();
+	for (entt::entity entity_id : entities_id)
+	{
+		Entity entity(entity_id);
+		auto &light = entity.getComponent<LightComponent>();
+		if (light.getType() != LIGHT_TYPE_POINT)
+			continue;
+
+		glm::vec3 position = glm::vec3(entity.getWorldTransformMatrix()[3]);
+
+		PointLightGPU light_gpu{};
+		light_gpu.position = glm::vec4(position, 1.0f);
+		light_gpu.intensity = glm::vec4(light.getPhotometricIntensity(), 1.0f);
+		light_gpu.attenuation_radius_sqr = pow(light.attenuation_radius, 2);
+		light_gpu.shadow_z_far = light.attenuation_radius;
+		light_gpu.shadow_map_tex_id = light.getShadowMap()->getShaderResourceView()->getBindlessIndex();
+		point_lights.push_back(light_gpu);
+	}
+}
+
+void DefferedLightingRenderer::update_clusters(FrameGraph &fg)
+{
+	PROFILE_CPU_FUNCTION();
+
+	cluster_lights.clear();
+	for (const PointLightGPU &light : point_lights)
+		cluster_lights.push_back({glm::vec3(light.position), light.shadow_z_far});
+
+	const auto uniforms = Renderer::getDefaultUniforms();
+	light_clusters.build(uniforms.view, uniforms.projection, uniforms.z_near, uniforms.z_far, cluster_lights);
+
+	const auto &ranges = light_clusters.getRanges();
+	const auto &indices = light_clusters.getLightIndices();
+	cluster_ranges_table.setArray(0, eastl::span<const LightClusters::Range>(ranges.data(), ranges.size()));
+	cluster_ranges_table.upload(fg);
+
+	// Empty lists are never read, because every cluster range is empty then
+	if (!point_lights.empty())
+	{
+		point_lights_table.setArray(0, eastl::span<const PointLightGPU>(point_lights.data(), point_lights.size()));
+		point_lights_table.upload(fg);
+	}
+	if (!indices.empty())
+	{
+		light_indices_table.setArray(0, eastl::span<const uint32_t>(indices.data(), indices.size()));
+		light_indices_table.upload(fg);
+	}
+}
+
+void DefferedLightingRenderer::render_clustered(const RenderPassResources &resources, RHICommandList *cmd_list)
+{
+	struct ClusteredUBO
+	{
+		uint32_t albedo_tex_id;
+		uint32_t normal_tex_id;
+		uint32_t depth_tex_id;
+		uint32_t shading_tex_id;
+		uint32_t lights_buffer_id;
+		uint32_t cluster_ranges_buffer_id;
+		uint32_t light_indices_buffer_id;
+		float cluster_slice_scale;
+		float cluster_slice_bias;
+		float shadow_z_near;
+	} clustered_ubo;
+
+	clustered_ubo.albedo_tex_id = resources.getReadTexture(GFXRID(GBufferAlbedo));
+	clustered_ubo.normal_tex_id = resources.getReadTexture(GFXRID(GBufferNormal));
+	clustered_ubo.depth_tex_id = resources.getReadTexture(GFXRID(GBufferDepth));
+	clustered_ubo.shading_tex_id = resources.getReadTexture(GFXRID(GBufferShading));
+	clustered_ubo.lights_buffer_id = point_lights_table.getBindlessIndex();
+	clustered_ubo.cluster_ranges_buffer_id = cluster_ranges_table.getBindlessIndex();
+	clustered_ubo.light_indices_buffer_id = light_indices_table.getBindlessIndex();
+	clustered_ubo.cluster_slice_scale = light_clusters.getSliceScale();
+	clustered_ubo.cluster_slice_bias = light_clusters.getSliceBias();
+	clustered_ubo.shadow_z_near = POINT_SHADOW_Z_NEAR;
+
+	eastl::vector<eastl::pair<const char *, const char *>> shader_defines;
+	shader_defines.push_back({"USE_SHADOWS", GFXOPTIONS(shadows).enabled ? "1" : "0"});
+	gGlobalPipeline->bindScreenQuadPipeline(cmd_list, gDynamicRHI->createShader(L"shaders/lighting/clustered_lighting.hlsl", FRAGMENT_SHADER, "PSMain", shader_defines));
+
+	gDynamicRHI->setConstantBufferData(0, &clustered_ubo, sizeof(ClusteredUBO));
+
+	// Render quad
+	cmd_list->drawInstanced(6, 1, 0, 0);
+}
+
+void DefferedLightingRenderer::update_tiles(FrameGraph &fg)
+{
+	PROFILE_CPU_FUNCTION();
+
+	const auto uniforms = Renderer::getDefaultUniforms();
+	tiles_projection = LightTiles::getProjection(uniforms.projection, glm::vec2(Renderer::getRenderWidth(), Renderer::getRenderHeight()));
+
+	light_spheres.clear();
+	for (const PointLightGPU &light : point_lights)
+		light_spheres.push_back(LightTiles::getViewSphere(uniforms.view, glm::vec3(light.position), light.shadow_z_far));
+
+	// Empty lists are never read, because lights count is 0 then
+	if (!point_lights.empty())
+	{
+		point_lights_table.setArray(0, eastl::span<const PointLightGPU>(point_lights.data(), point_lights.size()));
+		point_lights_table.upload(fg);
+		light_spheres_table.setArray(0, eastl::span<const glm::vec4>(light_spheres.data(), light_spheres.size()));
+		light_spheres_table.upload(fg);
+	}
+}
+
+void DefferedLightingRenderer::add_tiled_pass(FrameGraph &fg)
+{
+	auto *shadow_passes_data = fg.getBlackboard().tryGet<ShadowPasses>();
+	glm::uvec2 tiles = LightTiles::getTilesCount(glm::uvec2(tiles_projection.resolution));
+
+	fg.addCallbackPass("Tiled Deferred Lighting Pass",
+	[&](RenderPassBuilder &builder)
+	{
+		builder.createTexture(GFXRID(DiffuseLight), Renderer::getRenderWidth(), Renderer::getRenderHeight(), FORMAT_R32G32B32A32_SFLOAT);
+		builder.writeUAVTexture(GFXRID(DiffuseLight));
+
+		builder.createTexture(GFXRID(SpecularLight), Renderer::getRenderWidth(), Renderer::getRenderHeight(), FORMAT_R32G32B32A32_SFLOAT);
+		builder.writeUAVTexture(GFXRID(SpecularLight));
+
+		builder.createBuffer(GFXRID(TiledLightLists), sizeof(uint32_t), tiles.x * tiles.y * LightTiles::TILE_STRIDE, BufferUsage::SHADER_WRITE_BUFFER);
+		builder.writeBuffer(GFXRID(TiledLightLists));
+
+		builder.readTexture(GFXRID(GBufferAlbedo));
+		builder.readTexture(GFXRID(GBufferNormal));
+		builder.readTexture(GFXRID(GBufferDepth));
+		builder.readTexture(GFXRID(GBufferShading));
+
+		if (shadow_passes_data)
+		{
+			for (auto &map : shadow_passes_data->shadow_maps)
+				builder.readTexture(map);
+		}
+	},
+	[=](const RenderPassResources &resources, RHICommandList *cmd_list)
+	{
+		TiledUBO tiled_ubo;
+		set_tiled_projection(tiled_ubo, tiles_projection);
+		tiled_ubo.lights_count = (uint32_t)light_spheres.size();
+		tiled_ubo.light_spheres_buffer_id = light_spheres_table.getBindlessIndex();
+		tiled_ubo.lights_buffer_id = point_lights_table.getBindlessIndex();
+		tiled_ubo.tile_lights_buffer_id = resources.getReadWriteBuffer(GFXRID(TiledLightLists));
+		tiled_ubo.tile_lights_offset = 0;
+		tiled_ubo.depth_tex_id = resources.getReadTexture(GFXRID(GBufferDepth));
+		tiled_ubo.albedo_tex_id = resources.getReadTexture(GFXRID(GBufferAlbedo));
+		tiled_ubo.normal_tex_id = resources.getReadTexture(GFXRID(GBufferNormal));
+		tiled_ubo.shading_tex_id = resources.getReadTexture(GFXRID(GBufferShading));
+		tiled_ubo.diffuse_tex_id = resources.getReadWriteTexture(GFXRID(DiffuseLight));
+		tiled_ubo.specular_tex_id = resources.getReadWriteTexture(GFXRID(SpecularLight));
+		tiled_ubo.shadow_z_near = POINT_SHADOW_Z_NEAR;
+
+		gGlobalPipeline->setupComputePipeline(gDynamicRHI->createShader(L"shaders/lighting/tiled_lighting.hlsl", COMPUTE_SHADER, "CSMain",
+											  {
+												  {"TILE_SIZE", std::to_string(LightTiles::TILE_SIZE).c_str()},
+												  {"MAX_LIGHTS_PER_TILE", std::to_string(LightTiles::MAX_LIGHTS_PER_TILE).c_str()},
+												  {"BIN_ONLY", "0"},
+												  {"USE_SHADOWS", GFXOPTIONS(shadows).enabled ? "1" : "0"}
+											  }));
+		gGlobalPipeline->flushAndBind(cmd_list);
+
+		gDynamicRHI->setConstantBufferData(0, &tiled_ubo, sizeof(TiledUBO));
+		cmd_list->dispatch(tiles.x, tiles.y, 1);
+	});
+}
+
+void DefferedLightingRenderer::add_tiled_validation_pass(FrameGraph &fg)
+{
+	// Random lights instead of the scene ones, so binning is checked with lights of every size and depth
+	const auto uniforms = Renderer::getDefaultUniforms();
+	PendingTiledValidation validation;
+	validation.seed = gDynamicRHI->getFrame() + 1;
+	validation.projection = tiles_projection;
+	LightTiles::makeRandomSpheres(validation.seed, TILED_VALIDATION_LIGHTS, validation.projection, uniforms.z_near,
+								  glm::min(uniforms.z_far, TILED_VALIDATION_MAX_DEPTH), validation.spheres);
+
+	validation_spheres_table.setArray(0, eastl::span<const glm::vec4>(validation.spheres.data(), validation.spheres.size()));
+	validation_spheres_table.upload(fg);
+
+	fg.addCallbackPass("Tiled Lighting Validation Readback",
+	[](RenderPassBuilder &builder)
+	{
+		builder.readTexture(GFXRID(GBufferDepth));
+		builder.setSideEffect(true);
+	},
+	[=](const RenderPassResources &resources, RHICommandList *cmd_list)
+	{
+		PendingTiledValidation pending = validation;
+
+		// Depth first, then light lists of all tiles
+		glm::uvec2 resolution = glm::uvec2(pending.projection.resolution);
+		glm::uvec2 tiles = LightTiles::getTilesCount(resolution);
+		uint32_t depth_count = resolution.x * resolution.y;
+		uint64_t total_size = (uint64_t(depth_count) + tiles.x * tiles.y * LightTiles::TILE_STRIDE) * sizeof(uint32_t);
+
+		BufferDescription desc;
+		desc.size = total_size;
+		desc.use_staging_buffer = false;
+		desc.usage = BufferUsage::SHADER_WRITE_BUFFER;
+		pending.gpu_buffer = gDynamicRHI->createBuffer(desc);
+		pending.gpu_buffer->setDebugName("Tiled Lighting Validation");
+		desc.usage = BufferUsage::READBACK_BUFFER;
+		pending.readback_buffer = gDynamicRHI->createBuffer(desc);
+		pending.readback_buffer->setDebugName("Tiled Lighting Validation Readback");
+		uint32_t output_buffer_id = pending.gpu_buffer->getUnorderedAccessView()->getBindlessIndex();
+		uint32_t depth_tex_id = resources.getReadTexture(GFXRID(GBufferDepth));
+
+		gGlobalPipeline->setupComputePipeline(gDynamicRHI->createShader(L"shaders/texture_readback.hlsl", COMPUTE_SHADER));
+		gGlobalPipeline->flushAndBind(cmd_list);
+
+		struct
+		{
+			uint32_t texture_id;
+			uint32_t output_buffer_id;
+			uint32_t output_offset;
+			uint32_t width;
+			uint32_t height;
+		} readback_constants;
+		readback_constants.texture_id = depth_tex_id;
+		readback_constants.output_buffer_id = output_buffer_id;
+		readback_constants.output_offset = 0;
+		readback_constants.width = resolution.x;
+		readback_constants.height = resolution.y;
+		gDynamicRHI->setConstantBufferData(0, &readback_constants, sizeof(readback_constants));
+		cmd_list->dispatch((resolution.x + 7) / 8, (resolution.y + 7) / 8, 1);
+
+		TiledUBO tiled_ubo = {};
+		set_tiled_projection(tiled_ubo, pending.projection);
+		tiled_ubo.lights_count = (uint32_t)pending.spheres.size();
+		tiled_ubo.light_spheres_buffer_id = validation_spheres_table.getBindlessIndex();
+		tiled_ubo.tile_lights_buffer_id = output_buffer_id;
+		tiled_ubo.tile_lights_offset = depth_count;
+		tiled_ubo.depth_tex_id = depth_tex_id;
+
+		gGlobalPipeline->setupComputePipeline(gDynamicRHI->createShader(L"shaders/lighting/tiled_lighting.hlsl", COMPUTE_SHADER, "CSMain",
+											  {
+												  {"TILE_SIZE", std::to_string(LightTiles::TILE_SIZE).c_str()},
+												  {"MAX_LIGHTS_PER_TILE", std::to_string(LightTiles::MAX_LIGHTS_PER_TILE).c_str()},
+												  {"BIN_ONLY", "1"}
+											  }));
+		gGlobalPipeline->flushAndBind(cmd_list);
+
+		gDynamicRHI->setConstantBufferData(0, &tiled_ubo, sizeof(TiledUBO));
+		cmd_list->dispatch(tiles.x, tiles.y, 1);
+
+		cmd_list->copyBuffer(pending.gpu_buffer, pending.readback_buffer, 0, 0, total_size);
+		pending.frame = gDynamicRHI->getFrame();
+		pending_tiled_validation = eastl::move(pending);
+	});
+}
+
+void DefferedLightingRenderer::check_tiled_validation()
+{
+	if (!pending_tiled_validation || gDynamicRHI->getFrame() - pending_tiled_validation->frame <= MAX_FRAMES_IN_FLIGHT)
+		return;
+
+	PendingTiledValidation &validation = *pending_tiled_validation;
+	const LightTiles::Projection &projection = validation.projection;
+	glm::uvec2 resolution = glm::uvec2(projection.resolution);
+	glm::uvec2 tiles = LightTiles::getTilesCount(resolution);
+
+	void *mapped;
+	validation.readback_buffer->map(&mapped);
+	const float *depth = (const float *)mapped;
+	const uint32_t *gpu_tile_lights = (const uint32_t *)mapped + resolution.x * resolution.y;
+
+	eastl::vector<uint32_t> reference;
+	LightTiles::binReference(projection, depth, validation.spheres, reference);
+
+	// GPU may round the tile planes differently, so lights that touch a tile within the tolerance can go either way
+	auto is_on_boundary = [&](glm::uvec2 tile, float near_depth, float far_depth, uint32_t light)
+	{
+		glm::vec4 sphere = validation.spheres[light];
+		float tolerance = 1e-4f * (sphere.w + glm::abs(sphere.z));
+		bool is_inside_smaller = LightTiles::isSphereInTile(projection, tile, near_depth, far_depth, glm::vec4(glm::vec3(sphere), sphere.w - tolerance));
+		bool is_inside_larger = LightTiles::isSphereInTile(projection, tile, near_depth, far_depth, glm::vec4(glm::vec3(sphere), sphere.w + tolerance));
+		return is_inside_smaller != is_inside_larger;
+	};
+
+	uint32_t mismatched_tiles = 0;
+	uint32_t boundary_lights = 0;
+	uint64_t binned_lights = 0;
+	eastl::vector<uint32_t> gpu_list, cpu_list;
+	for (uint32_t tile_y = 0; tile_y < tiles.y; tile_y++)
+	{
+		for (uint32_t tile_x = 0; tile_x < tiles.x; tile_x++)
+		{
+			glm::uvec2 tile = glm::uvec2(tile_x, tile_y);
+			const uint32_t *gpu = &gpu_tile_lights[(tile_y * tiles.x + tile_x) * LightTiles::TILE_STRIDE];
+			const uint32_t *cpu = &reference[(tile_y * tiles.x + tile_x) * LightTiles::TILE_STRIDE];
+			binned_lights += cpu[0];
+
+			// Both keep the lowest light indices in order, lists are only complete up to MAX_LIGHTS_PER_TILE
+			bool is_complete = gpu[0] <= LightTiles::MAX_LIGHTS_PER_TILE && cpu[0] <= LightTiles::MAX_LIGHTS_PER_TILE;
+			if (is_complete)
+			{
+				gpu_list.assign(gpu + 1, gpu + 1 + gpu[0]);
+				cpu_list.assign(cpu + 1, cpu + 1 + cpu[0]);
+			}
+			if (gpu[0] == cpu[0] && (!is_complete || gpu_list == cpu_list))
+				continue;
+
+			float near_depth = 0.0f, far_depth = 0.0f;
+			bool has_depth = LightTiles::getTileDepthRange(projection, depth, tile, near_depth, far_depth);
+
+			uint32_t differences = 0;
+			uint32_t tolerated = 0;
+			if (is_complete && has_depth)
+			{
+				eastl::vector<uint32_t> difference;
+				eastl::set_symmetric_difference(gpu_list.begin(), gpu_list.end(), cpu_list.begin(), cpu_list.end(), eastl::back_inserter(difference));
+				for (uint32_t light : difference)
+				{
+					differences++;
+					if (light < validation.spheres.size() && is_on_boundary(tile, near_depth, far_depth, light))
+						tolerated++;
+				}
+			} else if (has_depth)
+			{
+				// Only counts are known for full tiles
+				differences = gpu[0] > cpu[0] ? gpu[0] - cpu[0] : cpu[0] - gpu[0];
+				for (uint32_t light = 0; light < validation.spheres.size() && tolerated < differences; light++)
+				{
+					if (is_on_boundary(tile, near_depth, far_depth, light))
+						tolerated++;
+				}
+			} else
+			{
+				differences = gpu[0];
+			}
+
+			boundary_lights += tolerated;
+			if (tolerated == differences)
+				continue;
+
+			if (mismatched_tiles == 0)
+			{
+				CORE_ERROR("Tiled lighting validation: tile ({}, {}) differs: GPU {} lights, CPU {} lights, {} lights differ, seed {}",
+						   tile_x, tile_y, gpu[0], cpu[0], differences - tolerated, validation.seed);
+			}
+			mismatched_tiles++;
+		}
+	}
+	validation.readback_buffer->unmap();
+
+	if (mismatched_tiles == 0)
+	{
+		CORE_INFO("Tiled lighting validation: {} tiles match the CPU reference ({} lights, {} binned, {} on tile boundaries)",
+				  tiles.x * tiles.y, validation.spheres.size(), binned_lights, boundary_lights);
+	} else
+	{
+		CORE_ERROR("Tiled lighting validation: {} of {} tiles differ from the CPU reference", mismatched_tiles, tiles.x * tiles.y);
+	}
+	pending_tiled_validation.reset();
+}
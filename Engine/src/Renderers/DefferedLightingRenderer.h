@@ -5,6 +5,10 @@
 #include "Scene/Scene.h"
 #include "FrameGraph/FrameGraphData.h"
 #include "FrameGraph/FrameGraphRHIResources.h"
+#include "Rendering/LightClusters.h"
+#include "Rendering/LightTiles.h"
+#include "Rendering/GpuTable.h"
+#include "Rendering/ShaderStructs.h"
 
 class DefferedLightingRenderer: public RendererBase
 {
@@ -41,6 +45,45 @@ public:
 
 	void renderLights(FrameGraph &fg);
 
+	// Next frame bins random lights over the current depth with the tiled shader and compares it with LightTiles::binReference, result is logged
+	static void requestTiledValidation() { is_tiled_validation_requested = true; }
+
+private:
+	struct PendingTiledValidation
+	{
+		RHIBufferRef gpu_buffer;
+		RHIBufferRef readback_buffer;
+		uint64_t frame = 0;
+		uint64_t seed = 0;
+		LightTiles::Projection projection;
+		eastl::vector<glm::vec4> spheres;
+	};
+
+	// Directional lights are still drawn as volumes, point lights go to clusters or tiles
+	void collect_point_lights();
+	void update_clusters(FrameGraph &fg);
+	void render_clustered(const RenderPassResources &resources, RHICommandList *cmd_list);
+
+	void update_tiles(FrameGraph &fg);
+	void add_tiled_pass(FrameGraph &fg);
+	void add_tiled_validation_pass(FrameGraph &fg);
+	void check_tiled_validation();
+
+	LightClusters light_clusters;
+	eastl::vector<LightClusters::Light> cluster_lights;
+	eastl::vector<PointLightGPU> point_lights;
+	GpuTable<PointLightGPU> point_lights_table;
+	GpuTable<LightClusters::Range> cluster_ranges_table;
+	GpuTable<uint32_t> light_indices_table;
+
+	LightTiles::Projection tiles_projection;
+	eastl::vector<glm::vec4> light_spheres; // View space, same order as point_lights
+	GpuTable<glm::vec4> light_spheres_table;
+	GpuTable<glm::vec4> validation_spheres_table;
+	eastl::optional<PendingTiledValidation> pending_tiled_validation;
+
+	static bool is_tiled_validation_requested;
+
 public:
 	Engine::Mesh *icosphere_mesh;
 
@@ -21,6 +21,7 @@ void GBufferPass::addPass(FrameGraph &fg, uint32_t max_draw_calls)
 	view.use_two_pass_occlusion = true;
 	view.cull_mode = CULL_MODE_NONE;
 	view.use_reverse_z = true;
+	view.texture_feedback = true;
 	view.shaders = OpaqueGeometryPass::ShaderSet::fromFile(L"shaders/gbuffer.hlsl");
 
 	OpaqueGeometryPass::GBufferOutput output;
@@ -2,12 +2,36 @@
 #include "HiZ.h"
 #include "Rendering/Renderer.h"
 #include "Rendering/GlobalPipeline.h"
+#include "FrameGraph/FrameGraphData.h"
 
 namespace
 {
-constexpr uint32_t HIZ_THREADGROUP_SIZE = 32;
+constexpr uint32_t HIZ_TILE_SIZE = 64;
+constexpr uint32_t HIZ_MAX_MIPS = 13; // 4096 mip 0, mip 6 of all tiles fits one tile
+constexpr uint32_t HIZ_MAX_LAYERS = 8; // per dispatch
+constexpr uint32_t HIZ_TAIL_VALUES_PER_LAYER = HIZ_TILE_SIZE * HIZ_TILE_SIZE;
+
+glm::ivec2 get_mip_size(glm::ivec2 size, uint32_t mip)
+{
+	return glm::max(glm::ivec2(size.x >> mip, size.y >> mip), glm::ivec2(1));
+}
+
+struct PendingValidation
+{
+	RHIBufferRef gpu_buffer;
+	RHIBufferRef readback_buffer;
+	uint64_t frame = 0;
+	glm::ivec2 depth_size;
+	glm::ivec2 hiz_size;
+	uint32_t mip_levels = 0;
+	bool is_depth_reverse_z = false;
+};
+
+eastl::optional<PendingValidation> pending_validation;
 }
 
+bool HiZ::is_validation_requested = false;
+
 void HiZ::createOrImport(FrameGraph &fg, RHITextureRef &texture, GraphicsResourceName name, glm::ivec2 size, uint32_t layers)
 {
 	glm::ivec2 mip_dimensions = glm::max(glm::ceil(glm::log2(glm::vec2(size))), glm::vec2(1.0f));
@@ -39,11 +63,19 @@ void HiZ::createOrImport(FrameGraph &fg, RHITextureRef &texture, GraphicsResourc
 	fg.importTexture(name, texture);
 }
 
-void HiZ::build(FrameGraph &fg, GraphicsResourceName hiz_name, GraphicsResourceName depth_name, uint32_t layer, bool is_depth_reverse_z)
+void HiZ::build(FrameGraph &fg, GraphicsResourceName hiz_name, GraphicsResourceName depth_name, uint32_t layer, bool is_depth_reverse_z, uint32_t layer_count)
 {
+	check_validation();
+
+	// Counters of the last tile per layer and mip 6 values of all tiles
+	GraphicsResourceName atomics_name = GFXRID_ID(HiZAtomics, hiz_name.hashed_name);
+
 	fg.addCallbackPass("HiZ Generation",
-	[hiz_name, depth_name](RenderPassBuilder &builder)
+	[hiz_name, depth_name, atomics_name](RenderPassBuilder &builder)
 	{
+		if (!builder.isBufferCreated(atomics_name))
+			builder.createBuffer(atomics_name, sizeof(uint32_t), HIZ_MAX_LAYERS * (1 + HIZ_TAIL_VALUES_PER_LAYER), BufferUsage::SHADER_WRITE_BUFFER);
+		builder.writeBuffer(atomics_name);
 		builder.writeUAVTexture(hiz_name);
 		builder.readTexture(depth_name);
 	},
@@ -51,34 +83,232 @@ void HiZ::build(FrameGraph &fg, GraphicsResourceName hiz_name, GraphicsResourceN
 	{
 		RHITexture *hiz = resources.getTexture(hiz_name);
 		RHITexture *depth = resources.getTexture(depth_name);
+		RHIBuffer *atomics = resources.getBuffer(atomics_name);
+		ENGINE_ASSERT(hiz->getMipLevels() <= HIZ_MAX_MIPS);
+
+		// Last tile of a layer resets its counter, transient memory has to be cleared once
+		cmd_list->fillBuffer(atomics, 0);
+		atomics->transitState(ResourceState::UAV);
 
 		gGlobalPipeline->setupComputePipeline(gDynamicRHI->createShader(L"shaders/depth_hiz.hlsl", COMPUTE_SHADER, "CSMain",
 											  {
-												  {"THREADGROUP_SIZE", std::to_string(HIZ_THREADGROUP_SIZE).c_str()}
+												  {"MAX_LAYERS", std::to_string(HIZ_MAX_LAYERS).c_str()}
 											  }));
 		gGlobalPipeline->flushAndBind(cmd_list);
 
-		for (int mip = 0; mip < hiz->getMipLevels(); mip++)
+		glm::ivec2 tiles = (hiz->getSize() + glm::ivec2(HIZ_TILE_SIZE - 1)) / glm::ivec2(HIZ_TILE_SIZE);
+		for (uint32_t first = 0; first < layer_count; first += HIZ_MAX_LAYERS)
 		{
 			struct
 			{
-				uint32_t output_tex_id;
-				uint32_t depth_tex_id;
-				glm::ivec2 texture_size;
+				glm::ivec2 depth_size;
+				glm::ivec2 hiz_size;
+				uint32_t mip_levels;
 				uint32_t convert_reverse_z;
-			} constants;
-			constants.depth_tex_id = (mip == 0)
-				? depth->getShaderResourceView(0, layer)->getBindlessIndex()
-				: hiz->getShaderResourceView(mip - 1, layer)->getBindlessIndex();
-			constants.output_tex_id = hiz->getUnorderedAccessView(mip, layer)->getBindlessIndex();
-			constants.texture_size = hiz->getSize(mip);
-			constants.convert_reverse_z = (is_depth_reverse_z && mip == 0) ? 1u : 0u;
+				uint32_t atomics_buffer_id;
+				uint32_t pad;
+				uint32_t texture_ids[HIZ_MAX_LAYERS][16];
+			} constants = {};
+			constants.depth_size = depth->getSize();
+			constants.hiz_size = hiz->getSize();
+			constants.mip_levels = hiz->getMipLevels();
+			constants.convert_reverse_z = is_depth_reverse_z ? 1u : 0u;
+			constants.atomics_buffer_id = resources.getReadWriteBuffer(atomics_name);
 
-			gDynamicRHI->setConstantBufferData(0, &constants, sizeof(constants));
+			uint32_t dispatch_layers = eastl::min(layer_count - first, HIZ_MAX_LAYERS);
+			for (uint32_t i = 0; i < dispatch_layers; i++)
+			{
+				constants.texture_ids[i][0] = depth->getShaderResourceView(0, layer + first + i)->getBindlessIndex();
+				for (uint32_t mip = 0; mip < hiz->getMipLevels(); mip++)
+					constants.texture_ids[i][1 + mip] = hiz->getUnorderedAccessView(mip, layer + first + i)->getBindlessIndex();
+			}
 
-			glm::ivec2 dispatch_size = glm::max(glm::vec2(1, 1), glm::ceil(glm::vec2(hiz->getSize(mip)) / float(HIZ_THREADGROUP_SIZE)));
-			cmd_list->dispatch(dispatch_size.x, dispatch_size.y, 1);
+			gDynamicRHI->setConstantBufferData(0, &constants, sizeof(constants));
+			cmd_list->dispatch(tiles.x, tiles.y, dispatch_layers);
 			hiz->transitLayout(cmd_list, TEXTURE_LAYOUT_UAV);
+			atomics->transitState(ResourceState::UAV);
+		}
+	});
+
+	if (is_validation_requested)
+	{
+		is_validation_requested = false;
+		add_validation_pass(fg, hiz_name, depth_name, layer, is_depth_reverse_z);
+	}
+}
+
+void HiZ::buildReference(const float *depth, glm::ivec2 depth_size, glm::ivec2 hiz_size, uint32_t mip_levels, bool is_depth_reverse_z, eastl::vector<float> &mips)
+{
+	size_t total_size = 0;
+	for (uint32_t mip = 0; mip < mip_levels; mip++)
+		total_size += get_mip_size(hiz_size, mip).x * get_mip_size(hiz_size, mip).y;
+	mips.resize(total_size);
+
+	// Mip 0: max of 2x2 depth texels around the texel center, same integer footprint as the shader
+	float *output = mips.data();
+	for (int y = 0; y < hiz_size.y; y++)
+	{
+		uint32_t base_y = ((2 * y + 1) * depth_size.y - hiz_size.y) / (2 * hiz_size.y);
+		uint32_t next_y = eastl::min<uint32_t>(base_y + 1, depth_size.y - 1);
+		for (int x = 0; x < hiz_size.x; x++)
+		{
+			uint32_t base_x = ((2 * x + 1) * depth_size.x - hiz_size.x) / (2 * hiz_size.x);
+			uint32_t next_x = eastl::min<uint32_t>(base_x + 1, depth_size.x - 1);
+
+			float result = 0.0f;
+			for (uint32_t sample_y : {base_y, next_y})
+			{
+				for (uint32_t sample_x : {base_x, next_x})
+				{
+					float value = depth[sample_y * depth_size.x + sample_x];
+					if (is_depth_reverse_z)
+						value = 1.0f - value;
+					result = eastl::max(result, value);
+				}
+			}
+			output[y * hiz_size.x + x] = result;
+		}
+	}
+
+	// Next mips: max of 2x2 texels, texels outside of the previous mip are 0
+	const float *input = output;
+	output += hiz_size.x * hiz_size.y;
+	for (uint32_t mip = 1; mip < mip_levels; mip++)
+	{
+		glm::ivec2 input_size = get_mip_size(hiz_size, mip - 1);
+		glm::ivec2 size = get_mip_size(hiz_size, mip);
+		for (int y = 0; y < size.y; y++)
+		{
+			for (int x = 0; x < size.x; x++)
+			{
+				float result = 0.0f;
+				for (int sample_y = 2 * y; sample_y < eastl::min(2 * y + 2, input_size.y); sample_y++)
+					for (int sample_x = 2 * x; sample_x < eastl::min(2 * x + 2, input_size.x); sample_x++)
+						result = eastl::max(result, input[sample_y * input_size.x + sample_x]);
+				output[y * size.x + x] = result;
+			}
+		}
+		input = output;
+		output += size.x * size.y;
+	}
+}
+
+void HiZ::shutdown()
+{
+	pending_validation.reset();
+}
+
+void HiZ::add_validation_pass(FrameGraph &fg, GraphicsResourceName hiz_name, GraphicsResourceName depth_name, uint32_t layer, bool is_depth_reverse_z)
+{
+	fg.addCallbackPass("HiZ Validation Readback",
+	[hiz_name, depth_name](RenderPassBuilder &builder)
+	{
+		builder.readTexture(hiz_name);
+		builder.readTexture(depth_name);
+		builder.setSideEffect(true);
+	},
+	[=](const RenderPassResources &resources, RHICommandList *cmd_list)
+	{
+		RHITexture *hiz = resources.getTexture(hiz_name);
+		RHITexture *depth = resources.getTexture(depth_name);
+
+		PendingValidation validation;
+		validation.frame = gDynamicRHI->getFrame();
+		validation.depth_size = depth->getSize();
+		validation.hiz_size = hiz->getSize();
+		validation.mip_levels = hiz->getMipLevels();
+		validation.is_depth_reverse_z = is_depth_reverse_z;
+
+		// Depth first, then all mips
+		struct Level
+		{
+			RHITextureView *view;
+			glm::ivec2 size;
+		};
+		eastl::vector<Level> levels;
+		levels.push_back({depth->getShaderResourceView(0, layer), validation.depth_size});
+		for (uint32_t mip = 0; mip < validation.mip_levels; mip++)
+			levels.push_back({hiz->getShaderResourceView(mip, layer), get_mip_size(validation.hiz_size, mip)});
+
+		uint64_t total_size = 0;
+		for (const Level &level : levels)
+			total_size += uint64_t(level.size.x) * level.size.y * sizeof(float);
+
+		BufferDescription desc;
+		desc.size = total_size;
+		desc.use_staging_buffer = false;
+		desc.usage = BufferUsage::SHADER_WRITE_BUFFER;
+		validation.gpu_buffer = gDynamicRHI->createBuffer(desc);
+		validation.gpu_buffer->setDebugName("HiZ Validation");
+		desc.usage = BufferUsage::READBACK_BUFFER;
+		validation.readback_buffer = gDynamicRHI->createBuffer(desc);
+		validation.readback_buffer->setDebugName("HiZ Validation Readback");
+
+		gGlobalPipeline->setupComputePipeline(gDynamicRHI->createShader(L"shaders/texture_readback.hlsl", COMPUTE_SHADER));
+		gGlobalPipeline->flushAndBind(cmd_list);
+
+		uint32_t offset = 0;
+		for (const Level &level : levels)
+		{
+			struct
+			{
+				uint32_t texture_id;
+				uint32_t output_buffer_id;
+				uint32_t output_offset;
+				uint32_t width;
+				uint32_t height;
+			} constants;
+			constants.texture_id = level.view->getBindlessIndex();
+			constants.output_buffer_id = validation.gpu_buffer->getUnorderedAccessView()->getBindlessIndex();
+			constants.output_offset = offset;
+			constants.width = level.size.x;
+			constants.height = level.size.y;
+			gDynamicRHI->setConstantBufferData(0, &constants, sizeof(constants));
+			cmd_list->dispatch((level.size.x + 7) / 8, (level.size.y + 7) / 8, 1);
+			offset += level.size.x * level.size.y;
 		}
+
+		cmd_list->copyBuffer(validation.gpu_buffer, validation.readback_buffer, 0, 0, total_size);
+		pending_validation = eastl::move(validation);
 	});
 }
+
+void HiZ::check_validation()
+{
+	if (!pending_validation || gDynamicRHI->getFrame() - pending_validation->frame <= MAX_FRAMES_IN_FLIGHT)
+		return;
+
+	PendingValidation &validation = *pending_validation;
+	void *mapped;
+	validation.readback_buffer->map(&mapped);
+	const float *depth = (const float *)mapped;
+	const float *gpu_mips = depth + validation.depth_size.x * validation.depth_size.y;
+
+	eastl::vector<float> reference;
+	buildReference(depth, validation.depth_size, validation.hiz_size, validation.mip_levels, validation.is_depth_reverse_z, reference);
+
+	uint32_t mismatched_mips = 0;
+	size_t offset = 0;
+	for (uint32_t mip = 0; mip < validation.mip_levels; mip++)
+	{
+		glm::ivec2 size = get_mip_size(validation.hiz_size, mip);
+		size_t count = size.x * size.y;
+		for (size_t i = 0; i < count; i++)
+		{
+			// Bit for bit, max of the same floats has no rounding
+			if (memcmp(&gpu_mips[offset + i], &reference[offset + i], sizeof(float)) != 0)
+			{
+				CORE_ERROR("HiZ validation: mip {} ({}x{}) differs at ({}, {}): GPU {}, CPU {}", mip, size.x, size.y,
+						   i % size.x, i / size.x, gpu_mips[offset + i], reference[offset + i]);
+				mismatched_mips++;
+				break;
+			}
+		}
+		offset += count;
+	}
+	validation.readback_buffer->unmap();
+
+	if (mismatched_mips == 0)
+		CORE_INFO("HiZ validation: {} mips ({}x{}) match the CPU reference", validation.mip_levels, validation.hiz_size.x, validation.hiz_size.y);
+	pending_validation.reset();
+}
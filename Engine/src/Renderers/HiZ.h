@@ -7,5 +7,19 @@ class HiZ
 {
 public:
 	static void createOrImport(FrameGraph &fg, RHITextureRef &texture, GraphicsResourceName name, glm::ivec2 size, uint32_t layers = 1);
-	static void build(FrameGraph &fg, GraphicsResourceName hiz, GraphicsResourceName depth, uint32_t layer = 0, bool is_depth_reverse_z = true);
+	// All mips of layer_count layers starting from layer are built in a single dispatch
+	static void build(FrameGraph &fg, GraphicsResourceName hiz, GraphicsResourceName depth, uint32_t layer = 0, bool is_depth_reverse_z = true, uint32_t layer_count = 1);
+
+	// CPU version of depth_hiz.hlsl for one layer, mips are written one after another
+	static void buildReference(const float *depth, glm::ivec2 depth_size, glm::ivec2 hiz_size, uint32_t mip_levels, bool is_depth_reverse_z, eastl::vector<float> &mips);
+
+	// Reads back depth and HiZ of the next build and compares it with buildReference bit for bit, result is logged
+	static void requestValidation() { is_validation_requested = true; }
+	static void shutdown();
+
+private:
+	static void add_validation_pass(FrameGraph &fg, GraphicsResourceName hiz, GraphicsResourceName depth, uint32_t layer, bool is_depth_reverse_z);
+	static void check_validation();
+
+	static bool is_validation_requested;
 };
@@ -67,7 +67,7 @@ void MeshletPass::add_counter_init_pass(FrameGraph &fg, const MeshletCullDesc &d
 			builder.createBuffer(GFXRID_ID(TraversalCtrl, view_id), sizeof(uint32_t) * 4, 1, BufferUsage::SHADER_WRITE_BUFFER);
 			builder.createBuffer(GFXRID_ID(VisibleMeshlets, view_id), sizeof(MeshletCandidate), MAX_MESHLETS_PER_FRAME, BufferUsage::SHADER_WRITE_BUFFER);
 			builder.createBuffer(GFXRID_ID(VisibleMeshletsCount, view_id), sizeof(uint32_t), 1, BufferUsage::INDIRECT_ARGS_BUFFER | BufferUsage::SHADER_WRITE_BUFFER);
-			builder.createBuffer(GFXRID_ID(DrawIndexedCount, view_id), sizeof(uint32_t), 1, BufferUsage::INDIRECT_ARGS_BUFFER | BufferUsage::SHADER_WRITE_BUFFER);
+			builder.createBuffer(GFXRID_ID(MeshletDrawCount, view_id), sizeof(uint32_t), 1, BufferUsage::INDIRECT_ARGS_BUFFER | BufferUsage::SHADER_WRITE_BUFFER);
 			builder.createBuffer(GFXRID_ID(OccludedMeshlets, view_id), sizeof(MeshletCandidate), MAX_MESHLETS_PER_FRAME, BufferUsage::SHADER_WRITE_BUFFER);
 			builder.createBuffer(GFXRID_ID(OccludedMeshletsCount, view_id), sizeof(uint32_t), 1, BufferUsage::SHADER_WRITE_BUFFER);
 			builder.createBuffer(GFXRID_ID(OccludedInstances, view_id), sizeof(uint32_t), instance_count, BufferUsage::SHADER_WRITE_BUFFER);
@@ -77,7 +77,7 @@ void MeshletPass::add_counter_init_pass(FrameGraph &fg, const MeshletCullDesc &d
 		builder.writeBuffer(GFXRID_ID(TraversalCtrl, view_id));
 		builder.writeBuffer(GFXRID_ID(TraversalQueue, view_id));
 		builder.writeBuffer(GFXRID_ID(VisibleMeshletsCount, view_id));
-		builder.writeBuffer(GFXRID_ID(DrawIndexedCount, view_id));
+		builder.writeBuffer(GFXRID_ID(MeshletDrawCount, view_id));
 		builder.writeBuffer(GFXRID_ID(OccludedMeshletsCount, view_id));
 		builder.writeBuffer(GFXRID_ID(OccludedInstancesCount, view_id));
 	},
@@ -96,7 +96,7 @@ void MeshletPass::add_counter_init_pass(FrameGraph &fg, const MeshletCullDesc &d
 		} constants;
 		constants.traversal_ctrl_buffer_id = resources.getReadWriteBuffer(GFXRID_ID(TraversalCtrl, view_id));
 		constants.visible_meshlets_count_buffer_id = resources.getReadWriteBuffer(GFXRID_ID(VisibleMeshletsCount, view_id));
-		constants.draw_calls_count_buffer_id = resources.getReadWriteBuffer(GFXRID_ID(DrawIndexedCount, view_id));
+		constants.draw_calls_count_buffer_id = resources.getReadWriteBuffer(GFXRID_ID(MeshletDrawCount, view_id));
 		constants.occluded_meshlets_count_buffer_id = resources.getReadWriteBuffer(GFXRID_ID(OccludedMeshletsCount, view_id));
 		constants.occluded_instances_count_buffer_id = resources.getReadWriteBuffer(GFXRID_ID(OccludedInstancesCount, view_id));
 		constants.reset_occluded = is_fix ? 0u : 1u;
@@ -193,7 +193,7 @@ void MeshletPass::add_traversal_pass(FrameGraph &fg, const MeshletCullDesc &desc
 		{
 			if (!render_meshlets_mesh_shaders)
 			{
-				builder.createBuffer(GFXRID_ID(DrawIndexedArgs, view_id), sizeof(DrawIndexedIndirect), MAX_MESHLETS_PER_FRAME, BufferUsage::INDIRECT_ARGS_BUFFER | BufferUsage::SHADER_WRITE_BUFFER);
+				builder.createBuffer(GFXRID_ID(MeshletDrawArgs, view_id), sizeof(DrawIndirect), MAX_MESHLETS_PER_FRAME, BufferUsage::INDIRECT_ARGS_BUFFER | BufferUsage::SHADER_WRITE_BUFFER);
 				builder.createBuffer(GFXRID_ID(DrawCallsInstances, view_id), sizeof(uint32_t), MAX_MESHLETS_PER_FRAME, BufferUsage::VERTEX_BUFFER | BufferUsage::SHADER_WRITE_BUFFER);
 			}
 		}
@@ -207,11 +207,12 @@ void MeshletPass::add_traversal_pass(FrameGraph &fg, const MeshletCullDesc &desc
 		builder.writeBuffer(GFXRID(GroupResidencyBuffer));
 		builder.writeBuffer(GFXRID(StreamRequestsBuffer));
 		builder.writeBuffer(GFXRID(GroupAgesBuffer));
+		builder.writeBuffer(GFXRID(GroupErrorsBuffer));
 
 		if (!render_meshlets_mesh_shaders)
 		{
-			builder.writeBuffer(GFXRID_ID(DrawIndexedArgs, view_id));
-			builder.writeBuffer(GFXRID_ID(DrawIndexedCount, view_id));
+			builder.writeBuffer(GFXRID_ID(MeshletDrawArgs, view_id));
+			builder.writeBuffer(GFXRID_ID(MeshletDrawCount, view_id));
 			builder.writeBuffer(GFXRID_ID(DrawCallsInstances, view_id));
 		}
 
@@ -238,8 +239,8 @@ void MeshletPass::add_traversal_pass(FrameGraph &fg, const MeshletCullDesc &desc
 			uint32_t traversal_ctrl_buffer_id;
 			uint32_t visible_meshlets_buffer_id;
 			uint32_t visible_meshlets_count_buffer_id;
-			uint32_t draw_indexed_args_buffer_id;
-			uint32_t draw_indexed_count_buffer_id;
+			uint32_t draw_args_buffer_id;
+			uint32_t draw_count_buffer_id;
 			uint32_t draw_calls_indirect_instances_buffer_id;
 			uint32_t max_queue_size;
 			uint32_t occluded_meshlets_buffer_id;
@@ -251,6 +252,7 @@ void MeshletPass::add_traversal_pass(FrameGraph &fg, const MeshletCullDesc &desc
 			uint32_t group_residency_buffer_id;
 			uint32_t stream_requests_buffer_id;
 			uint32_t group_ages_buffer_id;
+			uint32_t group_errors_buffer_id;
 		} constants = {};
 		constants.frustum_view_projection = desc.view_projection;
 		constants.queue_buffer_id = resources.getReadWriteBuffer(GFXRID_ID(TraversalQueue, view_id));
@@ -263,8 +265,8 @@ void MeshletPass::add_traversal_pass(FrameGraph &fg, const MeshletCullDesc &desc
 
 		if (!render_meshlets_mesh_shaders)
 		{
-			constants.draw_indexed_args_buffer_id = resources.getReadWriteBuffer(GFXRID_ID(DrawIndexedArgs, view_id));
-			constants.draw_indexed_count_buffer_id = resources.getReadWriteBuffer(GFXRID_ID(DrawIndexedCount, view_id));
+			constants.draw_args_buffer_id = resources.getReadWriteBuffer(GFXRID_ID(MeshletDrawArgs, view_id));
+			constants.draw_count_buffer_id = resources.getReadWriteBuffer(GFXRID_ID(MeshletDrawCount, view_id));
 			constants.draw_calls_indirect_instances_buffer_id = resources.getReadWriteBuffer(GFXRID_ID(DrawCallsInstances, view_id));
 		}
 
@@ -280,6 +282,7 @@ void MeshletPass::add_traversal_pass(FrameGraph &fg, const MeshletCullDesc &desc
 		constants.group_residency_buffer_id = resources.getReadWriteBuffer(GFXRID(GroupResidencyBuffer));
 		constants.stream_requests_buffer_id = resources.getReadWriteBuffer(GFXRID(StreamRequestsBuffer));
 		constants.group_ages_buffer_id = resources.getReadWriteBuffer(GFXRID(GroupAgesBuffer));
+		constants.group_errors_buffer_id = resources.getReadWriteBuffer(GFXRID(GroupErrorsBuffer));
 		gDynamicRHI->setConstantBufferData(0, &constants, sizeof(constants));
 		cmd_list->dispatch(PERSISTENT_THREAD_GROUPS, 1, 1);
 	});
@@ -298,8 +301,8 @@ void MeshletPass::add_meshlet_fix_pass(FrameGraph &fg, const MeshletCullDesc &de
 		builder.writeBuffer(GFXRID(GroupResidencyBuffer));
 		if (!render_meshlets_mesh_shaders)
 		{
-			builder.writeBuffer(GFXRID_ID(DrawIndexedArgs, view_id));
-			builder.writeBuffer(GFXRID_ID(DrawIndexedCount, view_id));
+			builder.writeBuffer(GFXRID_ID(MeshletDrawArgs, view_id));
+			builder.writeBuffer(GFXRID_ID(MeshletDrawCount, view_id));
 			builder.writeBuffer(GFXRID_ID(DrawCallsInstances, view_id));
 		}
 		builder.readIndirectArgsBuffer(GFXRID_ID(MeshletFixDispatchArgs, view_id));
@@ -322,8 +325,8 @@ void MeshletPass::add_meshlet_fix_pass(FrameGraph &fg, const MeshletCullDesc &de
 			glm::mat4 frustum_view_projection;
 			uint32_t visible_meshlets_buffer_id;
 			uint32_t visible_meshlets_count_buffer_id;
-			uint32_t draw_indexed_args_buffer_id;
-			uint32_t draw_indexed_count_buffer_id;
+			uint32_t draw_args_buffer_id;
+			uint32_t draw_count_buffer_id;
 			uint32_t draw_calls_indirect_instances_buffer_id;
 			uint32_t occluded_meshlets_buffer_id;
 			uint32_t occluded_meshlets_count_buffer_id;
@@ -341,8 +344,8 @@ void MeshletPass::add_meshlet_fix_pass(FrameGraph &fg, const MeshletCullDesc &de
 
 		if (!render_meshlets_mesh_shaders)
 		{
-			constants.draw_indexed_args_buffer_id = resources.getReadWriteBuffer(GFXRID_ID(DrawIndexedArgs, view_id));
-			constants.draw_indexed_count_buffer_id = resources.getReadWriteBuffer(GFXRID_ID(DrawIndexedCount, view_id));
+			constants.draw_args_buffer_id = resources.getReadWriteBuffer(GFXRID_ID(MeshletDrawArgs, view_id));
+			constants.draw_count_buffer_id = resources.getReadWriteBuffer(GFXRID_ID(MeshletDrawCount, view_id));
 			constants.draw_calls_indirect_instances_buffer_id = resources.getReadWriteBuffer(GFXRID_ID(DrawCallsInstances, view_id));
 		}
 
@@ -1,7 +1,6 @@
 #include "pch.h"
 #include "OpaqueGeometryPass.h"
 #include "Rendering/Renderer.h"
-#include "Rendering/GlobalBufferCache.h"
 #include "Rendering/GlobalPipeline.h"
 #include "FrameGraph/FrameGraphData.h"
 #include "Core/Variables.h"
@@ -58,7 +57,7 @@ void OpaqueGeometryPass::render(FrameGraph &fg, const RenderView &view, const Re
 	cull.use_occlusion = view.use_two_pass_occlusion;
 
 	meshlet_pass.addMainCullingPasses(fg, cull);
-	render_meshlets(fg, view, targets, true);
+	render_meshlets(fg, view, targets, view.clear_depth);
 
 	cull_traditional(fg, view);
 	render_traditional(fg, view, targets);
@@ -94,13 +93,15 @@ void OpaqueGeometryPass::render_meshlets(FrameGraph &fg, const RenderView &view,
 		builder.writeTexture(targets.depth.name);
 		builder.readBuffer(GFXRID_ID(VisibleMeshlets, view.view_id));
 		builder.writeBuffer(GFXRID(GroupResidencyBuffer));
+		if (view.texture_feedback)
+			builder.writeBuffer(GFXRID(TextureFeedbackBuffer));
 
 		if (render_meshlets_mesh_shaders)
 			builder.readIndirectArgsBuffer(GFXRID_ID(DispatchMeshIndirectArgs, view.view_id));
 		else
 		{
-			builder.readIndirectArgsBuffer(GFXRID_ID(DrawIndexedArgs, view.view_id));
-			builder.readIndirectArgsBuffer(GFXRID_ID(DrawIndexedCount, view.view_id));
+			builder.readIndirectArgsBuffer(GFXRID_ID(MeshletDrawArgs, view.view_id));
+			builder.readIndirectArgsBuffer(GFXRID_ID(MeshletDrawCount, view.view_id));
 			builder.readVertexBuffer(GFXRID_ID(DrawCallsInstances, view.view_id));
 		}
 	},
@@ -112,10 +113,7 @@ void OpaqueGeometryPass::render_meshlets(FrameGraph &fg, const RenderView &view,
 		RHITexture *depth = resources.getTexture(targets.depth.name);
 
 		if (!render_meshlets_mesh_shaders)
-		{
 			cmd_list->setVertexBuffer(resources.getBuffer(GFXRID_ID(DrawCallsInstances, view.view_id)), 0, sizeof(uint32_t), 0);
-			cmd_list->setIndexBuffer(GlobalBufferCache::getGlobalMeshletGeometryBuffer(), 0);
-		}
 
 		cmd_list->setRenderTargets(color_textures, depth, targets.layer, 0, clear, view.getDepthClear());
 
@@ -145,7 +143,7 @@ void OpaqueGeometryPass::render_meshlets(FrameGraph &fg, const RenderView &view,
 		if (render_meshlets_mesh_shaders)
 			cmd_list->dispatchMeshIndirect(resources.getBuffer(GFXRID_ID(DispatchMeshIndirectArgs, view.view_id)), 1);
 		else
-			cmd_list->drawIndexedIndirect(resources.getBuffer(GFXRID_ID(DrawIndexedArgs, view.view_id)), MAX_MESHLETS_PER_FRAME, resources.getBuffer(GFXRID_ID(DrawIndexedCount, view.view_id)));
+			cmd_list->drawIndirect(resources.getBuffer(GFXRID_ID(MeshletDrawArgs, view.view_id)), MAX_MESHLETS_PER_FRAME, resources.getBuffer(GFXRID_ID(MeshletDrawCount, view.view_id)));
 
 		cmd_list->resetRenderTargets();
 	});
@@ -212,6 +210,8 @@ void OpaqueGeometryPass::render_traditional(FrameGraph &fg, const RenderView &vi
 		builder.readIndirectArgsBuffer(GFXRID_ID(TraditionalDrawArgs, view.view_id));
 		builder.readIndirectArgsBuffer(GFXRID_ID(TraditionalDrawCount, view.view_id));
 		builder.readVertexBuffer(GFXRID_ID(TraditionalDrawInstances, view.view_id));
+		if (view.texture_feedback)
+			builder.writeBuffer(GFXRID(TextureFeedbackBuffer));
 	},
 	[view, targets](const RenderPassResources &resources, RHICommandList *cmd_list)
 	{
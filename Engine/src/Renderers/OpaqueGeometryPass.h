@@ -29,6 +29,8 @@ public:
 		bool use_two_pass_occlusion = true;
 		bool ortho_frustum = false;
 		bool use_reverse_z = true;
+		bool clear_depth = true; // false to draw on top of existing contents
+		bool texture_feedback = false; // pixel shader writes TextureFeedbackBuffer
 		CullMode cull_mode = CULL_MODE_BACK;
 		ShaderSet shaders;
 
@@ -42,6 +42,55 @@ void ShadowRenderer::addShadowMapPasses(FrameGraph &fg, uint32_t max_draw_calls_
 
 	uint32_t shadow_view_id = 1; // TODO: in future registrate frustums in separate system and use real view_id (view_id is tied to pass_mask and view_projection)
 
+	// Pick stale views to re-render this frame, lights are served round-robin within the budget
+	eastl::vector<entt::entity> shadow_lights;
+	for (entt::entity light_entity_id : light_entities_id)
+	{
+		auto it = light_caches.find(light_entity_id);
+		if (it != light_caches.end() && !it->second.views.empty())
+			shadow_lights.push_back(light_entity_id);
+	}
+
+	eastl::hash_set<uint64_t> scheduled_views;
+	auto view_key = [](entt::entity entity, uint32_t view) { return ((uint64_t)entity << 8) | view; };
+
+	stats = {};
+	int budget = render_shadows_update_budget > 0 ? render_shadows_update_budget.get() : INT_MAX;
+	uint32_t lights_count = shadow_lights.size();
+	uint32_t next_cursor = UINT32_MAX;
+	for (uint32_t i = 0; i < lights_count; i++)
+	{
+		uint32_t index = (update_cursor + i) % lights_count;
+		LightShadowCache &cache = light_caches[shadow_lights[index]];
+
+		bool fully_served = true;
+		bool is_stale = false;
+		for (uint32_t view = 0; view < cache.views.size(); view++)
+		{
+			if (cache.views[view].static_valid)
+				continue;
+			is_stale = true;
+
+			// Never rendered lights have nothing to fall back to, moved views would be sampled with the new matrix.
+			// Budget only defers views whose content changed
+			if (budget > 0 || !cache.static_rendered_once || cache.views[view].is_moved)
+			{
+				scheduled_views.insert(view_key(shadow_lights[index], view));
+				budget--;
+			} else
+			{
+				fully_served = false;
+				stats.views_deferred++;
+			}
+		}
+		stats.stale_lights += is_stale ? 1 : 0;
+
+		// Next frame starts from the first light that didn't fit
+		if (!fully_served && next_cursor == UINT32_MAX)
+			next_cursor = index;
+	}
+	update_cursor = next_cursor != UINT32_MAX ? next_cursor : 0;
+
 	for (entt::entity light_entity_id : light_entities_id)
 	{
 		Entity light_entity(light_entity_id);
@@ -50,84 +99,140 @@ void ShadowRenderer::addShadowMapPasses(FrameGraph &fg, uint32_t max_draw_calls_
 		if (light.getType() == LIGHT_TYPE_DIRECTIONAL && Renderer::isRayTracedShadowsEnabled())
 			continue;
 
-		glm::vec3 scale, position, skew;
-		glm::vec4 persp;
-		glm::quat rotation;
-		glm::decompose(light_entity.getWorldTransformMatrix(), scale, rotation, position, skew, persp);
+		auto cache_it = light_caches.find(light_entity_id);
+		if (cache_it == light_caches.end() || cache_it->second.views.empty())
+			continue;
+		LightShadowCache &cache = cache_it->second;
 
-		if (light.getType() == LIGHT_TYPE_POINT)
-		{
-			glm::mat4 faces_transforms[6] = {
-				glm::lookAtLH(position, position + glm::vec3(1, 0, 0), glm::vec3(0, 1, 0)),
-				glm::lookAtLH(position, position + glm::vec3(-1, 0, 0), glm::vec3(0, 1, 0)),
-				glm::lookAtLH(position, position + glm::vec3(0, 1, 0), glm::vec3(0, 0, -1)),
-				glm::lookAtLH(position, position + glm::vec3(0, -1, 0), glm::vec3(0, 0, 1)),
-				glm::lookAtLH(position, position + glm::vec3(0, 0, 1), glm::vec3(0, 1, 0)),
-				glm::lookAtLH(position, position + glm::vec3(0, 0, -1), glm::vec3(0, 1, 0)),
-			};
-			glm::mat4 light_projection = glm::perspectiveLH(glm::radians(90.0f), 1.0f, POINT_SHADOW_Z_NEAR, light.attenuation_radius);
+		GraphicsResourceName shadow_map_resource = GFXRID_ID(ShadowMap, (uint32_t)light_entity_id);
+		GraphicsResourceName static_shadow_map_resource = GFXRID_ID(ShadowMapStatic, (uint32_t)light_entity_id);
+		fg.importTexture(shadow_map_resource, light.getShadowMap());
+		fg.importTexture(static_shadow_map_resource, cache.static_shadow_map);
+		shadow_passes.shadow_maps.push_back(shadow_map_resource);
+
+		uint32_t shadow_size = light.getShadowMap()->getWidth();
+		bool is_point = light.getType() == LIGHT_TYPE_POINT;
+		if (!is_point)
+			HiZ::createOrImport(fg, cascade_hiz, GFXRID(CascadeHiZ), glm::ivec2(shadow_size / 4), SHADOW_MAP_CASCADE_COUNT);
 
-			GraphicsResourceName shadow_map_resource = GFXRID_ID(ShadowMap, (uint32_t)light_entity_id);
-			fg.importTexture(shadow_map_resource, light.getShadowMap());
-			shadow_passes.shadow_maps.push_back(shadow_map_resource);
+		OpaqueGeometryPass::ShaderSet shaders = OpaqueGeometryPass::ShaderSet::fromFile(L"shaders/lighting/shadows.hlsl");
 
-			OpaqueGeometryPass::ShaderSet shaders = OpaqueGeometryPass::ShaderSet::fromFile(L"shaders/lighting/shadows.hlsl");
+		OpaqueGeometryPass::DepthOutput output;
+		output.depth = shadow_map_resource;
 
-			for (int face = 0; face < 6; face++)
+		for (uint32_t layer = 0; layer < cache.views.size(); layer++)
+		{
+			ShadowViewCache &view_cache = cache.views[layer];
+			bool render_static = scheduled_views.count(view_key(light_entity_id, layer)) > 0;
+
+			OpaqueGeometryPass::RenderView view;
+			view.view_projection = view_cache.view_projection;
+			view.instance_count = max_draw_calls_count;
+			view.render_size = glm::ivec2(shadow_size);
+			view.layer = layer;
+			view.use_reverse_z = false;
+			view.cull_mode = CULL_MODE_FRONT;
+			view.shaders = shaders;
+			if (is_point)
 			{
-				OpaqueGeometryPass::RenderView view;
-				view.view_projection = light_projection * faces_transforms[face];
-				view.pass_mask = PASS_MASK_POINT_SHADOW;
-				view.instance_count = max_draw_calls_count;
-				view.view_id = shadow_view_id++;
-				view.render_size = glm::ivec2(light.getShadowMap()->getWidth());
-				view.layer = face;
 				view.use_two_pass_occlusion = false;
-				view.use_reverse_z = false;
-				view.cull_mode = CULL_MODE_FRONT;
-				view.shaders = shaders;
+			} else
+			{
+				view.hiz = GFXRID(CascadeHiZ);
+				view.use_two_pass_occlusion = true;
+				view.ortho_frustum = true;
+			}
+
+			if (render_static)
+			{
+				view.pass_mask = is_point ? PASS_MASK_POINT_SHADOW : PASS_MASK_DIRECTIONAL_SHADOW;
+				view.view_id = shadow_view_id++;
+				opaque.renderDepth(fg, view, output);
+				add_copy_layer_pass(fg, shadow_map_resource, static_shadow_map_resource, layer);
 
-				OpaqueGeometryPass::DepthOutput output;
-				output.depth = shadow_map_resource;
+				view_cache.static_valid = true;
+				view_cache.is_moved = false;
+				cache.static_rendered_once = true;
+				stats.views_rendered++;
+			} else if (view_cache.has_dynamic_casters || view_cache.shadow_map_has_dynamic)
+			{
+				// Restore static depth, dynamic casters from last frame are left in the shadow map
+				add_copy_layer_pass(fg, static_shadow_map_resource, shadow_map_resource, layer);
+				stats.views_composited++;
+			} else
+			{
+				stats.views_skipped++;
+			}
 
+			if (view_cache.has_dynamic_casters)
+			{
+				view.pass_mask = is_point ? PASS_MASK_POINT_SHADOW_DYNAMIC : PASS_MASK_DIRECTIONAL_SHADOW_DYNAMIC;
+				view.view_id = shadow_view_id++;
+				view.use_two_pass_occlusion = false;
+				view.clear_depth = false;
 				opaque.renderDepth(fg, view, output);
 			}
-		} else
-		{
-			GraphicsResourceName shadow_map_resource = GFXRID_ID(ShadowMap, (uint32_t)light_entity_id);
-			fg.importTexture(shadow_map_resource, light.getShadowMap());
-			shadow_passes.shadow_maps.push_back(shadow_map_resource);
+			view_cache.shadow_map_has_dynamic = view_cache.has_dynamic_casters;
+		}
+	}
+}
 
-			uint32_t shadow_size = light.getShadowMap()->getWidth();
-			HiZ::createOrImport(fg, cascade_hiz, GFXRID(CascadeHiZ), glm::ivec2(shadow_size / 4), SHADOW_MAP_CASCADE_COUNT);
+void ShadowRenderer::add_copy_layer_pass(FrameGraph &fg, GraphicsResourceName src, GraphicsResourceName dst, uint32_t layer)
+{
+	fg.addCallbackPass("Copy Shadow Map Layer",
+	[=](RenderPassBuilder &builder)
+	{
+		builder.readCopyTexture(src);
+		builder.writeCopyTexture(dst);
+		builder.setSideEffect(true);
+	},
+	[=](const RenderPassResources &resources, RHICommandList *cmd_list)
+	{
+		cmd_list->copyTexture(resources.getTexture(src), resources.getTexture(dst), layer, layer);
+	});
+}
 
-			OpaqueGeometryPass::ShaderSet shaders = OpaqueGeometryPass::ShaderSet::fromFile(L"shaders/lighting/shadows.hlsl");
+void ShadowRenderer::invalidateCaches(const eastl::vector<BoundBox> &changed_static_bounds, const eastl::vector<BoundBox> &dynamic_bounds)
+{
+	PROFILE_CPU_FUNCTION();
 
-			for (int cascade = 0; cascade < SHADOW_MAP_CASCADE_COUNT; cascade++)
-			{
-				OpaqueGeometryPass::RenderView view;
-				view.view_projection = light.cascades[cascade].viewProjMatrix;
-				view.pass_mask = PASS_MASK_DIRECTIONAL_SHADOW;
-				view.instance_count = max_draw_calls_count;
-				view.view_id = shadow_view_id++;
-				view.render_size = glm::ivec2(shadow_size);
-				view.hiz = GFXRID(CascadeHiZ);
-				view.layer = cascade;
-				view.use_two_pass_occlusion = true;
-				view.ortho_frustum = true;
-				view.use_reverse_z = false;
-				view.cull_mode = CULL_MODE_FRONT;
-				view.shaders = shaders;
+	for (auto &[entity, cache] : light_caches)
+	{
+		for (ShadowViewCache &view : cache.views)
+		{
+			BoundFrustum frustum(view.view_projection, glm::mat4(1.0f));
 
-				OpaqueGeometryPass::DepthOutput output;
-				output.depth = shadow_map_resource;
+			if (view.static_valid)
+			{
+				for (const BoundBox &bound_box : changed_static_bounds)
+				{
+					if (bound_box.isInside(frustum))
+					{
+						view.static_valid = false;
+						break;
+					}
+				}
+			}
 
-				opaque.renderDepth(fg, view, output);
+			view.has_dynamic_casters = false;
+			for (const BoundBox &bound_box : dynamic_bounds)
+			{
+				if (bound_box.isInside(frustum))
+				{
+					view.has_dynamic_casters = true;
+					break;
+				}
 			}
 		}
 	}
 }
 
+void ShadowRenderer::resetCaches()
+{
+	light_caches.clear();
+	update_cursor = 0;
+}
+
 void ShadowRenderer::addRayTracedShadowPasses(FrameGraph & fg, Ref<RayTracingScene> rt_scene)
 {
 	if (!rt_scene || !rt_scene->getTopLevelAS())
@@ -187,8 +292,12 @@ void ShadowRenderer::updateShadows(Camera *camera)
 {
 	auto components = Scene::getCurrentScene()->getEntitiesWith<TransformComponent, LightComponent>();
 
+	eastl::hash_set<entt::entity> alive_lights;
+
 	for (auto &&[entity, transform, light] : components.each())
 	{
+		eastl::fixed_vector<glm::mat4, 6, false> view_projections;
+
 		if (light.getType() == LIGHT_TYPE_DIRECTIONAL)
 		{
 			glm::vec3 scale, position, skew;
@@ -199,12 +308,69 @@ void ShadowRenderer::updateShadows(Camera *camera)
 			glm::vec3 light_dir = transform.getLocalDirection(glm::vec3(0, 0, 1));
 			debug_renderer->addArrow(position, position + light_dir, 0.1);
 			update_cascades(light, light_dir, camera);
+
+			if (!Renderer::isRayTracedShadowsEnabled())
+			{
+				for (int cascade = 0; cascade < SHADOW_MAP_CASCADE_COUNT; cascade++)
+					view_projections.push_back(light.cascades[cascade].viewProjMatrix);
+			}
 		} else if (light.getType() == LIGHT_TYPE_POINT)
 		{
 			glm::vec3 position = glm::vec3(transform.getWorldTransform()[3]);
-			debug_renderer->addSphere(position, POINT_SHADOW_Z_NEAR, 16, glm::vec3(1, 0.4, 0));
-			debug_renderer->addSphere(position, light.attenuation_radius, 32, glm::vec3(1, 1, 0));
+			debug_renderer->addSphere(position, POINT_SHADOW_Z_NEAR, glm::vec3(1, 0.4, 0));
+			debug_renderer->addSphere(position, light.attenuation_radius, glm::vec3(1, 1, 0));
+
+			glm::mat4 faces_transforms[6] = {
+				glm::lookAtLH(position, position + glm::vec3(1, 0, 0), glm::vec3(0, 1, 0)),
+				glm::lookAtLH(position, position + glm::vec3(-1, 0, 0), glm::vec3(0, 1, 0)),
+				glm::lookAtLH(position, position + glm::vec3(0, 1, 0), glm::vec3(0, 0, -1)),
+				glm::lookAtLH(position, position + glm::vec3(0, -1, 0), glm::vec3(0, 0, 1)),
+				glm::lookAtLH(position, position + glm::vec3(0, 0, 1), glm::vec3(0, 1, 0)),
+				glm::lookAtLH(position, position + glm::vec3(0, 0, -1), glm::vec3(0, 1, 0)),
+			};
+			glm::mat4 light_projection = glm::perspectiveLH(glm::radians(90.0f), 1.0f, POINT_SHADOW_Z_NEAR, light.attenuation_radius);
+			for (int face = 0; face < 6; face++)
+				view_projections.push_back(light_projection * faces_transforms[face]);
+		}
+
+		if (view_projections.empty())
+			continue;
+
+		alive_lights.insert(entity);
+		LightShadowCache &cache = light_caches[entity];
+
+		// Recreated shadow map (type or size changed) invalidates everything
+		RHITexture *shadow_map = light.getShadowMap();
+		if (cache.shadow_map != shadow_map || cache.views.size() != view_projections.size())
+		{
+			cache.shadow_map = shadow_map;
+			cache.static_shadow_map = gDynamicRHI->createTexture(shadow_map->getDescription());
+			cache.static_shadow_map->fill();
+			cache.static_shadow_map->setDebugName("Static Shadow Map Cache");
+			cache.static_rendered_once = false;
+			cache.views.clear();
+			cache.views.resize(view_projections.size());
 		}
+
+		// Moved light or cascade invalidates its view
+		for (uint32_t i = 0; i < view_projections.size(); i++)
+		{
+			ShadowViewCache &view = cache.views[i];
+			if (view.view_projection != view_projections[i])
+			{
+				view.view_projection = view_projections[i];
+				view.static_valid = false;
+				view.is_moved = true;
+			}
+		}
+	}
+
+	for (auto it = light_caches.begin(); it != light_caches.end();)
+	{
+		if (alive_lights.count(it->first) == 0)
+			it = light_caches.erase(it);
+		else
+			++it;
 	}
 }
 
@@ -5,10 +5,20 @@
 #include "Editor/EditorContext.h"
 #include "RHI/RayTracing/RayTracingScene.h"
 #include "Rendering/Renderer.h"
+#include "Math/BoundBox.h"
 
 class ShadowRenderer
 {
 public:
+	struct Stats
+	{
+		uint32_t views_rendered = 0; // static geometry re-rendered
+		uint32_t views_composited = 0; // cached static depth + dynamic casters
+		uint32_t views_skipped = 0; // cached shadow map reused as is
+		uint32_t views_deferred = 0; // stale, but out of update budget
+		uint32_t stale_lights = 0;
+	};
+
 	ShadowRenderer();
 
 	void addShadowMapPasses(FrameGraph &fg, uint32_t max_draw_calls_count);
@@ -19,8 +29,36 @@ public:
 	Ref<RayTracingScene> ray_tracing_scene;
 
 	void updateShadows(Camera *camera);
+
+	// Static bounds are changes of cached geometry (old and new positions), dynamic bounds are casters drawn every frame
+	void invalidateCaches(const eastl::vector<BoundBox> &changed_static_bounds, const eastl::vector<BoundBox> &dynamic_bounds);
+	void resetCaches();
+
+	const Stats &getStats() const { return stats; }
 private:
 	void update_cascades(LightComponent &light, glm::vec3 light_dir, Camera *camera);
+	void add_copy_layer_pass(FrameGraph &fg, GraphicsResourceName src, GraphicsResourceName dst, uint32_t layer);
+
+	struct ShadowViewCache
+	{
+		glm::mat4 view_projection = glm::mat4(0.0f);
+		bool static_valid = false;
+		bool is_moved = false; // cached depth was rendered with another view_projection, can't be deferred
+		bool has_dynamic_casters = false;
+		bool shadow_map_has_dynamic = false; // shadow map differs from cached static depth
+	};
+
+	struct LightShadowCache
+	{
+		RHITextureRef static_shadow_map;
+		RHITexture *shadow_map = nullptr;
+		eastl::fixed_vector<ShadowViewCache, 6, false> views;
+		bool static_rendered_once = false;
+	};
+
+	eastl::hash_map<entt::entity, LightShadowCache> light_caches;
+	uint32_t update_cursor = 0;
+	Stats stats;
 
 private:
 	RHIShaderRef raygen_shader;
@@ -29,4 +67,4 @@ private:
 
 	RHITextureRef cascade_hiz;
 	RHITextureRef storage_image;
-};
\ No newline at end of file
+};
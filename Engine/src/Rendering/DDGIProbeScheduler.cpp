@@ -0,0 +1,138 @@
+#include "pch.h"
+#include "DDGIProbeScheduler.h"
+
+void DDGIProbeScheduler::reset(uint32_t probes_count)
+{
+	probes.clear();
+	probes.resize(probes_count);
+	frame = 0;
+}
+
+void DDGIProbeScheduler::reportChange(uint32_t probe, float relative_change)
+{
+	if (probe >= probes.size())
+		return;
+	float change = glm::clamp(relative_change, 0.0f, 1.0f);
+	Probe &entry = probes[probe];
+	entry.variance += (change * change - entry.variance) * variance_decay;
+}
+
+void DDGIProbeScheduler::markSceneChanged(uint32_t probe)
+{
+	if (probe >= probes.size())
+		return;
+	probes[probe].has_scene_change = true;
+	probes[probe].last_scene_change_frame = frame;
+}
+
+void DDGIProbeScheduler::markAllSceneChanged()
+{
+	for (uint32_t probe = 0; probe < probes.size(); probe++)
+		markSceneChanged(probe);
+}
+
+float DDGIProbeScheduler::getPriority(uint32_t probe) const
+{
+	const Probe &entry = probes[probe];
+	float multiplier = 1.0f + variance_weight * sqrtf(entry.variance);
+	if (entry.has_scene_change && frame - entry.last_scene_change_frame < scene_change_frames)
+		multiplier += scene_change_boost;
+	return float(getAge(probe)) * multiplier;
+}
+
+uint32_t DDGIProbeScheduler::getStarvationBound(uint32_t budget) const
+{
+	uint32_t count = getProbesCount();
+	uint32_t reserved = eastl::min(budget, (count + max_age - 1) / max_age);
+	return reserved > 0 ? (count + reserved - 1) / reserved : UINT32_MAX;
+}
+
+void DDGIProbeScheduler::schedule(uint32_t budget, eastl::vector<uint32_t> &scheduled)
+{
+	PROFILE_CPU_FUNCTION();
+
+	uint32_t count = getProbesCount();
+	budget = eastl::min(budget, count);
+	if (budget == 0)
+	{
+		frame++;
+		return;
+	}
+
+	// Equal priorities go by index, so equal probes are updated round robin
+	auto is_higher = [](const Candidate &a, const Candidate &b)
+	{
+		return a.priority > b.priority || (a.priority == b.priority && a.probe < b.probe);
+	};
+
+	// Oldest probes first. Probes updated by priority only get younger, so a probe waits
+	// at most until all probes older than it were taken, reserved per frame
+	uint32_t reserved = eastl::min(budget, (count + max_age - 1) / max_age);
+	candidates.clear();
+	for (uint32_t probe = 0; probe < count; probe++)
+		candidates.push_back({float(getAge(probe)), probe});
+	eastl::partial_sort(candidates.begin(), candidates.begin() + reserved, candidates.end(), is_higher);
+
+	// Then the rest of the budget by priority
+	for (uint32_t i = reserved; i < count; i++)
+		candidates[i].priority = getPriority(candidates[i].probe);
+	eastl::partial_sort(candidates.begin() + reserved, candidates.begin() + budget, candidates.end(), is_higher);
+
+	size_t first = scheduled.size();
+	for (uint32_t i = 0; i < budget; i++)
+	{
+		uint32_t probe = candidates[i].probe;
+		scheduled.push_back(probe);
+
+		Probe &entry = probes[probe];
+		entry.last_update_frame = frame;
+		if (entry.has_scene_change && frame - entry.last_scene_change_frame >= scene_change_frames)
+			entry.has_scene_change = false;
+	}
+	eastl::sort(scheduled.begin() + first, scheduled.end());
+	frame++;
+}
+
+DDGIProbeScheduler::ReplayResult DDGIProbeScheduler::replay(DDGIProbeScheduler &scheduler, uint32_t probes_count, uint32_t budget, eastl::span<const ReplayFrame> frames, float noise_change)
+{
+	PROFILE_CPU_FUNCTION();
+	ReplayResult result;
+	scheduler.reset(probes_count);
+
+	eastl::vector<float> changes(probes_count, 1.0f);
+	eastl::vector<uint32_t> last_update_frames(probes_count, 0);
+	eastl::vector<uint32_t> scheduled;
+	double error_sum = 0.0;
+	for (uint32_t frame = 0; frame < frames.size(); frame++)
+	{
+		for (uint32_t probe : frames[frame].changed_probes)
+		{
+			changes[probe] = 1.0f;
+			scheduler.markSceneChanged(probe);
+		}
+
+		scheduled.clear();
+		scheduler.schedule(budget, scheduled);
+		for (uint32_t probe : scheduled)
+		{
+			result.max_age = eastl::max(result.max_age, frame - last_update_frames[probe]);
+			last_update_frames[probe] = frame;
+
+			scheduler.reportChange(probe, changes[probe]);
+			changes[probe] = eastl::max(changes[probe] * 0.5f, noise_change);
+		}
+		result.updates += scheduled.size();
+		result.max_frame_updates = eastl::max(result.max_frame_updates, (uint32_t)scheduled.size());
+
+		double frame_error = 0.0;
+		for (float change : changes)
+			frame_error += change - noise_change;
+		error_sum += frame_error / eastl::max(probes_count, 1u);
+	}
+
+	// Probes that were never updated waited for the whole replay
+	for (uint32_t probe = 0; probe < probes_count; probe++)
+		result.max_age = eastl::max(result.max_age, (uint32_t)frames.size() - last_update_frames[probe]);
+	result.average_error = frames.empty() ? 0.0 : error_sum / frames.size();
+	return result;
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include <EASTL/span.h>
+#include <EASTL/vector.h>
+
+// Picks the DDGI probes that are traced this frame. Works only with flat probe indices, so it can be replayed on the CPU.
+// Priority is the age of a probe (frames since its last update) scaled up by its irradiance variance
+// and raised for probes near recent scene changes, so converged probes in static regions are updated rarely.
+// Starvation bound: the oldest probes get a reserved part of the budget, every probe is updated at least
+// every max(max_age, ceil(probes / budget)) frames, whatever the priorities are.
+class DDGIProbeScheduler
+{
+public:
+	uint32_t max_age = 64;
+	float variance_weight = 4.0f; // age multiplier per unit of RMS relative irradiance change
+	float variance_decay = 0.25f; // weight of a new change in the running mean of squared changes
+	float scene_change_boost = 32.0f; // age multiplier of probes near a change
+	uint32_t scene_change_frames = 32; // frames a change keeps boosting probes near it
+
+	void reset(uint32_t probes_count);
+	uint32_t getProbesCount() const { return (uint32_t)probes.size(); }
+
+	// Relative irradiance change of an updated probe (0 - same, 1 - everything changed), reported by the update shader
+	void reportChange(uint32_t probe, float relative_change);
+	// Geometry or lights changed near the probe, it is boosted for scene_change_frames
+	void markSceneChanged(uint32_t probe);
+	void markAllSceneChanged();
+
+	// Appends up to budget probes sorted by index and advances the frame
+	void schedule(uint32_t budget, eastl::vector<uint32_t> &scheduled);
+
+	uint32_t getAge(uint32_t probe) const { return frame - probes[probe].last_update_frame; }
+	float getVariance(uint32_t probe) const { return probes[probe].variance; }
+	float getPriority(uint32_t probe) const;
+	uint32_t getStarvationBound(uint32_t budget) const;
+
+	struct ReplayFrame
+	{
+		eastl::vector<uint32_t> changed_probes; // probes near scene changes this frame
+	};
+
+	struct ReplayResult
+	{
+		uint64_t updates = 0;
+		uint32_t max_age = 0; // largest age a probe reached before its update
+		uint32_t max_frame_updates = 0; // most probes updated in one frame
+		double average_error = 0.0; // relative change not yet picked up by updates, per probe and frame
+	};
+
+	// Replays frames against the scheduler. A probe converges with every update: its change halves until it is
+	// under noise_change, changed_probes start again from 1. Reported changes are what an updated probe would report.
+	static ReplayResult replay(DDGIProbeScheduler &scheduler, uint32_t probes_count, uint32_t budget, eastl::span<const ReplayFrame> frames, float noise_change);
+
+private:
+	struct Probe
+	{
+		uint32_t last_update_frame = 0;
+		uint32_t last_scene_change_frame = 0;
+		float variance = 1.0f; // running mean of squared relative changes, new probes are unknown
+		bool has_scene_change = false;
+	};
+	eastl::vector<Probe> probes;
+	uint32_t frame = 0;
+
+	struct Candidate
+	{
+		float priority;
+		uint32_t probe;
+	};
+	eastl::vector<Candidate> candidates;
+};
@@ -0,0 +1,122 @@
+#include "pch.h"
+#include "GeometryResidencyPolicy.h"
+
+void BudgetLRUResidencyPolicy::onLoaded(uint32_t group, uint64_t size)
+{
+	Group &entry = groups[group];
+	entry.size = size;
+	entry.screen_error = 0.0f;
+	entry.age = 0;
+	entry.stale_frame = UINT64_MAX;
+}
+
+void BudgetLRUResidencyPolicy::onUnloaded(uint32_t group)
+{
+	groups.erase(group);
+}
+
+void BudgetLRUResidencyPolicy::onStale(uint32_t group, uint32_t age, float screen_error, uint64_t frame)
+{
+	auto it = groups.find(group);
+	if (it == groups.end())
+		return;
+	it->second.age = age;
+	it->second.screen_error = screen_error;
+	it->second.stale_frame = frame;
+}
+
+void BudgetLRUResidencyPolicy::selectEvictions(uint64_t resident_bytes, uint64_t budget_bytes, uint64_t frame, eastl::vector<uint32_t> &evictions)
+{
+	PROFILE_CPU_FUNCTION();
+	if (resident_bytes <= budget_bytes)
+		return;
+
+	candidates.clear();
+	for (const auto &[group, entry] : groups)
+	{
+		// Groups used again after their report stop being reported, so old reports expire
+		if (entry.stale_frame == UINT64_MAX || frame - entry.stale_frame > candidate_lifetime)
+			continue;
+		float age = float(entry.age + (frame - entry.stale_frame));
+		candidates.push_back({age / (1.0f + error_weight * entry.screen_error), group, entry.size});
+	}
+	eastl::sort(candidates.begin(), candidates.end(), [](const Candidate &a, const Candidate &b) { return a.score > b.score; });
+
+	uint64_t target_bytes = uint64_t(budget_bytes * (1.0f - hysteresis));
+	for (const Candidate &candidate : candidates)
+	{
+		if (resident_bytes <= target_bytes)
+			break;
+		evictions.push_back(candidate.group);
+		resident_bytes -= eastl::min(resident_bytes, candidate.size);
+	}
+}
+
+GeometryResidencyPolicy::ReplayResult GeometryResidencyPolicy::replay(GeometryResidencyPolicy &policy, eastl::span<const ReplayFrame> frames,
+	eastl::span<const uint64_t> group_sizes, uint64_t budget_bytes, uint32_t stale_age)
+{
+	PROFILE_CPU_FUNCTION();
+	ReplayResult result;
+	struct LastUse
+	{
+		uint64_t frame;
+		float screen_error;
+	};
+	eastl::hash_map<uint32_t, LastUse> last_used; // resident groups
+	eastl::vector<eastl::pair<uint32_t, float>> to_load;
+	eastl::vector<uint32_t> evictions;
+	uint64_t resident_bytes = 0;
+
+	for (uint64_t frame = 0; frame < frames.size(); frame++)
+	{
+		const ReplayFrame &replay_frame = frames[frame];
+		to_load.clear();
+		for (uint32_t i = 0; i < replay_frame.used_groups.size(); i++)
+		{
+			uint32_t group = replay_frame.used_groups[i];
+			float screen_error = i < replay_frame.used_errors.size() ? replay_frame.used_errors[i] : 0.0f;
+			result.requests++;
+			auto it = last_used.find(group);
+			if (it != last_used.end())
+			{
+				result.hits++;
+				// Several views in one frame, the GPU keeps the largest error
+				float previous_error = it->second.frame == frame ? it->second.screen_error : 0.0f;
+				it->second = {frame, eastl::max(previous_error, screen_error)};
+			} else
+			{
+				to_load.push_back({group, screen_error});
+			}
+		}
+
+		for (const auto &[group, use] : last_used)
+		{
+			uint64_t age = frame - use.frame;
+			if (age >= stale_age)
+				policy.onStale(group, (uint32_t)age, use.screen_error, frame);
+		}
+
+		for (const auto &[group, screen_error] : to_load)
+		{
+			if (!last_used.insert({group, LastUse{frame, screen_error}}).second)
+				continue; // requested twice in one frame
+			policy.onLoaded(group, group_sizes[group]);
+			resident_bytes += group_sizes[group];
+			result.upload_bytes += group_sizes[group];
+			result.loads++;
+		}
+		result.peak_resident_bytes = eastl::max(result.peak_resident_bytes, resident_bytes);
+
+		evictions.clear();
+		policy.selectEvictions(resident_bytes, budget_bytes, frame, evictions);
+		for (uint32_t group : evictions)
+		{
+			if (last_used.erase(group) == 0)
+				continue;
+			policy.onUnloaded(group);
+			resident_bytes -= group_sizes[group];
+			result.evictions++;
+		}
+	}
+	return result;
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include <EASTL/span.h>
+#include <EASTL/vector.h>
+#include <EASTL/hash_map.h>
+
+// Decides which resident meshlet groups are unloaded from the geometry buffer.
+// Works only with flat group indices and byte sizes, so a policy can be replayed on the CPU without a device.
+class GeometryResidencyPolicy
+{
+public:
+	virtual ~GeometryResidencyPolicy() = default;
+
+	virtual void onLoaded(uint32_t group, uint64_t size) = 0;
+	virtual void onUnloaded(uint32_t group) = 0;
+	// Group was not used by any view for 'age' frames (reported by the GPU aging pass). screen_error is the group
+	// simplification error in pixels the last frame it was used, the largest of all views (near groups have larger errors).
+	// A frame reports at most MAX_UNLOAD_REQUESTS groups from a rotating window, a larger stale set is seen over several frames
+	virtual void onStale(uint32_t group, uint32_t age, float screen_error, uint64_t frame) = 0;
+	// Appends groups to unload, nothing is appended while resident_bytes fits into budget_bytes
+	virtual void selectEvictions(uint64_t resident_bytes, uint64_t budget_bytes, uint64_t frame, eastl::vector<uint32_t> &evictions) = 0;
+
+	struct ReplayFrame
+	{
+		eastl::vector<uint32_t> used_groups; // groups the traversal wanted this frame (e.g. from MeshletTraversal)
+		eastl::vector<float> used_errors; // screen error in pixels of every used group, empty if not known
+	};
+
+	struct ReplayResult
+	{
+		uint64_t requests = 0;
+		uint64_t hits = 0;
+		uint64_t loads = 0;
+		uint64_t evictions = 0;
+		uint64_t upload_bytes = 0;
+		uint64_t peak_resident_bytes = 0;
+
+		float getHitRate() const { return requests > 0 ? (float)hits / requests : 1.0f; }
+	};
+
+	// Replays a recorded trace against the policy. Missing groups are loaded at the end of the frame,
+	// the same way GPU requests are served, and groups unused for stale_age frames are reported as stale.
+	static ReplayResult replay(GeometryResidencyPolicy &policy, eastl::span<const ReplayFrame> frames,
+		eastl::span<const uint64_t> group_sizes, uint64_t budget_bytes, uint32_t stale_age);
+};
+
+// LRU over the stale groups reported by the GPU. Evicts only when over budget and then down to
+// budget * (1 - hysteresis), so usage doesn't oscillate around the budget.
+// At equal age groups with a lower screen error the last time they were used go first: far away or finer than
+// the view needed, so their parents cover them on screen with the least visible loss.
+class BudgetLRUResidencyPolicy: public GeometryResidencyPolicy
+{
+public:
+	float hysteresis = 0.1f;
+	float error_weight = 4.0f; // per pixel of screen error
+	uint32_t candidate_lifetime = 8; // frames a stale report is trusted without being repeated
+
+	void onLoaded(uint32_t group, uint64_t size) override;
+	void onUnloaded(uint32_t group) override;
+	void onStale(uint32_t group, uint32_t age, float screen_error, uint64_t frame) override;
+	void selectEvictions(uint64_t resident_bytes, uint64_t budget_bytes, uint64_t frame, eastl::vector<uint32_t> &evictions) override;
+
+private:
+	struct Group
+	{
+		uint64_t size = 0;
+		float screen_error = 0.0f;
+		uint32_t age = 0;
+		uint64_t stale_frame = UINT64_MAX; // UINT64_MAX while the group is in use
+	};
+	eastl::hash_map<uint32_t, Group> groups;
+
+	struct Candidate
+	{
+		float score;
+		uint32_t group;
+		uint64_t size;
+	};
+	eastl::vector<Candidate> candidates;
+};
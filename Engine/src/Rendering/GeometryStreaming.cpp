@@ -1,6 +1,7 @@
 #include "pch.h"
 #include "GeometryStreaming.h"
 #include "Core/Platform.h"
+#include "Core/Variables.h"
 #include "Scene/Components.h"
 #include "GlobalBufferCache.h"
 #include "Assets/MeshFormat.h"
@@ -10,7 +11,6 @@
 
 namespace
 {
-constexpr uint32_t EVICTION_AGE_THRESHOLD = 16;
 constexpr uint32_t MAX_GROUPS_PER_FRAME = 256;
 constexpr uint32_t STALE_REQUEST_FRAMES = 12;
 
@@ -19,7 +19,9 @@ struct StreamRequestsBufferLayout
 	uint32_t load_count;
 	uint32_t unload_count;
 	uint32_t load_indices[MAX_STREAMING_REQUESTS];
-	uint32_t unload_indices[MAX_UNLOAD_REQUESTS];
+	uint32_t unload_indices[MAX_UNLOAD_REQUESTS]; // stale groups, eviction candidates for the residency policy
+	uint32_t unload_ages[MAX_UNLOAD_REQUESTS];
+	float unload_errors[MAX_UNLOAD_REQUESTS]; // screen error in pixels the last frame the group was used
 };
 constexpr uint32_t STREAM_REQUESTS_BUFFER_SIZE = sizeof(StreamRequestsBufferLayout);
 
@@ -35,11 +37,37 @@ RHIBufferRef create_storage_buffer(uint32_t size, BufferUsage usage, bool use_st
 	return buffer;
 }
 
-// Writes [Meshlet headers | Vertices | Triangles] into dst.
-void fill_group_data(uint8_t *dst, Engine::Mesh *mesh, uint32_t local_group_id, const Engine::MeshletFileView &file_view)
+// Triangles keep the .mesh packing: 3 uint8 local indices per triangle.
+// Section is padded to 4 bytes plus one guard word, shaders read every triangle with a single aligned Load2.
+uint32_t packed_triangle_section_size(uint32_t triangle_index_count)
 {
-	Engine::MeshletGeometry::LODGroupDataInfo &info = mesh->meshlet_data->meshlet_lod_group_data_info[local_group_id];
-	LODGroup &group = mesh->meshlet_data->meshlet_lod_groups[local_group_id];
+	return Math::alignedSize(triangle_index_count, 4u) + sizeof(uint32_t);
+}
+}
+
+uint32_t GeometryStreaming::getGroupDataSize(Engine::Mesh *mesh, uint32_t local_group_id)
+{
+	const Engine::MeshletGeometry::LODGroupDataInfo &info = mesh->meshlet_data->meshlet_lod_group_data_info[local_group_id];
+	const LODGroup &group = mesh->meshlet_data->meshlet_lod_groups[local_group_id];
+	return group.meshlet_count * sizeof(Meshlet)
+		+ info.cpu_vertex_count * MeshFormat::diskVertexStride(mesh->attribute_flags)
+		+ packed_triangle_section_size(info.cpu_triangle_count);
+}
+
+glm::uvec3 GeometryStreaming::decodePackedTriangle(const uint8_t *group_data, uint32_t byte_offset)
+{
+	uint32_t aligned_offset = byte_offset & ~3u;
+	uint32_t shift = (byte_offset - aligned_offset) * 8;
+	uint32_t words[2];
+	memcpy(words, group_data + aligned_offset, sizeof(words));
+	uint32_t packed = shift == 0 ? words[0] : (words[0] >> shift) | (words[1] << (32 - shift));
+	return glm::uvec3(packed & 0xFF, (packed >> 8) & 0xFF, (packed >> 16) & 0xFF);
+}
+
+void GeometryStreaming::fillGroupData(uint8_t *dst, Engine::Mesh *mesh, uint32_t local_group_id, const Engine::MeshletFileView &file_view)
+{
+	const Engine::MeshletGeometry::LODGroupDataInfo &info = mesh->meshlet_data->meshlet_lod_group_data_info[local_group_id];
+	const LODGroup &group = mesh->meshlet_data->meshlet_lod_groups[local_group_id];
 
 	uint32_t meshlet_count = group.meshlet_count;
 	uint32_t header_bytes = meshlet_count * sizeof(Meshlet);
@@ -48,41 +76,33 @@ void fill_group_data(uint8_t *dst, Engine::Mesh *mesh, uint32_t local_group_id,
 
 	for (uint32_t m = 0; m < meshlet_count; m++)
 	{
-		Meshlet meshlet = mesh->meshlet_data->meshlets[group.first_meshlet + m];
+		// Meshlets are decoded only when their group is streamed in
+		Meshlet meshlet = mesh->meshlet_data->getMeshlet(group.first_meshlet + m);
 		meshlet.vertex_offset = header_bytes + meshlet.vertex_offset * disk_stride;
-		meshlet.triangle_offset = header_bytes + vertex_section_bytes + meshlet.triangle_offset * sizeof(uint32_t);
+		meshlet.triangle_offset = header_bytes + vertex_section_bytes + meshlet.triangle_offset;
 		memcpy(dst + m * sizeof(Meshlet), &meshlet, sizeof(Meshlet));
 	}
 
 	const uint8_t *src_verts = file_view.vertices_ptr + info.cpu_vertex_offset * disk_stride;
 	memcpy(dst + header_bytes, src_verts, vertex_section_bytes);
 
-	uint32_t *dst_tris = (uint32_t *)(dst + header_bytes + vertex_section_bytes);
+	uint8_t *dst_tris = dst + header_bytes + vertex_section_bytes;
 	const uint8_t *src_tris = file_view.triangles_ptr + info.cpu_triangle_offset;
-	for (uint32_t k = 0; k < info.cpu_triangle_count; k++)
-		dst_tris[k] = src_tris[k];
-}
-
-uint32_t group_data_size(Engine::Mesh *mesh, uint32_t local_group_id)
-{
-	const Engine::MeshletGeometry::LODGroupDataInfo &info = mesh->meshlet_data->meshlet_lod_group_data_info[local_group_id];
-	const LODGroup &group = mesh->meshlet_data->meshlet_lod_groups[local_group_id];
-	return group.meshlet_count * sizeof(Meshlet)
-		+ info.cpu_vertex_count * MeshFormat::diskVertexStride(mesh->attribute_flags)
-		+ info.cpu_triangle_count * sizeof(uint32_t);
-}
+	uint32_t triangle_section_bytes = packed_triangle_section_size(info.cpu_triangle_count);
+	memcpy(dst_tris, src_tris, info.cpu_triangle_count);
+	memset(dst_tris + info.cpu_triangle_count, 0, triangle_section_bytes - info.cpu_triangle_count);
 }
 
 uint32_t GeometryStreaming::upload_group_data(Engine::Mesh *mesh, uint32_t local_group_id, const Engine::MeshletFileView &file_view, RHICommandList *cmd_list)
 {
 	PROFILE_CPU_FUNCTION();
-	uint32_t data_size = group_data_size(mesh, local_group_id);
+	uint32_t data_size = getGroupDataSize(mesh, local_group_id);
 
 	UploadManager::StagedRange range = gUploadManager->stage(data_size);
 	if (!range.data)
 		return UINT32_MAX;
 
-	fill_group_data(range.data, mesh, local_group_id, file_view);
+	fillGroupData(range.data, mesh, local_group_id, file_view);
 
 	uint64_t offset = GlobalBufferCache::addMeshletGeometryData(range.buffer, range.offset, data_size, cmd_list);
 	if (offset != UINT64_MAX)
@@ -92,9 +112,13 @@ uint32_t GeometryStreaming::upload_group_data(Engine::Mesh *mesh, uint32_t local
 
 void GeometryStreaming::init()
 {
+	if (!residency_policy)
+		residency_policy = std::make_unique<BudgetLRUResidencyPolicy>();
+
 	stream_requests_gpu = create_storage_buffer(STREAM_REQUESTS_BUFFER_SIZE, BufferUsage::SHADER_WRITE_BUFFER, true, "Streaming Requests GPU");
 	group_residency_gpu = create_storage_buffer(sizeof(GroupResidency), BufferUsage::SHADER_WRITE_BUFFER, true, "Meshlet Group Residency Buffer");
 	group_ages_gpu = create_storage_buffer(sizeof(uint32_t), BufferUsage::SHADER_WRITE_BUFFER, true, "Meshlet Group Ages Buffer");
+	group_errors_gpu = create_storage_buffer(GROUP_ERRORS_STRIDE, BufferUsage::SHADER_WRITE_BUFFER, true, "Meshlet Group Errors Buffer");
 
 	for (int i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
 		stream_requests_readback[i] = create_storage_buffer(STREAM_REQUESTS_BUFFER_SIZE, BufferUsage::READBACK_BUFFER, false, "Streaming Requests Readback");
@@ -147,16 +171,19 @@ void GeometryStreaming::registerMesh(Engine::Mesh *mesh, const Engine::MeshletFi
 		GroupResidency &group = group_residency[base + i];
 		if (i >= coarsest_lod.group_offset)
 		{
-			uint32_t data_size = group_data_size(mesh, i);
+			uint32_t data_size = getGroupDataSize(mesh, i);
 			eastl::vector<uint8_t> scratch(data_size);
-			fill_group_data(scratch.data(), mesh, i, reg.file_view);
+			fillGroupData(scratch.data(), mesh, i, reg.file_view);
 
 			RHIBufferRef staging = create_storage_buffer(data_size, BufferUsage::STAGING_BUFFER, false, "Group Upload Staging");
 			staging->fill(scratch.data());
 
 			group.geometry_buffer_offset = GlobalBufferCache::addMeshletGeometryData(staging, 0, data_size, gDynamicRHI->getCmdList());
 			if (group.geometry_buffer_offset != UINT64_MAX)
+			{
 				stats.resident_groups++;
+				stats.resident_bytes += data_size;
+			}
 		} else
 		{
 			group.geometry_buffer_offset = GROUP_NON_RESIDENT_ADDRESS_START;
@@ -183,9 +210,10 @@ void GeometryStreaming::unregisterMesh(Engine::Mesh *mesh)
 		uint64_t offset = group_residency[flat_index].geometry_buffer_offset;
 		if (offset < GROUP_NON_RESIDENT_ADDRESS_START)
 		{
-			uint64_t data_size = group_data_size(mesh, i);
+			uint64_t data_size = getGroupDataSize(mesh, i);
 			pending_frees.push_back({offset, data_size, gDynamicRHI->getFrame()});
 			stats.addUnload(data_size);
+			residency_policy->onUnloaded(flat_index);
 		}
 		group_residency[flat_index].geometry_buffer_offset = GROUP_NON_RESIDENT_ADDRESS_START;
 		flat_to_mesh[flat_index] = nullptr;
@@ -212,6 +240,7 @@ void GeometryStreaming::update()
 	process_deferred_frees();
 
 	eastl::vector<uint32_t> newly_loaded = upload_pending_groups(gDynamicRHI->getCmdList());
+	evict_over_budget();
 
 	stats.pending_load_queue_size = load_queued.size();
 	stats.pending_frees_count = pending_frees.size();
@@ -224,6 +253,14 @@ void GeometryStreaming::update()
 		ages_buffer_grew = true;
 	}
 
+	// Errors are zero between frames, the aging pass moves them to the last used error and clears them
+	uint32_t errors_size = group_residency.size() * GROUP_ERRORS_STRIDE;
+	if (group_errors_gpu->getSize() < errors_size)
+	{
+		group_errors_gpu = create_storage_buffer(errors_size, BufferUsage::SHADER_WRITE_BUFFER, true, "Meshlet Group Errors Buffer");
+		gUploadManager->queueUpload(GFXRID(GroupErrorsBuffer), 0, errors_size, [errors_size](uint8_t *dst) { memset(dst, 0, errors_size); });
+	}
+
 	if (is_residency_dirty)
 	{
 		is_residency_dirty = false;
@@ -260,6 +297,7 @@ void GeometryStreaming::importBuffers(FrameGraph &frame_graph)
 	frame_graph.importBuffer(GFXRID(GroupResidencyBuffer), group_residency_gpu);
 	frame_graph.importBuffer(GFXRID(StreamRequestsBuffer), stream_requests_gpu);
 	frame_graph.importBuffer(GFXRID(GroupAgesBuffer), group_ages_gpu);
+	frame_graph.importBuffer(GFXRID(GroupErrorsBuffer), group_errors_gpu);
 }
 
 void GeometryStreaming::addAgeFilterAndReadbackPasses(FrameGraph &frame_graph)
@@ -273,6 +311,7 @@ void GeometryStreaming::addAgeFilterAndReadbackPasses(FrameGraph &frame_graph)
 		{
 			builder.writeBuffer(GFXRID(GroupResidencyBuffer));
 			builder.writeBuffer(GFXRID(GroupAgesBuffer));
+			builder.writeBuffer(GFXRID(GroupErrorsBuffer));
 			builder.writeBuffer(GFXRID(StreamRequestsBuffer));
 		},
 		[this, group_count](const RenderPassResources &resources, RHICommandList *cmd_list)
@@ -284,12 +323,17 @@ void GeometryStreaming::addAgeFilterAndReadbackPasses(FrameGraph &frame_graph)
 				uint32_t group_residency_buffer_id;
 				uint32_t stream_requests_buffer_id;
 				uint32_t group_ages_buffer_id;
+				uint32_t report_offset;
+				uint32_t group_errors_buffer_id;
 			} constants;
 			constants.group_count = group_count;
-			constants.age_threshold = EVICTION_AGE_THRESHOLD;
+			constants.age_threshold = (uint32_t)eastl::max(render_streaming_stale_age.get(), 1);
 			constants.group_residency_buffer_id = resources.getReadWriteBuffer(GFXRID(GroupResidencyBuffer));
 			constants.stream_requests_buffer_id = resources.getReadWriteBuffer(GFXRID(StreamRequestsBuffer));
 			constants.group_ages_buffer_id = resources.getReadWriteBuffer(GFXRID(GroupAgesBuffer));
+			constants.report_offset = stale_report_offset % group_count;
+			stale_report_offsets[gDynamicRHI->getFrameInFlight()] = constants.report_offset;
+			constants.group_errors_buffer_id = resources.getReadWriteBuffer(GFXRID(GroupErrorsBuffer));
 
 			gGlobalPipeline->setupComputePipeline(gDynamicRHI->createShader(L"shaders/gpu_driven/meshlet_stream_aging.hlsl", COMPUTE_SHADER));
 			gGlobalPipeline->flushAndBind(cmd_list);
@@ -324,6 +368,7 @@ void GeometryStreaming::process_gpu_requests(int frame)
 		load_queued[flat_index] = gDynamicRHI->getFrame();
 	}
 
+	// Stale groups are only reported, the policy decides what is evicted once the budget is exceeded
 	uint32_t unload_count = eastl::min(requests->unload_count, MAX_UNLOAD_REQUESTS);
 	for (uint32_t i = 0; i < unload_count; i++)
 	{
@@ -332,6 +377,35 @@ void GeometryStreaming::process_gpu_requests(int frame)
 			continue;
 		if (group_residency[flat_index].geometry_buffer_offset >= GROUP_NON_RESIDENT_ADDRESS_START)
 			continue;
+		residency_policy->onStale(flat_index, requests->unload_ages[i], requests->unload_errors[i], gDynamicRHI->getFrame());
+	}
+
+	// Report overflowed, next scan starts after the furthest reported group. Reports stay with the policy for
+	// candidate_lifetime frames, so it sorts by age over the stale groups of the last few windows
+	uint32_t group_count = group_residency.size();
+	if (requests->unload_count > MAX_UNLOAD_REQUESTS && group_count > 0)
+	{
+		uint32_t report_offset = stale_report_offsets[frame] % group_count;
+		uint32_t furthest = 0;
+		for (uint32_t i = 0; i < unload_count; i++)
+			furthest = eastl::max(furthest, (requests->unload_indices[i] + group_count - report_offset) % group_count);
+		stale_report_offset = (report_offset + furthest + 1) % group_count;
+	}
+
+	stream_requests_readback[frame]->unmap();
+}
+
+void GeometryStreaming::evict_over_budget()
+{
+	PROFILE_CPU_FUNCTION();
+	stats.budget_bytes = (uint64_t)eastl::max(render_streaming_budget_mb.get(), 0) * 1024 * 1024;
+
+	eastl::vector<uint32_t> evictions;
+	residency_policy->selectEvictions(stats.resident_bytes, stats.budget_bytes, gDynamicRHI->getFrame(), evictions);
+	for (uint32_t flat_index : evictions)
+	{
+		if (flat_index >= flat_to_mesh.size() || group_residency[flat_index].geometry_buffer_offset >= GROUP_NON_RESIDENT_ADDRESS_START)
+			continue;
 
 		Engine::Mesh *mesh = flat_to_mesh[flat_index];
 		if (!mesh)
@@ -343,13 +417,12 @@ void GeometryStreaming::process_gpu_requests(int frame)
 
 		is_residency_dirty = true;
 		uint64_t freed_offset = group_residency[flat_index].geometry_buffer_offset;
-		uint64_t freed_size = group_data_size(mesh, local_group_id);
+		uint64_t freed_size = getGroupDataSize(mesh, local_group_id);
 		group_residency[flat_index].geometry_buffer_offset = GROUP_NON_RESIDENT_ADDRESS_START;
 		pending_frees.push_back({freed_offset, freed_size, gDynamicRHI->getFrame()});
 		stats.addUnload(freed_size);
+		residency_policy->onUnloaded(flat_index);
 	}
-
-	stream_requests_readback[frame]->unmap();
 }
 
 void GeometryStreaming::process_deferred_frees()
@@ -401,6 +474,7 @@ eastl::vector<uint32_t> GeometryStreaming::upload_pending_groups(RHICommandList
 			break;
 
 		group_residency[flat_index].geometry_buffer_offset = offset;
+		residency_policy->onLoaded(flat_index, getGroupDataSize(mesh, local_group_id));
 		loaded.push_back(flat_index);
 		is_residency_dirty = true;
 		loaded_groups++;
@@ -4,6 +4,7 @@
 #include "ShaderStructs.h"
 #include "Renderer.h"
 #include "FrameGraph/FrameGraph.h"
+#include "GeometryResidencyPolicy.h"
 
 class GeometryStreaming
 {
@@ -17,6 +18,9 @@ public:
 
 	uint32_t getMeshResidencyOffset(Engine::Mesh *mesh) const { return registered_meshes.at(mesh).group_residency_offset; }
 
+	// Must be set before any mesh is registered, init() falls back to BudgetLRUResidencyPolicy
+	void setResidencyPolicy(std::unique_ptr<GeometryResidencyPolicy> policy) { residency_policy = std::move(policy); }
+
 	struct Stats
 	{
 		uint64_t total_loads = 0;
@@ -34,9 +38,12 @@ public:
 		uint32_t registered_mesh_count = 0;
 		uint32_t pending_load_queue_size = 0;
 		uint32_t pending_frees_count = 0;
+		uint64_t resident_bytes = 0;
+		uint64_t budget_bytes = 0;
 
 		void addLoad(uint64_t size)
 		{
+			resident_bytes += size;
 			total_loads++;
 			loads_last_frame++;
 			total_bytes_loaded += size;
@@ -46,6 +53,7 @@ public:
 
 		void addUnload(uint64_t size)
 		{
+			resident_bytes -= eastl::min(resident_bytes, size);
 			total_unloads++;
 			unloads_last_frame++;
 			total_bytes_unloaded += size;
@@ -56,6 +64,12 @@ public:
 	};
 	const Stats &getStats() const { return stats; }
 
+	// Upload layout of a meshlet group: [Meshlet headers | Vertices | Packed triangles]
+	static uint32_t getGroupDataSize(Engine::Mesh *mesh, uint32_t local_group_id);
+	static void fillGroupData(uint8_t *dst, Engine::Mesh *mesh, uint32_t local_group_id, const Engine::MeshletFileView &file_view);
+	// Same decode as loadMeshletTriangle in meshlet_vertex.h
+	static glm::uvec3 decodePackedTriangle(const uint8_t *group_data, uint32_t byte_offset);
+
 private:
 	struct RegisteredMesh
 	{
@@ -78,6 +92,7 @@ private:
 
 	void process_gpu_requests(int frame);
 	void process_deferred_frees();
+	void evict_over_budget();
 	eastl::vector<uint32_t> upload_pending_groups(RHICommandList *cmd_list);
 	uint32_t upload_group_data(Engine::Mesh *mesh, uint32_t local_group_id, const Engine::MeshletFileView &file_view, RHICommandList *cmd_list);
 	uint32_t allocate_residency_range(uint32_t count);
@@ -89,10 +104,17 @@ private:
 
 	bool is_residency_dirty = false;
 	Stats stats;
+	std::unique_ptr<GeometryResidencyPolicy> residency_policy;
 	eastl::vector<GroupResidency> group_residency;
 	RHIBufferRef group_residency_gpu;
 	RHIBufferRef group_ages_gpu;
+	// Per group: largest screen error of this frame (as uint, traversal takes max of all views), error of the last frame it was used
+	RHIBufferRef group_errors_gpu;
+	static constexpr uint32_t GROUP_ERRORS_STRIDE = 2 * sizeof(uint32_t);
 
 	RHIBufferRef stream_requests_gpu;
 	RHIBufferRef stream_requests_readback[MAX_FRAMES_IN_FLIGHT];
+	// First group of the stale report scan, the report holds only MAX_UNLOAD_REQUESTS groups
+	uint32_t stale_report_offset = 0;
+	uint32_t stale_report_offsets[MAX_FRAMES_IN_FLIGHT] = {};
 };
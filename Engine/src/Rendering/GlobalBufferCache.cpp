@@ -67,9 +67,11 @@ uint64_t GlobalBufferCache::GlobalBuffer::allocate_range(uint64_t needed_size, R
 
 		cmd_list->copyBuffer(buffer, new_buffer, 0, 0, max_size);
 
+		// New space joins the free range at the end of the old buffer
+		uint64_t old_size = max_size;
 		buffer = new_buffer;
 		max_size = new_size;
-		free_ranges.push_back({max_size, new_size - max_size});
+		remove(old_size, new_size - old_size);
 
 		fit = find_first_fit();
 		if (fit == free_ranges.end())
@@ -171,7 +173,7 @@ GlobalBufferCache::MeshGlobalOffsets GlobalBufferCache::getMeshOffsets(size_t me
 	return mesh_offsets.at(mesh_id);
 }
 
-uint64_t GlobalBufferCache::addMeshletLodGroupData(LODGroup *data, uint32_t count, RHICommandList *cmd_list)
+uint64_t GlobalBufferCache::addMeshletLodGroupData(const LODGroup *data, uint32_t count, RHICommandList *cmd_list)
 {
 	if (!lod_groups.isInitialized())
 		lod_groups.init(3'000'000 * sizeof(LODGroup), BufferUsage::SHADER_READ_BUFFER, "LOD Groups");
@@ -179,7 +181,7 @@ uint64_t GlobalBufferCache::addMeshletLodGroupData(LODGroup *data, uint32_t coun
 	return byte_offset == UINT64_MAX ? UINT64_MAX : byte_offset / sizeof(LODGroup);
 }
 
-uint64_t GlobalBufferCache::addLodNodeData(LodNode *data, uint32_t count, RHICommandList *cmd_list)
+uint64_t GlobalBufferCache::addLodNodeData(const LodNode *data, uint32_t count, RHICommandList *cmd_list)
 {
 	if (!lod_nodes.isInitialized())
 		lod_nodes.init(3'000'000 * sizeof(LodNode), BufferUsage::SHADER_READ_BUFFER, "LOD Nodes");
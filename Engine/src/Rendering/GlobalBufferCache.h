@@ -13,8 +13,8 @@ public:
 
 	static void shutdown();
 
-	static uint64_t addMeshletLodGroupData(LODGroup *data, uint32_t count, RHICommandList *cmd_list);
-	static uint64_t addLodNodeData(LodNode *data, uint32_t count, RHICommandList *cmd_list);
+	static uint64_t addMeshletLodGroupData(const LODGroup *data, uint32_t count, RHICommandList *cmd_list);
+	static uint64_t addLodNodeData(const LodNode *data, uint32_t count, RHICommandList *cmd_list);
 
 	static void registerMeshOffsets(size_t mesh_id, uint64_t lod_groups_offset, uint64_t lod_nodes_offset);
 	static MeshGlobalOffsets getMeshOffsets(size_t mesh_id);
@@ -0,0 +1,169 @@
+#include "pch.h"
+#include "LightClusters.h"
+
+#if defined(_M_X64) || defined(_M_AMD64) || defined(__SSE2__)
+	#include <xmmintrin.h>
+	#define LIGHT_CLUSTERS_SSE 1
+#else
+	#define LIGHT_CLUSTERS_SSE 0
+#endif
+
+void LightClusters::build(const glm::mat4 &view, const glm::mat4 &projection, float z_near, float z_far, eastl::span<const Light> lights)
+{
+	PROFILE_CPU_FUNCTION();
+
+	glm::vec4 key(projection[0][0], projection[1][1], z_near, z_far);
+	if (key != bounds_key || slice_bounds.empty())
+	{
+		bounds_key = key;
+		rebuild_bounds(projection, z_near, z_far);
+	}
+
+	pairs.clear();
+	for (uint32_t i = 0; i < lights.size(); i++)
+	{
+		glm::vec4 view_position = view * glm::vec4(lights[i].position, 1.0f);
+		glm::vec3 center = glm::vec3(view_position.x, view_position.y, -view_position.z);
+		float radius = lights[i].radius;
+
+		if (center.z + radius < z_near || center.z - radius > z_far)
+			continue;
+
+		uint32_t first_slice = getSlice(glm::max(center.z - radius, z_near));
+		uint32_t last_slice = getSlice(glm::min(center.z + radius, z_far));
+		for (uint32_t slice = first_slice; slice <= last_slice; slice++)
+		{
+			if (use_reference_binning)
+				bin_slice_reference(slice, center, radius, i);
+			else
+				bin_slice(slice, center, radius, i);
+		}
+	}
+
+	// Counting sort by cluster, lights stay in submission order inside every cluster
+	ranges.assign(CLUSTERS_COUNT, Range{0, 0});
+	for (const Pair &pair : pairs)
+		ranges[pair.cluster].count++;
+
+	uint32_t offset = 0;
+	for (Range &range : ranges)
+	{
+		range.offset = offset;
+		offset += range.count;
+		range.count = 0;
+	}
+
+	light_indices.resize(pairs.size());
+	for (const Pair &pair : pairs)
+	{
+		Range &range = ranges[pair.cluster];
+		light_indices[range.offset + range.count++] = pair.light;
+	}
+}
+
+uint32_t LightClusters::getSlice(float view_depth) const
+{
+	float slice = floorf(logf(glm::max(view_depth, z_near)) * slice_scale + slice_bias);
+	return (uint32_t)glm::clamp(slice, 0.0f, float(GRID_Z - 1));
+}
+
+void LightClusters::rebuild_bounds(const glm::mat4 &projection, float z_near, float z_far)
+{
+	this->z_near = z_near;
+	this->z_far = z_far;
+
+	float depth_log_range = logf(z_far / z_near);
+	slice_scale = GRID_Z / depth_log_range;
+	slice_bias = -GRID_Z * logf(z_near) / depth_log_range;
+
+	// View space extents grow linearly with depth, so the box of a froxel comes from its 4 corner NDC values at both depths
+	auto extents = [](float ndc_a, float ndc_b, float depth_near, float depth_far, float scale, float &out_min, float &out_max)
+	{
+		float values[4] = {ndc_a * depth_near, ndc_a * depth_far, ndc_b * depth_near, ndc_b * depth_far};
+		out_min = FLT_MAX;
+		out_max = -FLT_MAX;
+		for (float value : values)
+		{
+			out_min = glm::min(out_min, value / scale);
+			out_max = glm::max(out_max, value / scale);
+		}
+	};
+
+	slice_bounds.resize(GRID_Z);
+	for (uint32_t z = 0; z < GRID_Z; z++)
+	{
+		SliceBounds &bounds = slice_bounds[z];
+		float depth_near = z_near * powf(z_far / z_near, float(z) / GRID_Z);
+		float depth_far = z_near * powf(z_far / z_near, float(z + 1) / GRID_Z);
+
+		for (uint32_t y = 0; y < GRID_Y; y++)
+		{
+			// Tile rows go top to bottom as uv does
+			float ndc_y0 = 1.0f - 2.0f * y / GRID_Y;
+			float ndc_y1 = 1.0f - 2.0f * (y + 1) / GRID_Y;
+
+			for (uint32_t x = 0; x < GRID_X; x++)
+			{
+				float ndc_x0 = -1.0f + 2.0f * x / GRID_X;
+				float ndc_x1 = -1.0f + 2.0f * (x + 1) / GRID_X;
+
+				uint32_t tile = y * GRID_X + x;
+				extents(ndc_x0, ndc_x1, depth_near, depth_far, projection[0][0], bounds.min_x[tile], bounds.max_x[tile]);
+				extents(ndc_y0, ndc_y1, depth_near, depth_far, projection[1][1], bounds.min_y[tile], bounds.max_y[tile]);
+				bounds.min_z[tile] = depth_near;
+				bounds.max_z[tile] = depth_far;
+			}
+		}
+	}
+}
+
+void LightClusters::bin_slice(uint32_t slice, const glm::vec3 &center, float radius, uint32_t light_index)
+{
+#if LIGHT_CLUSTERS_SSE
+	static_assert(TILES_PER_SLICE % 4 == 0, "Slice is processed by 4 tiles");
+
+	const SliceBounds &bounds = slice_bounds[slice];
+	uint32_t base_cluster = slice * TILES_PER_SLICE;
+
+	const __m128 cx = _mm_set1_ps(center.x);
+	const __m128 cy = _mm_set1_ps(center.y);
+	const __m128 cz = _mm_set1_ps(center.z);
+	const __m128 radius_sqr = _mm_set1_ps(radius * radius);
+	const __m128 zero = _mm_setzero_ps();
+
+	for (uint32_t tile = 0; tile < TILES_PER_SLICE; tile += 4)
+	{
+		// Distance from sphere center to the box, per axis only one of (min - c), (c - max) can be positive
+		__m128 dx = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_load_ps(bounds.min_x + tile), cx), _mm_sub_ps(cx, _mm_load_ps(bounds.max_x + tile))), zero);
+		__m128 dy = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_load_ps(bounds.min_y + tile), cy), _mm_sub_ps(cy, _mm_load_ps(bounds.max_y + tile))), zero);
+		__m128 dz = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_load_ps(bounds.min_z + tile), cz), _mm_sub_ps(cz, _mm_load_ps(bounds.max_z + tile))), zero);
+		__m128 distance_sqr = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+
+		int mask = _mm_movemask_ps(_mm_cmple_ps(distance_sqr, radius_sqr));
+		if (mask == 0)
+			continue;
+		for (uint32_t lane = 0; lane < 4; lane++)
+		{
+			if (mask & (1 << lane))
+				pairs.push_back({base_cluster + tile + lane, light_index});
+		}
+	}
+#else
+	bin_slice_reference(slice, center, radius, light_index);
+#endif
+}
+
+void LightClusters::bin_slice_reference(uint32_t slice, const glm::vec3 &center, float radius, uint32_t light_index)
+{
+	const SliceBounds &bounds = slice_bounds[slice];
+	uint32_t base_cluster = slice * TILES_PER_SLICE;
+
+	for (uint32_t tile = 0; tile < TILES_PER_SLICE; tile++)
+	{
+		glm::vec3 box_min(bounds.min_x[tile], bounds.min_y[tile], bounds.min_z[tile]);
+		glm::vec3 box_max(bounds.max_x[tile], bounds.max_y[tile], bounds.max_z[tile]);
+		glm::vec3 delta = glm::max(glm::max(box_min - center, center - box_max), glm::vec3(0.0f));
+		if (glm::dot(delta, delta) <= radius * radius)
+			pairs.push_back({base_cluster + tile, light_index});
+	}
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include <EASTL/span.h>
+#include <EASTL/vector.h>
+#include <glm/glm.hpp>
+
+// View space froxel grid, depth is sliced exponentially between z_near and z_far.
+// Binning depends only on math types, so it can run without a device.
+class LightClusters
+{
+public:
+	static constexpr uint32_t GRID_X = 16;
+	static constexpr uint32_t GRID_Y = 9;
+	static constexpr uint32_t GRID_Z = 24;
+	static constexpr uint32_t CLUSTERS_COUNT = GRID_X * GRID_Y * GRID_Z;
+	static constexpr uint32_t TILES_PER_SLICE = GRID_X * GRID_Y;
+
+	struct Light
+	{
+		glm::vec3 position; // world space
+		float radius;
+	};
+
+	struct Range
+	{
+		uint32_t offset;
+		uint32_t count;
+	};
+
+	// Scalar binning instead of the SSE one, lists must come out the same. Microbenchmarks compare the two
+	bool use_reference_binning = false;
+
+	// projection is expected to be symmetric perspective (jitter is ignored)
+	void build(const glm::mat4 &view, const glm::mat4 &projection, float z_near, float z_far, eastl::span<const Light> lights);
+
+	const eastl::vector<Range> &getRanges() const { return ranges; }
+	const eastl::vector<uint32_t> &getLightIndices() const { return light_indices; }
+
+	// Shader computes slice as log(depth) * scale + bias
+	float getSliceScale() const { return slice_scale; }
+	float getSliceBias() const { return slice_bias; }
+
+	uint32_t getSlice(float view_depth) const;
+	static uint32_t getClusterIndex(uint32_t x, uint32_t y, uint32_t z) { return (z * GRID_Y + y) * GRID_X + x; }
+
+private:
+	void rebuild_bounds(const glm::mat4 &projection, float z_near, float z_far);
+	// Adds (cluster, light) pair for every cluster of the slice that overlaps the sphere
+	void bin_slice(uint32_t slice, const glm::vec3 &center, float radius, uint32_t light_index);
+	void bin_slice_reference(uint32_t slice, const glm::vec3 &center, float radius, uint32_t light_index);
+
+	// Cluster AABBs in view space (depth is positive), SoA so 4 clusters are tested at once
+	struct SliceBounds
+	{
+		alignas(16) float min_x[TILES_PER_SLICE];
+		alignas(16) float min_y[TILES_PER_SLICE];
+		alignas(16) float min_z[TILES_PER_SLICE];
+		alignas(16) float max_x[TILES_PER_SLICE];
+		alignas(16) float max_y[TILES_PER_SLICE];
+		alignas(16) float max_z[TILES_PER_SLICE];
+	};
+	eastl::vector<SliceBounds> slice_bounds;
+
+	glm::vec4 bounds_key = glm::vec4(0.0f);
+	float slice_scale = 0.0f;
+	float slice_bias = 0.0f;
+	float z_near = 0.0f;
+	float z_far = 0.0f;
+
+	struct Pair
+	{
+		uint32_t cluster;
+		uint32_t light;
+	};
+	eastl::vector<Pair> pairs;
+	eastl::vector<Range> ranges;
+	eastl::vector<uint32_t> light_indices;
+};
@@ -0,0 +1,143 @@
+#include "pch.h"
+#include "LightTiles.h"
+
+LightTiles::Projection LightTiles::getProjection(const glm::mat4 &projection, glm::vec2 resolution)
+{
+	// Perspective with w = -view z, jitter is in the third column and goes to the slope offsets
+	Projection result;
+	result.slopes = glm::vec4(1.0f / projection[0][0], projection[2][0] / projection[0][0],
+							  1.0f / projection[1][1], projection[2][1] / projection[1][1]);
+
+	// Depth and w of the inverse only depend on hardware depth, not on ndc x and y
+	glm::mat4 inverse_projection = glm::inverse(projection);
+	result.depth = glm::vec4(inverse_projection[2][2], inverse_projection[3][2], inverse_projection[2][3], inverse_projection[3][3]);
+	result.resolution = resolution;
+	return result;
+}
+
+glm::vec4 LightTiles::getViewSphere(const glm::mat4 &view, const glm::vec3 &position, float radius)
+{
+	glm::vec4 view_position = view * glm::vec4(position, 1.0f);
+	return glm::vec4(view_position.x, view_position.y, -view_position.z, radius);
+}
+
+float LightTiles::getLinearDepth(const Projection &projection, float hardware_depth)
+{
+	return -(hardware_depth * projection.depth.x + projection.depth.y) / (hardware_depth * projection.depth.z + projection.depth.w);
+}
+
+bool LightTiles::isSphereInTile(const Projection &projection, glm::uvec2 tile, float near_depth, float far_depth, const glm::vec4 &sphere)
+{
+	// Same operations in the same order as tiled_lighting.hlsl
+	float x0 = float(tile.x * TILE_SIZE);
+	float x1 = glm::min(float((tile.x + 1) * TILE_SIZE), projection.resolution.x);
+	float y0 = float(tile.y * TILE_SIZE);
+	float y1 = glm::min(float((tile.y + 1) * TILE_SIZE), projection.resolution.y);
+
+	// Tile rows go top to bottom, ndc y goes bottom to top
+	float left = (x0 / projection.resolution.x * 2.0f - 1.0f) * projection.slopes.x + projection.slopes.y;
+	float right = (x1 / projection.resolution.x * 2.0f - 1.0f) * projection.slopes.x + projection.slopes.y;
+	float top = (1.0f - y0 / projection.resolution.y * 2.0f) * projection.slopes.z + projection.slopes.w;
+	float bottom = (1.0f - y1 / projection.resolution.y * 2.0f) * projection.slopes.z + projection.slopes.w;
+
+	glm::vec3 center = glm::vec3(sphere);
+	float radius = sphere.w;
+
+	// Side planes go through the camera, distance to a plane is (dot(plane normal, center)) / length(plane normal)
+	if (center.x - left * center.z < -radius * sqrtf(1.0f + left * left))
+		return false;
+	if (right * center.z - center.x < -radius * sqrtf(1.0f + right * right))
+		return false;
+	if (center.y - bottom * center.z < -radius * sqrtf(1.0f + bottom * bottom))
+		return false;
+	if (top * center.z - center.y < -radius * sqrtf(1.0f + top * top))
+		return false;
+
+	// Planes pass spheres near the frustum corners, the box of the frustum part between depths doesn't
+	glm::vec3 box_min = glm::vec3(glm::min(left * near_depth, left * far_depth), glm::min(bottom * near_depth, bottom * far_depth), near_depth);
+	glm::vec3 box_max = glm::vec3(glm::max(right * near_depth, right * far_depth), glm::max(top * near_depth, top * far_depth), far_depth);
+	glm::vec3 delta = glm::max(glm::max(box_min - center, center - box_max), glm::vec3(0.0f));
+	return glm::dot(delta, delta) <= radius * radius;
+}
+
+bool LightTiles::getTileDepthRange(const Projection &projection, const float *depth, glm::uvec2 tile, float &near_depth, float &far_depth)
+{
+	glm::uvec2 resolution = glm::uvec2(projection.resolution);
+
+	// Reverse-z: the largest hardware depth is the nearest
+	float min_hardware_depth = FLT_MAX;
+	float max_hardware_depth = 0.0f;
+	uint32_t end_x = glm::min((tile.x + 1) * TILE_SIZE, resolution.x);
+	uint32_t end_y = glm::min((tile.y + 1) * TILE_SIZE, resolution.y);
+	for (uint32_t y = tile.y * TILE_SIZE; y < end_y; y++)
+	{
+		for (uint32_t x = tile.x * TILE_SIZE; x < end_x; x++)
+		{
+			float value = depth[y * resolution.x + x];
+			if (value <= 0.0f)
+				continue;
+			min_hardware_depth = glm::min(min_hardware_depth, value);
+			max_hardware_depth = glm::max(max_hardware_depth, value);
+		}
+	}
+	if (max_hardware_depth == 0.0f)
+		return false;
+
+	near_depth = getLinearDepth(projection, max_hardware_depth);
+	far_depth = getLinearDepth(projection, min_hardware_depth);
+	return true;
+}
+
+void LightTiles::binReference(const Projection &projection, const float *depth, eastl::span<const glm::vec4> spheres, eastl::vector<uint32_t> &tile_lights)
+{
+	PROFILE_CPU_FUNCTION();
+
+	glm::uvec2 resolution = glm::uvec2(projection.resolution);
+	glm::uvec2 tiles = getTilesCount(resolution);
+	tile_lights.assign(tiles.x * tiles.y * TILE_STRIDE, 0);
+
+	for (uint32_t tile_y = 0; tile_y < tiles.y; tile_y++)
+	{
+		for (uint32_t tile_x = 0; tile_x < tiles.x; tile_x++)
+		{
+			float near_depth, far_depth;
+			if (!getTileDepthRange(projection, depth, glm::uvec2(tile_x, tile_y), near_depth, far_depth))
+				continue;
+
+			uint32_t *output = &tile_lights[(tile_y * tiles.x + tile_x) * TILE_STRIDE];
+			for (uint32_t i = 0; i < spheres.size(); i++)
+			{
+				if (!isSphereInTile(projection, glm::uvec2(tile_x, tile_y), near_depth, far_depth, spheres[i]))
+					continue;
+				if (output[0] < MAX_LIGHTS_PER_TILE)
+					output[1 + output[0]] = i;
+				output[0]++;
+			}
+		}
+	}
+}
+
+void LightTiles::makeRandomSpheres(uint64_t seed, uint32_t count, const Projection &projection, float z_near, float max_depth, eastl::vector<glm::vec4> &spheres)
+{
+	uint64_t state = seed ? seed : 1;
+	auto random_unit = [&state]()
+	{
+		state ^= state << 13;
+		state ^= state >> 7;
+		state ^= state << 17;
+		return uint32_t(state >> 40) * (1.0f / 16777216.0f);
+	};
+
+	spheres.resize(count);
+	for (glm::vec4 &sphere : spheres)
+	{
+		// More lights near the camera, some outside of the screen
+		float u = random_unit();
+		float depth = z_near + u * u * (max_depth - z_near);
+		float ndc_x = random_unit() * 2.4f - 1.2f;
+		float ndc_y = random_unit() * 2.4f - 1.2f;
+		float r = random_unit();
+		float radius = 0.05f + r * r * r * 20.0f;
+		sphere = glm::vec4((ndc_x * projection.slopes.x + projection.slopes.y) * depth, (ndc_y * projection.slopes.z + projection.slopes.w) * depth, depth, radius);
+	}
+}
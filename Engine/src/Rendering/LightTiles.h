@@ -0,0 +1,42 @@
+#pragma once
+#include <EASTL/span.h>
+#include <EASTL/vector.h>
+#include <glm/glm.hpp>
+
+// Screen tiles for compute tiled lighting (shaders/lighting/tiled_lighting.hlsl). Every tile keeps the point lights whose
+// sphere touches the tile frustum between the nearest and the farthest depth of its pixels, tiles of sky keep nothing.
+// This is the CPU version of the shader binning, it only depends on math types so it can run without a device.
+class LightTiles
+{
+public:
+	static constexpr uint32_t TILE_SIZE = 16;
+	static constexpr uint32_t MAX_LIGHTS_PER_TILE = 255;
+	// Per tile: count of lights that passed (can be more than MAX_LIGHTS_PER_TILE), then light indices in increasing order.
+	// Tiles with more lights keep the MAX_LIGHTS_PER_TILE lowest indices
+	static constexpr uint32_t TILE_STRIDE = MAX_LIGHTS_PER_TILE + 1;
+
+	// Values of the projection matrix that the culling needs, shader gets the same values in constants
+	struct Projection
+	{
+		glm::vec4 slopes; // view x / depth = ndc x * slopes.x + slopes.y, view y / depth = ndc y * slopes.z + slopes.w
+		glm::vec4 depth; // depth = -(hw * depth.x + depth.y) / (hw * depth.z + depth.w)
+		glm::vec2 resolution;
+	};
+
+	// Jittered projection is fine, jitter moves the tile frustums with the pixels
+	static Projection getProjection(const glm::mat4 &projection, glm::vec2 resolution);
+	static glm::uvec2 getTilesCount(glm::uvec2 resolution) { return (resolution + glm::uvec2(TILE_SIZE - 1)) / TILE_SIZE; }
+
+	// Light as culling sees it: view space x, y, positive depth and radius
+	static glm::vec4 getViewSphere(const glm::mat4 &view, const glm::vec3 &position, float radius);
+	static float getLinearDepth(const Projection &projection, float hardware_depth);
+	static bool isSphereInTile(const Projection &projection, glm::uvec2 tile, float near_depth, float far_depth, const glm::vec4 &sphere);
+	// Linear depths of the nearest and the farthest pixel, false for tiles of sky
+	static bool getTileDepthRange(const Projection &projection, const float *depth, glm::uvec2 tile, float &near_depth, float &far_depth);
+
+	// depth is reverse-z hardware depth of resolution pixels, 0 is sky. Output has TILE_STRIDE values per tile
+	static void binReference(const Projection &projection, const float *depth, eastl::span<const glm::vec4> spheres, eastl::vector<uint32_t> &tile_lights);
+
+	// Spheres spread over the view frustum up to max_depth, sizes from small to covering many tiles
+	static void makeRandomSpheres(uint64_t seed, uint32_t count, const Projection &projection, float z_near, float max_depth, eastl::vector<glm::vec4> &spheres);
+};
@@ -1,5 +1,27 @@
 #include "pch.h"
 #include "Rendering/Material.h"
 #include "RHI/BindlessResources.h"
+#include "Rendering/TextureStreaming.h"
 
 static const AssetTypeInfo *registered_material_type = AssetManager::registerSerializedType<Material>(".material");
+
+void Material::update(TextureStreaming &texture_streaming)
+{
+	auto update_texture = [&texture_streaming](MaterialTexture &material_texture, Format format, TextureCompression compression)
+	{
+		if (material_texture.resolved_handle != material_texture.asset.guid)
+		{
+			material_texture.bindless_id = 0;
+			material_texture.resolved_handle = material_texture.asset.guid;
+		}
+
+		if (material_texture.bindless_id == 0 && material_texture.asset.isValid())
+			material_texture.bindless_id = texture_streaming.requestTexture(material_texture.asset, format, compression);
+	};
+
+	update_texture(albedo_tex, FORMAT_R8G8B8A8_SRGB, TEXTURE_COMPRESSION_COLOR);
+	update_texture(metalness_tex, FORMAT_R8G8B8A8_UNORM, TEXTURE_COMPRESSION_MASK);
+	update_texture(roughness_tex, FORMAT_R8G8B8A8_UNORM, TEXTURE_COMPRESSION_MASK);
+	update_texture(specular_tex, FORMAT_R8G8B8A8_UNORM, TEXTURE_COMPRESSION_MASK);
+	update_texture(normal_tex, FORMAT_R8G8B8A8_UNORM, TEXTURE_COMPRESSION_NORMAL);
+}
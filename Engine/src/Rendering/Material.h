@@ -4,6 +4,8 @@
 #include "Core/Reflection.h"
 #include "Assets/AssetManager.h"
 
+class TextureStreaming;
+
 struct LightingOnlyMaterial
 {
 	static constexpr float albedo = 0.3f;
@@ -40,34 +42,8 @@ public:
 
 	MaterialTexture normal_tex;
 
-	void update()
-	{
-		auto update_texture = [](MaterialTexture &material_texture, Format format)
-		{
-			if (material_texture.resolved_handle != material_texture.asset.guid)
-			{
-				material_texture.bindless_id = 0;
-				material_texture.resolved_handle = material_texture.asset.guid;
-			}
-
-			if (material_texture.bindless_id == 0 && material_texture.asset.isValid())
-			{
-				TextureDescription desc{};
-				desc.format = format;
-				desc.usage_flags = TEXTURE_USAGE_TRANSFER_SRC;
-				auto tex = AssetManager::getTextureAsset(material_texture.asset, desc);
-				if (!tex || !tex->isValid())
-					return;
-				material_texture.bindless_id = tex->getShaderResourceView()->getBindlessIndex();
-			}
-		};
-
-		update_texture(albedo_tex, FORMAT_R8G8B8A8_SRGB);
-		update_texture(metalness_tex, FORMAT_R8G8B8A8_UNORM);
-		update_texture(roughness_tex, FORMAT_R8G8B8A8_UNORM);
-		update_texture(specular_tex, FORMAT_R8G8B8A8_UNORM);
-		update_texture(normal_tex, FORMAT_R8G8B8A8_UNORM);
-	}
+	// Resolves bindless ids of textures that changed or were invalidated
+	void update(TextureStreaming &texture_streaming);
 
 	bool usesTexture(Engine::GUID guid) const
 	{
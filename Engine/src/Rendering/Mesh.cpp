@@ -2,7 +2,9 @@
 #include "Mesh.h"
 #include "Core/Variables.h"
 #include "RHI/DynamicRHI.h"
+#include "RHI/RHIUploadBatch.h"
 #include "GlobalBufferCache.h"
+#include "RayTracingProxy.h"
 
 namespace Engine
 {
@@ -11,7 +13,11 @@ namespace Engine
 		indexed.emplace();
 		indexed->vertices = std::move(vertices);
 		indexed->indices = std::move(indices);
-		uploadTraditionalBuffers();
+
+		BufferUsage extra = BufferUsage::SHADER_READ_BUFFER;
+		if (engine_ray_tracing)
+			extra |= BufferUsage::ACCELERATION_STRUCTURE_BUILD_INPUT_BUFFER;
+		uploadIndexedBuffers(*indexed, extra, "Vertex Buffer", "Index Buffer");
 	}
 
 	void Mesh::initMeshleted()
@@ -19,31 +25,43 @@ namespace Engine
 		uploadMeshletMetadata();
 	}
 
-	void Mesh::uploadTraditionalBuffers()
+	void Mesh::initRayTracingProxy(const MeshletFileView &file_view, uint32_t max_triangles)
 	{
-		BufferUsage extra = BufferUsage::SHADER_READ_BUFFER;
-		if (engine_ray_tracing)
-			extra |= BufferUsage::ACCELERATION_STRUCTURE_BUILD_INPUT_BUFFER;
+		ray_tracing_proxy.emplace();
+		RayTracingProxy::Info info = RayTracingProxy::build(*meshlet_data, file_view, attribute_flags, max_triangles, *ray_tracing_proxy);
+		if (ray_tracing_proxy->indices.empty())
+		{
+			ray_tracing_proxy.reset();
+			return;
+		}
 
+		// Hits read vertex attributes through bindless views, like traditional meshes
+		uploadIndexedBuffers(*ray_tracing_proxy, BufferUsage::SHADER_READ_BUFFER | BufferUsage::ACCELERATION_STRUCTURE_BUILD_INPUT_BUFFER,
+							 "Ray Tracing Proxy Vertex Buffer", "Ray Tracing Proxy Index Buffer");
+		CORE_TRACE("Ray tracing proxy of mesh {}: {} triangles, error {}", id, info.triangles_count, info.error_threshold);
+	}
+
+	void Mesh::uploadIndexedBuffers(IndexedGeometry &geometry, BufferUsage extra_usage, const char *vertex_buffer_name, const char *index_buffer_name)
+	{
 		BufferDescription vd;
-		vd.size = sizeof(indexed->vertices[0]) * indexed->vertices.size();
+		vd.size = sizeof(geometry.vertices[0]) * geometry.vertices.size();
 		vd.use_staging_buffer = true;
-		vd.usage = BufferUsage::VERTEX_BUFFER | extra;
+		vd.usage = BufferUsage::VERTEX_BUFFER | extra_usage;
 		vd.storage_stride = sizeof(uint32_t);
 		vd.alignment = 16;
-		indexed->vertex_buffer = gDynamicRHI->createBuffer(vd);
-		indexed->vertex_buffer->fill(indexed->vertices.data());
-		indexed->vertex_buffer->setDebugName("Vertex Buffer");
+		geometry.vertex_buffer = gDynamicRHI->createBuffer(vd);
+		RHIUploadBatch::enqueueBuffer(geometry.vertex_buffer, geometry.vertices.data(), vd.size);
+		geometry.vertex_buffer->setDebugName(vertex_buffer_name);
 
 		BufferDescription id;
-		id.size = sizeof(indexed->indices[0]) * indexed->indices.size();
+		id.size = sizeof(geometry.indices[0]) * geometry.indices.size();
 		id.use_staging_buffer = true;
-		id.usage = BufferUsage::INDEX_BUFFER | extra;
+		id.usage = BufferUsage::INDEX_BUFFER | extra_usage;
 		id.alignment = 0;
 		id.storage_stride = sizeof(uint32_t);
-		indexed->index_buffer = gDynamicRHI->createBuffer(id);
-		indexed->index_buffer->fill(indexed->indices.data());
-		indexed->index_buffer->setDebugName("Index Buffer");
+		geometry.index_buffer = gDynamicRHI->createBuffer(id);
+		RHIUploadBatch::enqueueBuffer(geometry.index_buffer, geometry.indices.data(), id.size);
+		geometry.index_buffer->setDebugName(index_buffer_name);
 	}
 
 	void Mesh::uploadMeshletMetadata()
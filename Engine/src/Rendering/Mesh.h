@@ -1,8 +1,10 @@
 #pragma once
+#include <EASTL/span.h>
 #include "RHI/RHIBuffer.h"
 #include "Math/BoundBox.h"
 #include "RHI/RHIPipeline.h"
 #include "ShaderStructs.h"
+#include "Assets/MeshFormat.h"
 
 namespace Engine
 {
@@ -52,12 +54,16 @@ struct MeshletGeometry
 		uint32_t cpu_triangle_count;
 	};
 
-	eastl::vector<Meshlet> meshlets;
-	eastl::vector<LODGroup> meshlet_lod_groups;
-	eastl::vector<LodNode> lod_nodes;
-	eastl::vector<LODLevel> meshlet_lod_levels;
+	// Views into the mapped .mesh file (same lifetime as MeshletFileView), nothing is copied on load.
+	// Meshlets stay in disk format and are decoded on demand with getMeshlet.
+	eastl::span<const MeshFormat::DiskMeshlet> meshlets;
+	eastl::span<const LODGroup> meshlet_lod_groups;
+	eastl::span<const LodNode> lod_nodes;
+	eastl::span<const LODLevel> meshlet_lod_levels;
 	eastl::vector<LODGroupDataInfo> meshlet_lod_group_data_info;
 	uint32_t meshlet_root_group_local_offset = 0;
+
+	Meshlet getMeshlet(uint32_t index) const { return MeshFormat::decodeMeshlet(meshlets[index]); }
 };
 
 class Mesh: public RefCounted
@@ -71,14 +77,19 @@ public:
 
 	eastl::optional<IndexedGeometry> indexed;
 	eastl::optional<MeshletGeometry> meshlet_data;
+	// Coarse LOD cut of a meshlet mesh (see RayTracingProxy), resident whatever groups are streamed
+	eastl::optional<IndexedGeometry> ray_tracing_proxy;
 
 	bool useMeshlets() const { return meshlet_data.has_value(); }
+	// Geometry of the BLAS and of ray hits, nullptr if the mesh can't be ray traced
+	const IndexedGeometry *getRayTracingGeometry() const { return indexed ? &*indexed : ray_tracing_proxy ? &*ray_tracing_proxy : nullptr; }
 
 	void initTraditional(eastl::vector<Vertex> vertices, eastl::vector<uint32_t> indices);
 	void initMeshleted();
+	void initRayTracingProxy(const MeshletFileView &file_view, uint32_t max_triangles);
 
 private:
-	void uploadTraditionalBuffers();
+	static void uploadIndexedBuffers(IndexedGeometry &geometry, BufferUsage extra_usage, const char *vertex_buffer_name, const char *index_buffer_name);
 	void uploadMeshletMetadata();
 };
 }
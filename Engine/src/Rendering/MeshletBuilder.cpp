@@ -40,8 +40,8 @@ MeshletBuildData build(Engine::Mesh *mesh, const char *debug_name, const eastl::
 	input_mesh.attribute_count = _countof(attr_weights);
 	input_mesh.attribute_protect_mask = 1 << 7 | 1 << 8;
 
+	// Metadata goes to the build data, meshlet_data only marks the mesh and views the .mesh file once loaded
 	mesh->meshlet_data.emplace();
-	Engine::MeshletGeometry &geometry = *mesh->meshlet_data;
 	MeshletBuildData build_data;
 	const uint32_t attribute_flags = mesh->attribute_flags;
 	const uint32_t disk_stride = MeshFormat::diskVertexStride(attribute_flags);
@@ -52,26 +52,22 @@ MeshletBuildData build(Engine::Mesh *mesh, const char *debug_name, const eastl::
 		size_t estimated_triangle_count = base_triangle_count * 2; // about 2x of triangles in DAG
 		size_t estimated_meshlet_count = Math::divideRoundUp(estimated_triangle_count, settings.meshlet_max_triangles) + 64;
 		size_t estimated_vertex_count = estimated_meshlet_count * settings.meshlet_max_vertices;
-		geometry.meshlets.reserve(estimated_meshlet_count);
-		geometry.meshlet_lod_groups.reserve(estimated_meshlet_count / 4 + 16);
-		geometry.meshlet_lod_group_data_info.reserve(estimated_meshlet_count / 4 + 16);
+		build_data.meshlets.reserve(estimated_meshlet_count);
+		build_data.lod_groups.reserve(estimated_meshlet_count / 4 + 16);
 		build_data.vertices.reserve(estimated_vertex_count * disk_stride);
 		build_data.triangles.reserve(estimated_triangle_count * 3);
 	}
 
-	uint32_t total_vertex_count = 0;
-	uint32_t total_triangle_index_count = 0;
-
 	eastl::vector<uint32_t> local_vertex_indices(settings.meshlet_max_vertices);
 	eastl::vector<uint8_t> local_triangle_indices(settings.meshlet_max_triangles * 3);
 
 	clodBuild(config, input_mesh,
 		[&](const clodGroup &group, const clodCluster *clusters, size_t cluster_count)
 	{
-		uint32_t group_id = geometry.meshlet_lod_groups.size();
-		uint32_t first_meshlet_in_group = geometry.meshlets.size();
+		uint32_t group_id = build_data.lod_groups.size();
+		uint32_t first_meshlet_in_group = build_data.meshlets.size();
 
-		LODGroup &lod_group = geometry.meshlet_lod_groups.emplace_back();
+		LODGroup &lod_group = build_data.lod_groups.emplace_back();
 		lod_group.center = glm::vec3(group.simplified.center[0], group.simplified.center[1], group.simplified.center[2]);
 		lod_group.radius = group.simplified.radius;
 		lod_group.error = group.simplified.error;
@@ -79,10 +75,6 @@ MeshletBuildData build(Engine::Mesh *mesh, const char *debug_name, const eastl::
 		lod_group.first_meshlet = first_meshlet_in_group;
 		lod_group.meshlet_count = cluster_count;
 
-		Engine::MeshletGeometry::LODGroupDataInfo &group_info = geometry.meshlet_lod_group_data_info.emplace_back();
-		group_info.cpu_vertex_offset = total_vertex_count;
-		group_info.cpu_triangle_offset = total_triangle_index_count;
-
 		uint32_t group_vertex_count = 0;
 		uint32_t group_triangle_index_count = 0;
 
@@ -90,7 +82,7 @@ MeshletBuildData build(Engine::Mesh *mesh, const char *debug_name, const eastl::
 		{
 			const clodCluster *cluster = &clusters[i];
 
-			Meshlet &meshlet = geometry.meshlets.emplace_back();
+			Meshlet &meshlet = build_data.meshlets.emplace_back();
 			meshlet.group_id = group_id;
 			meshlet.refined_group_id = cluster->refined == -1 ? 0xFFFFFFFFu : cluster->refined;
 
@@ -123,36 +115,30 @@ MeshletBuildData build(Engine::Mesh *mesh, const char *debug_name, const eastl::
 			group_triangle_index_count += cluster->index_count;
 		}
 
-		total_vertex_count += group_vertex_count;
-		total_triangle_index_count += group_triangle_index_count;
-
-		group_info.cpu_vertex_count = group_vertex_count;
-		group_info.cpu_triangle_count = group_triangle_index_count;
-
 		// Next level started
-		if (group.depth >= geometry.meshlet_lod_levels.size())
+		if (group.depth >= build_data.lod_levels.size())
 		{
-			LODLevel &level = geometry.meshlet_lod_levels.emplace_back();
+			LODLevel &level = build_data.lod_levels.emplace_back();
 			level.group_offset = group_id;
 		}
-		geometry.meshlet_lod_levels.back().group_count++;
+		build_data.lod_levels.back().group_count++;
 
 		return group_id;
 	});
 
-	const LODLevel &last = geometry.meshlet_lod_levels.back();
+	const LODLevel &last = build_data.lod_levels.back();
 	if (last.group_count != 1)
 		CORE_CRITICAL("MeshletBuilder::build: {} root groups for '{}', expected 1.", last.group_count, debug_name);
 
 	// BVH build
 	static constexpr uint32_t NODE_WIDTH = 8;
-	uint32_t groups_count = geometry.meshlet_lod_groups.size();
+	uint32_t groups_count = build_data.lod_groups.size();
 
-	geometry.lod_nodes.resize(groups_count);
+	build_data.lod_nodes.resize(groups_count);
 	for (uint32_t g = 0; g < groups_count; g++)
 	{
-		const LODGroup &group = geometry.meshlet_lod_groups[g];
-		LodNode &node = geometry.lod_nodes[g];
+		const LODGroup &group = build_data.lod_groups[g];
+		LodNode &node = build_data.lod_nodes[g];
 		node = {};
 		node.center = group.center;
 		node.radius = group.radius;
@@ -171,36 +157,36 @@ MeshletBuildData build(Engine::Mesh *mesh, const char *debug_name, const eastl::
 	while (level_count > 1)
 	{
 		remap.resize(level_count);
-		meshopt_spatialClusterPoints(remap.data(), &geometry.lod_nodes[level_begin].center.x, level_count, sizeof(LodNode), NODE_WIDTH);
+		meshopt_spatialClusterPoints(remap.data(), &build_data.lod_nodes[level_begin].center.x, level_count, sizeof(LodNode), NODE_WIDTH);
 
-		lod_nodes.assign(geometry.lod_nodes.begin() + level_begin, geometry.lod_nodes.begin() + level_begin + level_count);
+		lod_nodes.assign(build_data.lod_nodes.begin() + level_begin, build_data.lod_nodes.begin() + level_begin + level_count);
 		for (uint32_t i = 0; i < level_count; i++)
-			geometry.lod_nodes[level_begin + i] = lod_nodes[remap[i]];
+			build_data.lod_nodes[level_begin + i] = lod_nodes[remap[i]];
 
-		const uint32_t parent_begin = (uint32_t)geometry.lod_nodes.size();
+		const uint32_t parent_begin = (uint32_t)build_data.lod_nodes.size();
 		const uint32_t parent_count = (level_count + NODE_WIDTH - 1) / NODE_WIDTH;
-		geometry.lod_nodes.resize(parent_begin + parent_count);
+		build_data.lod_nodes.resize(parent_begin + parent_count);
 
 		for (uint32_t p = 0; p < parent_count; p++)
 		{
 			uint32_t first_child = level_begin + p * NODE_WIDTH;
 			uint32_t child_count = std::min(first_child + NODE_WIDTH, level_begin + level_count) - first_child;
 
-			LodNode &parent = geometry.lod_nodes[parent_begin + p];
+			LodNode &parent = build_data.lod_nodes[parent_begin + p];
 			parent = {};
 			parent.first_child = first_child;
 			parent.child_count = child_count;
 
 			// Merge bounding spheres
 			meshopt_Bounds merged = meshopt_computeSphereBounds(
-				&geometry.lod_nodes[first_child].center.x, child_count, sizeof(LodNode),
-				&geometry.lod_nodes[first_child].radius, sizeof(LodNode));
+				&build_data.lod_nodes[first_child].center.x, child_count, sizeof(LodNode),
+				&build_data.lod_nodes[first_child].radius, sizeof(LodNode));
 			parent.center = glm::vec3(merged.center[0], merged.center[1], merged.center[2]);
 			parent.radius = merged.radius;
 
 			// Error is conservative
 			for (uint32_t c = 0; c < child_count; c++)
-				parent.error = std::max(parent.error, geometry.lod_nodes[first_child + c].error);
+				parent.error = std::max(parent.error, build_data.lod_nodes[first_child + c].error);
 		}
 
 		level_begin = parent_begin;
@@ -208,7 +194,7 @@ MeshletBuildData build(Engine::Mesh *mesh, const char *debug_name, const eastl::
 	}
 
 	// Root is the single node
-	geometry.meshlet_root_group_local_offset = level_begin;
+	build_data.root_group_local_offset = level_begin;
 	return build_data;
 }
 
@@ -3,11 +3,17 @@
 
 struct ModelImportSettings;
 
+// Owned build output, written into the .mesh file. At runtime MeshletGeometry only views the file.
 struct MeshletBuildData
 {
 	eastl::vector<uint8_t> vertices;
 	uint32_t vertex_count = 0;
 	eastl::vector<uint8_t> triangles;
+	eastl::vector<Meshlet> meshlets;
+	eastl::vector<LODGroup> lod_groups;
+	eastl::vector<LodNode> lod_nodes;
+	eastl::vector<LODLevel> lod_levels;
+	uint32_t root_group_local_offset = 0;
 };
 
 namespace MeshletBuilder
@@ -0,0 +1,387 @@
+#include "pch.h"
+#include "MeshletTraversal.h"
+#include <atomic>
+#include <thread>
+
+#if defined(_M_X64) || defined(_M_AMD64) || defined(__SSE2__)
+	#include <xmmintrin.h>
+	#define MESHLET_TRAVERSAL_SSE 1
+#else
+	#define MESHLET_TRAVERSAL_SSE 0
+#endif
+
+namespace
+{
+constexpr uint32_t MOST_DETAILED_CLUSTER_GROUP_ID = 0xFFFFFFFFu;
+constexpr uint32_t INSTANCES_PER_JOB = 64;
+
+struct FrustumCullData
+{
+	glm::vec3 rect_min;
+	glm::vec3 rect_max;
+	bool is_visible;
+};
+
+void transform_bound_box(glm::vec3 &bound_center, glm::vec3 &bound_extent, const glm::mat4 &world_transform)
+{
+	glm::mat3 rotation_scale = glm::mat3(world_transform);
+	glm::mat3 abs_rotation_scale = glm::mat3(glm::abs(rotation_scale[0]), glm::abs(rotation_scale[1]), glm::abs(rotation_scale[2]));
+
+	bound_center = rotation_scale * bound_center + glm::vec3(world_transform[3]);
+	bound_extent = abs_rotation_scale * bound_extent;
+}
+
+float get_scale_from_transform(const glm::mat4 &transform)
+{
+	return glm::max(glm::max(glm::length(glm::vec3(transform[0])), glm::length(glm::vec3(transform[1]))), glm::length(glm::vec3(transform[2])));
+}
+
+FrustumCullData get_frustum_cull_data_ortho(const glm::vec3 &bound_center, const glm::vec3 &bound_extent, const glm::mat4 &view_projection)
+{
+	FrustumCullData data;
+
+	glm::vec3 center_clip = glm::vec3(view_projection * glm::vec4(bound_center, 1.0f));
+	glm::vec3 clip_delta = glm::abs(bound_extent.x * glm::vec3(view_projection[0]))
+						 + glm::abs(bound_extent.y * glm::vec3(view_projection[1]))
+						 + glm::abs(bound_extent.z * glm::vec3(view_projection[2]));
+
+	data.rect_min = center_clip - clip_delta;
+	data.rect_max = center_clip + clip_delta;
+
+	bool frustum_culled = data.rect_max.x < -1.0f || data.rect_max.y < -1.0f;
+	data.is_visible = data.rect_max.z < 1.0f && !frustum_culled;
+	return data;
+}
+
+FrustumCullData get_frustum_cull_data(const glm::vec3 &bound_center, const glm::vec3 &bound_extent, const glm::mat4 &view_projection)
+{
+	FrustumCullData data;
+	data.rect_min = glm::vec3(1.0f);
+	data.rect_max = glm::vec3(-1.0f);
+	data.is_visible = true;
+
+	glm::vec4 dx = view_projection * glm::vec4(bound_extent.x * 2.0f, 0, 0, 0);
+	glm::vec4 dy = view_projection * glm::vec4(0, bound_extent.y * 2.0f, 0, 0);
+	glm::vec4 dz = view_projection * glm::vec4(0, 0, bound_extent.z * 2.0f, 0);
+
+	float min_w = 1e27f;
+	float max_w = -1e27f;
+	glm::vec4 planes_min = glm::vec4(1.0f);
+
+	auto corner = [&](const glm::vec4 &p)
+	{
+		min_w = glm::min(min_w, p.w);
+		max_w = glm::max(max_w, p.w);
+		planes_min = glm::min(planes_min, glm::vec4(p.x, p.y, -p.x, -p.y) - p.w);
+		glm::vec3 screen_space = glm::vec3(p) / p.w;
+		data.rect_min = glm::min(data.rect_min, screen_space);
+		data.rect_max = glm::max(data.rect_max, screen_space);
+	};
+
+	glm::vec4 p000 = view_projection * glm::vec4(bound_center - bound_extent, 1.0f);
+	glm::vec4 p001 = p000 + dz;
+	glm::vec4 p100 = p000 + dx;
+	glm::vec4 p101 = p001 + dx;
+	glm::vec4 p110 = p100 + dy;
+	glm::vec4 p111 = p101 + dy;
+	glm::vec4 p010 = p110 - dx;
+	glm::vec4 p011 = p111 - dx;
+	for (const glm::vec4 &p : {p000, p001, p100, p101, p110, p111, p010, p011})
+		corner(p);
+
+	// Camera between two corners, conservatively fallback to full rect
+	if (min_w <= 0.0f && max_w > 0.0f)
+	{
+		data.rect_min = glm::vec3(-1.0f);
+		data.rect_max = glm::vec3(1.0f);
+		data.is_visible = true;
+	} else if (max_w <= 0.0f)
+	{
+		data.is_visible = false;
+	}
+
+	bool frustum_culled = planes_min.x > 0.0f || planes_min.y > 0.0f || planes_min.z > 0.0f || planes_min.w > 0.0f;
+	data.is_visible = data.is_visible && !frustum_culled;
+	return data;
+}
+
+bool is_box_visible(const MeshletTraversal::View &view, glm::vec3 bound_center, glm::vec3 bound_extent, const glm::mat4 &world_transform)
+{
+	transform_bound_box(bound_center, bound_extent, world_transform);
+	if (view.is_ortho)
+		return get_frustum_cull_data_ortho(bound_center, bound_extent, view.view_projection).is_visible;
+	return get_frustum_cull_data(bound_center, bound_extent, view.view_projection).is_visible;
+}
+
+// Bounding spheres of up to 4 lod nodes / groups in SoA layout
+struct SphereBatch
+{
+	alignas(16) float center_x[4] = {};
+	alignas(16) float center_y[4] = {};
+	alignas(16) float center_z[4] = {};
+	alignas(16) float radius[4] = {};
+	alignas(16) float error[4] = {};
+	uint32_t count = 0;
+
+	void add(const glm::vec3 &center, float sphere_radius, float sphere_error)
+	{
+		center_x[count] = center.x;
+		center_y[count] = center.y;
+		center_z[count] = center.z;
+		radius[count] = sphere_radius;
+		error[count] = sphere_error;
+		count++;
+	}
+};
+
+// Bit per sphere that is coarser than needed (isCoarserThanNeeded)
+uint32_t coarse_mask(const MeshletTraversal::View &view, const glm::mat4 &world_transform, float scale, const SphereBatch &batch)
+{
+#if MESHLET_TRAVERSAL_SSE
+	const __m128 center_x = _mm_load_ps(batch.center_x);
+	const __m128 center_y = _mm_load_ps(batch.center_y);
+	const __m128 center_z = _mm_load_ps(batch.center_z);
+
+	auto transform_row = [&](int row)
+	{
+		__m128 result = _mm_set1_ps(world_transform[3][row]);
+		result = _mm_add_ps(result, _mm_mul_ps(center_x, _mm_set1_ps(world_transform[0][row])));
+		result = _mm_add_ps(result, _mm_mul_ps(center_y, _mm_set1_ps(world_transform[1][row])));
+		result = _mm_add_ps(result, _mm_mul_ps(center_z, _mm_set1_ps(world_transform[2][row])));
+		return result;
+	};
+
+	__m128 dx = _mm_sub_ps(transform_row(0), _mm_set1_ps(view.camera_position.x));
+	__m128 dy = _mm_sub_ps(transform_row(1), _mm_set1_ps(view.camera_position.y));
+	__m128 dz = _mm_sub_ps(transform_row(2), _mm_set1_ps(view.camera_position.z));
+	__m128 distance = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz)));
+
+	__m128 scale_v = _mm_set1_ps(scale);
+	distance = _mm_sub_ps(distance, _mm_mul_ps(_mm_load_ps(batch.radius), scale_v));
+	distance = _mm_max_ps(distance, _mm_set1_ps(view.z_near));
+
+	__m128 error = _mm_div_ps(_mm_mul_ps(_mm_load_ps(batch.error), scale_v), distance);
+	uint32_t mask = _mm_movemask_ps(_mm_cmpge_ps(error, _mm_set1_ps(view.error_threshold)));
+	return mask & ((1u << batch.count) - 1);
+#else
+	uint32_t mask = 0;
+	for (uint32_t i = 0; i < batch.count; i++)
+	{
+		glm::vec3 center(batch.center_x[i], batch.center_y[i], batch.center_z[i]);
+		if (MeshletTraversal::isCoarserThanNeeded(view, world_transform, scale, center, batch.radius[i], batch.error[i]))
+			mask |= 1u << i;
+	}
+	return mask;
+#endif
+}
+
+struct TraversalItem
+{
+	bool is_group;
+	uint32_t first; // first child node or group index
+	uint32_t count;
+};
+
+struct JobOutput
+{
+	eastl::vector<MeshletTraversal::SelectedMeshlet> meshlets;
+	eastl::vector<MeshletTraversal::StreamRequest> stream_requests;
+	uint32_t visited_nodes = 0;
+	uint32_t visited_groups = 0;
+	uint32_t culled_instances = 0;
+};
+
+bool is_resident(const MeshletTraversal::Instance &instance, uint32_t group_index)
+{
+	return !instance.resident_groups || instance.resident_groups[group_index] != 0;
+}
+
+void process_group(const MeshletTraversal::View &view, const MeshletTraversal::Instance &instance, float scale, uint32_t group_index, JobOutput &output)
+{
+	const Engine::MeshletGeometry &geometry = *instance.geometry;
+	const LODGroup &group = geometry.meshlet_lod_groups[group_index];
+	output.visited_groups++;
+
+	for (uint32_t base = 0; base < group.meshlet_count; base += 4)
+	{
+		// Meshlet is picked when finer group is not needed (or absent / non resident)
+		SphereBatch refined;
+		uint32_t lanes[4];
+		uint32_t lanes_count = eastl::min(4u, group.meshlet_count - base);
+		uint32_t need_this_level = 0;
+		for (uint32_t lane = 0; lane < lanes_count; lane++)
+		{
+			const MeshFormat::DiskMeshlet &meshlet = geometry.meshlets[group.first_meshlet + base + lane];
+			if (meshlet.refined_group_id != MOST_DETAILED_CLUSTER_GROUP_ID && is_resident(instance, meshlet.refined_group_id))
+			{
+				const LODGroup &refined_group = geometry.meshlet_lod_groups[meshlet.refined_group_id];
+				lanes[refined.count] = lane;
+				refined.add(refined_group.center, refined_group.radius, refined_group.error);
+			} else
+			{
+				need_this_level |= 1u << lane;
+			}
+		}
+
+		uint32_t refined_coarse = refined.count > 0 ? coarse_mask(view, instance.world_transform, scale, refined) : 0;
+		for (uint32_t i = 0; i < refined.count; i++)
+		{
+			if ((refined_coarse & (1u << i)) == 0)
+				need_this_level |= 1u << lanes[i];
+		}
+
+		for (uint32_t lane = 0; lane < lanes_count; lane++)
+		{
+			if ((need_this_level & (1u << lane)) == 0)
+				continue;
+
+			Meshlet meshlet = geometry.getMeshlet(group.first_meshlet + base + lane);
+			if (is_box_visible(view, meshlet.center, meshlet.extent, instance.world_transform))
+				output.meshlets.push_back({instance.instance_id, group_index, base + lane});
+		}
+	}
+}
+
+void traverse_instance(const MeshletTraversal::View &view, const MeshletTraversal::Instance &instance, eastl::vector<TraversalItem> &stack, JobOutput &output)
+{
+	const Engine::MeshletGeometry &geometry = *instance.geometry;
+	if (geometry.lod_nodes.empty())
+		return;
+
+	if (!MeshletTraversal::isInstanceVisible(view, instance))
+	{
+		output.culled_instances++;
+		return;
+	}
+
+	float scale = get_scale_from_transform(instance.world_transform);
+
+	const LodNode &root = geometry.lod_nodes[geometry.meshlet_root_group_local_offset];
+	stack.clear();
+	if (root.child_count == 0)
+		stack.push_back({true, root.group_index, root.meshlet_count});
+	else
+		stack.push_back({false, root.first_child, root.child_count});
+
+	while (!stack.empty())
+	{
+		TraversalItem item = stack.back();
+		stack.pop_back();
+
+		if (item.is_group)
+		{
+			process_group(view, instance, scale, item.first, output);
+			continue;
+		}
+
+		for (uint32_t base = 0; base < item.count; base += 4)
+		{
+			SphereBatch batch;
+			uint32_t lanes_count = eastl::min(4u, item.count - base);
+			for (uint32_t lane = 0; lane < lanes_count; lane++)
+			{
+				const LodNode &child = geometry.lod_nodes[item.first + base + lane];
+				batch.add(child.center, child.radius, child.error);
+			}
+			output.visited_nodes += lanes_count;
+
+			// Only too coarse children are refined further, others are covered by coarser groups
+			uint32_t mask = coarse_mask(view, instance.world_transform, scale, batch);
+			for (uint32_t lane = 0; lane < lanes_count; lane++)
+			{
+				if ((mask & (1u << lane)) == 0)
+					continue;
+
+				const LodNode &child = geometry.lod_nodes[item.first + base + lane];
+				if (child.child_count != 0)
+					stack.push_back({false, child.first_child, child.child_count});
+				else if (is_resident(instance, child.group_index))
+					stack.push_back({true, child.group_index, child.meshlet_count});
+				else
+					output.stream_requests.push_back({instance.geometry, child.group_index});
+			}
+		}
+	}
+}
+}
+
+bool MeshletTraversal::isInstanceVisible(const View &view, const Instance &instance)
+{
+	return is_box_visible(view, instance.bound_box.getCenter(), instance.bound_box.getSize() / 2.0f, instance.world_transform);
+}
+
+bool MeshletTraversal::isCoarserThanNeeded(const View &view, const glm::mat4 &world_transform, float scale, glm::vec3 center, float radius, float error)
+{
+	return getProjectedError(view, world_transform, scale, center, radius, error) >= view.error_threshold;
+}
+
+float MeshletTraversal::getProjectedError(const View &view, const glm::mat4 &world_transform, float scale, glm::vec3 center, float radius, float error)
+{
+	center = glm::vec3(world_transform * glm::vec4(center, 1.0f));
+	radius *= scale;
+
+	float distance = glm::max(glm::distance(center, view.camera_position) - radius, view.z_near);
+	return error * scale / distance;
+}
+
+void MeshletTraversal::traverse(const View &view, eastl::span<const Instance> instances, Result &result, uint32_t threads_count)
+{
+	PROFILE_CPU_FUNCTION();
+
+	uint32_t jobs_count = (instances.size() + INSTANCES_PER_JOB - 1) / INSTANCES_PER_JOB;
+	eastl::vector<JobOutput> jobs(jobs_count);
+
+	std::atomic<uint32_t> job_counter = 0;
+	auto worker = [&]()
+	{
+		// Reusable memory
+		eastl::vector<TraversalItem> stack;
+
+		while (true)
+		{
+			uint32_t job_id = job_counter.fetch_add(1, std::memory_order_relaxed);
+			if (job_id >= jobs_count)
+				break;
+
+			uint32_t end = eastl::min<uint32_t>((job_id + 1) * INSTANCES_PER_JOB, instances.size());
+			for (uint32_t i = job_id * INSTANCES_PER_JOB; i < end; i++)
+			{
+				if (instances[i].geometry)
+					traverse_instance(view, instances[i], stack, jobs[job_id]);
+			}
+		}
+	};
+
+	if (threads_count == 0)
+		threads_count = std::max(1u, std::thread::hardware_concurrency());
+	threads_count = eastl::min(threads_count, eastl::max(jobs_count, 1u));
+
+	eastl::vector<std::thread> threads(threads_count - 1);
+	for (auto &t : threads)
+		t = std::thread(worker);
+	worker(); // main thread also executes
+
+	for (auto &t : threads)
+		t.join();
+
+	// Merge in instance order, so result doesn't depend on threads count
+	result.meshlets.clear();
+	result.stream_requests.clear();
+	result.visited_nodes = 0;
+	result.visited_groups = 0;
+	result.culled_instances = 0;
+
+	eastl::hash_map<const Engine::MeshletGeometry *, eastl::hash_set<uint32_t>> requested_groups;
+	for (const JobOutput &job : jobs)
+	{
+		result.meshlets.insert(result.meshlets.end(), job.meshlets.begin(), job.meshlets.end());
+		for (const StreamRequest &request : job.stream_requests)
+		{
+			if (requested_groups[request.geometry].insert(request.group_index).second)
+				result.stream_requests.push_back(request);
+		}
+		result.visited_nodes += job.visited_nodes;
+		result.visited_groups += job.visited_groups;
+		result.culled_instances += job.culled_instances;
+	}
+}
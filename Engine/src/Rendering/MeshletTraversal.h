@@ -0,0 +1,66 @@
+#pragma once
+#include <EASTL/span.h>
+#include <EASTL/vector.h>
+#include "Rendering/Mesh.h"
+
+// CPU version of meshlet_cull_instances.hlsl + meshlet_traverse.hlsl.
+// Selects the same LOD cut as the GPU (without HiZ occlusion), so it can be used to validate readbacks
+// or to precompute visibility without a device.
+class MeshletTraversal
+{
+public:
+	struct View
+	{
+		glm::mat4 view_projection;
+		glm::vec3 camera_position;
+		float z_near = 0.1f;
+		float error_threshold = 0.0f; // see computeErrorThreshold
+		bool is_ortho = false;
+
+		// Matches error_threshold in streaming.h
+		static float computeErrorThreshold(float fov_y, float render_height, float threshold_pixels = 1.0f)
+		{
+			return tanf(fov_y * 0.5f) * threshold_pixels / render_height;
+		}
+	};
+
+	struct Instance
+	{
+		const Engine::MeshletGeometry *geometry = nullptr;
+		glm::mat4 world_transform = glm::mat4(1.0f);
+		BoundBox bound_box; // local mesh bounds
+		uint32_t instance_id = 0;
+		const uint8_t *resident_groups = nullptr; // per local group, nullptr if everything is resident
+	};
+
+	struct SelectedMeshlet
+	{
+		uint32_t instance_id;
+		uint32_t group_index; // local LODGroup index
+		uint32_t local_meshlet; // index inside group
+	};
+
+	struct StreamRequest
+	{
+		const Engine::MeshletGeometry *geometry;
+		uint32_t group_index;
+	};
+
+	struct Result
+	{
+		eastl::vector<SelectedMeshlet> meshlets; // in instance order
+		eastl::vector<StreamRequest> stream_requests; // deduplicated per mesh group
+		uint32_t visited_nodes = 0;
+		uint32_t visited_groups = 0;
+		uint32_t culled_instances = 0;
+	};
+
+	// threads_count = 0 uses all hardware threads
+	static void traverse(const View &view, eastl::span<const Instance> instances, Result &result, uint32_t threads_count = 0);
+
+	// Reference scalar versions of the shader tests, SIMD paths are validated against them
+	static bool isInstanceVisible(const View &view, const Instance &instance);
+	static bool isCoarserThanNeeded(const View &view, const glm::mat4 &world_transform, float scale, glm::vec3 center, float radius, float error);
+	// Simplification error over the distance, as getError in streaming.h. Divided by error_threshold it is in pixels
+	static float getProjectedError(const View &view, const glm::mat4 &world_transform, float scale, glm::vec3 center, float radius, float error);
+};
@@ -90,6 +90,8 @@ Entity Model::create_entity_node(Model *model, MeshNode *node, Scene *scene)
 		child_transform_component.parent = entity;
 		transform_component.children.push_back(child);
 	}
+	if (!node->children.empty())
+		scene->markHierarchyChanged();
 	return entity;
 }
 
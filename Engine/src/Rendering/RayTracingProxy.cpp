@@ -0,0 +1,223 @@
+#include "pch.h"
+#include "RayTracingProxy.h"
+#include "Math/EngineMath.h"
+
+namespace
+{
+constexpr uint32_t MOST_DETAILED_CLUSTER_GROUP_ID = 0xFFFFFFFFu;
+
+struct MeshletErrors
+{
+	float own; // error of the simplification that made the meshlet
+	float parent; // error of the coarser meshlets that replace its group
+};
+
+MeshletErrors get_meshlet_errors(const Engine::MeshletGeometry &geometry, const MeshFormat::DiskMeshlet &meshlet, uint32_t root_level_begin)
+{
+	MeshletErrors errors;
+	errors.own = meshlet.refined_group_id == MOST_DETAILED_CLUSTER_GROUP_ID ? 0.0f : geometry.meshlet_lod_groups[meshlet.refined_group_id].error;
+	// Nothing replaces the root level, it closes every cut
+	errors.parent = meshlet.group_id >= root_level_begin ? FLT_MAX : geometry.meshlet_lod_groups[meshlet.group_id].error;
+	return errors;
+}
+
+bool is_in_cut(const MeshletErrors &errors, float error_threshold)
+{
+	return errors.own <= error_threshold && error_threshold < errors.parent;
+}
+
+// Real-Time Collision Detection, 5.1.5
+glm::vec3 closest_point_on_triangle(glm::vec3 p, glm::vec3 a, glm::vec3 b, glm::vec3 c)
+{
+	glm::vec3 ab = b - a;
+	glm::vec3 ac = c - a;
+	glm::vec3 ap = p - a;
+	float d1 = glm::dot(ab, ap);
+	float d2 = glm::dot(ac, ap);
+	if (d1 <= 0.0f && d2 <= 0.0f)
+		return a;
+
+	glm::vec3 bp = p - b;
+	float d3 = glm::dot(ab, bp);
+	float d4 = glm::dot(ac, bp);
+	if (d3 >= 0.0f && d4 <= d3)
+		return b;
+
+	float vc = d1 * d4 - d3 * d2;
+	if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f)
+		return a + ab * (d1 / (d1 - d3));
+
+	glm::vec3 cp = p - c;
+	float d5 = glm::dot(ab, cp);
+	float d6 = glm::dot(ac, cp);
+	if (d6 >= 0.0f && d5 <= d6)
+		return c;
+
+	float vb = d5 * d2 - d1 * d6;
+	if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f)
+		return a + ac * (d2 / (d2 - d6));
+
+	float va = d3 * d6 - d5 * d4;
+	if (va <= 0.0f && d4 - d3 >= 0.0f && d5 - d6 >= 0.0f)
+		return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+
+	float denom = 1.0f / (va + vb + vc);
+	return a + ab * (vb * denom) + ac * (vc * denom);
+}
+}
+
+float RayTracingProxy::selectErrorThreshold(const Engine::MeshletGeometry &geometry, uint32_t max_triangles)
+{
+	PROFILE_CPU_FUNCTION();
+	if (geometry.meshlet_lod_levels.empty())
+		return 0.0f;
+	uint32_t root_level_begin = geometry.meshlet_lod_levels.back().group_offset;
+
+	// Triangles of a meshlet are in every cut with the threshold between its own and its parent error
+	struct Event
+	{
+		float error;
+		int32_t triangles;
+	};
+	eastl::vector<Event> events;
+	events.reserve(geometry.meshlets.size() * 2);
+	for (const MeshFormat::DiskMeshlet &meshlet : geometry.meshlets)
+	{
+		MeshletErrors errors = get_meshlet_errors(geometry, meshlet, root_level_begin);
+		if (errors.own >= errors.parent)
+			continue;
+		events.push_back({errors.own, int32_t(meshlet.triangle_count)});
+		if (errors.parent != FLT_MAX)
+			events.push_back({errors.parent, -int32_t(meshlet.triangle_count)});
+	}
+	eastl::sort(events.begin(), events.end(), [](const Event &a, const Event &b) { return a.error < b.error; });
+
+	// Cuts go from fine to coarse, the first one in budget is the finest
+	int64_t triangles = 0;
+	int64_t best_triangles = INT64_MAX;
+	float best_threshold = 0.0f;
+	for (size_t i = 0; i < events.size();)
+	{
+		float error = events[i].error;
+		for (; i < events.size() && events[i].error == error; i++)
+			triangles += events[i].triangles;
+
+		if (triangles <= 0)
+			continue;
+		if (triangles <= max_triangles)
+			return error;
+		if (triangles < best_triangles)
+		{
+			best_triangles = triangles;
+			best_threshold = error;
+		}
+	}
+	return best_threshold;
+}
+
+RayTracingProxy::Info RayTracingProxy::extract(const Engine::MeshletGeometry &geometry, const Engine::MeshletFileView &file_view, uint32_t attribute_flags, float error_threshold, Engine::IndexedGeometry &proxy)
+{
+	PROFILE_CPU_FUNCTION();
+	Info info;
+	info.error_threshold = error_threshold;
+	proxy.vertices.clear();
+	proxy.indices.clear();
+	if (geometry.meshlet_lod_levels.empty() || !file_view.isValid())
+		return info;
+
+	uint32_t root_level_begin = geometry.meshlet_lod_levels.back().group_offset;
+	uint32_t disk_stride = MeshFormat::diskVertexStride(attribute_flags);
+
+	// Meshlets repeat the vertices on their borders, equal vertices on disk are welded
+	eastl::hash_map<size_t, uint32_t> welded;
+	eastl::vector<const uint8_t *> welded_sources;
+	uint32_t local_remap[256];
+
+	for (uint32_t group_index = 0; group_index < geometry.meshlet_lod_groups.size(); group_index++)
+	{
+		const LODGroup &group = geometry.meshlet_lod_groups[group_index];
+		const Engine::MeshletGeometry::LODGroupDataInfo &data_info = geometry.meshlet_lod_group_data_info[group_index];
+		for (uint32_t m = 0; m < group.meshlet_count; m++)
+		{
+			const MeshFormat::DiskMeshlet &meshlet = geometry.meshlets[group.first_meshlet + m];
+			if (!is_in_cut(get_meshlet_errors(geometry, meshlet, root_level_begin), error_threshold))
+				continue;
+
+			const uint8_t *vertices = file_view.vertices_ptr + uint64_t(data_info.cpu_vertex_offset + meshlet.vertex_offset) * disk_stride;
+			for (uint32_t v = 0; v < meshlet.vertex_count; v++)
+			{
+				const uint8_t *vertex = vertices + v * disk_stride;
+				size_t hash = Engine::Math::fnv1aHash((const uint32_t *)vertex, disk_stride);
+				auto [it, is_inserted] = welded.insert(eastl::make_pair(hash, (uint32_t)proxy.vertices.size()));
+				if (!is_inserted && memcmp(welded_sources[it->second], vertex, disk_stride) == 0)
+				{
+					local_remap[v] = it->second;
+					continue;
+				}
+
+				// Hash collisions are kept as separate vertices
+				local_remap[v] = proxy.vertices.size();
+				proxy.vertices.push_back(MeshFormat::decodeVertex(vertex, attribute_flags));
+				welded_sources.push_back(vertex);
+			}
+
+			const uint8_t *triangles = file_view.triangles_ptr + data_info.cpu_triangle_offset + meshlet.triangle_offset;
+			for (uint32_t k = 0; k < meshlet.triangle_count * 3u; k++)
+				proxy.indices.push_back(local_remap[triangles[k]]);
+
+			info.meshlets_count++;
+			info.triangles_count += meshlet.triangle_count;
+		}
+	}
+	return info;
+}
+
+RayTracingProxy::Error RayTracingProxy::measureError(const Engine::IndexedGeometry &proxy, const Engine::MeshletGeometry &geometry, const Engine::MeshletFileView &file_view, uint32_t attribute_flags, uint32_t max_samples)
+{
+	PROFILE_CPU_FUNCTION();
+	Error error;
+	if (!file_view.isValid() || proxy.indices.empty() || max_samples == 0)
+		return error;
+
+	// Source mesh is the finest cut, its meshlets were not made by simplification
+	uint32_t disk_stride = MeshFormat::diskVertexStride(attribute_flags);
+	eastl::vector<const uint8_t *> source_vertices;
+	for (uint32_t group_index = 0; group_index < geometry.meshlet_lod_groups.size(); group_index++)
+	{
+		const LODGroup &group = geometry.meshlet_lod_groups[group_index];
+		const Engine::MeshletGeometry::LODGroupDataInfo &data_info = geometry.meshlet_lod_group_data_info[group_index];
+		for (uint32_t m = 0; m < group.meshlet_count; m++)
+		{
+			const MeshFormat::DiskMeshlet &meshlet = geometry.meshlets[group.first_meshlet + m];
+			if (meshlet.refined_group_id != MOST_DETAILED_CLUSTER_GROUP_ID)
+				continue;
+			const uint8_t *vertices = file_view.vertices_ptr + uint64_t(data_info.cpu_vertex_offset + meshlet.vertex_offset) * disk_stride;
+			for (uint32_t v = 0; v < meshlet.vertex_count; v++)
+				source_vertices.push_back(vertices + v * disk_stride);
+		}
+	}
+	if (source_vertices.empty())
+		return error;
+
+	double distance_sum = 0.0;
+	size_t step = eastl::max<size_t>(1, source_vertices.size() / max_samples);
+	for (size_t i = 0; i < source_vertices.size() && error.samples_count < max_samples; i += step)
+	{
+		glm::vec3 position = MeshFormat::decodeVertex(source_vertices[i], attribute_flags).pos;
+		float min_distance_sq = FLT_MAX;
+		for (size_t k = 0; k + 2 < proxy.indices.size(); k += 3)
+		{
+			glm::vec3 closest = closest_point_on_triangle(position, proxy.vertices[proxy.indices[k]].pos,
+														  proxy.vertices[proxy.indices[k + 1]].pos, proxy.vertices[proxy.indices[k + 2]].pos);
+			glm::vec3 delta = closest - position;
+			min_distance_sq = glm::min(min_distance_sq, glm::dot(delta, delta));
+		}
+
+		float distance = sqrtf(min_distance_sq);
+		error.max_distance = glm::max(error.max_distance, distance);
+		distance_sum += distance;
+		error.samples_count++;
+	}
+	error.mean_distance = float(distance_sum / error.samples_count);
+	return error;
+}
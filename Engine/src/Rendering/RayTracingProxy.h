@@ -0,0 +1,37 @@
+#pragma once
+#include "Rendering/Mesh.h"
+
+// Indexed proxy of a meshlet mesh for ray tracing, built once from the .mesh file and kept resident while streaming
+// changes what is rasterized. The proxy is a cut of the baked LOD DAG with a fixed object space error: meshlets whose own
+// error (error of their refined group, 0 for source meshlets) is under the threshold and whose group error is over it.
+// This is the cut MeshletTraversal picks when every group is resident and the projected threshold is the same everywhere,
+// so the proxy has no cracks. The finest cut that fits the triangle budget is used.
+class RayTracingProxy
+{
+public:
+	struct Info
+	{
+		float error_threshold = 0.0f; // object space
+		uint32_t triangles_count = 0;
+		uint32_t meshlets_count = 0;
+	};
+
+	// Smallest threshold which cut has at most max_triangles, the coarsest cut if none fits
+	static float selectErrorThreshold(const Engine::MeshletGeometry &geometry, uint32_t max_triangles);
+	static Info extract(const Engine::MeshletGeometry &geometry, const Engine::MeshletFileView &file_view, uint32_t attribute_flags, float error_threshold, Engine::IndexedGeometry &proxy);
+	static Info build(const Engine::MeshletGeometry &geometry, const Engine::MeshletFileView &file_view, uint32_t attribute_flags, uint32_t max_triangles, Engine::IndexedGeometry &proxy)
+	{
+		return extract(geometry, file_view, attribute_flags, selectErrorThreshold(geometry, max_triangles), proxy);
+	}
+
+	struct Error
+	{
+		float max_distance = 0.0f;
+		float mean_distance = 0.0f;
+		uint32_t samples_count = 0;
+	};
+
+	// Distances from source vertices (the finest cut) to the nearest proxy triangle, up to max_samples vertices spread over the mesh.
+	// Brute force over the proxy triangles, for tests and tools only
+	static Error measureError(const Engine::IndexedGeometry &proxy, const Engine::MeshletGeometry &geometry, const Engine::MeshletFileView &file_view, uint32_t attribute_flags, uint32_t max_samples);
+};
@@ -3,6 +3,7 @@
 #include "GlobalBufferCache.h"
 #include "RHI/BindlessResources.h"
 #include "RHI/Upscaler.h"
+#include "RHI/RHIUploadBatch.h"
 #include "Core/Variables.h"
 #include "Utils/Math.h"
 
@@ -47,6 +48,8 @@ void Renderer::beginFrame()
 	// Update debug info
 	prev_debug_info = debug_info;
 	debug_info = RendererDebugInfo{};
+
+	RHIUploadBatch::releaseCompleted();
 }
 
 void Renderer::endFrame(unsigned int image_index)
@@ -66,6 +66,8 @@ public:
 		uint32_t tlas_id = 0;
 		uint32_t ddgi_volume_buffer_id = 0;
 		uint32_t lines_gpu_buffer_id = 0;
+		uint32_t texture_feedback_buffer_id = 0;
+		uint32_t debug_primitives_gpu_buffer_id = 0;
 	};
 
 	Renderer() = delete;
@@ -5,13 +5,20 @@
 #include "Math/BoundSphere.h"
 #include "GlobalBufferCache.h"
 #include "Rendering/Model.h"
+#include "Scene/Prefab.h"
 #include "Rendering/UploadManager.h"
 #include "Assets/AssetManager.h"
 
+namespace
+{
+constexpr uint32_t DYNAMIC_SETTLE_FRAMES = 30;
+}
+
 SceneRenderer::SceneRenderer()
 {
 	shadow_renderer.debug_renderer = &debug_renderer;
 	geometry_streaming.init();
+	texture_streaming.init();
 
 	frustums_table.init("Frustums Buffer", 64, ReplicationPolicy::Copy);
 	materials_table.init("Materials Buffer", 512, ReplicationPolicy::DirtyRows);
@@ -20,12 +27,14 @@ SceneRenderer::SceneRenderer()
 
 	AssetManager::onPreReimport().connect<&SceneRenderer::on_asset_pre_reimport>(this);
 	AssetManager::onPostReimport().connect<&SceneRenderer::on_asset_post_reimport>(this);
+	AssetManager::onPreRuntimeRecreate().connect<&SceneRenderer::on_asset_pre_runtime_recreate>(this);
 }
 
 SceneRenderer::~SceneRenderer()
 {
 	AssetManager::onPreReimport().disconnect(this);
 	AssetManager::onPostReimport().disconnect(this);
+	AssetManager::onPreRuntimeRecreate().disconnect(this);
 }
 
 void SceneRenderer::setScene(Ref<Scene> scene)
@@ -37,6 +46,8 @@ void SceneRenderer::setScene(Ref<Scene> scene)
 	{
 		this->scene->registry.on_construct<MeshRendererComponent>().disconnect<&SceneRenderer::on_mesh_renderer_constructed>(this);
 		this->scene->registry.on_destroy<MeshRendererComponent>().disconnect<&SceneRenderer::on_mesh_renderer_destroyed>(this);
+		this->scene->registry.on_construct<PrefabInstanceComponent>().disconnect<&SceneRenderer::on_mesh_renderer_constructed>(this);
+		this->scene->registry.on_destroy<PrefabInstanceComponent>().disconnect<&SceneRenderer::on_mesh_renderer_destroyed>(this);
 	}
 
 	this->scene = scene;
@@ -49,6 +60,12 @@ void SceneRenderer::setScene(Ref<Scene> scene)
 	}
 
 	entity_instances.clear();
+	prefab_records.clear();
+	entity_prefabs.clear();
+	dynamic_entities.clear();
+	entity_bounds.clear();
+	changed_static_bounds.clear();
+	shadow_renderer.resetCaches();
 	instances_table.reset();
 	materials_table.reset();
 	meshes_table.reset();
@@ -58,9 +75,14 @@ void SceneRenderer::setScene(Ref<Scene> scene)
 
 	scene->registry.on_construct<MeshRendererComponent>().connect<&SceneRenderer::on_mesh_renderer_constructed>(this);
 	scene->registry.on_destroy<MeshRendererComponent>().connect<&SceneRenderer::on_mesh_renderer_destroyed>(this);
+	// Prefab instances are drawn instead of mesh renderers, their records are made and freed the same way
+	scene->registry.on_construct<PrefabInstanceComponent>().connect<&SceneRenderer::on_mesh_renderer_constructed>(this);
+	scene->registry.on_destroy<PrefabInstanceComponent>().connect<&SceneRenderer::on_mesh_renderer_destroyed>(this);
 
 	for (entt::entity entity : scene->registry.view<MeshRendererComponent>())
 		scene->markDirty(entity, DIRTY_RENDER_STATE);
+	for (entt::entity entity : scene->registry.view<PrefabInstanceComponent>())
+		scene->markDirty(entity, DIRTY_RENDER_STATE);
 }
 
 void SceneRenderer::on_mesh_renderer_constructed(entt::registry &registry, entt::entity entity)
@@ -89,6 +111,21 @@ void SceneRenderer::free_instances(entt::entity entity_id)
 	}
 	instances_table.freeArray(it->second.start, it->second.count);
 	entity_instances.erase(it);
+
+	auto prefab_it = entity_prefabs.find(entity_id);
+	if (prefab_it != entity_prefabs.end())
+	{
+		release_prefab_records(prefab_it->second);
+		entity_prefabs.erase(prefab_it);
+	}
+
+	auto bounds_it = entity_bounds.find(entity_id);
+	if (bounds_it != entity_bounds.end())
+	{
+		changed_static_bounds.push_back(bounds_it->second);
+		entity_bounds.erase(bounds_it);
+	}
+	dynamic_entities.erase(entity_id);
 }
 
 void SceneRenderer::refresh_meshes(entt::entity entity_id, MeshRendererComponent &mesh_renderer)
@@ -103,34 +140,42 @@ void SceneRenderer::refresh_meshes(entt::entity entity_id, MeshRendererComponent
 		if (!mesh)
 			continue;
 
-		const Engine::MeshletFileView *file_view = mesh_renderer.meshes[i].getModel()->getFileView(mesh->id);
-		if (file_view)
-			geometry_streaming.registerMesh(mesh, *file_view);
-
-		MeshGPU mesh_gpu{};
-		mesh_gpu.vertex_buffer_id = mesh->indexed && mesh->indexed->vertex_buffer ? mesh->indexed->vertex_buffer->getShaderResourceView()->getBindlessIndex() : 0;
-		mesh_gpu.index_buffer_id = mesh->indexed && mesh->indexed->index_buffer ? mesh->indexed->index_buffer->getShaderResourceView()->getBindlessIndex() : 0;
-		mesh_gpu.vertex_stride = sizeof(Engine::Vertex);
-		mesh_gpu.positions_offset = offsetof(Engine::Vertex, pos);
-		mesh_gpu.normals_offset = offsetof(Engine::Vertex, normal);
-		mesh_gpu.tangents_offset = offsetof(Engine::Vertex, tangent);
-		mesh_gpu.uvs_offset = offsetof(Engine::Vertex, uv);
-		mesh_gpu.indices_count = mesh->indexed ? mesh->indexed->indices.size() : 0;
-		if (mesh->useMeshlets())
-		{
-			GlobalBufferCache::MeshGlobalOffsets mesh_global = GlobalBufferCache::getMeshOffsets(mesh->id);
-			mesh_gpu.meshlet_lod_groups_offset = mesh_global.lod_groups_offset;
-			mesh_gpu.group_residency_offset = geometry_streaming.getMeshResidencyOffset(mesh);
-			mesh_gpu.lod_nodes_offset = mesh_global.lod_nodes_offset;
-		}
-		mesh_gpu.root_group_offset = mesh->meshlet_data ? mesh->meshlet_data->meshlet_root_group_local_offset : 0;
-		mesh_gpu.attribute_flags = mesh->attribute_flags;
-		mesh_gpu.flags = mesh->useMeshlets() ? MESH_FLAG_MESHLET : 0;
-
+		MeshGPU mesh_gpu = make_mesh_gpu(mesh, mesh_renderer.meshes[i].getModel());
 		meshes_table.set(it->second.start + i, mesh_gpu); // In future every mesh would hold its own slot and dont hold duplicates
 	}
 }
 
+MeshGPU SceneRenderer::make_mesh_gpu(Engine::Mesh *mesh, Model *model)
+{
+	const Engine::MeshletFileView *file_view = model->getFileView(mesh->id);
+	if (file_view)
+		geometry_streaming.registerMesh(mesh, *file_view);
+
+	// Meshlet meshes are rasterized from streamed groups, ray hits read the vertices of their proxy
+	const Engine::IndexedGeometry *geometry = mesh->getRayTracingGeometry();
+	MeshGPU mesh_gpu{};
+	mesh_gpu.vertex_buffer_id = geometry && geometry->vertex_buffer ? geometry->vertex_buffer->getShaderResourceView()->getBindlessIndex() : 0;
+	mesh_gpu.index_buffer_id = geometry && geometry->index_buffer ? geometry->index_buffer->getShaderResourceView()->getBindlessIndex() : 0;
+	mesh_gpu.vertex_stride = sizeof(Engine::Vertex);
+	mesh_gpu.positions_offset = offsetof(Engine::Vertex, pos);
+	mesh_gpu.normals_offset = offsetof(Engine::Vertex, normal);
+	mesh_gpu.tangents_offset = offsetof(Engine::Vertex, tangent);
+	mesh_gpu.uvs_offset = offsetof(Engine::Vertex, uv);
+	mesh_gpu.indices_count = mesh->indexed ? mesh->indexed->indices.size() : 0;
+	if (mesh->useMeshlets())
+	{
+		GlobalBufferCache::MeshGlobalOffsets mesh_global = GlobalBufferCache::getMeshOffsets(mesh->id);
+		mesh_gpu.meshlet_lod_groups_offset = mesh_global.lod_groups_offset;
+		mesh_gpu.group_residency_offset = geometry_streaming.getMeshResidencyOffset(mesh);
+		mesh_gpu.lod_nodes_offset = mesh_global.lod_nodes_offset;
+	}
+	mesh_gpu.root_group_offset = mesh->meshlet_data ? mesh->meshlet_data->meshlet_root_group_local_offset : 0;
+	mesh_gpu.attribute_flags = mesh->attribute_flags;
+	mesh_gpu.flags = mesh->useMeshlets() ? MESH_FLAG_MESHLET : 0;
+
+	return mesh_gpu;
+}
+
 void SceneRenderer::refresh_materials(entt::entity entity_id, MeshRendererComponent &mesh_renderer)
 {
 	auto it = entity_instances.find(entity_id);
@@ -143,26 +188,31 @@ void SceneRenderer::refresh_materials(entt::entity entity_id, MeshRendererCompon
 		if (!material)
 			continue;
 
-		material->update();
+		materials_table.set(it->second.start + i, make_material_gpu(material)); // In future materials would be globally unique, so every material would hold its own slot
+	}
+}
 
-		MaterialGPU material_gpu{};
-		if (render_lighting_only)
-		{
-			material_gpu.albedo = glm::vec4(glm::vec3(LightingOnlyMaterial::albedo), 1.0f);
-			material_gpu.shading = glm::vec4(LightingOnlyMaterial::metalness, LightingOnlyMaterial::roughness, LightingOnlyMaterial::specular, 1.0f);
-		} else
-		{
-			material_gpu.albedo = material->albedo;
-			material_gpu.shading = glm::vec4(material->metalness, material->roughness, material->specular, 1.0f);
-			material_gpu.albedo_tex_id = material->albedo_tex.bindless_id;
-			material_gpu.metalness_tex_id = material->metalness_tex.bindless_id;
-			material_gpu.roughness_tex_id = material->roughness_tex.bindless_id;
-			material_gpu.specular_tex_id = material->specular_tex.bindless_id;
-			material_gpu.normal_tex_id = material->normal_tex.bindless_id;
-		}
+MaterialGPU SceneRenderer::make_material_gpu(Material *material)
+{
+	material->update(texture_streaming);
 
-		materials_table.set(it->second.start + i, material_gpu); // In future materials would be globally unique, so every material would hold its own slot
+	MaterialGPU material_gpu{};
+	if (render_lighting_only)
+	{
+		material_gpu.albedo = glm::vec4(glm::vec3(LightingOnlyMaterial::albedo), 1.0f);
+		material_gpu.shading = glm::vec4(LightingOnlyMaterial::metalness, LightingOnlyMaterial::roughness, LightingOnlyMaterial::specular, 1.0f);
+	} else
+	{
+		material_gpu.albedo = material->albedo;
+		material_gpu.shading = glm::vec4(material->metalness, material->roughness, material->specular, 1.0f);
+		material_gpu.albedo_tex_id = material->albedo_tex.bindless_id;
+		material_gpu.metalness_tex_id = material->metalness_tex.bindless_id;
+		material_gpu.roughness_tex_id = material->roughness_tex.bindless_id;
+		material_gpu.specular_tex_id = material->specular_tex.bindless_id;
+		material_gpu.normal_tex_id = material->normal_tex.bindless_id;
 	}
+
+	return material_gpu;
 }
 
 void SceneRenderer::refresh_transforms(entt::entity entity_id)
@@ -171,10 +221,18 @@ void SceneRenderer::refresh_transforms(entt::entity entity_id)
 	if (it == entity_instances.end())
 		return;
 
+	if (PrefabInstanceComponent *prefab_instance = scene->registry.try_get<PrefabInstanceComponent>(entity_id))
+	{
+		refresh_prefab_transforms(entity_id, *prefab_instance);
+		return;
+	}
+
 	Entity entity(entity_id);
 	const TransformComponent &transform = entity.getComponent<TransformComponent>();
 	MeshRendererComponent &mesh_renderer = entity.getComponent<MeshRendererComponent>();
+	bool is_dynamic = dynamic_entities.find(entity_id) != dynamic_entities.end();
 
+	BoundBox world_bound_box;
 	for (int i = 0; i < it->second.count && i < mesh_renderer.meshes.size(); i++)
 	{
 		uint32_t slot = it->second.start + i;
@@ -198,16 +256,179 @@ void SceneRenderer::refresh_transforms(entt::entity entity_id)
 		BoundBox bound_box(mesh->bound_box);
 		instance.bound_center = glm::vec4(bound_box.getCenter(), 1.0f);
 		instance.bound_extent = glm::vec4(bound_box.getSize() / 2.0f, 1.0);
+		instance.flags = is_dynamic ? INSTANCE_FLAG_DYNAMIC : 0;
+		world_bound_box.extend(bound_box * transform.getWorldTransform());
 
 		instances_table.set(slot, instance);
 		if (rt_scene)
 			rt_scene->setInstance(slot, mesh, transform.getWorldTransform());
 	}
+	entity_bounds[entity_id] = world_bound_box;
+}
+
+bool SceneRenderer::create_prefab_instances(entt::entity entity_id, PrefabInstanceComponent &prefab_instance)
+{
+	Prefab *prefab = prefab_instance.getPrefab();
+	if (!prefab || prefab->getParts().empty())
+		return false;
+
+	acquire_prefab_records(prefab);
+	entity_prefabs[entity_id] = prefab;
+
+	uint32_t count = prefab->getParts().size();
+	entity_instances[entity_id] = { instances_table.allocate(count), count };
+	refresh_prefab_materials(entity_id, prefab_instance);
+	return true;
+}
+
+void SceneRenderer::refresh_prefab_materials(entt::entity entity_id, PrefabInstanceComponent &prefab_instance)
+{
+	auto it = entity_instances.find(entity_id);
+	if (it == entity_instances.end())
+		return;
+
+	// Only overridden parts have their own materials, the rest use records of the prefab
+	for (const PrefabOverride &part_override : prefab_instance.overrides)
+	{
+		if (part_override.part >= it->second.count || !prefab_instance.hasMaterialOverride(part_override.part))
+			continue;
+		if (Material *material = prefab_instance.getMaterial(part_override.part))
+			materials_table.set(it->second.start + part_override.part, make_material_gpu(material));
+	}
+}
+
+void SceneRenderer::refresh_prefab_transforms(entt::entity entity_id, PrefabInstanceComponent &prefab_instance)
+{
+	InstanceRange range = entity_instances[entity_id];
+	Prefab *prefab = entity_prefabs[entity_id];
+	InstanceRange records = prefab_records[prefab].range;
+
+	const TransformComponent &transform = scene->registry.get<TransformComponent>(entity_id);
+	const glm::mat4 &world_transform = transform.getWorldTransform();
+	const glm::mat4 &inverse_world_transform = transform.getInverseWorldTransform();
+	const glm::mat4 &old_world_transform = transform.getOldWorldTransform();
+	bool is_dynamic = dynamic_entities.find(entity_id) != dynamic_entities.end();
+
+	// Parts are expanded in one pass and uploaded as one range
+	const eastl::vector<Prefab::Part> &parts = prefab->getParts();
+	prefab_instances_scratch.resize(range.count);
+	BoundBox world_bound_box;
+	for (uint32_t i = 0; i < range.count; i++)
+	{
+		InstanceGPU &instance = prefab_instances_scratch[i];
+		instance = InstanceGPU{};
+
+		Engine::Mesh *mesh = prefab->getMesh(i);
+		if (!mesh || prefab_instance.isHidden(i))
+		{
+			instance.flags = INSTANCE_FLAG_INVALID;
+			if (rt_scene)
+				rt_scene->removeInstance(range.start + i);
+			continue;
+		}
+
+		const Prefab::Part &part = parts[i];
+		instance.world_transform = world_transform * part.transform;
+		instance.iworld_transform = part.inverse_transform * inverse_world_transform;
+		instance.old_world_transform = old_world_transform * part.transform;
+		instance.mesh_id = records.start + i;
+		instance.material_id = prefab_instance.hasMaterialOverride(i) ? range.start + i : records.start + i;
+		BoundBox bound_box(mesh->bound_box);
+		instance.bound_center = glm::vec4(bound_box.getCenter(), 1.0f);
+		instance.bound_extent = glm::vec4(bound_box.getSize() / 2.0f, 1.0);
+		instance.flags = is_dynamic ? INSTANCE_FLAG_DYNAMIC : 0;
+		world_bound_box.extend(bound_box * instance.world_transform);
+
+		if (rt_scene)
+			rt_scene->setInstance(range.start + i, mesh, instance.world_transform);
+	}
+	instances_table.setArray(range.start, eastl::span<const InstanceGPU>(prefab_instances_scratch.data(), range.count));
+	entity_bounds[entity_id] = world_bound_box;
+}
+
+void SceneRenderer::acquire_prefab_records(Prefab *prefab)
+{
+	auto it = prefab_records.find(prefab);
+	if (it != prefab_records.end())
+	{
+		it->second.users++;
+		return;
+	}
+
+	uint32_t count = prefab->getParts().size();
+	PrefabRecords &records = prefab_records[prefab];
+	records.range = { instances_table.allocate(count), count };
+	records.users = 1;
+
+	InstanceGPU empty_instance{};
+	empty_instance.flags = INSTANCE_FLAG_INVALID;
+	for (uint32_t i = 0; i < count; i++)
+		instances_table.set(records.range.start + i, empty_instance);
+	refresh_prefab_records(prefab);
+}
+
+void SceneRenderer::release_prefab_records(Prefab *prefab)
+{
+	auto it = prefab_records.find(prefab);
+	if (it == prefab_records.end() || --it->second.users > 0)
+		return;
+
+	instances_table.freeArray(it->second.range.start, it->second.range.count);
+	prefab_records.erase(it);
+}
+
+void SceneRenderer::refresh_prefab_records(Prefab *prefab)
+{
+	PrefabRecords &records = prefab_records[prefab];
+	records.is_dirty = false;
+	for (uint32_t i = 0; i < records.range.count; i++)
+	{
+		uint32_t slot = records.range.start + i;
+		if (Engine::Mesh *mesh = prefab->getMesh(i))
+			meshes_table.set(slot, make_mesh_gpu(mesh, prefab->getModel(i)));
+		if (Material *material = prefab->getMaterial(i))
+			materials_table.set(slot, make_material_gpu(material));
+	}
+}
+
+void SceneRenderer::free_prefab_instances(Prefab *prefab)
+{
+	eastl::vector<entt::entity> entities;
+	for (auto &[entity, entity_prefab] : entity_prefabs)
+	{
+		if (entity_prefab == prefab)
+			entities.push_back(entity);
+	}
+	for (entt::entity entity : entities)
+		free_instances(entity);
+}
+
+void SceneRenderer::invalidate_prefab_records(const eastl::function<bool(Material *material)> &is_affected)
+{
+	for (auto &[prefab, records] : prefab_records)
+	{
+		for (uint32_t i = 0; i < records.range.count; i++)
+		{
+			Material *material = prefab->getMaterial(i);
+			if (material && is_affected(material))
+				records.is_dirty = true;
+		}
+	}
 }
 
 void SceneRenderer::on_asset_pre_reimport(Asset *asset)
 {
-	if (!scene || asset->type != AssetManager::getTypeInfo<Model>())
+	if (!scene)
+		return;
+
+	// Parts of the reloaded prefab can change, its instances and records are made again after reimport
+	if (asset->type == AssetManager::getTypeInfo<Prefab>())
+	{
+		free_prefab_instances(static_cast<Prefab *>(asset));
+		return;
+	}
+
+	if (asset->type != AssetManager::getTypeInfo<Model>())
 		return;
 
 	Model *model = static_cast<Model *>(asset);
@@ -227,6 +448,10 @@ void SceneRenderer::on_asset_post_reimport(Asset *asset)
 		return;
 
 	if (asset->type == AssetManager::getTypeInfo<RHITexture>())
+	{
+		texture_streaming.releaseTexture(asset->guid);
+		invalidate_texture_users({&asset->guid, 1});
+	} else if (asset->type == AssetManager::getTypeInfo<Material>())
 	{
 		auto view = scene->registry.view<MeshRendererComponent>();
 		for (entt::entity entity : view)
@@ -234,23 +459,22 @@ void SceneRenderer::on_asset_post_reimport(Asset *asset)
 			MeshRendererComponent &mesh_renderer = view.get<MeshRendererComponent>(entity);
 			for (int i = 0; i < mesh_renderer.meshes.size(); i++)
 			{
-				Material *material = mesh_renderer.getMaterial(i);
-				if (!material || !material->usesTexture(asset->guid))
+				if (mesh_renderer.getMaterial(i) != asset)
 					continue;
 
-				material->invalidateTextures();
 				scene->markDirty(entity, DIRTY_MATERIAL);
+				break;
 			}
 		}
-	} else if (asset->type == AssetManager::getTypeInfo<Material>())
-	{
-		auto view = scene->registry.view<MeshRendererComponent>();
-		for (entt::entity entity : view)
+
+		invalidate_prefab_records([asset](Material *material) { return material == asset; });
+		auto prefab_view = scene->registry.view<PrefabInstanceComponent>();
+		for (entt::entity entity : prefab_view)
 		{
-			MeshRendererComponent &mesh_renderer = view.get<MeshRendererComponent>(entity);
-			for (int i = 0; i < mesh_renderer.meshes.size(); i++)
+			PrefabInstanceComponent &prefab_instance = prefab_view.get<PrefabInstanceComponent>(entity);
+			for (PrefabOverride &part_override : prefab_instance.overrides)
 			{
-				if (mesh_renderer.getMaterial(i) != asset)
+				if (part_override.material.getMaterial() != asset)
 					continue;
 
 				scene->markDirty(entity, DIRTY_MATERIAL);
@@ -273,6 +497,78 @@ void SceneRenderer::on_asset_post_reimport(Asset *asset)
 				}
 			}
 		}
+
+		for (auto &[prefab, records] : prefab_records)
+		{
+			for (uint32_t i = 0; i < records.range.count && !records.is_dirty; i++)
+				records.is_dirty = prefab->getModel(i) == model;
+		}
+		for (auto &[entity, prefab] : entity_prefabs)
+		{
+			if (prefab_records[prefab].is_dirty)
+				scene->markDirty(entity, DIRTY_RENDER_STATE);
+		}
+	} else if (asset->type == AssetManager::getTypeInfo<Prefab>())
+	{
+		// Edited in place or reloaded, parts follow the nodes
+		Prefab *prefab = static_cast<Prefab *>(asset);
+		free_prefab_instances(prefab);
+		prefab->build();
+
+		auto view = scene->registry.view<PrefabInstanceComponent>();
+		for (entt::entity entity : view)
+		{
+			if (view.get<PrefabInstanceComponent>(entity).getPrefab() == prefab)
+				scene->markDirty(entity, DIRTY_RENDER_STATE);
+		}
+	}
+}
+
+void SceneRenderer::on_asset_pre_runtime_recreate(Engine::GUID guid)
+{
+	// Streamed textures are not loaded through the asset manager, so their reimport only recreates the runtime file.
+	// Released texture unmaps it, materials request the new runtime on their next update
+	texture_streaming.releaseTexture(guid);
+	if (scene)
+		invalidate_texture_users({&guid, 1});
+}
+
+void SceneRenderer::invalidate_texture_users(eastl::span<const Engine::GUID> guids)
+{
+	auto view = scene->registry.view<MeshRendererComponent>();
+	for (entt::entity entity : view)
+	{
+		MeshRendererComponent &mesh_renderer = view.get<MeshRendererComponent>(entity);
+		for (int i = 0; i < mesh_renderer.meshes.size(); i++)
+		{
+			Material *material = mesh_renderer.getMaterial(i);
+			if (!material || eastl::none_of(guids.begin(), guids.end(), [material](Engine::GUID guid) { return material->usesTexture(guid); }))
+				continue;
+
+			material->invalidateTextures();
+			scene->markDirty(entity, DIRTY_MATERIAL);
+		}
+	}
+
+	auto uses_textures = [guids](Material *material)
+	{
+		if (eastl::none_of(guids.begin(), guids.end(), [material](Engine::GUID guid) { return material->usesTexture(guid); }))
+			return false;
+		material->invalidateTextures();
+		return true;
+	};
+	invalidate_prefab_records(uses_textures);
+
+	auto prefab_view = scene->registry.view<PrefabInstanceComponent>();
+	for (entt::entity entity : prefab_view)
+	{
+		PrefabInstanceComponent &prefab_instance = prefab_view.get<PrefabInstanceComponent>(entity);
+		for (PrefabOverride &part_override : prefab_instance.overrides)
+		{
+			Material *material = part_override.material.getMaterial();
+			if (material && uses_textures(material))
+				scene->markDirty(entity, DIRTY_MATERIAL);
+		}
 	}
 }
 
@@ -297,6 +593,7 @@ void SceneRenderer::render(Camera *camera, RHITextureRef result_texture)
 	frame_graph.importTexture(GFXRID(FinalTexture), result_texture);
 	frame_graph.importTexture(GFXRID(LutBRDF), lut_renderer.brdf_lut_texture);
 	geometry_streaming.importBuffers(frame_graph);
+	texture_streaming.importBuffers(frame_graph);
 
 	frustums_table.upload(frame_graph);
 	instances_table.upload(frame_graph);
@@ -366,6 +663,7 @@ void SceneRenderer::render_deferred(Camera *camera, FrameGraph &frame_graph)
 	}
 
 	geometry_streaming.addAgeFilterAndReadbackPasses(frame_graph);
+	texture_streaming.addReadbackPass(frame_graph);
 
 	{
 		// Lighting
@@ -417,6 +715,7 @@ void SceneRenderer::update(Camera *camera)
 		FrustumDataGPU frustum_data;
 		frustum_data.view_projection = camera->getProj() * camera->getView();
 		frustum_data.pass_mask = PASS_MASK_GBUFFER;
+		frustum_data.dynamic_pass_mask = PASS_MASK_GBUFFER;
 		frustums.push_back(frustum_data);
 
 		auto light_entities_id = Scene::getCurrentScene()->getEntitiesWith<LightComponent>();
@@ -434,6 +733,7 @@ void SceneRenderer::update(Camera *camera)
 			{
 				FrustumDataGPU frustum_data;
 				frustum_data.pass_mask = PASS_MASK_POINT_SHADOW;
+				frustum_data.dynamic_pass_mask = PASS_MASK_POINT_SHADOW_DYNAMIC;
 
 				eastl::vector<glm::mat4> faces_transforms;
 				faces_transforms.push_back(glm::lookAtLH(position, position + glm::vec3(1, 0, 0), glm::vec3(0, 1, 0)));
@@ -452,6 +752,7 @@ void SceneRenderer::update(Camera *camera)
 			{
 				FrustumDataGPU frustum_data;
 				frustum_data.pass_mask = PASS_MASK_DIRECTIONAL_SHADOW;
+				frustum_data.dynamic_pass_mask = PASS_MASK_DIRECTIONAL_SHADOW_DYNAMIC;
 				frustum_data.is_ortho = true;
 
 				for (int i = 0; i < SHADOW_MAP_CASCADE_COUNT; i++)
@@ -466,12 +767,20 @@ void SceneRenderer::update(Camera *camera)
 
 		geometry_streaming.update();
 
+		texture_streaming.update();
+		const eastl::vector<Engine::GUID> &changed_textures = texture_streaming.getChangedTextures();
+		if (!changed_textures.empty())
+			invalidate_texture_users(eastl::span<const Engine::GUID>(changed_textures.data(), changed_textures.size()));
+
 		static bool last_render_lighting_only = render_lighting_only;
 		if (last_render_lighting_only != render_lighting_only)
 		{
 			last_render_lighting_only = render_lighting_only;
 			for (entt::entity entity_id : scene->getEntitiesWith<MeshRendererComponent>())
 				scene->markDirty(entity_id, DIRTY_MATERIAL);
+			for (entt::entity entity_id : scene->getEntitiesWith<PrefabInstanceComponent>())
+				scene->markDirty(entity_id, DIRTY_MATERIAL);
+			invalidate_prefab_records([](Material *material) { return true; });
 			render_path_tracing_first_frame = true;
 		}
 
@@ -479,35 +788,83 @@ void SceneRenderer::update(Camera *camera)
 
 		for (entt::entity entity_id : scene->getDirtyList())
 		{
-			if (!scene->registry.valid(entity_id) || !scene->registry.all_of<MeshRendererComponent>(entity_id))
+			if (!scene->registry.valid(entity_id))
 				continue;
 
-			Entity entity(entity_id);
-			MeshRendererComponent &mesh_renderer = entity.getComponent<MeshRendererComponent>();
+			PrefabInstanceComponent *prefab_instance = scene->registry.try_get<PrefabInstanceComponent>(entity_id);
+			MeshRendererComponent *mesh_renderer = scene->registry.try_get<MeshRendererComponent>(entity_id);
+			if (!prefab_instance && !mesh_renderer)
+				continue;
 
 			uint32_t flags = scene->getDirtyFlags(entity_id);
 			if (flags & DIRTY_RENDER_STATE)
 			{
 				free_instances(entity_id);
-				if (mesh_renderer.meshes.empty())
-					continue;
+				if (prefab_instance)
+				{
+					if (!create_prefab_instances(entity_id, *prefab_instance))
+						continue;
+				} else
+				{
+					if (mesh_renderer->meshes.empty())
+						continue;
 
-				uint32_t count = mesh_renderer.meshes.size();
-				entity_instances[entity_id] = { instances_table.allocate(count), count };
+					uint32_t count = mesh_renderer->meshes.size();
+					entity_instances[entity_id] = { instances_table.allocate(count), count };
 
-				refresh_meshes(entity_id, mesh_renderer);
-				refresh_materials(entity_id, mesh_renderer);
+					refresh_meshes(entity_id, *mesh_renderer);
+					refresh_materials(entity_id, *mesh_renderer);
+				}
 				refresh_transforms(entity_id);
+				changed_static_bounds.push_back(entity_bounds[entity_id]);
 			} else if (flags & DIRTY_MATERIAL)
 			{
-				refresh_materials(entity_id, mesh_renderer);
+				if (prefab_instance)
+					refresh_prefab_materials(entity_id, *prefab_instance);
+				else
+					refresh_materials(entity_id, *mesh_renderer);
 			} else if (flags & DIRTY_TRANSFORM)
 			{
+				// Static object started moving, it leaves cached shadows and is drawn as dynamic until it settles
+				auto dynamic_it = dynamic_entities.find(entity_id);
+				if (dynamic_it == dynamic_entities.end())
+				{
+					auto bounds_it = entity_bounds.find(entity_id);
+					if (bounds_it != entity_bounds.end())
+						changed_static_bounds.push_back(bounds_it->second);
+					dynamic_entities[entity_id] = 0;
+				} else
+				{
+					dynamic_it->second = 0;
+				}
+
 				refresh_transforms(entity_id);
 				moved_this_frame.insert(entity_id);
 			}
 		}
 
+		for (auto &[prefab, records] : prefab_records)
+		{
+			if (records.is_dirty)
+				refresh_prefab_records(prefab);
+		}
+
+		// Settled objects are baked back into cached shadows
+		eastl::vector<entt::entity> settled_entities;
+		for (auto &[entity_id, frames_still] : dynamic_entities)
+		{
+			if (moved_this_frame.find(entity_id) != moved_this_frame.end())
+				continue;
+			if (++frames_still >= DYNAMIC_SETTLE_FRAMES)
+				settled_entities.push_back(entity_id);
+		}
+		for (entt::entity entity_id : settled_entities)
+		{
+			dynamic_entities.erase(entity_id);
+			refresh_transforms(entity_id);
+			changed_static_bounds.push_back(entity_bounds[entity_id]);
+		}
+
 		// Reupload moved objects old transformation once more (so old_position would be the same as position)
 		for (entt::entity entity_id : moved_last_frame_entities)
 		{
@@ -517,67 +874,59 @@ void SceneRenderer::update(Camera *camera)
 		}
 		moved_last_frame_entities = moved_this_frame;
 
-		indirect_draw_calls_max_count = instances_table.getMaxUsedSlot();
-		scene->clearDirty();
-
-		if (engine_ray_tracing && rt_scene)
-			rt_scene->update(camera);
-
-		if (render_meshlets_bvh_visualize)
+		if (GFXOPTIONS(shadows).enabled)
 		{
-			auto depthColor = [](int depth) -> glm::vec3
-			{
-				static const glm::vec3 palette[] = {
-					{1.f, 0.f, 0.f}, {0.f, 1.f, 0.f}, {0.f, 0.f, 1.f},
-					{1.f, 1.f, 0.f}, {1.f, 0.f, 1.f}, {0.f, 1.f, 1.f},
-				};
-				return palette[depth % (sizeof(palette) / sizeof(palette[0]))];
-			};
+			eastl::vector<BoundBox> dynamic_bounds;
+			dynamic_bounds.reserve(dynamic_entities.size());
+			for (auto &[entity_id, frames_still] : dynamic_entities)
+				dynamic_bounds.push_back(entity_bounds[entity_id]);
+			shadow_renderer.invalidateCaches(changed_static_bounds, dynamic_bounds);
+		}
 
-			int target_depth = render_meshlets_bvh_visualize_depth;
+		if (GFXOPTIONS(ddgi).enabled)
+		{
+			// Probes near changed geometry and lights are updated sooner, the changes are seen next frame
+			for (const BoundBox &bounds : changed_static_bounds)
+				ddgi_renderer.markSceneChanged(bounds);
+			for (auto &[entity_id, frames_still] : dynamic_entities)
+				ddgi_renderer.markSceneChanged(entity_bounds[entity_id]);
 
-			auto view = scene->getEntitiesWith<TransformComponent, MeshRendererComponent>();
-			for (entt::entity entity_id : view)
+			for (entt::entity entity_id : scene->getDirtyList())
 			{
-				auto &transform = view.get<TransformComponent>(entity_id);
-				auto &mesh_renderer = view.get<MeshRendererComponent>(entity_id);
-				for (int i = 0; i < mesh_renderer.meshes.size(); i++)
-				{
-					const Engine::Mesh *mesh = mesh_renderer.meshes[i].getMesh();
-					if (!mesh || !mesh->meshlet_data)
-						continue;
-
-					glm::mat4 world = transform.getWorldTransform();
-					float uniform_scale = glm::length(glm::vec3(world[0]));
-
-					struct VisItem { uint32_t node_idx; int depth; };
-					eastl::queue<VisItem> q;
-					q.push({mesh->meshlet_data->meshlet_root_group_local_offset, 0});
+				if (!scene->registry.valid(entity_id) || !scene->registry.all_of<LightComponent>(entity_id))
+					continue;
 
-					while (!q.empty())
-					{
-						auto [idx, depth] = q.front();
-						q.pop();
-						const LodNode &node = mesh->meshlet_data->lod_nodes[idx];
+				Entity entity(entity_id);
+				auto &light = entity.getComponent<LightComponent>();
+				if (light.getType() == LIGHT_TYPE_DIRECTIONAL)
+				{
+					ddgi_renderer.markAllSceneChanged();
+				} else
+				{
+					glm::vec3 position = glm::vec3(entity.getWorldTransformMatrix()[3]);
+					ddgi_renderer.markSceneChanged(BoundBox(position - glm::vec3(light.attenuation_radius), position + glm::vec3(light.attenuation_radius)));
+				}
+			}
+		}
+		changed_static_bounds.clear();
 
-						bool is_leaf = (node.child_count == 0);
-						bool draw = (target_depth < 0) ? !is_leaf : (depth == target_depth);
+		// Any change can move or stream in BVH meshes, the list is not rebuilt while the scene is still
+		bool is_bvh_debug_list_stale = !scene->getDirtyList().empty() || bvh_debug_list_depth != render_meshlets_bvh_visualize_depth;
 
-						if (draw)
-						{
-							glm::vec3 wc = glm::vec3(world * glm::vec4(node.center, 1.f));
-							debug_renderer.addSphere(wc, node.radius * uniform_scale, 16, depthColor(depth));
-						}
+		indirect_draw_calls_max_count = instances_table.getMaxUsedSlot();
+		scene->clearDirty();
 
-						if (!is_leaf && (target_depth < 0 || depth < target_depth))
-						{
-							for (uint32_t c = 0; c < node.child_count; c++)
-								q.push({node.first_child + c, depth + 1});
-						}
-					}
+		if (engine_ray_tracing && rt_scene)
+			rt_scene->update(camera);
 
-				}
-			}
+		if (render_meshlets_bvh_visualize)
+		{
+			if (is_bvh_debug_list_stale)
+				rebuild_bvh_debug_list();
+			debug_renderer.addDrawList(&bvh_debug_list);
+		} else
+		{
+			bvh_debug_list_depth = INT32_MIN;
 		}
 	}
 
@@ -590,9 +939,71 @@ void SceneRenderer::update(Camera *camera)
 	uniforms.tlas_id = engine_ray_tracing ? rt_scene->getTopLevelAS()->getBindlessId() : 0;
 	uniforms.ddgi_volume_buffer_id = GFXOPTIONS(ddgi).enabled ? ddgi_renderer.getVolumeBufferId() : 0;
 	uniforms.lines_gpu_buffer_id = debug_renderer.getLinesGpuBuffer()->getUnorderedAccessView()->getBindlessIndex();
+	uniforms.debug_primitives_gpu_buffer_id = debug_renderer.getPrimitivesGpuBuffer()->getUnorderedAccessView()->getBindlessIndex();
+	uniforms.texture_feedback_buffer_id = texture_streaming.getFeedbackBufferBindlessId();
 	gDynamicRHI->setConstantBufferDataPerFrame(32, &uniforms, sizeof(uniforms));
 }
 
+void SceneRenderer::rebuild_bvh_debug_list()
+{
+	PROFILE_CPU_FUNCTION();
+
+	auto depthColor = [](int depth) -> glm::vec3
+	{
+		static const glm::vec3 palette[] = {
+			{1.f, 0.f, 0.f}, {0.f, 1.f, 0.f}, {0.f, 0.f, 1.f},
+			{1.f, 1.f, 0.f}, {1.f, 0.f, 1.f}, {0.f, 1.f, 1.f},
+		};
+		return palette[depth % (sizeof(palette) / sizeof(palette[0]))];
+	};
+
+	int target_depth = render_meshlets_bvh_visualize_depth;
+	bvh_debug_list_depth = target_depth;
+	bvh_debug_list.clear();
+
+	auto view = scene->getEntitiesWith<TransformComponent, MeshRendererComponent>();
+	for (entt::entity entity_id : view)
+	{
+		auto &transform = view.get<TransformComponent>(entity_id);
+		auto &mesh_renderer = view.get<MeshRendererComponent>(entity_id);
+		for (int i = 0; i < mesh_renderer.meshes.size(); i++)
+		{
+			const Engine::Mesh *mesh = mesh_renderer.meshes[i].getMesh();
+			if (!mesh || !mesh->meshlet_data)
+				continue;
+
+			const glm::mat4 &world = transform.getWorldTransform();
+
+			struct VisItem { uint32_t node_idx; int depth; };
+			eastl::queue<VisItem> q;
+			q.push({mesh->meshlet_data->meshlet_root_group_local_offset, 0});
+
+			while (!q.empty())
+			{
+				auto [idx, depth] = q.front();
+				q.pop();
+				const LodNode &node = mesh->meshlet_data->lod_nodes[idx];
+
+				bool is_leaf = (node.child_count == 0);
+				bool draw = (target_depth < 0) ? !is_leaf : (depth == target_depth);
+
+				if (draw)
+				{
+					glm::mat4 sphere_transform = glm::scale(glm::translate(world, glm::vec3(node.center)), glm::vec3(node.radius));
+					bvh_debug_list.addPrimitive(DEBUG_PRIMITIVE_SPHERE, sphere_transform, depthColor(depth));
+				}
+
+				if (!is_leaf && (target_depth < 0 || depth < target_depth))
+				{
+					for (uint32_t c = 0; c < node.child_count; c++)
+						q.push({node.first_child + c, depth + 1});
+				}
+			}
+
+		}
+	}
+}
+
 void SceneRenderer::gpu_frame_cull(FrameGraph &frame_graph)
 {
 	// Cull Instances
@@ -2,6 +2,7 @@
 #include "RHI/DynamicRHI.h"
 #include "Rendering/Mesh.h"
 #include "Rendering/GeometryStreaming.h"
+#include "Rendering/TextureStreaming.h"
 #include "Scene/Scene.h"
 #include "Scene/Components.h"
 #include "renderers/LutRenderer.h"
@@ -26,6 +27,7 @@
 #include "GpuTable.h"
 
 class Asset;
+class Prefab;
 
 class SceneRenderer : public RefCounted
 {
@@ -50,10 +52,24 @@ public:
 	void refresh_meshes(entt::entity entity_id, MeshRendererComponent &mesh_renderer);
 	void refresh_materials(entt::entity entity_id, MeshRendererComponent &mesh_renderer);
 	void refresh_transforms(entt::entity entity_id);
+	MeshGPU make_mesh_gpu(Engine::Mesh *mesh, Model *model);
+	MaterialGPU make_material_gpu(Material *material);
+
+	bool create_prefab_instances(entt::entity entity_id, PrefabInstanceComponent &prefab_instance);
+	void refresh_prefab_materials(entt::entity entity_id, PrefabInstanceComponent &prefab_instance);
+	void refresh_prefab_transforms(entt::entity entity_id, PrefabInstanceComponent &prefab_instance);
+	void acquire_prefab_records(Prefab *prefab);
+	void release_prefab_records(Prefab *prefab);
+	void refresh_prefab_records(Prefab *prefab);
+	void free_prefab_instances(Prefab *prefab);
+	void invalidate_prefab_records(const eastl::function<bool(Material *material)> &is_affected);
 
 	void on_asset_pre_reimport(Asset *asset);
 	void on_asset_post_reimport(Asset *asset);
+	void on_asset_pre_runtime_recreate(Engine::GUID guid);
+	void invalidate_texture_users(eastl::span<const Engine::GUID> guids);
 
+	void rebuild_bvh_debug_list();
 	void gpu_frame_cull(FrameGraph &frame_graph);
 
 	Camera *main_view_camera = nullptr;
@@ -61,6 +77,7 @@ public:
 	Ref<Scene> scene;
 	Ref<RayTracingScene> rt_scene;
 	GeometryStreaming geometry_streaming;
+	TextureStreaming texture_streaming;
 
 	eastl::vector<FrustumDataGPU> frustums;
 
@@ -68,6 +85,23 @@ public:
 	eastl::hash_map<entt::entity, InstanceRange> entity_instances;
 	eastl::hash_set<entt::entity> moved_last_frame_entities;
 
+	// Mesh and material records of a prefab are shared by all its instances. Records are indexed by instance slots,
+	// so their range is reserved in the instances table and filled with invalid instances
+	struct PrefabRecords
+	{
+		InstanceRange range;
+		uint32_t users = 0;
+		bool is_dirty = false;
+	};
+	eastl::hash_map<Prefab *, PrefabRecords> prefab_records;
+	eastl::hash_map<entt::entity, Prefab *> entity_prefabs;
+	eastl::vector<InstanceGPU> prefab_instances_scratch;
+
+	// Entities moved recently are drawn in dynamic shadow passes instead of cached ones (value is frames since last move)
+	eastl::hash_map<entt::entity, uint32_t> dynamic_entities;
+	eastl::hash_map<entt::entity, BoundBox> entity_bounds;
+	eastl::vector<BoundBox> changed_static_bounds;
+
 	GpuTable<FrustumDataGPU> frustums_table;
 	GpuTable<MaterialGPU> materials_table;
 	GpuTable<MeshGPU> meshes_table;
@@ -86,6 +120,9 @@ public:
 	DefferedCompositeRenderer deffered_composite_renderer;
 	PostProcessingRenderer post_renderer;
 	DebugRenderer debug_renderer;
+	// Meshlet BVH spheres, kept while the scene does not change
+	DebugDrawList bvh_debug_list;
+	int32_t bvh_debug_list_depth = INT32_MIN;
 
 	SSAORenderer ssao_renderer;
 	SSRRenderer ssr_renderer;
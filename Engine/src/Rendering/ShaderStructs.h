@@ -3,6 +3,9 @@
 #define PASS_MASK_GBUFFER 1 << 1
 #define PASS_MASK_DIRECTIONAL_SHADOW 1 << 2
 #define PASS_MASK_POINT_SHADOW 1 << 3
+// Dynamic casters are drawn on top of cached static shadow maps
+#define PASS_MASK_DIRECTIONAL_SHADOW_DYNAMIC 1 << 4
+#define PASS_MASK_POINT_SHADOW_DYNAMIC 1 << 5
 
 struct MaterialGPU
 {
@@ -17,6 +20,7 @@ struct MaterialGPU
 };
 
 #define INSTANCE_FLAG_INVALID 0x1
+#define INSTANCE_FLAG_DYNAMIC 0x2
 
 struct InstanceGPU
 {
@@ -115,6 +119,10 @@ struct Meshlet
 static constexpr uint32_t PINNED_GROUP_AGE = 0xFFFFFFFFu;
 static constexpr uint32_t MAX_STREAMING_REQUESTS = 1024;
 static constexpr uint32_t MAX_UNLOAD_REQUESTS = 1024;
+
+// Texture feedback: finest sampled mip + TEXTURE_FEEDBACK_MIP_BIAS per bindless index, so magnified textures report below 0
+static constexpr uint32_t TEXTURE_FEEDBACK_NONE = 0xFFFFFFFFu;
+static constexpr uint32_t TEXTURE_FEEDBACK_MIP_BIAS = 16;
 struct GroupResidency
 {
 	uint32_t geometry_buffer_offset; // byte offset in global geometry buffer
@@ -125,7 +133,18 @@ struct FrustumDataGPU
 	glm::mat4 view_projection;
 	uint32_t pass_mask;
 	uint32_t is_ortho = 0;
-	uint32_t pad[2];
+	uint32_t dynamic_pass_mask; // used instead of pass_mask for instances with INSTANCE_FLAG_DYNAMIC
+	uint32_t pad;
+};
+
+struct PointLightGPU
+{
+	glm::vec4 position;
+	glm::vec4 intensity;
+	float attenuation_radius_sqr;
+	float shadow_z_far;
+	uint32_t shadow_map_tex_id;
+	uint32_t pad;
 };
 
 struct DrawIndexedIndirect
@@ -150,4 +169,18 @@ struct DispatchIndirect
 	uint32_t group_x;
 	uint32_t group_y;
 	uint32_t group_z;
+};
+
+#define DEBUG_PRIMITIVE_LINE 0
+#define DEBUG_PRIMITIVE_BOX 1
+#define DEBUG_PRIMITIVE_SPHERE 2
+#define DEBUG_PRIMITIVE_TYPES_COUNT 3
+#define DEBUG_SPHERE_SEGMENTS 24
+#define MAX_GPU_DEBUG_PRIMITIVES 65536 // per type, appended by shaders every frame
+
+// Instanced wireframe shape: line goes from (0, 0, 0) to (1, 0, 0), box and sphere are unit ones (half extent and radius 1)
+struct DebugPrimitiveGPU
+{
+	glm::mat4 transform;
+	glm::vec4 color;
 };
\ No newline at end of file
@@ -0,0 +1,296 @@
+#include "pch.h"
+#include "TextureStreaming.h"
+#include "Core/Variables.h"
+#include "Utils/Image.h"
+#include "Assets/AssetManager.h"
+#include "RHI/BindlessResources.h"
+#include "RHI/RHIUploadBatch.h"
+#include "Rendering/UploadManager.h"
+#include "FrameGraph/FrameGraphData.h"
+
+namespace
+{
+constexpr uint32_t TAIL_MAX_SIZE = 128; // mips up to this size are always resident
+constexpr uint32_t FEEDBACK_BUFFER_SIZE = MAX_BINDLESS_RESOURCES * sizeof(uint32_t);
+
+RHIBufferRef create_storage_buffer(uint32_t size, BufferUsage usage, bool use_staging, const char *debug_name)
+{
+	BufferDescription desc;
+	desc.size = size;
+	desc.usage = usage;
+	desc.use_staging_buffer = use_staging;
+	desc.storage_stride = sizeof(uint32_t);
+	RHIBufferRef buffer = gDynamicRHI->createBuffer(desc);
+	buffer->setDebugName(debug_name);
+	return buffer;
+}
+
+uint32_t calc_tail_mip(const Image &image)
+{
+	uint32_t mip = 0;
+	while (mip + 1 < image.getMipLevels() && eastl::max(image.getWidth(mip), image.getHeight(mip)) > TAIL_MAX_SIZE)
+		mip++;
+	return mip;
+}
+
+void resolve_slot_compression(const std::filesystem::path &path, TextureCompression slot_compression)
+{
+	AssetMetadata &metadata = AssetManager::getMetadata(path);
+	if (!metadata.isValid() || metadata.type != AssetManager::getTypeInfo<RHITexture>())
+		return;
+
+	TextureImportSettings &settings = metadata.getImportSettings<TextureImportSettings>();
+	if (settings.slot_compression == TEXTURE_COMPRESSION_NONE && slot_compression != TEXTURE_COMPRESSION_NONE)
+	{
+		settings.slot_compression = slot_compression;
+		AssetManager::saveMetadata(metadata);
+	}
+
+	// Image loads the source when runtime is stale, it must be cooked with the new compression first
+	if (!AssetManager::hasValidRuntime(path))
+		AssetManager::recreateRuntime(path);
+}
+
+// Creates the texture with mips first_mip..last, data is uploaded with the current upload batch
+RHITextureRef create_texture(Image &image, Format format, uint32_t first_mip, const char *debug_name)
+{
+	TextureDescription desc{};
+	desc.width = eastl::max(image.getWidth(first_mip), 1u);
+	desc.height = eastl::max(image.getHeight(first_mip), 1u);
+	desc.mip_levels = image.getMipLevels() - first_mip;
+	desc.format = (format == FORMAT_UNDEFINED || image.isCompressedFormat()) ? image.getFormat() : format;
+	desc.usage_flags = TEXTURE_USAGE_TRANSFER_SRC;
+
+	RHITextureRef texture = gDynamicRHI->createTexture(desc);
+	texture->setDebugName(debug_name);
+	texture->fill();
+
+	uint64_t offset = 0;
+	for (uint32_t i = 0; i < first_mip; i++)
+		offset += image.getImageSize(i);
+	RHIUploadBatch::enqueueTexture(texture, image.getData().data() + offset);
+	return texture;
+}
+}
+
+void TextureStreaming::init()
+{
+	feedback_gpu = create_storage_buffer(FEEDBACK_BUFFER_SIZE, BufferUsage::SHADER_WRITE_BUFFER, true, "Texture Feedback Buffer");
+	for (int i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+		feedback_readback[i] = create_storage_buffer(FEEDBACK_BUFFER_SIZE, BufferUsage::READBACK_BUFFER, false, "Texture Feedback Readback");
+}
+
+uint32_t TextureStreaming::requestTexture(const AssetReference &reference, Format format, TextureCompression slot_compression)
+{
+	auto it = slot_by_texture.find({reference.guid, format});
+	if (it != slot_by_texture.end())
+		return textures[it->second].texture->getShaderResourceView()->getBindlessIndex();
+
+	std::filesystem::path path = AssetManager::getPath(reference);
+	if (path.empty())
+		return 0;
+
+	PROFILE_CPU_FUNCTION();
+	resolve_slot_compression(path, slot_compression);
+	auto image = std::make_unique<Image>(path.string().c_str());
+	if (image->getData().empty())
+		return 0;
+
+	uint32_t slot;
+	if (free_slots.empty())
+	{
+		slot = textures.size();
+		textures.emplace_back();
+	} else
+	{
+		slot = free_slots.back();
+		free_slots.pop_back();
+	}
+	slot_by_texture[{reference.guid, format}] = slot;
+
+	StreamedTexture &streamed = textures[slot];
+	streamed.guid = reference.guid;
+	streamed.format = format;
+	streamed.all_mips_size = image->getImageSize();
+
+	uint32_t tail_mip = calc_tail_mip(*image);
+	set_texture(slot, create_texture(*image, format, tail_mip, path.filename().string().c_str()), tail_mip);
+	stats.all_mips_bytes += streamed.all_mips_size;
+
+	if (tail_mip > 0)
+	{
+		eastl::vector<uint64_t> mip_sizes(image->getMipLevels());
+		for (uint32_t i = 0; i < mip_sizes.size(); i++)
+			mip_sizes[i] = image->getImageSize(i);
+		policy.addTexture(slot, eastl::span<const uint64_t>(mip_sizes.data(), mip_sizes.size()), tail_mip);
+		(image->isMapped() ? stats.source_mapped_bytes : stats.source_heap_bytes) += streamed.all_mips_size;
+		streamed.image = std::move(image);
+	} else
+	{
+		// Whole texture is the tail, nothing to stream
+		unstreamed_bytes += streamed.all_mips_size;
+	}
+
+	stats.streamed_textures = slot_by_texture.size();
+	return streamed.texture->getShaderResourceView()->getBindlessIndex();
+}
+
+void TextureStreaming::releaseTexture(Engine::GUID guid)
+{
+	for (auto it = slot_by_texture.begin(); it != slot_by_texture.end(); )
+	{
+		if (it->first.first != guid)
+		{
+			++it;
+			continue;
+		}
+
+		uint32_t slot = it->second;
+		StreamedTexture &streamed = textures[slot];
+		stats.all_mips_bytes -= eastl::min(stats.all_mips_bytes, streamed.all_mips_size);
+		if (streamed.image)
+		{
+			policy.removeTexture(slot);
+			uint64_t &source_bytes = streamed.image->isMapped() ? stats.source_mapped_bytes : stats.source_heap_bytes;
+			source_bytes -= eastl::min(source_bytes, streamed.all_mips_size);
+		} else
+			unstreamed_bytes -= eastl::min(unstreamed_bytes, streamed.all_mips_size);
+
+		// Slot can be reused before pending releases expire, its old indices must not report to the new texture
+		for (auto target = feedback_targets.begin(); target != feedback_targets.end(); )
+			target = target->second.slot == slot ? feedback_targets.erase(target) : eastl::next(target);
+
+		retire_texture(streamed.texture);
+		streamed = StreamedTexture();
+		free_slots.push_back(slot);
+		it = slot_by_texture.erase(it);
+	}
+	stats.streamed_textures = slot_by_texture.size();
+}
+
+void TextureStreaming::set_texture(uint32_t slot, RHITextureRef texture, uint32_t first_mip)
+{
+	StreamedTexture &streamed = textures[slot];
+	if (streamed.texture)
+		retire_texture(streamed.texture);
+
+	streamed.texture = texture;
+	streamed.first_mip = first_mip;
+	feedback_targets[texture->getShaderResourceView()->getBindlessIndex()] = {slot, first_mip};
+}
+
+void TextureStreaming::retire_texture(RHITextureRef texture)
+{
+	// Frames in flight may still sample it, the bindless index must not be reused until they finish
+	pending_releases.push_back({texture, texture->getShaderResourceView()->getBindlessIndex(), gDynamicRHI->getFrame()});
+}
+
+void TextureStreaming::update()
+{
+	PROFILE_CPU_FUNCTION();
+	stats.upgrades_last_frame = 0;
+	stats.downgrades_last_frame = 0;
+	stats.bytes_uploaded_last_frame = 0;
+	changed_textures.clear();
+
+	int frame_in_flight = gDynamicRHI->getFrameInFlight();
+	if (gDynamicRHI->getFrame() >= MAX_FRAMES_IN_FLIGHT && is_readback_written[frame_in_flight])
+		process_feedback(frame_in_flight);
+	is_readback_written[frame_in_flight] = false;
+
+	process_pending_releases();
+
+	stats.budget_bytes = (uint64_t)eastl::max(render_streaming_texture_budget_mb.get(), 0) * 1024 * 1024;
+
+	changes.clear();
+	policy.schedule(stats.budget_bytes - eastl::min(stats.budget_bytes, unstreamed_bytes), gDynamicRHI->getFrame(), changes);
+	if (!changes.empty())
+	{
+		RHIUploadBatch::Scope upload_scope;
+		for (const TextureStreamingPolicy::Change &change : changes)
+		{
+			StreamedTexture &streamed = textures[change.texture];
+			set_texture(change.texture, create_texture(*streamed.image, streamed.format, change.first_mip, streamed.texture->getDebugName()), change.first_mip);
+			changed_textures.push_back(streamed.guid);
+
+			if (change.first_mip < change.previous_mip)
+			{
+				stats.upgrades_last_frame++;
+				stats.total_upgrades++;
+			} else
+			{
+				stats.downgrades_last_frame++;
+				stats.total_downgrades++;
+			}
+			stats.bytes_uploaded_last_frame += change.size;
+			stats.total_bytes_uploaded += change.size;
+		}
+	}
+	stats.resident_bytes = unstreamed_bytes + policy.getResidentBytes();
+	stats.pending_releases = pending_releases.size();
+
+	// No request is 0xFFFFFFFF, pixels write with InterlockedMin
+	gUploadManager->queueUpload(GFXRID(TextureFeedbackBuffer), 0, FEEDBACK_BUFFER_SIZE, [](uint8_t *dst)
+	{
+		memset(dst, 0xFF, FEEDBACK_BUFFER_SIZE);
+	});
+}
+
+void TextureStreaming::importBuffers(FrameGraph &frame_graph)
+{
+	frame_graph.importBuffer(GFXRID(TextureFeedbackBuffer), feedback_gpu);
+}
+
+void TextureStreaming::addReadbackPass(FrameGraph &frame_graph)
+{
+	frame_graph.addCallbackPass("Texture Feedback Readback Copy",
+	[](RenderPassBuilder &builder)
+	{
+		builder.writeBuffer(GFXRID(TextureFeedbackBuffer));
+		builder.setSideEffect(true);
+	},
+	[this](const RenderPassResources &, RHICommandList *cmd_list)
+	{
+		int frame_in_flight = gDynamicRHI->getFrameInFlight();
+		cmd_list->copyBuffer(feedback_gpu, feedback_readback[frame_in_flight], 0, 0, FEEDBACK_BUFFER_SIZE);
+		is_readback_written[frame_in_flight] = true;
+	});
+}
+
+uint32_t TextureStreaming::getFeedbackBufferBindlessId() const
+{
+	return feedback_gpu->getUnorderedAccessView()->getBindlessIndex();
+}
+
+void TextureStreaming::process_feedback(int frame)
+{
+	PROFILE_CPU_FUNCTION();
+	void *mapped;
+	feedback_readback[frame]->map(&mapped);
+	const uint32_t *feedback = (const uint32_t *)mapped;
+
+	for (const auto &[bindless_id, target] : feedback_targets)
+	{
+		uint32_t value = feedback[bindless_id];
+		if (value == TEXTURE_FEEDBACK_NONE || !textures[target.slot].image)
+			continue;
+
+		// Shaders see only the resident mips, their mip 0 is first_mip of the full texture
+		int desired_mip = (int)target.first_mip + (int)value - (int)TEXTURE_FEEDBACK_MIP_BIAS;
+		policy.onFeedback(target.slot, (uint32_t)eastl::max(desired_mip, 0), gDynamicRHI->getFrame());
+	}
+
+	feedback_readback[frame]->unmap();
+}
+
+void TextureStreaming::process_pending_releases()
+{
+	auto expired = eastl::remove_if(pending_releases.begin(), pending_releases.end(), [&](const PendingRelease &release)
+	{
+		if (gDynamicRHI->getFrame() - release.frame <= MAX_FRAMES_IN_FLIGHT)
+			return false;
+		feedback_targets.erase(release.bindless_id);
+		return true;
+	});
+	pending_releases.erase(expired, pending_releases.end());
+}
@@ -0,0 +1,99 @@
+#pragma once
+#include "RHI/DynamicRHI.h"
+#include "RHI/RHIBuffer.h"
+#include "RHI/RHITexture.h"
+#include "ShaderStructs.h"
+#include "Renderer.h"
+#include "FrameGraph/FrameGraph.h"
+#include "Core/GUID.h"
+#include "TextureStreamingPolicy.h"
+#include "Assets/TextureImportSettings.h"
+
+class Image;
+
+// Material textures are created with only their low mip tail resident. The gbuffer pass reports the finest mip
+// it samples per bindless index into a feedback buffer, finer mips are uploaded (or dropped) within a VRAM budget.
+// A change recreates the texture with the new mip range, so its bindless index changes and users are listed in getChangedTextures().
+class TextureStreaming
+{
+public:
+	void init();
+	// Returns bindless index of the texture SRV, 0 if it can't be loaded.
+	// Textures with Auto compression are cooked with slot_compression of the first slot that requests them.
+	uint32_t requestTexture(const AssetReference &reference, Format format, TextureCompression slot_compression);
+	// Forgets the texture (e.g. source was reimported), the next request loads it again
+	void releaseTexture(Engine::GUID guid);
+	void update();
+	void importBuffers(FrameGraph &frame_graph);
+	void addReadbackPass(FrameGraph &frame_graph);
+
+	uint32_t getFeedbackBufferBindlessId() const;
+	// Textures recreated by the last update(), materials using them must take the new bindless index
+	const eastl::vector<Engine::GUID> &getChangedTextures() const { return changed_textures; }
+
+	struct Stats
+	{
+		uint32_t streamed_textures = 0;
+		uint32_t pending_releases = 0;
+		uint64_t resident_bytes = 0;
+		uint64_t budget_bytes = 0;
+		uint64_t all_mips_bytes = 0; // resident size if every mip was loaded
+		uint64_t source_mapped_bytes = 0; // kept sources of finer mips, paged in from runtime files on upload
+		uint64_t source_heap_bytes = 0; // kept sources that were not cooked to .dds and live on the heap
+
+		uint32_t upgrades_last_frame = 0;
+		uint32_t downgrades_last_frame = 0;
+		uint64_t bytes_uploaded_last_frame = 0;
+
+		uint64_t total_upgrades = 0;
+		uint64_t total_downgrades = 0;
+		uint64_t total_bytes_uploaded = 0;
+	};
+	const Stats &getStats() const { return stats; }
+
+private:
+	struct StreamedTexture
+	{
+		Engine::GUID guid = 0;
+		Format format = FORMAT_UNDEFINED;
+		std::unique_ptr<Image> image; // source of finer mips (mapped .dds runtime), null when the whole texture fits in the tail
+		RHITextureRef texture;
+		uint32_t first_mip = 0;
+		uint64_t all_mips_size = 0;
+	};
+
+	// Bindless index of every live texture view, readbacks may still report indices of textures that are being released
+	struct FeedbackTarget
+	{
+		uint32_t slot;
+		uint32_t first_mip;
+	};
+
+	struct PendingRelease
+	{
+		RHITextureRef texture;
+		uint32_t bindless_id;
+		uint64_t frame;
+	};
+
+	void process_feedback(int frame);
+	void process_pending_releases();
+	void set_texture(uint32_t slot, RHITextureRef texture, uint32_t first_mip);
+	void retire_texture(RHITextureRef texture);
+
+	eastl::vector<StreamedTexture> textures;
+	eastl::vector<uint32_t> free_slots;
+	eastl::map<eastl::pair<Engine::GUID, Format>, uint32_t> slot_by_texture;
+	eastl::hash_map<uint32_t, FeedbackTarget> feedback_targets;
+	eastl::vector<PendingRelease> pending_releases;
+	eastl::vector<Engine::GUID> changed_textures;
+
+	uint64_t unstreamed_bytes = 0; // textures small enough to be only the tail
+	TextureStreamingPolicy policy;
+	eastl::vector<TextureStreamingPolicy::Change> changes;
+	Stats stats;
+
+	RHIBufferRef feedback_gpu;
+	RHIBufferRef feedback_readback[MAX_FRAMES_IN_FLIGHT];
+	bool is_readback_written[MAX_FRAMES_IN_FLIGHT] = {};
+};
@@ -0,0 +1,177 @@
+#include "pch.h"
+#include "TextureStreamingPolicy.h"
+#include <EASTL/priority_queue.h>
+
+void TextureStreamingPolicy::addTexture(uint32_t texture, eastl::span<const uint64_t> mip_sizes, uint32_t tail_mip)
+{
+	ENGINE_ASSERT(!mip_sizes.empty() && tail_mip < mip_sizes.size());
+	Texture &entry = textures[texture];
+	entry.mip_tail_sizes.resize(mip_sizes.size());
+	uint64_t size = 0;
+	for (int i = (int)mip_sizes.size() - 1; i >= 0; i--)
+	{
+		size += mip_sizes[i];
+		entry.mip_tail_sizes[i] = size;
+	}
+	entry.tail_mip = tail_mip;
+	entry.resident_mip = tail_mip;
+	entry.wanted_mip = tail_mip;
+	entry.wanted_frame = 0;
+	resident_bytes += entry.getSize(tail_mip);
+}
+
+void TextureStreamingPolicy::removeTexture(uint32_t texture)
+{
+	auto it = textures.find(texture);
+	if (it == textures.end())
+		return;
+	resident_bytes -= eastl::min(resident_bytes, it->second.getSize(it->second.resident_mip));
+	textures.erase(it);
+}
+
+void TextureStreamingPolicy::onFeedback(uint32_t texture, uint32_t desired_mip, uint64_t frame)
+{
+	auto it = textures.find(texture);
+	if (it == textures.end())
+		return;
+
+	Texture &entry = it->second;
+	desired_mip = eastl::min(desired_mip, entry.tail_mip);
+	// Coarser reports don't override a finer one until it expires, pixels report only a sparse subset each frame
+	if (desired_mip <= entry.wanted_mip || frame - entry.wanted_frame > feedback_lifetime)
+	{
+		entry.wanted_mip = desired_mip;
+		entry.wanted_frame = frame;
+	}
+}
+
+uint32_t TextureStreamingPolicy::getResidentMip(uint32_t texture) const
+{
+	auto it = textures.find(texture);
+	return it != textures.end() ? it->second.resident_mip : UINT32_MAX;
+}
+
+void TextureStreamingPolicy::schedule(uint64_t budget_bytes, uint64_t frame, eastl::vector<Change> &changes)
+{
+	PROFILE_CPU_FUNCTION();
+	candidates.clear();
+	uint64_t total_bytes = 0;
+	for (const auto &[index, texture] : textures)
+	{
+		bool is_wanted = frame - texture.wanted_frame <= feedback_lifetime;
+		uint32_t wanted_mip = is_wanted ? texture.wanted_mip : texture.tail_mip;
+		uint32_t target_mip = eastl::min(wanted_mip, texture.resident_mip);
+		candidates.push_back({index, target_mip, wanted_mip, texture.wanted_frame});
+		total_bytes += texture.getSize(target_mip);
+	}
+
+	if (total_bytes > budget_bytes)
+	{
+		// Mips nobody wants anymore, least recently wanted first
+		eastl::sort(candidates.begin(), candidates.end(), [](const Candidate &a, const Candidate &b) { return a.wanted_frame < b.wanted_frame; });
+		uint64_t target_bytes = uint64_t(budget_bytes * (1.0f - hysteresis));
+		for (Candidate &candidate : candidates)
+		{
+			if (total_bytes <= target_bytes)
+				break;
+			if (candidate.target_mip >= candidate.wanted_mip)
+				continue;
+			const Texture &texture = textures[candidate.texture];
+			total_bytes -= texture.getSize(candidate.target_mip) - texture.getSize(candidate.wanted_mip);
+			candidate.target_mip = candidate.wanted_mip;
+		}
+
+		// Wanted mips don't fit either, drop the largest finest mips so texel density stays even
+		eastl::priority_queue<eastl::pair<uint64_t, uint32_t>> largest_mips;
+		auto finest_mip_size = [this](const Candidate &candidate)
+		{
+			const Texture &texture = textures[candidate.texture];
+			return texture.getSize(candidate.target_mip) - texture.getSize(candidate.target_mip + 1);
+		};
+		for (uint32_t i = 0; i < candidates.size(); i++)
+		{
+			if (candidates[i].target_mip < textures[candidates[i].texture].tail_mip)
+				largest_mips.push({finest_mip_size(candidates[i]), i});
+		}
+		while (total_bytes > budget_bytes && !largest_mips.empty())
+		{
+			auto [size, i] = largest_mips.top();
+			largest_mips.pop();
+
+			Candidate &candidate = candidates[i];
+			total_bytes -= size;
+			candidate.target_mip++;
+			if (candidate.target_mip < textures[candidate.texture].tail_mip)
+				largest_mips.push({finest_mip_size(candidate), i});
+		}
+	}
+
+	// Downgrades only free memory and are always applied, upgrades wait for upload bandwidth, most recently wanted first
+	eastl::sort(candidates.begin(), candidates.end(), [](const Candidate &a, const Candidate &b) { return a.wanted_frame > b.wanted_frame; });
+	uint64_t upload_bytes = 0;
+	bool has_upgrades = false;
+	for (int pass = 0; pass < 2; pass++)
+	{
+		bool is_upgrade_pass = pass == 1;
+		for (const Candidate &candidate : candidates)
+		{
+			Texture &texture = textures[candidate.texture];
+			if (candidate.target_mip == texture.resident_mip || (candidate.target_mip < texture.resident_mip) != is_upgrade_pass)
+				continue;
+
+			uint64_t size = texture.getSize(candidate.target_mip);
+			if (is_upgrade_pass)
+			{
+				if (has_upgrades && upload_bytes + size > max_upload_bytes_per_frame)
+					continue;
+				has_upgrades = true;
+			}
+
+			upload_bytes += size;
+			resident_bytes = resident_bytes - texture.getSize(texture.resident_mip) + size;
+			changes.push_back({candidate.texture, texture.resident_mip, candidate.target_mip, size});
+			texture.resident_mip = candidate.target_mip;
+		}
+	}
+}
+
+TextureStreamingPolicy::ReplayResult TextureStreamingPolicy::replay(TextureStreamingPolicy &policy, eastl::span<const ReplayFrame> frames, uint64_t budget_bytes)
+{
+	PROFILE_CPU_FUNCTION();
+	ReplayResult result;
+	eastl::vector<Change> changes;
+	result.peak_resident_bytes = policy.getResidentBytes();
+
+	for (uint64_t frame = 0; frame < frames.size(); frame++)
+	{
+		for (const ReplayFrame::Feedback &feedback : frames[frame].feedback)
+		{
+			result.requests++;
+			if (policy.getResidentMip(feedback.texture) <= feedback.desired_mip)
+				result.satisfied++;
+			policy.onFeedback(feedback.texture, feedback.desired_mip, frame);
+		}
+
+		changes.clear();
+		policy.schedule(budget_bytes, frame, changes);
+		uint32_t frame_upgrades = 0;
+		uint64_t frame_upgrade_bytes = 0;
+		for (const Change &change : changes)
+		{
+			if (change.first_mip < change.previous_mip)
+			{
+				result.upgrades++;
+				frame_upgrades++;
+				frame_upgrade_bytes += change.size;
+			} else
+			{
+				result.downgrades++;
+			}
+			result.upload_bytes += change.size;
+		}
+		result.peak_resident_bytes = eastl::max(result.peak_resident_bytes, policy.getResidentBytes());
+		result.peak_frame_upgrades = eastl::max(result.peak_frame_upgrades, frame_upgrades);
+		result.peak_frame_upgrade_bytes = eastl::max(result.peak_frame_upgrade_bytes, frame_upgrade_bytes);
+	}
+	return result;
+}
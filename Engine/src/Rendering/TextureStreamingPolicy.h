@@ -0,0 +1,87 @@
+#pragma once
+#include <EASTL/span.h>
+#include <EASTL/vector.h>
+#include <EASTL/hash_map.h>
+
+// Decides which mips of streamed textures are resident.
+// Works only with texture indices and mip byte sizes, so scheduling can be replayed on the CPU with synthetic feedback.
+// Mip 0 is always the full resolution mip, a texture with first resident mip N holds mips N..last.
+class TextureStreamingPolicy
+{
+public:
+	float hysteresis = 0.1f;
+	uint32_t feedback_lifetime = 30; // frames a reported mip is kept wanted without being reported again
+	uint64_t max_upload_bytes_per_frame = 32 * 1024 * 1024; // at least one texture is changed per frame
+
+	// mip_sizes[i] is the byte size of mip i, tail_mip is the finest mip that is always resident
+	void addTexture(uint32_t texture, eastl::span<const uint64_t> mip_sizes, uint32_t tail_mip);
+	void removeTexture(uint32_t texture);
+	// Finest mip the GPU sampled this frame
+	void onFeedback(uint32_t texture, uint32_t desired_mip, uint64_t frame);
+
+	struct Change
+	{
+		uint32_t texture;
+		uint32_t previous_mip;
+		uint32_t first_mip;
+		uint64_t size; // resident bytes with the new first mip
+	};
+	// Appends textures whose first resident mip changes and treats them as changed right away.
+	// Textures keep mips nobody wants while everything fits, over budget stale mips go first and then
+	// the largest wanted mips are dropped until the wanted set fits too.
+	void schedule(uint64_t budget_bytes, uint64_t frame, eastl::vector<Change> &changes);
+
+	uint32_t getResidentMip(uint32_t texture) const; // UINT32_MAX for unknown textures
+	uint64_t getResidentBytes() const { return resident_bytes; }
+
+	struct ReplayFrame
+	{
+		struct Feedback
+		{
+			uint32_t texture;
+			uint32_t desired_mip;
+		};
+		eastl::vector<Feedback> feedback; // what the GPU would report this frame
+	};
+
+	struct ReplayResult
+	{
+		uint64_t requests = 0;
+		uint64_t satisfied = 0; // requests with the desired mip (or finer) already resident
+		uint64_t upgrades = 0;
+		uint64_t downgrades = 0;
+		uint64_t upload_bytes = 0;
+		uint64_t peak_resident_bytes = 0;
+		uint32_t peak_frame_upgrades = 0;
+		uint64_t peak_frame_upgrade_bytes = 0;
+
+		float getSatisfiedRate() const { return requests > 0 ? (float)satisfied / requests : 1.0f; }
+	};
+
+	// Replays synthetic feedback against textures already added to the policy, changes are applied at the end of the
+	// frame the same way TextureStreaming applies them. Textures are recreated on change, so every change is uploaded.
+	static ReplayResult replay(TextureStreamingPolicy &policy, eastl::span<const ReplayFrame> frames, uint64_t budget_bytes);
+
+private:
+	struct Texture
+	{
+		eastl::vector<uint64_t> mip_tail_sizes; // [i] is the size of mips i..last
+		uint32_t tail_mip = 0;
+		uint32_t resident_mip = 0;
+		uint32_t wanted_mip = 0;
+		uint64_t wanted_frame = 0;
+
+		uint64_t getSize(uint32_t first_mip) const { return mip_tail_sizes[first_mip]; }
+	};
+	eastl::hash_map<uint32_t, Texture> textures;
+	uint64_t resident_bytes = 0;
+
+	struct Candidate
+	{
+		uint32_t texture;
+		uint32_t target_mip;
+		uint32_t wanted_mip;
+		uint64_t wanted_frame;
+	};
+	eastl::vector<Candidate> candidates;
+};
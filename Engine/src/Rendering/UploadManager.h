@@ -23,6 +23,8 @@ public:
 
 	// Sub allocate from staging buffer
 	StagedRange stage(uint32_t size);
+	// Bytes staged since beginFrame
+	uint32_t getStagedBytes() const { return ring_offset; }
 
 	bool queueUpload(GraphicsResourceName dst, uint32_t dst_offset, const void *data, uint32_t size);
 
@@ -1,6 +1,7 @@
 #include "pch.h"
 #include "Components.h"
 #include "Rendering/Model.h"
+#include "Scene/Prefab.h"
 #include "Assets/AssetManager.h"
 
 Model *MeshRendererComponent::MeshId::getModel()
@@ -66,6 +67,52 @@ void MeshRendererComponent::setFromMeshNode(Ref<Model> model, MeshNode *mesh_nod
 	}
 }
 
+Prefab *PrefabInstanceComponent::getPrefab()
+{
+	if (prefab && prefab_asset.guid.isValid() && prefab->guid != prefab_asset.guid)
+		prefab = nullptr;
+
+	if (!prefab && prefab_asset.isValid())
+		prefab = AssetManager::getAsset<Prefab>(prefab_asset).getReference();
+	return prefab;
+}
+
+const PrefabOverride *PrefabInstanceComponent::findOverride(uint32_t part) const
+{
+	for (const PrefabOverride &part_override : overrides)
+	{
+		if (part_override.part == part)
+			return &part_override;
+	}
+	return nullptr;
+}
+
+Material *PrefabInstanceComponent::getMaterial(uint32_t part)
+{
+	for (PrefabOverride &part_override : overrides)
+	{
+		if (part_override.part != part)
+			continue;
+		if (Material *material = part_override.material.getMaterial())
+			return material;
+	}
+
+	Prefab *prefab = getPrefab();
+	return prefab ? prefab->getMaterial(part) : nullptr;
+}
+
+bool PrefabInstanceComponent::hasMaterialOverride(uint32_t part) const
+{
+	const PrefabOverride *part_override = findOverride(part);
+	return part_override && part_override->material.material_asset.isValid();
+}
+
+bool PrefabInstanceComponent::isHidden(uint32_t part) const
+{
+	const PrefabOverride *part_override = findOverride(part);
+	return part_override && part_override->is_hidden;
+}
+
 glm::vec3 LightComponent::getPhotometricIntensity() const
 {
 	float luminance = glm::dot(color, glm::vec3(0.2126f, 0.7152f, 0.0722f));
@@ -10,6 +10,7 @@
 
 struct MeshNode;
 class Model;
+class Prefab;
 
 struct TransformComponent
 {
@@ -166,6 +167,42 @@ REFLECT_BEGIN(MeshRendererComponent)
 	REFLECT_FIELD(materials),
 REFLECT_END()
 
+struct PrefabOverride
+{
+	uint32_t part = 0; // index in prefab parts
+	bool is_hidden = false;
+	MeshRendererComponent::MaterialSlot material; // replaces material of the part when set
+};
+
+REFLECT_BEGIN(PrefabOverride)
+	REFLECT_FIELD(part),
+	REFLECT_FIELD(is_hidden).label("Hidden"),
+	REFLECT_FIELD(material),
+REFLECT_END()
+
+// Instance of a shared prefab, its nodes are not entities. Differences from the prefab are stored as overrides of its parts.
+// MeshRendererComponent of the same entity is not drawn
+struct PrefabInstanceComponent
+{
+	AssetReference prefab_asset;
+	eastl::vector<PrefabOverride> overrides;
+
+	Prefab *getPrefab();
+	const PrefabOverride *findOverride(uint32_t part) const;
+	// Override material or material of the prefab
+	Material *getMaterial(uint32_t part);
+	bool hasMaterialOverride(uint32_t part) const;
+	bool isHidden(uint32_t part) const;
+
+private:
+	Prefab *prefab = nullptr;
+};
+
+REFLECT_BEGIN(PrefabInstanceComponent)
+	REFLECT_FIELD(prefab_asset).label("Prefab").asset<Prefab>(),
+	REFLECT_FIELD(overrides),
+REFLECT_END()
+
 enum LIGHT_TYPE
 {
 	LIGHT_TYPE_POINT,
@@ -202,7 +239,7 @@ struct LightComponent
 			description.width = shadow_map_size;
 			description.height = shadow_map_size;
 			description.format = FORMAT_D32S8;
-			description.usage_flags = TEXTURE_USAGE_ATTACHMENT;
+			description.usage_flags = TEXTURE_USAGE_ATTACHMENT | TEXTURE_USAGE_TRANSFER_SRC | TEXTURE_USAGE_TRANSFER_DST;
 			description.is_cube = true;
 			description.mip_levels = 1;
 			description.filtering = FILTER_NEAREST;
@@ -216,7 +253,7 @@ struct LightComponent
 			description.width = shadow_map_size;
 			description.height = shadow_map_size;
 			description.format = FORMAT_D32S8;
-			description.usage_flags = TEXTURE_USAGE_ATTACHMENT;
+			description.usage_flags = TEXTURE_USAGE_ATTACHMENT | TEXTURE_USAGE_TRANSFER_SRC | TEXTURE_USAGE_TRANSFER_DST;
 			description.is_cube = false;
 			description.mip_levels = 1;
 			description.array_levels = 4;
@@ -298,4 +335,4 @@ REFLECT_BEGIN(BoxColliderComponent)
 	REFLECT_FIELD(half_extent),
 REFLECT_END()
 
-#define ALL_COMPONENTS TransformComponent, MeshRendererComponent, LightComponent, RigidBodyComponent, BoxColliderComponent
\ No newline at end of file
+#define ALL_COMPONENTS TransformComponent, MeshRendererComponent, PrefabInstanceComponent, LightComponent, RigidBodyComponent, BoxColliderComponent
\ No newline at end of file
@@ -42,7 +42,10 @@ public:
 		auto &childs = getTransform().children;
 		auto found = eastl::find(childs.begin(), childs.end(), child);
 		if (found != childs.end())
+		{
 			childs.erase(found);
+			scene->markHierarchyChanged();
+		}
 	}
 
 	template<typename T, typename ...Args>
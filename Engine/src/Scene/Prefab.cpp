@@ -0,0 +1,143 @@
+#include "pch.h"
+#include "Prefab.h"
+#include "Rendering/Model.h"
+#include "Assets/AssetManager.h"
+
+static Ref<Asset> load_prefab(const std::filesystem::path &path)
+{
+	Ref<Prefab> prefab = new Prefab();
+	ReflectionYaml::loadFromFile(Reflected<Prefab>::getInfo(), prefab.getReference(), path);
+	prefab->build();
+	return prefab;
+}
+
+static const AssetTypeInfo *registered_prefab_type = []()
+{
+	AssetTypeInfo type{Reflected<Prefab>::name, {".prefab"}, load_prefab};
+	type.structInfo = &Reflected<Prefab>::getInfo();
+	return AssetManager::registerType<Prefab>(type);
+}();
+
+void Prefab::build()
+{
+	parts.clear();
+	is_bounds_valid = false;
+
+	eastl::vector<glm::mat4> transforms(nodes.size());
+	for (uint32_t i = 0; i < nodes.size(); i++)
+	{
+		const PrefabNode &node = nodes[i];
+		transforms[i] = node.getLocalTransform();
+		if (node.parent >= 0 && node.parent < (int32_t)i)
+			transforms[i] = transforms[node.parent] * transforms[i];
+
+		glm::mat4 inverse_transform = glm::inverse(transforms[i]);
+		for (uint32_t mesh = 0; mesh < node.meshes.size(); mesh++)
+			parts.push_back({i, mesh, transforms[i], inverse_transform});
+	}
+}
+
+void Prefab::reload()
+{
+	nodes.clear();
+	ReflectionYaml::loadFromFile(Reflected<Prefab>::getInfo(), this, AssetManager::getPath(guid));
+	build();
+}
+
+Model *Prefab::getModel(uint32_t part)
+{
+	return nodes[parts[part].node].meshes[parts[part].mesh].getModel();
+}
+
+Engine::Mesh *Prefab::getMesh(uint32_t part)
+{
+	return nodes[parts[part].node].meshes[parts[part].mesh].getMesh();
+}
+
+Material *Prefab::getMaterial(uint32_t part)
+{
+	PrefabNode &node = nodes[parts[part].node];
+	uint32_t mesh = parts[part].mesh;
+	if (mesh < node.materials.size())
+	{
+		if (Material *material = node.materials[mesh].getMaterial())
+			return material;
+	}
+
+	Model *model = node.meshes[mesh].getModel();
+	return model ? model->getMaterial(node.meshes[mesh].mesh_id) : nullptr;
+}
+
+BoundBox Prefab::getBounds()
+{
+	if (is_bounds_valid)
+		return bounds;
+
+	// Cached once every mesh is loaded
+	BoundBox result;
+	bool is_complete = true;
+	for (uint32_t i = 0; i < parts.size(); i++)
+	{
+		Engine::Mesh *mesh = getMesh(i);
+		if (!mesh)
+		{
+			is_complete = false;
+			continue;
+		}
+		result.extend(BoundBox(mesh->bound_box) * parts[i].transform);
+	}
+
+	bounds = result;
+	is_bounds_valid = is_complete;
+	return result;
+}
+
+Ref<Prefab> Prefab::createFromEntity(Entity root)
+{
+	PROFILE_CPU_FUNCTION();
+	Ref<Prefab> prefab = new Prefab();
+
+	struct StackEntry
+	{
+		entt::entity entity;
+		int32_t parent;
+	};
+	eastl::vector<StackEntry> stack;
+	stack.push_back({root, -1});
+	while (!stack.empty())
+	{
+		StackEntry entry = stack.back();
+		stack.pop_back();
+
+		Entity entity(entry.entity);
+		const TransformComponent &transform = entity.getTransform();
+		PrefabNode node;
+		node.name = transform.name;
+		node.parent = entry.parent;
+		if (entry.parent >= 0)
+		{
+			node.position = transform.getLocalPosition();
+			node.rotation = transform.getLocalRotation();
+			node.scale = transform.getLocalScale();
+		}
+		if (entity.hasComponent<MeshRendererComponent>())
+		{
+			const MeshRendererComponent &mesh_renderer = entity.getComponent<MeshRendererComponent>();
+			node.meshes = mesh_renderer.meshes;
+			node.materials = mesh_renderer.materials;
+		}
+
+		int32_t index = prefab->nodes.size();
+		prefab->nodes.push_back(node);
+		for (size_t i = transform.children.size(); i > 0; i--)
+			stack.push_back({transform.children[i - 1], index});
+	}
+
+	prefab->build();
+	return prefab;
+}
+
+bool Prefab::save(const std::filesystem::path &path) const
+{
+	return ReflectionYaml::saveToFile(Reflected<Prefab>::getInfo(), this, path);
+}
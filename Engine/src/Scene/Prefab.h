@@ -0,0 +1,72 @@
+#pragma once
+#include "Scene/Components.h"
+#include "Math/BoundBox.h"
+
+// Entity of a prefab subtree, parents go before their children
+struct PrefabNode
+{
+	eastl::string name;
+	int32_t parent = -1;
+	glm::vec3 position = glm::vec3(0, 0, 0);
+	glm::quat rotation = glm::identity<glm::quat>();
+	glm::vec3 scale = glm::vec3(1, 1, 1);
+	eastl::vector<MeshRendererComponent::MeshId> meshes;
+	eastl::vector<MeshRendererComponent::MaterialSlot> materials;
+
+	glm::mat4 getLocalTransform() const
+	{
+		return glm::translate(glm::mat4(1.0f), position) * glm::toMat4(rotation) * glm::scale(glm::mat4(1.0f), scale);
+	}
+};
+
+REFLECT_BEGIN(PrefabNode)
+	REFLECT_FIELD(name),
+	REFLECT_FIELD(parent),
+	REFLECT_FIELD(position),
+	REFLECT_FIELD(rotation),
+	REFLECT_FIELD(scale),
+	REFLECT_FIELD(meshes),
+	REFLECT_FIELD(materials),
+REFLECT_END()
+
+// Entity subtree shared by its instances (PrefabInstanceComponent), instances never change it.
+// An instance is a single entity, so a repeated building costs one transform and one serialized entity
+// instead of its whole subtree, and the renderer expands it into instance records of the parts in bulk
+class Prefab : public Asset
+{
+public:
+	eastl::vector<PrefabNode> nodes;
+
+	// One mesh of a node, transform is in prefab space (local space of the instance entity)
+	struct Part
+	{
+		uint32_t node;
+		uint32_t mesh; // index in node meshes
+		glm::mat4 transform;
+		glm::mat4 inverse_transform;
+	};
+
+	// Rebuilds parts after nodes were loaded or edited
+	void build();
+	void reload() override;
+
+	const eastl::vector<Part> &getParts() const { return parts; }
+	Model *getModel(uint32_t part);
+	Engine::Mesh *getMesh(uint32_t part);
+	Material *getMaterial(uint32_t part);
+	// Prefab space bounds of loaded part meshes
+	BoundBox getBounds();
+
+	// Captures the entity with its descendants, transform of the entity becomes prefab space
+	static Ref<Prefab> createFromEntity(Entity root);
+	bool save(const std::filesystem::path &path) const;
+
+private:
+	eastl::vector<Part> parts;
+	BoundBox bounds;
+	bool is_bounds_valid = false;
+};
+
+REFLECT_BEGIN(Prefab)
+	REFLECT_FIELD(nodes),
+REFLECT_END()
@@ -2,8 +2,10 @@
 #include "Scene.h"
 #include "Components.h"
 #include "Entity.h"
+#include "Prefab.h"
 #include "Utils/YamlExtensions.h"
 #include "Rendering/Renderer.h"
+#include "RHI/RHIUploadBatch.h"
 #include "Core/Variables.h"
 
 Ref<Scene> Scene::current_scene;
@@ -13,10 +15,28 @@ using namespace physx;
 Scene::Scene()
 {
 	physics_scene = new PhysicsScene(this);
+	markHierarchyChanged();
+	registry.on_construct<TransformComponent>().connect<&Scene::on_transform_constructed>(this);
+	registry.on_destroy<TransformComponent>().connect<&Scene::on_transform_destroyed>(this);
 }
 
 Scene::~Scene()
 {
+	registry.on_construct<TransformComponent>().disconnect<&Scene::on_transform_constructed>(this);
+	registry.on_destroy<TransformComponent>().disconnect<&Scene::on_transform_destroyed>(this);
+}
+
+void Scene::on_transform_constructed(entt::registry &registry, entt::entity entity)
+{
+	// New and copied entities get into the spatial index with the next clearDirty
+	markDirty(entity, DIRTY_TRANSFORM);
+	markHierarchyChanged();
+}
+
+void Scene::on_transform_destroyed(entt::registry &registry, entt::entity entity)
+{
+	spatial_index.remove(entity);
+	markHierarchyChanged();
 }
 
 Entity Scene::createEntity(eastl::string name)
@@ -57,13 +77,65 @@ void Scene::clearDirty()
 {
 	for (entt::entity entity_id : dirty_list)
 	{
+		if (!registry.valid(entity_id))
+			continue;
+
 		TransformComponent &transform = registry.get<TransformComponent>(entity_id);
 		transform.old_world_transform = transform.world_transform;
+
+		if (getDirtyFlags(entity_id) & (DIRTY_TRANSFORM | DIRTY_RENDER_STATE))
+			spatial_index.update(entity_id, getWorldBounds(entity_id));
 	}
 	dirty_flags.clear();
 	dirty_list.clear();
 }
 
+BoundBox Scene::getWorldBounds(entt::entity entity)
+{
+	const TransformComponent &transform = registry.get<TransformComponent>(entity);
+	const glm::mat4 &world_transform = transform.getWorldTransform();
+
+	BoundBox bounds;
+	if (MeshRendererComponent *mesh_renderer = registry.try_get<MeshRendererComponent>(entity))
+	{
+		for (MeshRendererComponent::MeshId &mesh_id : mesh_renderer->meshes)
+		{
+			if (Engine::Mesh *mesh = mesh_id.getMesh())
+				bounds.extend(BoundBox(mesh->bound_box) * world_transform);
+		}
+	}
+	if (PrefabInstanceComponent *prefab_instance = registry.try_get<PrefabInstanceComponent>(entity))
+	{
+		if (Prefab *prefab = prefab_instance->getPrefab())
+		{
+			BoundBox prefab_bounds = prefab->getBounds();
+			if (prefab_bounds.min.x <= prefab_bounds.max.x)
+				bounds.extend(prefab_bounds * world_transform);
+		}
+	}
+
+	// Lights, cameras and meshes that are not loaded yet can still be picked
+	if (bounds.min.x > bounds.max.x)
+	{
+		static constexpr float EMPTY_ENTITY_EXTENT = 0.25f;
+		glm::vec3 position = glm::vec3(world_transform[3]);
+		bounds = BoundBox(position - glm::vec3(EMPTY_ENTITY_EXTENT), position + glm::vec3(EMPTY_ENTITY_EXTENT));
+	}
+	return bounds;
+}
+
+void Scene::writeLocalTransforms(const eastl::vector<LocalTransformWrite> &writes)
+{
+	for (const LocalTransformWrite &write : writes)
+	{
+		TransformComponent &transform = registry.get<TransformComponent>(write.entity);
+		transform.local_position = write.position;
+		transform.local_rotation = write.rotation;
+		transform.local_rotation_euler = glm::eulerAngles(write.rotation);
+		propagate_local_transforms_update(write.entity);
+	}
+}
+
 Entity Scene::findEntityByName(eastl::string name)
 {
 	auto view = registry.view<TransformComponent>();
@@ -185,6 +257,9 @@ void Scene::loadFile(const eastl::string &filename)
 {
 	YAML::Node root = YAML::LoadFile(filename.c_str());
 
+	// Models and textures referenced by the scene are uploaded in one copy submission
+	RHIUploadBatch::Scope upload_scope;
+
 	for (auto entity : root["Entities"])
 	{
 		entt::entity entity_id = entt::null;
@@ -193,6 +268,7 @@ void Scene::loadFile(const eastl::string &filename)
 
 		read_components<ALL_COMPONENTS>(entity, createEntity("", entity_id));
 	}
+	markHierarchyChanged();
 
 	for (auto [entity_id, transform] : registry.view<TransformComponent>().each())
 	{
@@ -222,9 +298,9 @@ void Scene::closeScene()
 	current_scene = nullptr;
 }
 
-void Scene::updateRuntime()
+void Scene::updateRuntime(float delta_time, DebugRenderer *debug_renderer)
 {
-	physics_scene->simulate();
+	physics_scene->simulate(delta_time, debug_renderer);
 }
 
 void Scene::propagate_world_transforms_update(entt::entity entity_id)
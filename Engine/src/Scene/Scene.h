@@ -1,6 +1,7 @@
 #pragma once
 #include "entt/entt.hpp"
 #include "Physics/PhysicsScene.h"
+#include "Scene/SceneSpatialIndex.h"
 
 class Entity;
 
@@ -27,8 +28,27 @@ public:
 	void markDirty(entt::entity entity, uint32_t channels);
 	uint32_t getDirtyFlags(entt::entity entity) const;
 	const eastl::vector<entt::entity> &getDirtyList() const { return dirty_list; }
+	// Moves dirty entities in the spatial index, then clears the list
 	void clearDirty();
 
+	// Changes when entities are created, destroyed or reparented. Versions are unique across scenes,
+	// so cached views of the hierarchy compare the version alone
+	uint32_t getHierarchyVersion() const { return hierarchy_version; }
+	void markHierarchyChanged() { hierarchy_version = ++last_hierarchy_version; }
+
+	// World bounds of entities, as of the last clearDirty. Entities without meshes have a small box around their position
+	const SceneSpatialIndex &getSpatialIndex() const { return spatial_index; }
+	BoundBox getWorldBounds(entt::entity entity);
+
+	struct LocalTransformWrite
+	{
+		entt::entity entity;
+		glm::vec3 position;
+		glm::quat rotation;
+	};
+	// Writes position and rotation together, propagating each subtree only once
+	void writeLocalTransforms(const eastl::vector<LocalTransformWrite> &writes);
+
 	Ref<Scene> copy();
 
 	template<typename ...T>
@@ -45,19 +65,25 @@ public:
 	static void setCurrentScene(Ref<Scene> scene) { current_scene = scene; }
 	static void closeScene();
 
-	void updateRuntime();
+	void updateRuntime(float delta_time, DebugRenderer *debug_renderer = nullptr);
 private:
 	friend class SceneRenderer;
 
 	static void propagate_world_transforms_update(entt::entity entity_id);
 	static void propagate_local_transforms_update(entt::entity entity_id);
 
+	void on_transform_constructed(entt::registry &registry, entt::entity entity);
+	void on_transform_destroyed(entt::registry &registry, entt::entity entity);
+
 	friend class Entity;
 	friend class TransformComponent;
 	entt::registry registry;
 
 	eastl::hash_map<entt::entity, uint32_t> dirty_flags;
 	eastl::vector<entt::entity> dirty_list;
+	SceneSpatialIndex spatial_index;
+	uint32_t hierarchy_version = 0;
+	inline static uint32_t last_hierarchy_version = 0;
 public:
 	Ref<PhysicsScene> physics_scene;
 
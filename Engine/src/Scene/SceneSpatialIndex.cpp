@@ -0,0 +1,475 @@
+#include "pch.h"
+#include "SceneSpatialIndex.h"
+
+namespace
+{
+BoundBox merge(const BoundBox &a, const BoundBox &b)
+{
+	return BoundBox(glm::min(a.min, b.min), glm::max(a.max, b.max));
+}
+
+// Half of the surface area, only compared
+float get_area(const BoundBox &box)
+{
+	glm::vec3 size = box.max - box.min;
+	return size.x * size.y + size.y * size.z + size.z * size.x;
+}
+
+bool is_box_inside(const BoundBox &outer, const BoundBox &inner)
+{
+	return glm::all(glm::lessThanEqual(outer.min, inner.min)) && glm::all(glm::lessThanEqual(inner.max, outer.max));
+}
+
+bool is_overlapping(const BoundBox &a, const BoundBox &b)
+{
+	return glm::all(glm::lessThanEqual(a.min, b.max)) && glm::all(glm::lessThanEqual(b.min, a.max));
+}
+
+bool intersect_ray(glm::vec3 origin, glm::vec3 inverse_direction, float max_distance, const BoundBox &box, float &distance)
+{
+	glm::vec3 t0 = (box.min - origin) * inverse_direction;
+	glm::vec3 t1 = (box.max - origin) * inverse_direction;
+	glm::vec3 t_near = glm::min(t0, t1);
+	glm::vec3 t_far = glm::max(t0, t1);
+	float enter = glm::max(glm::max(t_near.x, t_near.y), glm::max(t_near.z, 0.0f));
+	float exit = glm::min(glm::min(t_far.x, t_far.y), glm::min(t_far.z, max_distance));
+	distance = enter;
+	return enter <= exit;
+}
+
+enum class FrustumTest
+{
+	OUTSIDE,
+	INTERSECTS,
+	INSIDE,
+};
+
+// Same plane test as BoundBox::isInside, plus the nearest corner to know if the whole box is inside
+FrustumTest test_frustum(const BoundFrustum &frustum, const BoundBox &box)
+{
+	FrustumTest result = FrustumTest::INSIDE;
+	for (const glm::vec4 &plane : frustum.planes)
+	{
+		glm::vec3 normal(plane);
+		glm::vec3 far_corner = glm::max(box.min * normal, box.max * normal);
+		if (far_corner.x + far_corner.y + far_corner.z <= -plane.w)
+			return FrustumTest::OUTSIDE;
+		glm::vec3 near_corner = glm::min(box.min * normal, box.max * normal);
+		if (near_corner.x + near_corner.y + near_corner.z <= -plane.w)
+			result = FrustumTest::INTERSECTS;
+	}
+	return result;
+}
+
+using NodeStack = eastl::fixed_vector<int32_t, 64, true>;
+}
+
+void SceneSpatialIndex::clear()
+{
+	nodes.clear();
+	leaves.clear();
+	root = NULL_NODE;
+	free_list = NULL_NODE;
+	count = 0;
+}
+
+void SceneSpatialIndex::update(entt::entity entity, const BoundBox &bounds)
+{
+	// Entities without bounds are not indexed
+	if (glm::any(glm::greaterThan(bounds.min, bounds.max)))
+	{
+		remove(entity);
+		return;
+	}
+
+	uint32_t index = entt::to_entity(entity);
+	if (index >= leaves.size())
+		leaves.resize(index + 1);
+
+	Leaf &leaf = leaves[index];
+	leaf.bounds = bounds;
+	if (leaf.node != NULL_NODE)
+	{
+		nodes[leaf.node].entity = entity;
+		if (is_box_inside(nodes[leaf.node].box, bounds))
+			return;
+		remove_leaf(leaf.node);
+	} else
+	{
+		leaf.node = allocate_node();
+		nodes[leaf.node].entity = entity;
+		count++;
+	}
+
+	glm::vec3 extension = glm::vec3(margin) + bounds.getSize() * relative_margin;
+	nodes[leaf.node].box = BoundBox(bounds.min - extension, bounds.max + extension);
+	insert_leaf(leaf.node);
+}
+
+void SceneSpatialIndex::remove(entt::entity entity)
+{
+	if (!contains(entity))
+		return;
+
+	Leaf &leaf = leaves[entt::to_entity(entity)];
+	remove_leaf(leaf.node);
+	free_node(leaf.node);
+	leaf.node = NULL_NODE;
+	count--;
+}
+
+bool SceneSpatialIndex::contains(entt::entity entity) const
+{
+	uint32_t index = entt::to_entity(entity);
+	return index < leaves.size() && leaves[index].node != NULL_NODE && nodes[leaves[index].node].entity == entity;
+}
+
+const BoundBox &SceneSpatialIndex::getBounds(entt::entity entity) const
+{
+	return leaves[entt::to_entity(entity)].bounds;
+}
+
+void SceneSpatialIndex::raycast(glm::vec3 origin, glm::vec3 direction, float max_distance, eastl::vector<RayHit> &hits) const
+{
+	PROFILE_CPU_FUNCTION();
+	hits.clear();
+	if (root == NULL_NODE)
+		return;
+
+	direction = glm::normalize(direction);
+	glm::vec3 inverse_direction = 1.0f / direction;
+
+	NodeStack stack;
+	stack.push_back(root);
+	while (!stack.empty())
+	{
+		const Node &node = nodes[stack.back()];
+		stack.pop_back();
+
+		float distance;
+		if (!intersect_ray(origin, inverse_direction, max_distance, node.box, distance))
+			continue;
+
+		if (node.isLeaf())
+		{
+			if (intersect_ray(origin, inverse_direction, max_distance, leaves[entt::to_entity(node.entity)].bounds, distance))
+				hits.push_back({node.entity, distance});
+		} else
+		{
+			stack.push_back(node.child1);
+			stack.push_back(node.child2);
+		}
+	}
+	eastl::sort(hits.begin(), hits.end(), [](const RayHit &a, const RayHit &b) { return a.distance < b.distance; });
+}
+
+void SceneSpatialIndex::queryFrustum(const BoundFrustum &frustum, eastl::vector<entt::entity> &entities) const
+{
+	PROFILE_CPU_FUNCTION();
+	if (root == NULL_NODE)
+		return;
+
+	NodeStack stack;
+	stack.push_back(root);
+	while (!stack.empty())
+	{
+		int32_t index = stack.back();
+		stack.pop_back();
+
+		const Node &node = nodes[index];
+		FrustumTest test = test_frustum(frustum, node.box);
+		if (test == FrustumTest::OUTSIDE)
+			continue;
+
+		if (node.isLeaf())
+		{
+			if (test == FrustumTest::INSIDE || test_frustum(frustum, leaves[entt::to_entity(node.entity)].bounds) != FrustumTest::OUTSIDE)
+				entities.push_back(node.entity);
+		} else if (test == FrustumTest::INSIDE)
+		{
+			// Exact bounds are inside of the fat ones
+			collect_leaves(index, entities);
+		} else
+		{
+			stack.push_back(node.child1);
+			stack.push_back(node.child2);
+		}
+	}
+}
+
+void SceneSpatialIndex::queryBox(const BoundBox &box, eastl::vector<entt::entity> &entities) const
+{
+	PROFILE_CPU_FUNCTION();
+	if (root == NULL_NODE)
+		return;
+
+	NodeStack stack;
+	stack.push_back(root);
+	while (!stack.empty())
+	{
+		const Node &node = nodes[stack.back()];
+		stack.pop_back();
+
+		if (!is_overlapping(node.box, box))
+			continue;
+
+		if (node.isLeaf())
+		{
+			if (is_overlapping(leaves[entt::to_entity(node.entity)].bounds, box))
+				entities.push_back(node.entity);
+		} else
+		{
+			stack.push_back(node.child1);
+			stack.push_back(node.child2);
+		}
+	}
+}
+
+void SceneSpatialIndex::collect_leaves(int32_t node, eastl::vector<entt::entity> &entities) const
+{
+	NodeStack stack;
+	stack.push_back(node);
+	while (!stack.empty())
+	{
+		const Node &current = nodes[stack.back()];
+		stack.pop_back();
+		if (current.isLeaf())
+		{
+			entities.push_back(current.entity);
+		} else
+		{
+			stack.push_back(current.child1);
+			stack.push_back(current.child2);
+		}
+	}
+}
+
+int32_t SceneSpatialIndex::allocate_node()
+{
+	int32_t index;
+	if (free_list != NULL_NODE)
+	{
+		index = free_list;
+		free_list = nodes[index].parent;
+	} else
+	{
+		index = nodes.size();
+		nodes.push_back();
+	}
+
+	Node &node = nodes[index];
+	node.parent = NULL_NODE;
+	node.child1 = NULL_NODE;
+	node.child2 = NULL_NODE;
+	node.height = 0;
+	node.entity = entt::null;
+	return index;
+}
+
+void SceneSpatialIndex::free_node(int32_t node)
+{
+	nodes[node].parent = free_list;
+	nodes[node].height = -1;
+	free_list = node;
+}
+
+void SceneSpatialIndex::insert_leaf(int32_t leaf)
+{
+	if (root == NULL_NODE)
+	{
+		root = leaf;
+		nodes[root].parent = NULL_NODE;
+		return;
+	}
+
+	// Find the sibling: going down costs the growth of every box on the way, stop where a new parent is cheaper
+	BoundBox leaf_box = nodes[leaf].box;
+	int32_t index = root;
+	while (!nodes[index].isLeaf())
+	{
+		const Node &node = nodes[index];
+		float area = get_area(node.box);
+		float combined_area = get_area(merge(node.box, leaf_box));
+
+		float cost = 2.0f * combined_area;
+		float inheritance_cost = 2.0f * (combined_area - area);
+
+		auto get_child_cost = [&](int32_t child)
+		{
+			const Node &child_node = nodes[child];
+			float new_area = get_area(merge(leaf_box, child_node.box));
+			return (child_node.isLeaf() ? new_area : new_area - get_area(child_node.box)) + inheritance_cost;
+		};
+		float cost1 = get_child_cost(node.child1);
+		float cost2 = get_child_cost(node.child2);
+
+		if (cost < cost1 && cost < cost2)
+			break;
+		index = cost1 < cost2 ? node.child1 : node.child2;
+	}
+	int32_t sibling = index;
+
+	int32_t old_parent = nodes[sibling].parent;
+	int32_t new_parent = allocate_node();
+	nodes[new_parent].parent = old_parent;
+	nodes[new_parent].box = merge(leaf_box, nodes[sibling].box);
+	nodes[new_parent].height = nodes[sibling].height + 1;
+	nodes[new_parent].child1 = sibling;
+	nodes[new_parent].child2 = leaf;
+	nodes[sibling].parent = new_parent;
+	nodes[leaf].parent = new_parent;
+
+	if (old_parent != NULL_NODE)
+	{
+		if (nodes[old_parent].child1 == sibling)
+			nodes[old_parent].child1 = new_parent;
+		else
+			nodes[old_parent].child2 = new_parent;
+	} else
+	{
+		root = new_parent;
+	}
+
+	// Fix heights and boxes up to the root
+	index = nodes[leaf].parent;
+	while (index != NULL_NODE)
+	{
+		index = balance(index);
+		Node &node = nodes[index];
+		node.height = 1 + eastl::max(nodes[node.child1].height, nodes[node.child2].height);
+		node.box = merge(nodes[node.child1].box, nodes[node.child2].box);
+		index = node.parent;
+	}
+}
+
+void SceneSpatialIndex::remove_leaf(int32_t leaf)
+{
+	if (leaf == root)
+	{
+		root = NULL_NODE;
+		return;
+	}
+
+	int32_t parent = nodes[leaf].parent;
+	int32_t grand_parent = nodes[parent].parent;
+	int32_t sibling = nodes[parent].child1 == leaf ? nodes[parent].child2 : nodes[parent].child1;
+	free_node(parent);
+
+	if (grand_parent == NULL_NODE)
+	{
+		root = sibling;
+		nodes[sibling].parent = NULL_NODE;
+		return;
+	}
+
+	// Sibling takes the place of the parent
+	if (nodes[grand_parent].child1 == parent)
+		nodes[grand_parent].child1 = sibling;
+	else
+		nodes[grand_parent].child2 = sibling;
+	nodes[sibling].parent = grand_parent;
+
+	int32_t index = grand_parent;
+	while (index != NULL_NODE)
+	{
+		index = balance(index);
+		Node &node = nodes[index];
+		node.height = 1 + eastl::max(nodes[node.child1].height, nodes[node.child2].height);
+		node.box = merge(nodes[node.child1].box, nodes[node.child2].box);
+		index = node.parent;
+	}
+}
+
+int32_t SceneSpatialIndex::balance(int32_t index_a)
+{
+	// Rotates the higher child up if heights of the children differ by more than one, returns the new subtree root
+	Node &a = nodes[index_a];
+	if (a.isLeaf() || a.height < 2)
+		return index_a;
+
+	int32_t index_b = a.child1;
+	int32_t index_c = a.child2;
+	Node &b = nodes[index_b];
+	Node &c = nodes[index_c];
+	int32_t height_difference = c.height - b.height;
+	if (height_difference >= -1 && height_difference <= 1)
+		return index_a;
+
+	// Child that goes up (c) and the one that stays under a (b)
+	bool is_c_up = height_difference > 1;
+	int32_t index_up = is_c_up ? index_c : index_b;
+	Node &up = nodes[index_up];
+	Node &stay = is_c_up ? b : c;
+
+	int32_t index_f = up.child1;
+	int32_t index_g = up.child2;
+	Node &f = nodes[index_f];
+	Node &g = nodes[index_g];
+
+	// Swap a and up
+	up.child1 = index_a;
+	up.parent = a.parent;
+	a.parent = index_up;
+	if (up.parent != NULL_NODE)
+	{
+		if (nodes[up.parent].child1 == index_a)
+			nodes[up.parent].child1 = index_up;
+		else
+			nodes[up.parent].child2 = index_up;
+	} else
+	{
+		root = index_up;
+	}
+
+	// Higher grandchild stays with up, the lower one moves under a
+	int32_t index_keep = f.height > g.height ? index_f : index_g;
+	int32_t index_move = f.height > g.height ? index_g : index_f;
+	Node &keep = nodes[index_keep];
+	Node &move = nodes[index_move];
+
+	up.child2 = index_keep;
+	if (is_c_up)
+		a.child2 = index_move;
+	else
+		a.child1 = index_move;
+	move.parent = index_a;
+
+	a.box = merge(stay.box, move.box);
+	a.height = 1 + eastl::max(stay.height, move.height);
+	up.box = merge(a.box, keep.box);
+	up.height = 1 + eastl::max(a.height, keep.height);
+	return index_up;
+}
+
+bool SceneSpatialIndex::validate() const
+{
+	uint32_t leaves_count = 0;
+	if (root != NULL_NODE && (nodes[root].parent != NULL_NODE || validate_node(root, leaves_count) < 0))
+		return false;
+	return leaves_count == count;
+}
+
+int32_t SceneSpatialIndex::validate_node(int32_t index, uint32_t &leaves_count) const
+{
+	const Node &node = nodes[index];
+	if (node.isLeaf())
+	{
+		leaves_count++;
+		bool is_valid = node.child2 == NULL_NODE && node.height == 0 && contains(node.entity)
+			&& leaves[entt::to_entity(node.entity)].node == index && is_box_inside(node.box, getBounds(node.entity));
+		return is_valid ? 0 : -1;
+	}
+
+	const Node &child1 = nodes[node.child1];
+	const Node &child2 = nodes[node.child2];
+	if (child1.parent != index || child2.parent != index)
+		return -1;
+	if (!is_box_inside(node.box, child1.box) || !is_box_inside(node.box, child2.box))
+		return -1;
+
+	int32_t height1 = validate_node(node.child1, leaves_count);
+	int32_t height2 = validate_node(node.child2, leaves_count);
+	if (height1 < 0 || height2 < 0 || node.height != 1 + eastl::max(height1, height2))
+		return -1;
+	return node.height;
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include <EASTL/vector.h>
+#include "entt/entt.hpp"
+#include "Math/BoundBox.h"
+
+// Dynamic AABB tree over world bounds of scene entities (same scheme as Box2D b2DynamicTree).
+// Leaves keep fattened boxes, so an entity that moves a little stays in its leaf and costs only a bounds write.
+// Leaves are inserted next to the sibling with the smallest surface area cost and the tree is kept balanced
+// by rotations on the way up, so updates are O(log n) and the tree doesn't degrade with moving entities.
+// Queries test the exact bounds of entities, the tree only reads the fat ones.
+class SceneSpatialIndex
+{
+public:
+	float margin = 0.1f; // fat box extension in world units
+	float relative_margin = 0.1f; // and in sizes of the box
+
+	struct RayHit
+	{
+		entt::entity entity;
+		float distance; // entry distance along the normalized direction, 0 if the origin is inside
+	};
+
+	void clear();
+	// Inserts or moves the entity
+	void update(entt::entity entity, const BoundBox &bounds);
+	void remove(entt::entity entity);
+
+	bool contains(entt::entity entity) const;
+	const BoundBox &getBounds(entt::entity entity) const;
+	uint32_t getCount() const { return count; }
+	uint32_t getHeight() const { return root == NULL_NODE ? 0 : nodes[root].height; }
+
+	// Hits are sorted by distance
+	void raycast(glm::vec3 origin, glm::vec3 direction, float max_distance, eastl::vector<RayHit> &hits) const;
+	void queryFrustum(const BoundFrustum &frustum, eastl::vector<entt::entity> &entities) const;
+	void queryBox(const BoundBox &box, eastl::vector<entt::entity> &entities) const;
+
+	// Checks links, heights and boxes of every node, for tests
+	bool validate() const;
+
+private:
+	static constexpr int32_t NULL_NODE = -1;
+
+	struct Node
+	{
+		BoundBox box; // fat box for leaves
+		int32_t parent; // next free node while in the free list
+		int32_t child1;
+		int32_t child2;
+		int32_t height; // 0 for leaves, -1 for free nodes
+		entt::entity entity;
+
+		bool isLeaf() const { return child1 == NULL_NODE; }
+	};
+
+	struct Leaf
+	{
+		int32_t node = NULL_NODE;
+		BoundBox bounds;
+	};
+
+	int32_t allocate_node();
+	void free_node(int32_t node);
+	void insert_leaf(int32_t leaf);
+	void remove_leaf(int32_t leaf);
+	int32_t balance(int32_t node);
+	void collect_leaves(int32_t node, eastl::vector<entt::entity> &entities) const;
+	int32_t validate_node(int32_t node, uint32_t &leaves_count) const;
+
+	eastl::vector<Node> nodes;
+	eastl::vector<Leaf> leaves; // by entity index
+	int32_t root = NULL_NODE;
+	int32_t free_list = NULL_NODE;
+	uint32_t count = 0;
+};
@@ -0,0 +1,614 @@
+#include "pch.h"
+#include "BCnEncoder.h"
+
+namespace
+{
+constexpr float BC1_WEIGHTS[4] = {0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f};
+constexpr int BC7_WEIGHTS[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+struct BitWriter
+{
+	uint8_t *dst;
+	uint32_t position = 0;
+
+	void write(uint32_t value, uint32_t bits)
+	{
+		for (uint32_t i = 0; i < bits; i++, position++)
+		{
+			if (value >> i & 1)
+				dst[position >> 3] |= 1 << (position & 7);
+		}
+	}
+};
+
+struct BitReader
+{
+	const uint8_t *src;
+	uint32_t position = 0;
+
+	uint32_t read(uint32_t bits)
+	{
+		uint32_t value = 0;
+		for (uint32_t i = 0; i < bits; i++, position++)
+			value |= (src[position >> 3] >> (position & 7) & 1) << i;
+		return value;
+	}
+};
+
+void to_float(const uint8_t texels[64], float block[16][4])
+{
+	for (int i = 0; i < 16; i++)
+	{
+		for (int c = 0; c < 4; c++)
+			block[i][c] = texels[i * 4 + c];
+	}
+}
+
+// Line through the first N channels of the block, its direction is found with power iteration of the covariance matrix
+template<int N>
+void find_endpoints(const float block[16][4], float e0[4], float e1[4])
+{
+	float mean[N] = {};
+	for (int i = 0; i < 16; i++)
+	{
+		for (int c = 0; c < N; c++)
+			mean[c] += block[i][c] / 16.0f;
+	}
+
+	float covariance[N][N] = {};
+	float min_value[N], max_value[N];
+	for (int c = 0; c < N; c++)
+	{
+		min_value[c] = 255.0f;
+		max_value[c] = 0.0f;
+	}
+	for (int i = 0; i < 16; i++)
+	{
+		for (int a = 0; a < N; a++)
+		{
+			for (int b = 0; b < N; b++)
+				covariance[a][b] += (block[i][a] - mean[a]) * (block[i][b] - mean[b]);
+			min_value[a] = eastl::min(min_value[a], block[i][a]);
+			max_value[a] = eastl::max(max_value[a], block[i][a]);
+		}
+	}
+
+	// Bounding box diagonal is a good first guess, iterations only fix its direction
+	float axis[N];
+	for (int c = 0; c < N; c++)
+		axis[c] = max_value[c] - min_value[c];
+	for (int iteration = 0; iteration < 8; iteration++)
+	{
+		float next[N] = {};
+		float length = 0.0f;
+		for (int a = 0; a < N; a++)
+		{
+			for (int b = 0; b < N; b++)
+				next[a] += covariance[a][b] * axis[b];
+			length += next[a] * next[a];
+		}
+		if (length < 1e-12f)
+			break;
+		length = sqrtf(length);
+		for (int c = 0; c < N; c++)
+			axis[c] = next[c] / length;
+	}
+
+	float t_min = FLT_MAX, t_max = -FLT_MAX;
+	for (int i = 0; i < 16; i++)
+	{
+		float t = 0.0f;
+		for (int c = 0; c < N; c++)
+			t += (block[i][c] - mean[c]) * axis[c];
+		t_min = eastl::min(t_min, t);
+		t_max = eastl::max(t_max, t);
+	}
+
+	for (int c = 0; c < N; c++)
+	{
+		e0[c] = eastl::clamp(mean[c] + axis[c] * t_min, 0.0f, 255.0f);
+		e1[c] = eastl::clamp(mean[c] + axis[c] * t_max, 0.0f, 255.0f);
+	}
+}
+
+// Least squares endpoints for fixed interpolation weights, false if every texel has the same weight
+template<int N>
+bool refine_endpoints(const float block[16][4], const float weights[16], float e0[4], float e1[4])
+{
+	float a = 0.0f, b = 0.0f, c = 0.0f;
+	float x0[N] = {}, x1[N] = {};
+	for (int i = 0; i < 16; i++)
+	{
+		float w = weights[i];
+		float iw = 1.0f - w;
+		a += iw * iw;
+		b += iw * w;
+		c += w * w;
+		for (int ch = 0; ch < N; ch++)
+		{
+			x0[ch] += iw * block[i][ch];
+			x1[ch] += w * block[i][ch];
+		}
+	}
+
+	float det = a * c - b * b;
+	if (fabsf(det) < 1e-6f)
+		return false;
+
+	for (int ch = 0; ch < N; ch++)
+	{
+		e0[ch] = eastl::clamp((c * x0[ch] - b * x1[ch]) / det, 0.0f, 255.0f);
+		e1[ch] = eastl::clamp((a * x1[ch] - b * x0[ch]) / det, 0.0f, 255.0f);
+	}
+	return true;
+}
+
+uint16_t pack_565(const float color[4])
+{
+	uint32_t r = (uint32_t)eastl::clamp(color[0] * 31.0f / 255.0f + 0.5f, 0.0f, 31.0f);
+	uint32_t g = (uint32_t)eastl::clamp(color[1] * 63.0f / 255.0f + 0.5f, 0.0f, 63.0f);
+	uint32_t b = (uint32_t)eastl::clamp(color[2] * 31.0f / 255.0f + 0.5f, 0.0f, 31.0f);
+	return (uint16_t)(r << 11 | g << 5 | b);
+}
+
+void unpack_565(uint16_t value, int color[4])
+{
+	int r = value >> 11 & 31;
+	int g = value >> 5 & 63;
+	int b = value & 31;
+	color[0] = r << 3 | r >> 2;
+	color[1] = g << 2 | g >> 4;
+	color[2] = b << 3 | b >> 2;
+	color[3] = 255;
+}
+
+// 4 color mode palette, encoder orders endpoints for it at the end
+float fit_bc1_indices(const float block[16][4], uint16_t c0, uint16_t c1, uint8_t indices[16])
+{
+	int palette[4][4];
+	unpack_565(c0, palette[0]);
+	unpack_565(c1, palette[1]);
+	for (int c = 0; c < 3; c++)
+	{
+		palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+		palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+	}
+
+	float total_error = 0.0f;
+	for (int i = 0; i < 16; i++)
+	{
+		float best_error = FLT_MAX;
+		for (int p = 0; p < 4; p++)
+		{
+			float error = 0.0f;
+			for (int c = 0; c < 3; c++)
+			{
+				float d = block[i][c] - palette[p][c];
+				error += d * d;
+			}
+			if (error < best_error)
+			{
+				best_error = error;
+				indices[i] = p;
+			}
+		}
+		total_error += best_error;
+	}
+	return total_error;
+}
+
+void encode_bc1(const uint8_t texels[64], uint8_t *dst)
+{
+	float block[16][4];
+	to_float(texels, block);
+
+	float e0[4], e1[4];
+	find_endpoints<3>(block, e0, e1);
+	// Extreme texels are usually covered well enough by the interpolated colors
+	for (int c = 0; c < 3; c++)
+	{
+		float inset = (e1[c] - e0[c]) / 16.0f;
+		e0[c] += inset;
+		e1[c] -= inset;
+	}
+
+	uint16_t best_c0 = 0, best_c1 = 0;
+	uint8_t best_indices[16] = {};
+	float best_error = FLT_MAX;
+	for (int iteration = 0; iteration < 2; iteration++)
+	{
+		uint16_t c0 = pack_565(e0);
+		uint16_t c1 = pack_565(e1);
+		uint8_t indices[16];
+		float error = fit_bc1_indices(block, c0, c1, indices);
+		if (error >= best_error)
+			break;
+		best_error = error;
+		best_c0 = c0;
+		best_c1 = c1;
+		memcpy(best_indices, indices, sizeof(indices));
+
+		float weights[16];
+		for (int i = 0; i < 16; i++)
+			weights[i] = BC1_WEIGHTS[indices[i]];
+		if (!refine_endpoints<3>(block, weights, e0, e1))
+			break;
+	}
+
+	// 4 color mode needs c0 > c1, swapping endpoints swaps indices 0 with 1 and 2 with 3
+	if (best_c0 < best_c1)
+	{
+		eastl::swap(best_c0, best_c1);
+		for (uint8_t &index : best_indices)
+			index ^= 1;
+	} else if (best_c0 == best_c1)
+	{
+		memset(best_indices, 0, sizeof(best_indices));
+	}
+
+	uint32_t bits = 0;
+	for (int i = 0; i < 16; i++)
+		bits |= (uint32_t)best_indices[i] << (i * 2);
+	memcpy(dst, &best_c0, 2);
+	memcpy(dst + 2, &best_c1, 2);
+	memcpy(dst + 4, &bits, 4);
+}
+
+void decode_bc1(const uint8_t *src, uint8_t texels[64])
+{
+	uint16_t c0, c1;
+	uint32_t bits;
+	memcpy(&c0, src, 2);
+	memcpy(&c1, src + 2, 2);
+	memcpy(&bits, src + 4, 4);
+
+	int palette[4][4];
+	unpack_565(c0, palette[0]);
+	unpack_565(c1, palette[1]);
+	for (int c = 0; c < 3; c++)
+	{
+		if (c0 > c1)
+		{
+			palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+			palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+		} else
+		{
+			palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+			palette[3][c] = 0;
+		}
+	}
+	palette[2][3] = 255;
+	palette[3][3] = c0 > c1 ? 255 : 0;
+
+	for (int i = 0; i < 16; i++)
+	{
+		uint32_t index = bits >> (i * 2) & 3;
+		for (int c = 0; c < 4; c++)
+			texels[i * 4 + c] = palette[index][c];
+	}
+}
+
+void bc4_palette(int r0, int r1, int palette[8])
+{
+	palette[0] = r0;
+	palette[1] = r1;
+	if (r0 > r1)
+	{
+		for (int i = 2; i < 8; i++)
+			palette[i] = ((8 - i) * r0 + (i - 1) * r1) / 7;
+	} else
+	{
+		for (int i = 2; i < 6; i++)
+			palette[i] = ((6 - i) * r0 + (i - 1) * r1) / 5;
+		palette[6] = 0;
+		palette[7] = 255;
+	}
+}
+
+// 8 value mode between min and max of the channel
+void encode_bc4(const uint8_t texels[64], int channel, uint8_t *dst)
+{
+	int min_value = 255, max_value = 0;
+	for (int i = 0; i < 16; i++)
+	{
+		min_value = eastl::min(min_value, (int)texels[i * 4 + channel]);
+		max_value = eastl::max(max_value, (int)texels[i * 4 + channel]);
+	}
+
+	int palette[8];
+	bc4_palette(max_value, min_value, palette);
+
+	uint64_t bits = 0;
+	for (int i = 0; i < 16; i++)
+	{
+		int value = texels[i * 4 + channel];
+		int best_index = 0;
+		for (int p = 1; p < 8; p++)
+		{
+			if (abs(palette[p] - value) < abs(palette[best_index] - value))
+				best_index = p;
+		}
+		bits |= (uint64_t)best_index << (i * 3);
+	}
+
+	dst[0] = max_value;
+	dst[1] = min_value;
+	for (int b = 0; b < 6; b++)
+		dst[2 + b] = bits >> (b * 8) & 0xFF;
+}
+
+void decode_bc4(const uint8_t *src, int channel, uint8_t texels[64])
+{
+	int palette[8];
+	bc4_palette(src[0], src[1], palette);
+
+	uint64_t bits = 0;
+	for (int b = 0; b < 6; b++)
+		bits |= (uint64_t)src[2 + b] << (b * 8);
+	for (int i = 0; i < 16; i++)
+		texels[i * 4 + channel] = palette[bits >> (i * 3) & 7];
+}
+
+struct Bc7Endpoints
+{
+	uint8_t color[2][4]; // 7 bit per channel
+	uint8_t p_bit[2];
+};
+
+// Endpoint channels are 7 bits with a shared lowest bit, p bit that fits all channels best is picked
+void quantize_bc7_endpoint(const float endpoint[4], uint8_t color[4], uint8_t &p_bit)
+{
+	float best_error = FLT_MAX;
+	for (uint8_t p = 0; p < 2; p++)
+	{
+		uint8_t quantized[4];
+		float error = 0.0f;
+		for (int c = 0; c < 4; c++)
+		{
+			quantized[c] = (uint8_t)eastl::clamp((endpoint[c] - p) * 0.5f + 0.5f, 0.0f, 127.0f);
+			float d = (quantized[c] << 1 | p) - endpoint[c];
+			error += d * d;
+		}
+		if (error < best_error)
+		{
+			best_error = error;
+			memcpy(color, quantized, 4);
+			p_bit = p;
+		}
+	}
+}
+
+void bc7_palette(const Bc7Endpoints &endpoints, int palette[16][4])
+{
+	for (int c = 0; c < 4; c++)
+	{
+		int v0 = endpoints.color[0][c] << 1 | endpoints.p_bit[0];
+		int v1 = endpoints.color[1][c] << 1 | endpoints.p_bit[1];
+		for (int i = 0; i < 16; i++)
+			palette[i][c] = ((64 - BC7_WEIGHTS[i]) * v0 + BC7_WEIGHTS[i] * v1 + 32) >> 6;
+	}
+}
+
+float fit_bc7_indices(const float block[16][4], const Bc7Endpoints &endpoints, uint8_t indices[16])
+{
+	int palette[16][4];
+	bc7_palette(endpoints, palette);
+
+	float total_error = 0.0f;
+	for (int i = 0; i < 16; i++)
+	{
+		float best_error = FLT_MAX;
+		for (int p = 0; p < 16; p++)
+		{
+			float error = 0.0f;
+			for (int c = 0; c < 4; c++)
+			{
+				float d = block[i][c] - palette[p][c];
+				error += d * d;
+			}
+			if (error < best_error)
+			{
+				best_error = error;
+				indices[i] = p;
+			}
+		}
+		total_error += best_error;
+	}
+	return total_error;
+}
+
+// Mode 6: single subset, RGBA endpoints and 4 bit indices
+void encode_bc7(const uint8_t texels[64], uint8_t *dst)
+{
+	float block[16][4];
+	to_float(texels, block);
+
+	float e0[4], e1[4];
+	find_endpoints<4>(block, e0, e1);
+
+	Bc7Endpoints best_endpoints{};
+	uint8_t best_indices[16] = {};
+	float best_error = FLT_MAX;
+	for (int iteration = 0; iteration < 3; iteration++)
+	{
+		Bc7Endpoints endpoints;
+		quantize_bc7_endpoint(e0, endpoints.color[0], endpoints.p_bit[0]);
+		quantize_bc7_endpoint(e1, endpoints.color[1], endpoints.p_bit[1]);
+
+		uint8_t indices[16];
+		float error = fit_bc7_indices(block, endpoints, indices);
+		if (error >= best_error)
+			break;
+		best_error = error;
+		best_endpoints = endpoints;
+		memcpy(best_indices, indices, sizeof(indices));
+
+		float weights[16];
+		for (int i = 0; i < 16; i++)
+			weights[i] = BC7_WEIGHTS[indices[i]] / 64.0f;
+		if (!refine_endpoints<4>(block, weights, e0, e1))
+			break;
+	}
+
+	// Top bit of the first index is implicitly 0, weights are symmetric so swapping endpoints mirrors indices
+	if (best_indices[0] >= 8)
+	{
+		eastl::swap(best_endpoints.p_bit[0], best_endpoints.p_bit[1]);
+		for (int c = 0; c < 4; c++)
+			eastl::swap(best_endpoints.color[0][c], best_endpoints.color[1][c]);
+		for (uint8_t &index : best_indices)
+			index = 15 - index;
+	}
+
+	memset(dst, 0, 16);
+	BitWriter writer{dst};
+	writer.write(1 << 6, 7);
+	for (int c = 0; c < 4; c++)
+	{
+		writer.write(best_endpoints.color[0][c], 7);
+		writer.write(best_endpoints.color[1][c], 7);
+	}
+	writer.write(best_endpoints.p_bit[0], 1);
+	writer.write(best_endpoints.p_bit[1], 1);
+	for (int i = 0; i < 16; i++)
+		writer.write(best_indices[i], i == 0 ? 3 : 4);
+}
+
+bool decode_bc7(const uint8_t *src, uint8_t texels[64])
+{
+	if ((src[0] & 0x7F) != 1 << 6)
+		return false;
+
+	BitReader reader{src, 7};
+	Bc7Endpoints endpoints;
+	for (int c = 0; c < 4; c++)
+	{
+		endpoints.color[0][c] = reader.read(7);
+		endpoints.color[1][c] = reader.read(7);
+	}
+	endpoints.p_bit[0] = reader.read(1);
+	endpoints.p_bit[1] = reader.read(1);
+
+	int palette[16][4];
+	bc7_palette(endpoints, palette);
+	for (int i = 0; i < 16; i++)
+	{
+		uint32_t index = reader.read(i == 0 ? 3 : 4);
+		for (int c = 0; c < 4; c++)
+			texels[i * 4 + c] = palette[index][c];
+	}
+	return true;
+}
+}
+
+namespace BCn
+{
+
+bool isSupportedFormat(Format format)
+{
+	switch (format)
+	{
+		case FORMAT_BC1:
+		case FORMAT_BC1_SRGB:
+		case FORMAT_BC4:
+		case FORMAT_BC5:
+		case FORMAT_BC7:
+		case FORMAT_BC7_SRGB: return true;
+	}
+	return false;
+}
+
+uint32_t getBlockBytes(Format format)
+{
+	switch (format)
+	{
+		case FORMAT_BC1:
+		case FORMAT_BC1_SRGB:
+		case FORMAT_BC4: return 8;
+		case FORMAT_BC3:
+		case FORMAT_BC5:
+		case FORMAT_BC7:
+		case FORMAT_BC7_SRGB: return 16;
+	}
+	return 0;
+}
+
+uint32_t getChannelCount(Format format)
+{
+	switch (format)
+	{
+		case FORMAT_BC4: return 1;
+		case FORMAT_BC5: return 2;
+		case FORMAT_BC1:
+		case FORMAT_BC1_SRGB: return 3;
+	}
+	return 4;
+}
+
+void encodeBlock(Format format, const uint8_t texels[64], uint8_t *dst)
+{
+	switch (format)
+	{
+		case FORMAT_BC1:
+		case FORMAT_BC1_SRGB:
+			encode_bc1(texels, dst);
+			break;
+		case FORMAT_BC4:
+			encode_bc4(texels, 0, dst);
+			break;
+		case FORMAT_BC5:
+			encode_bc4(texels, 0, dst);
+			encode_bc4(texels, 1, dst + 8);
+			break;
+		case FORMAT_BC7:
+		case FORMAT_BC7_SRGB:
+			encode_bc7(texels, dst);
+			break;
+		default:
+			ENGINE_ASSERT(false);
+			break;
+	}
+}
+
+bool decodeBlock(Format format, const uint8_t *src, uint8_t texels[64])
+{
+	for (int i = 0; i < 16; i++)
+	{
+		texels[i * 4 + 0] = texels[i * 4 + 1] = texels[i * 4 + 2] = 0;
+		texels[i * 4 + 3] = 255;
+	}
+
+	switch (format)
+	{
+		case FORMAT_BC1:
+		case FORMAT_BC1_SRGB:
+			decode_bc1(src, texels);
+			return true;
+		case FORMAT_BC4:
+			decode_bc4(src, 0, texels);
+			return true;
+		case FORMAT_BC5:
+			decode_bc4(src, 0, texels);
+			decode_bc4(src + 8, 1, texels);
+			return true;
+		case FORMAT_BC7:
+		case FORMAT_BC7_SRGB:
+			return decode_bc7(src, texels);
+	}
+	return false;
+}
+
+void loadBlock(const uint8_t *rgba, uint32_t width, uint32_t height, uint32_t block_x, uint32_t block_y, uint8_t texels[64])
+{
+	for (uint32_t y = 0; y < 4; y++)
+	{
+		uint32_t source_y = eastl::min(block_y * 4 + y, height - 1);
+		for (uint32_t x = 0; x < 4; x++)
+		{
+			uint32_t source_x = eastl::min(block_x * 4 + x, width - 1);
+			memcpy(texels + (y * 4 + x) * 4, rgba + ((uint64_t)source_y * width + source_x) * 4, 4);
+		}
+	}
+}
+
+}
@@ -0,0 +1,21 @@
+#pragma once
+#include "RHI/RHIDefinitions.h"
+
+// Portable block compression for the texture cook.
+// Blocks are 4x4 RGBA8 texels, row major. Encoders only use what their format can keep:
+// BC1 - opaque RGB, BC4 - R, BC5 - RG, BC7 - RGBA (mode 6 only, single subset with 4 bit indices).
+namespace BCn
+{
+
+bool isSupportedFormat(Format format);
+uint32_t getBlockBytes(Format format);
+uint32_t getChannelCount(Format format); // channels that are compared for error
+
+void encodeBlock(Format format, const uint8_t texels[64], uint8_t *dst);
+// Returns false if the block uses a mode the encoder never writes
+bool decodeBlock(Format format, const uint8_t *src, uint8_t texels[64]);
+
+// Copies the 4x4 block at (block_x, block_y), texels outside of the image repeat the edge
+void loadBlock(const uint8_t *rgba, uint32_t width, uint32_t height, uint32_t block_x, uint32_t block_y, uint8_t texels[64]);
+
+}
@@ -87,7 +87,7 @@ public:
 	const glm::vec3 &getPosition() const { return position; }
 	void setPosition(glm::vec3 position) { this->position = position; updateMatrices(); }
 
-	const glm::vec3 &getRotation() const { return glm::vec3(pitch, yaw, 0); }
+	glm::vec3 getRotation() const { return glm::vec3(pitch, yaw, 0); }
 	void setRotation(glm::vec3 rotation)
 	{  
 		pitch = glm::radians(rotation.x);
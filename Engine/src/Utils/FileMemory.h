@@ -1,4 +1,10 @@
 #pragma once
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 class FileMemory
 {
@@ -9,6 +15,7 @@ public:
 	{
 		close();
 
+#ifdef _WIN32
 		eastl::wstring path_w = unicode_to_wstring(path.c_str());
 		file_handle = CreateFile(path_w.c_str(), read_only ? GENERIC_READ : GENERIC_READ | GENERIC_WRITE, read_only ? FILE_SHARE_READ : 0, nullptr, read_only ? OPEN_EXISTING : CREATE_ALWAYS, read_only ? FILE_ATTRIBUTE_READONLY : FILE_ATTRIBUTE_NORMAL, nullptr);
 		if (file_handle == INVALID_HANDLE_VALUE)
@@ -38,6 +45,40 @@ public:
 		{
 			mapped_size = write_size;
 		}
+#else
+		int file_descriptor = ::open(path.c_str(), read_only ? O_RDONLY : O_RDWR | O_CREAT | O_TRUNC, 0644);
+		if (file_descriptor < 0)
+			return false;
+
+		if (read_only)
+		{
+			struct stat file_stat;
+			if (fstat(file_descriptor, &file_stat) != 0)
+			{
+				::close(file_descriptor);
+				return false;
+			}
+			mapped_size = file_stat.st_size;
+		} else
+		{
+			if (ftruncate(file_descriptor, write_size) != 0)
+			{
+				::close(file_descriptor);
+				return false;
+			}
+			mapped_size = write_size;
+		}
+
+		// Mapping keeps the file alive, the descriptor is closed right away so thousands of mapped textures don't hit the open files limit
+		mapped_data = mmap(nullptr, mapped_size, read_only ? PROT_READ : PROT_READ | PROT_WRITE, MAP_SHARED, file_descriptor, 0);
+		::close(file_descriptor);
+		if (mapped_data == MAP_FAILED)
+		{
+			mapped_data = nullptr;
+			mapped_size = 0;
+			return false;
+		}
+#endif
 		is_open = true;
 		return true;
 	}
@@ -46,12 +87,15 @@ public:
 	{
 		if (is_open)
 		{
+#ifdef _WIN32
 			UnmapViewOfFile(mapped_data);
-			mapped_data = nullptr;
-			mapped_size = 0;
-
 			CloseHandle(mapping_handle);
 			CloseHandle(file_handle);
+#else
+			munmap(mapped_data, mapped_size);
+#endif
+			mapped_data = nullptr;
+			mapped_size = 0;
 			is_open = false;
 		}
 	}
@@ -66,6 +110,8 @@ private:
 	void *mapped_data = nullptr;
 	size_t mapped_size = 0;
 
+#ifdef _WIN32
 	HANDLE file_handle;
 	HANDLE mapping_handle;
+#endif
 };
\ No newline at end of file
@@ -0,0 +1,311 @@
+#include "pch.h"
+#include "FileWatcher.h"
+#ifndef _WIN32
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+struct FileWatcher::Watch
+{
+	std::filesystem::path root;
+	bool recursive = false;
+	HANDLE handle = INVALID_HANDLE_VALUE;
+	OVERLAPPED overlapped = {};
+	alignas(DWORD) uint8_t buffer[64 * 1024];
+
+	bool read_changes()
+	{
+		DWORD filter = FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE;
+		return ReadDirectoryChangesW(handle, buffer, sizeof(buffer), recursive, filter, nullptr, &overlapped, nullptr);
+	}
+};
+#else
+struct FileWatcher::Watch
+{
+	std::filesystem::path directory;
+	bool recursive = false;
+	int descriptor = -1;
+};
+#endif
+
+FileWatcher::FileWatcher() = default;
+
+FileWatcher::~FileWatcher()
+{
+#ifdef _WIN32
+	for (auto &watch : watches)
+	{
+		DWORD bytes;
+		CancelIoEx(watch->handle, &watch->overlapped);
+		GetOverlappedResult(watch->handle, &watch->overlapped, &bytes, TRUE);
+		CloseHandle(watch->handle);
+	}
+#else
+	if (inotify_descriptor >= 0)
+		close(inotify_descriptor);
+#endif
+}
+
+bool FileWatcher::addPath(const eastl::wstring &path, bool recursive)
+{
+	std::filesystem::path directory = path.c_str();
+	if (!std::filesystem::is_directory(directory))
+	{
+		CORE_ERROR("Can't watch {}, not a directory", directory.string());
+		return false;
+	}
+
+#ifdef _WIN32
+	auto watch = std::make_unique<Watch>();
+	watch->root = directory;
+	watch->recursive = recursive;
+	watch->handle = CreateFileW(path.c_str(), FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+								OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+	if (watch->handle == INVALID_HANDLE_VALUE)
+	{
+		CORE_ERROR("Can't watch {}, error {}", directory.string(), GetLastError());
+		return false;
+	}
+
+	if (!watch->read_changes())
+	{
+		CORE_ERROR("Can't watch {}, error {}", directory.string(), GetLastError());
+		CloseHandle(watch->handle);
+		return false;
+	}
+	watches.push_back(eastl::move(watch));
+#else
+	if (inotify_descriptor < 0)
+	{
+		inotify_descriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+		if (inotify_descriptor < 0)
+		{
+			CORE_ERROR("Can't watch {}, inotify is not available", directory.string());
+			return false;
+		}
+	}
+	add_inotify_watches(directory, recursive);
+#endif
+	return true;
+}
+
+void FileWatcher::poll(std::chrono::steady_clock::time_point now)
+{
+#ifdef _WIN32
+	for (auto &watch : watches)
+	{
+		DWORD bytes = 0;
+		if (!GetOverlappedResult(watch->handle, &watch->overlapped, &bytes, FALSE))
+			continue; // Still waiting for changes
+
+		if (bytes == 0)
+			CORE_WARN("Too many file changes in {}, some are lost", watch->root.string());
+
+		for (DWORD offset = 0; bytes > 0;)
+		{
+			const FILE_NOTIFY_INFORMATION *info = (const FILE_NOTIFY_INFORMATION *)(watch->buffer + offset);
+			std::filesystem::path path = watch->root / std::wstring(info->FileName, info->FileNameLength / sizeof(WCHAR));
+
+			// Directory moved in or created with files already in it, nothing is reported for them
+			bool is_new = info->Action == FILE_ACTION_ADDED || info->Action == FILE_ACTION_RENAMED_NEW_NAME;
+			if (is_new && std::filesystem::is_directory(path))
+				add_directory_files(path, watch->recursive, now);
+			add_change(path, now, is_new);
+
+			if (info->NextEntryOffset == 0)
+				break;
+			offset += info->NextEntryOffset;
+		}
+
+		watch->overlapped = {};
+		if (!watch->read_changes())
+			CORE_ERROR("Stopped watching {}, error {}", watch->root.string(), GetLastError());
+	}
+#else
+	if (inotify_descriptor < 0)
+		return;
+
+	alignas(inotify_event) char buffer[64 * 1024];
+	while (true)
+	{
+		ssize_t length = read(inotify_descriptor, buffer, sizeof(buffer));
+		if (length <= 0)
+			break;
+
+		for (char *pointer = buffer; pointer < buffer + length;)
+		{
+			const inotify_event *event = (const inotify_event *)pointer;
+			pointer += sizeof(inotify_event) + event->len;
+
+			if (event->mask & IN_Q_OVERFLOW)
+			{
+				CORE_WARN("Too many file changes, some are lost");
+				continue;
+			}
+
+			auto it = eastl::find_if(watches.begin(), watches.end(), [&](const auto &watch) { return watch->descriptor == event->wd; });
+			if (it == watches.end())
+				continue;
+
+			if (event->mask & IN_IGNORED)
+			{
+				watches.erase(it);
+				continue;
+			}
+
+			if (event->len == 0)
+				continue;
+
+			std::filesystem::path path = (*it)->directory / event->name;
+			if (event->mask & IN_ISDIR)
+			{
+				// New directories are not watched yet and could already have files
+				if ((event->mask & (IN_CREATE | IN_MOVED_TO)) && (*it)->recursive)
+				{
+					add_inotify_watches(path, true);
+					add_directory_files(path, true, now);
+				} else if (event->mask & IN_MOVED_FROM)
+				{
+					remove_inotify_watches(path);
+				}
+			}
+			add_change(path, now, event->mask & (IN_CREATE | IN_MOVED_TO));
+
+			eastl::wstring key = path.lexically_normal().wstring().c_str();
+			if (event->mask & IN_MODIFY)
+				writing.insert(key);
+			else if (event->mask & (IN_CLOSE_WRITE | IN_DELETE | IN_MOVED_FROM))
+				writing.erase(key);
+		}
+	}
+#endif
+}
+
+bool FileWatcher::popBatch(eastl::vector<Change> &changes, std::chrono::steady_clock::time_point now)
+{
+	changes.clear();
+	if (pending.empty())
+		return false;
+
+	if (now - last_event_time < debounce_time && now - batch_start_time < max_batch_time)
+		return false;
+
+	// Files still open for writing move on to the next batch
+	eastl::vector<eastl::wstring> still_writing;
+	for (const eastl::wstring &path : pending)
+	{
+		if (writing.find(path) != writing.end())
+		{
+			still_writing.push_back(path);
+			continue;
+		}
+
+		std::error_code error;
+		std::filesystem::file_status status = std::filesystem::status(path.c_str(), error);
+		if (std::filesystem::is_directory(status))
+			continue;
+		bool is_exists = std::filesystem::exists(status);
+		if (!is_exists && created.find(path) != created.end())
+			continue;
+		changes.push_back({path, is_exists ? ChangeType::Changed : ChangeType::Removed});
+	}
+
+	pending.clear();
+	pending_set.clear();
+	eastl::hash_set<eastl::wstring> still_created;
+	for (const eastl::wstring &path : still_writing)
+	{
+		pending.push_back(path);
+		pending_set.insert(path);
+		if (created.find(path) != created.end())
+			still_created.insert(path);
+	}
+	created.swap(still_created);
+	batch_start_time = now;
+	return !changes.empty();
+}
+
+void FileWatcher::add_change(const std::filesystem::path &path, std::chrono::steady_clock::time_point now, bool is_created)
+{
+	if (pending.empty())
+		batch_start_time = now;
+	last_event_time = now;
+
+	eastl::wstring key = path.lexically_normal().wstring().c_str();
+	if (pending_set.insert(key).second)
+	{
+		pending.push_back(key);
+		if (is_created)
+			created.insert(key);
+	}
+}
+
+void FileWatcher::add_directory_files(const std::filesystem::path &directory, bool recursive, std::chrono::steady_clock::time_point now)
+{
+	std::error_code error;
+	if (recursive)
+	{
+		for (auto &entry : std::filesystem::recursive_directory_iterator(directory, error))
+		{
+			if (entry.is_regular_file())
+				add_change(entry.path(), now, true);
+		}
+	} else
+	{
+		for (auto &entry : std::filesystem::directory_iterator(directory, error))
+		{
+			if (entry.is_regular_file())
+				add_change(entry.path(), now, true);
+		}
+	}
+}
+
+#ifndef _WIN32
+void FileWatcher::add_inotify_watches(const std::filesystem::path &directory, bool recursive)
+{
+	// Close write is the end of writing a file, modify only keeps the batch open until then
+	uint32_t mask = IN_CREATE | IN_DELETE | IN_MODIFY | IN_CLOSE_WRITE | IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR;
+
+	auto add_watch = [&](const std::filesystem::path &path)
+	{
+		int descriptor = inotify_add_watch(inotify_descriptor, path.c_str(), mask);
+		if (descriptor < 0)
+		{
+			CORE_WARN("Can't watch {}", path.string());
+			return;
+		}
+
+		// Same directory returns the same descriptor
+		auto it = eastl::find_if(watches.begin(), watches.end(), [&](const auto &watch) { return watch->descriptor == descriptor; });
+		if (it == watches.end())
+			it = watches.insert(watches.end(), std::make_unique<Watch>());
+		(*it)->directory = path;
+		(*it)->recursive = recursive;
+		(*it)->descriptor = descriptor;
+	};
+
+	add_watch(directory);
+	if (!recursive)
+		return;
+
+	std::error_code error;
+	for (auto &entry : std::filesystem::recursive_directory_iterator(directory, error))
+	{
+		if (entry.is_directory())
+			add_watch(entry.path());
+	}
+}
+
+void FileWatcher::remove_inotify_watches(const std::filesystem::path &directory)
+{
+	// Moved directory keeps its watches, but their paths are stale. They are added again if it is moved inside
+	eastl::wstring prefix = (directory.lexically_normal() / "").wstring().c_str();
+	for (auto &watch : watches)
+	{
+		eastl::wstring watch_path = (watch->directory.lexically_normal() / "").wstring().c_str();
+		if (watch_path.compare(0, prefix.size(), prefix) == 0)
+			inotify_rm_watch(inotify_descriptor, watch->descriptor);
+	}
+}
+#endif
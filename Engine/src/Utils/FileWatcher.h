@@ -1,58 +1,83 @@
 #pragma once
-#include <string>
+#include <chrono>
 #include <filesystem>
-#include <unordered_map>
+#include <memory>
+#include <EASTL/hash_set.h>
 
+// Watches directories with native notifications (ReadDirectoryChangesW on Windows, inotify on Linux).
+// Events are collected into a batch that is reported once nothing happened for the debounce time,
+// so files still being written and editor saves (temp file + rename) come out as one change per path.
+// On Linux a file modified and not closed yet stays pending until it is closed, whatever the batch times are.
 class FileWatcher
 {
 public:
-	void addPath(const eastl::wstring &path, bool recursive = false)
+	enum class ChangeType
 	{
-		if (recursive)
-		{
-			for (auto &path : std::filesystem::recursive_directory_iterator(path.c_str()))
-			{
-				if (path.is_regular_file())
-					files_times[path.path().c_str()] = path.last_write_time();
-			}
-		}
-		else
-		{
-			for (auto &path : std::filesystem::directory_iterator(path.c_str()))
-			{
-				if (path.is_regular_file())
-					files_times[path.path().c_str()] = path.last_write_time();
-			}
-		}
-	}
+		Changed, // Created, written or renamed to
+		Removed // Deleted or renamed from
+	};
+
+	struct Change
+	{
+		eastl::wstring path;
+		ChangeType type;
+	};
+
+	FileWatcher();
+	~FileWatcher();
+	FileWatcher(const FileWatcher &) = delete;
+	FileWatcher &operator=(const FileWatcher &) = delete;
+
+	// Reported paths start with the watched path, as it was given
+	bool addPath(const eastl::wstring &path, bool recursive = false);
+
+	void setDebounceTime(double milliseconds) { debounce_time = std::chrono::duration<double, std::milli>(milliseconds); }
+
+	// Reads events from OS without blocking
+	void poll(std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now());
+
+	// Returns false while a batch is still changing. Files are checked for existence here, so a path
+	// created and deleted in one batch is dropped and type of other paths is what they ended up with
+	bool popBatch(eastl::vector<Change> &changes, std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now());
 
 	template <typename F>
 	void checkUpdates(F callback_function)
 	{
 		auto time_point = std::chrono::steady_clock::now();
+		poll(time_point);
 
-		if (std::chrono::duration<double, std::milli>(time_point - last_time_point).count() < 300)
-			return;
-		last_time_point = time_point;
-
-		eastl::vector<eastl::wstring> files;
-		for (auto &[file, time]: files_times)
-		{
-			auto new_time = std::filesystem::last_write_time(file.c_str());
-			if (new_time != time)
-			{
-				time = new_time;
-				files.push_back(file.c_str());
-			}
-		}
-
-		for (auto &file : files)
-		{
-			callback_function(file);
-		}
+		eastl::vector<Change> changes;
+		if (popBatch(changes, time_point))
+			callback_function(changes);
 	}
 
 private:
-	eastl::unordered_map<eastl::wstring, std::filesystem::file_time_type> files_times;
-	std::chrono::steady_clock::time_point last_time_point = std::chrono::steady_clock::now();
-};
\ No newline at end of file
+	struct Watch;
+
+	// is_created - the event created the path (added or renamed to)
+	void add_change(const std::filesystem::path &path, std::chrono::steady_clock::time_point now, bool is_created = false);
+	void add_directory_files(const std::filesystem::path &directory, bool recursive, std::chrono::steady_clock::time_point now);
+#ifndef _WIN32
+	void add_inotify_watches(const std::filesystem::path &directory, bool recursive);
+	void remove_inotify_watches(const std::filesystem::path &directory);
+#endif
+
+	eastl::vector<std::unique_ptr<Watch>> watches;
+#ifndef _WIN32
+	int inotify_descriptor = -1;
+#endif
+
+	// Paths in order of their first event, one entry per path
+	eastl::vector<eastl::wstring> pending;
+	eastl::hash_set<eastl::wstring> pending_set;
+	// Pending paths that didn't exist before their first event of the batch
+	eastl::hash_set<eastl::wstring> created;
+	// Modified and not closed yet (Linux only, Windows doesn't report closes)
+	eastl::hash_set<eastl::wstring> writing;
+	std::chrono::steady_clock::time_point batch_start_time;
+	std::chrono::steady_clock::time_point last_event_time;
+
+	std::chrono::duration<double, std::milli> debounce_time{200.0};
+	// File that is written all the time still gets reported
+	std::chrono::duration<double, std::milli> max_batch_time{2000.0};
+};
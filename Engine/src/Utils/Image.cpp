@@ -1,24 +1,45 @@
 #include "pch.h"
 #include "Image.h"
-#include <tinyddsloader.h>
-#define TINYDDS_IMPLEMENTATION
-#include <tinydds.h>
 #include <stb_image.h>
-#include <compressonator.h>
-#include "dds_helpers.h"
 #include "dds.h"
+#include "BCnEncoder.h"
 #include "Utils/FileStream.h"
+#include "Utils/Math.h"
 #include "Assets/AssetManager.h"
+#include "Core/Variables.h"
+#include <atomic>
+#include <thread>
+#include <chrono>
 
-static CMP_FORMAT to_cmp_format(Format format)
+static Format get_dds_format(dds::DXGI_FORMAT dxgi_format)
 {
-	switch(format)
+	switch (dxgi_format)
 	{
-		case FORMAT_R8G8B8A8_SRGB: return CMP_FORMAT_RGBA_8888;
+		case dds::DXGI_FORMAT_R8G8B8A8_UNORM:
+		case dds::DXGI_FORMAT_B8G8R8A8_UNORM: return FORMAT_R8G8B8A8_UNORM;
+		case dds::DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
+		case dds::DXGI_FORMAT_B8G8R8A8_UNORM_SRGB: return FORMAT_R8G8B8A8_SRGB;
+		case dds::DXGI_FORMAT_BC1_UNORM: return FORMAT_BC1;
+		case dds::DXGI_FORMAT_BC1_UNORM_SRGB: return FORMAT_BC1_SRGB;
+		case dds::DXGI_FORMAT_BC3_UNORM: return FORMAT_BC3;
+		case dds::DXGI_FORMAT_BC4_UNORM: return FORMAT_BC4;
+		case dds::DXGI_FORMAT_BC5_UNORM: return FORMAT_BC5;
+		case dds::DXGI_FORMAT_BC7_UNORM: return FORMAT_BC7;
+		case dds::DXGI_FORMAT_BC7_UNORM_SRGB: return FORMAT_BC7_SRGB;
 	}
-	return CMP_FORMAT_Unknown;
+	return FORMAT_UNDEFINED;
 }
 
+static float srgb_to_linear(float value)
+{
+	return value <= 0.04045f ? value / 12.92f : powf((value + 0.055f) / 1.055f, 2.4f);
+}
+
+static uint8_t linear_to_srgb(float value)
+{
+	value = value <= 0.0031308f ? value * 12.92f : 1.055f * powf(value, 1.0f / 2.4f) - 0.055f;
+	return (uint8_t)(eastl::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+}
 
 Image::Image(eastl::string path)
 {
@@ -27,39 +48,180 @@ Image::Image(eastl::string path)
 
 void Image::createMipmaps()
 {
-	// Mipmaps generation for compressed formats is not supported now
-	if (isCompressedFormat())
+	// Mipmaps generation for compressed and float formats is not supported now
+	if (isCompressedFormat() || getFormatSize(format) != 4)
 		return;
-	CMP_MipSet mipSetIn{};
-	mipSetIn.m_nWidth = width;
-	mipSetIn.m_nHeight = height;
-	mipSetIn.m_format = CMP_FORMAT_RGBA_8888;
-	mipSetIn.m_nMipLevels = 1;
-	mipSetIn.pData = data.data();
-	mipSetIn.dwDataSize = data.size();
-
-	CMP_INT requestLevel = CMP_CalcMaxMipLevel(mipSetIn.m_nHeight, mipSetIn.m_nWidth, true);
-	CMP_INT nMinSize = CMP_CalcMinMipSize(mipSetIn.m_nHeight, mipSetIn.m_nWidth, requestLevel);
+	PROFILE_CPU_FUNCTION();
+	copyMappedData();
 
-	CMP_MipSet srcMipSet = {};
-	CMP_CreateMipSet(&srcMipSet, width, height, 1, CF_8bit, TT_2D);
-	memcpy(srcMipSet.pData, data.data(), srcMipSet.dwDataSize);
+	// getWidth(mip) doesn't clamp to 1, so the chain ends when the smaller side reaches 1
+	mip_levels = 1;
+	while (eastl::min(getWidth(mip_levels), getHeight(mip_levels)) >= 1)
+		mip_levels++;
 
-	CMP_GenerateMIPLevels(&srcMipSet, nMinSize);
+	// sRGB colors are averaged in linear space, otherwise mips of contrasty textures get darker. Alpha is linear
+	bool is_srgb = format == FORMAT_R8G8B8A8_SRGB;
+	float to_linear[256];
+	for (uint32_t i = 0; i < 256; i++)
+		to_linear[i] = srgb_to_linear(i / 255.0f);
 
-	mip_levels = srcMipSet.m_nMipLevels;
+	uint64_t source_offset = 0;
 	data.resize(getImageSize());
+	for (uint32_t mip = 1; mip < mip_levels; mip++)
+	{
+		const uint8_t *source = data.data() + source_offset;
+		uint8_t *destination = data.data() + source_offset + getImageSize(mip - 1);
+		uint32_t source_width = getWidth(mip - 1);
+		uint32_t source_height = getHeight(mip - 1);
+
+		// 2x2 box filter, the last row and column of odd sizes are dropped
+		for (uint32_t y = 0; y < getHeight(mip); y++)
+		{
+			for (uint32_t x = 0; x < getWidth(mip); x++)
+			{
+				const uint8_t *row0 = source + ((uint64_t)(y * 2) * source_width + x * 2) * 4;
+				const uint8_t *row1 = source + ((uint64_t)eastl::min(y * 2 + 1, source_height - 1) * source_width + x * 2) * 4;
+				uint32_t next = x * 2 + 1 < source_width ? 4 : 0;
+				uint8_t *texel = destination + ((uint64_t)y * getWidth(mip) + x) * 4;
+				for (uint32_t c = 0; c < 4; c++)
+				{
+					if (is_srgb && c < 3)
+						texel[c] = linear_to_srgb((to_linear[row0[c]] + to_linear[row0[next + c]] + to_linear[row1[c]] + to_linear[row1[next + c]]) * 0.25f);
+					else
+						texel[c] = (row0[c] + row0[next + c] + row1[c] + row1[next + c] + 2) / 4;
+				}
+			}
+		}
+		source_offset += getImageSize(mip - 1);
+	}
+}
 
-	size_t offset = 0;
-	for (int mip = 0; mip < mip_levels; mip++)
+void Image::compress(Format target_format)
+{
+	if (isCompressedFormat() || getFormatSize(format) != 4 || !BCn::isSupportedFormat(target_format))
 	{
-		CMP_MipLevel *level = nullptr;
-		CMP_GetMipLevel(&level, &srcMipSet, mip, 0);
-		memcpy(data.data() + offset, level->m_pdwData, level->m_dwLinearSize);
-		offset += level->m_dwLinearSize;
+		CORE_WARN("Image {} can't be compressed from {} to {}", path.c_str(), getFormatName(format), getFormatName(target_format));
+		return;
 	}
+	PROFILE_CPU_FUNCTION();
+	copyMappedData();
+
+	// Jobs are a few block rows of one mip, so large mips are split across threads and small mips don't wait on them
+	constexpr uint32_t JOB_BLOCK_ROWS = 8;
+	struct Job
+	{
+		uint32_t mip;
+		uint32_t first_row;
+		uint32_t row_count;
+		uint64_t source_offset;
+		uint64_t destination_offset;
+		double squared_error = 0.0;
+		bool is_decoded = true;
+	};
 
-	CMP_FreeMipSet(&mipSetIn);
+	uint32_t block_bytes = BCn::getBlockBytes(target_format);
+	eastl::vector<Job> jobs;
+	uint64_t source_offset = 0;
+	uint64_t destination_offset = 0;
+	uint64_t texels_count = 0;
+	for (uint32_t mip = 0; mip < mip_levels; mip++)
+	{
+		uint32_t blocks_width = Math::divideRoundUp(getWidth(mip), 4u);
+		uint32_t blocks_height = Math::divideRoundUp(getHeight(mip), 4u);
+		for (uint32_t row = 0; row < blocks_height; row += JOB_BLOCK_ROWS)
+		{
+			uint64_t row_offset = (uint64_t)row * blocks_width * block_bytes;
+			jobs.push_back({mip, row, eastl::min(JOB_BLOCK_ROWS, blocks_height - row), source_offset, destination_offset + row_offset});
+		}
+		source_offset += getImageSize(mip);
+		destination_offset += (uint64_t)blocks_width * blocks_height * block_bytes;
+		texels_count += (uint64_t)getWidth(mip) * getHeight(mip);
+	}
+
+	eastl::vector<uint8_t> compressed(destination_offset);
+	uint32_t channels = BCn::getChannelCount(target_format);
+	std::atomic<uint32_t> next_job{0};
+	auto worker = [&]()
+	{
+		uint8_t texels[64];
+		uint8_t decoded[64];
+		while (true)
+		{
+			uint32_t job_index = next_job.fetch_add(1);
+			if (job_index >= jobs.size())
+				break;
+
+			Job &job = jobs[job_index];
+			uint32_t mip_width = getWidth(job.mip);
+			uint32_t mip_height = getHeight(job.mip);
+			uint32_t blocks_width = Math::divideRoundUp(mip_width, 4u);
+			const uint8_t *source = data.data() + job.source_offset;
+			uint8_t *block = compressed.data() + job.destination_offset;
+			for (uint32_t y = job.first_row; y < job.first_row + job.row_count; y++)
+			{
+				for (uint32_t x = 0; x < blocks_width; x++, block += block_bytes)
+				{
+					BCn::loadBlock(source, mip_width, mip_height, x, y, texels);
+					BCn::encodeBlock(target_format, texels, block);
+
+					// Error of texels inside the image only, padding of small mips is not sampled
+					job.is_decoded &= BCn::decodeBlock(target_format, block, decoded);
+					for (uint32_t i = 0; i < 16; i++)
+					{
+						if (x * 4 + i % 4 >= mip_width || y * 4 + i / 4 >= mip_height)
+							continue;
+						for (uint32_t c = 0; c < channels; c++)
+						{
+							int d = (int)texels[i * 4 + c] - (int)decoded[i * 4 + c];
+							job.squared_error += d * d;
+						}
+					}
+				}
+			}
+		}
+	};
+
+	int threads_count;
+	if (engine_texture_cook_threads > 0)
+		threads_count = engine_texture_cook_threads;
+	else
+		threads_count = std::max(1u, std::thread::hardware_concurrency());
+	threads_count = eastl::min(threads_count, (int)jobs.size());
+
+	auto start_time = std::chrono::steady_clock::now();
+	eastl::vector<std::thread> threads(eastl::max(threads_count - 1, 0));
+	for (auto &t : threads)
+		t = std::thread(worker);
+	worker(); // main thread also executes
+
+	for (auto &t : threads)
+		t.join();
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+
+	double squared_error = 0.0;
+	bool is_decoded = true;
+	for (const Job &job : jobs)
+	{
+		squared_error += job.squared_error;
+		is_decoded &= job.is_decoded;
+	}
+	double mse = squared_error / ((double)texels_count * channels);
+	double psnr = mse > 0.0 ? 10.0 * log10(255.0 * 255.0 / mse) : 99.0;
+	double megatexels_per_second = texels_count / eastl::max(seconds, 1e-6) / 1e6;
+	if (is_decoded)
+		CORE_INFO("Compressed {} ({}x{}, {} mips) to {}: PSNR {:.2f} dB, {:.1f} MTexels/s on {} threads", path.c_str(), width, height, mip_levels, getFormatName(target_format), psnr, megatexels_per_second, eastl::max(threads_count, 1));
+
+	data = eastl::move(compressed);
+	format = target_format;
+}
+
+void Image::copyMappedData()
+{
+	if (mapped_data.empty())
+		return;
+	data.assign(mapped_data.begin(), mapped_data.end());
+	mapped_data = {};
+	file_memory.close();
 }
 
 void Image::load(eastl::string path)
@@ -77,6 +239,10 @@ void Image::load(eastl::string path)
 		runtime_path = AssetManager::getRuntimePath(path.c_str()).string();
 	}
 	
+	data.clear();
+	mapped_data = {};
+	file_memory.close();
+
 	std::filesystem::path tex_path(runtime_path);
 	eastl::string ext = tex_path.extension().string().c_str();
 	void *pixels;
@@ -85,45 +251,26 @@ void Image::load(eastl::string path)
 		// TODO:
 	} else if (ext == ".dds")
 	{
-		tinyddsloader::DDSFile file;
-		tinyddsloader::Result result = file.Load(runtime_path.string().c_str());
-		if (result != tinyddsloader::Success)
+		if (!file_memory.open(runtime_path.string().c_str(), true, 0))
 		{
-			assert(false);
-			CORE_ERROR("Loading texture error");
+			CORE_ERROR("Loading texture error {}", runtime_path.string());
 			return;
 		}
 
-		//file.Flip();
-		width = file.GetWidth();
-		height = file.GetHeight();
-		mip_levels = file.GetMipCount();
+		const uint8_t *file_data = (const uint8_t *)file_memory.getData();
+		dds::Header header = dds::read_header(file_data, file_memory.getSize());
+		width = header.width();
+		height = header.height();
+		mip_levels = header.mip_levels();
+		format = get_dds_format(header.format());
 
-		auto dxgi_format = file.GetFormat();
-		if (dxgi_format == tinyddsloader::DDSFile::DXGIFormat::R8G8B8A8_UNorm || dxgi_format == tinyddsloader::DDSFile::DXGIFormat::B8G8R8A8_UNorm)
-			format = FORMAT_R8G8B8A8_UNORM;
-		else if (dxgi_format == tinyddsloader::DDSFile::DXGIFormat::R8G8B8A8_UNorm_SRGB || dxgi_format == tinyddsloader::DDSFile::DXGIFormat::B8G8R8A8_UNorm_SRGB)
-			format = FORMAT_R8G8B8A8_SRGB;
-		else if (dxgi_format == tinyddsloader::DDSFile::DXGIFormat::BC1_UNorm)
-			format = FORMAT_BC1;
-		else if (dxgi_format == tinyddsloader::DDSFile::DXGIFormat::BC3_UNorm)
-			format = FORMAT_BC3;
-		else if (dxgi_format == tinyddsloader::DDSFile::DXGIFormat::BC5_UNorm)
-			format = FORMAT_BC5;
-		else if (dxgi_format == tinyddsloader::DDSFile::DXGIFormat::BC7_UNorm)
-			format = FORMAT_BC7;
-		else
-			CORE_ERROR("Invalid texture format");
-
-
-		data.clear();
-		data.reserve(getImageSize());
-		for (int i = 0; i < mip_levels; i++)
+		if (!header.is_valid() || format == FORMAT_UNDEFINED || header.data_offset() + getImageSize() > file_memory.getSize())
 		{
-			auto *img_data = file.GetImageData(i, 0);
-			uint8_t *bytes = (uint8_t *)img_data->m_mem;
-			data.insert(data.end(), bytes, bytes + getImageSize(i));
+			CORE_ERROR("Invalid texture {}", runtime_path.string());
+			file_memory.close();
+			return;
 		}
+		mapped_data = eastl::span<const uint8_t>(file_data + header.data_offset(), getImageSize());
 	} else
 	{
 		int tex_width, tex_height, tex_channels;
@@ -168,7 +315,8 @@ void Image::save(const std::filesystem::path &path)
 		stream.write(height);
 		stream.write(mip_levels);
 		stream.write(format);
-		stream.write(data);
+		stream.write(getData().size());
+		stream.writeBytes((const char *)getData().data(), getData().size());
 	} else if (extension == ".dds")
 	{
 		dds::DXGI_FORMAT dds_format;
@@ -212,27 +360,36 @@ void Image::save(const std::filesystem::path &path)
 			case FORMAT_BC1:
 				dds_format = dds::DXGI_FORMAT_BC1_UNORM;
 				break;
+			case FORMAT_BC1_SRGB:
+				dds_format = dds::DXGI_FORMAT_BC1_UNORM_SRGB;
+				break;
 			case FORMAT_BC3:
 				dds_format = dds::DXGI_FORMAT_BC3_UNORM;
 				break;
+			case FORMAT_BC4:
+				dds_format = dds::DXGI_FORMAT_BC4_UNORM;
+				break;
 			case FORMAT_BC5:
 				dds_format = dds::DXGI_FORMAT_BC5_UNORM;
 				break;
 			case FORMAT_BC7:
 				dds_format = dds::DXGI_FORMAT_BC7_UNORM;
 				break;
+			case FORMAT_BC7_SRGB:
+				dds_format = dds::DXGI_FORMAT_BC7_UNORM_SRGB;
+				break;
 			default:
 				assert(false);
 				break;
 		}
 
-		eastl::vector<uint8_t> dds_data;
-		dds_data.resize(sizeof(dds::Header) + data.size());
-		dds::write_header(dds_data.data(), dds_format, width, height, mip_levels, 1, false, 0);
-		memcpy(dds_data.data() + sizeof(dds::Header), data.data(), data.size());
+		dds::Header header;
+		dds::write_header(&header, dds_format, width, height, mip_levels, 1, false, 0);
 
+		// Header and pixels are written separately, so mapped pixels aren't copied
 		FileStream stream(path.string().c_str(), std::ofstream::out | std::ofstream::binary);
-		stream.writeBytes((const char *)dds_data.data(), dds_data.size());
+		stream.write(header);
+		stream.writeBytes((const char *)getData().data(), getData().size());
 	} else
 	{
 		CORE_ERROR("Saving image to extension {} not supported", extension.string());
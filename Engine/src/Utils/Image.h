@@ -2,6 +2,8 @@
 #include "Core/Core.h"
 #include "Assets/Asset.h"
 #include "RHI/RHIDefinitions.h"
+#include "Utils/FileMemory.h"
+#include <EASTL/span.h>
 
 class Image : public Asset
 {
@@ -13,12 +15,13 @@ public:
 	uint32_t getMipLevels() const { return mip_levels; }
 	Format getFormat() const { return format; }
 
-	eastl::vector<uint8_t> &getRawData() { return data; }
-
+	// Pixels of all mips. Data of .dds files points into the mapped file, so it can be copied right into staging memory
+	eastl::span<const uint8_t> getData() const { return mapped_data.empty() ? eastl::span<const uint8_t>(data.data(), data.size()) : mapped_data; }
+	bool isMapped() const { return !mapped_data.empty(); }
 
 	bool isCompressedFormat() const
 	{ 
-		return format >= FORMAT_BC1 && format <= FORMAT_BC7;
+		return ::isCompressedFormat(format);
 	}
 
 	uint64_t getImageSize(uint32_t mip) const
@@ -36,11 +39,14 @@ public:
 			switch (format)
 			{
 				case FORMAT_BC1:
+				case FORMAT_BC1_SRGB:
+				case FORMAT_BC4:
 					block_size = 8;
 					break;
 				case FORMAT_BC3:
 				case FORMAT_BC5:
 				case FORMAT_BC7:
+				case FORMAT_BC7_SRGB:
 					block_size = 16;
 					break;
 			}
@@ -59,12 +65,18 @@ public:
 	}
 
 	void createMipmaps();
+	// Encodes all mips of an RGBA8 image into a BCn format supported by BCnEncoder
+	void compress(Format target_format);
 
 	void load(eastl::string path);
+	// Copies mapped pixels to the heap and unmaps the file. Mipmaps and compression edit pixels in place, so they do it first
+	void copyMappedData();
 
 	void save(const std::filesystem::path &path);
 private:
 	eastl::vector<uint8_t> data;
+	FileMemory file_memory;
+	eastl::span<const uint8_t> mapped_data;
 	eastl::string path;
 
 	uint32_t width;
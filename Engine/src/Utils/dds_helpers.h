@@ -1,37 +0,0 @@
-// Copyright (c) 2016-2024 Advanced Micro Devices, Inc. All rights reserved
-// Copyright (c) 2004-2006    ATI Technologies Inc.
-//
-// Permission is hereby granted, free of charge, to any person obtaining a copy
-// of this software and associated documentation files(the "Software"), to deal
-// in the Software without restriction, including without limitation the rights
-// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
-// copies of the Software, and to permit persons to whom the Software is
-// furnished to do so, subject to the following conditions :
-//
-// The above copyright notice and this permission notice shall be included in
-// all copies or substantial portions of the Software.
-//
-// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
-// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
-// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
-// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
-// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
-// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
-// THE SOFTWARE.
-//
-// AMD_Compress_Test_Helpers.h : Defines the entry point for the console application.
-//
-
-#include "compressonator.h"]
-
-namespace CMP
-{
-	CMP_FORMAT GetFormat(CMP_DWORD dwFourCC);
-	CMP_DWORD  GetFourCC(CMP_FORMAT nFormat);
-	bool       IsDXT5SwizzledFormat(CMP_FORMAT nFormat);
-	CMP_FORMAT ParseFormat(const char *pszFormat);
-	char *GetFormatDesc(CMP_FORMAT nFormat);
-
-	bool LoadDDSFile(const char *pszFile, CMP_Texture &texture);
-	void SaveDDSFile(const char *pszFile, CMP_Texture &texture);
-}
\ No newline at end of file
@@ -1,5 +1,6 @@
 workspace "RenderingEngine"
 	architecture "x64"
+	startproject "Engine"
 
 	configurations
 	{
@@ -39,12 +40,10 @@ IncludeDir["PhysX"] = "vendor/physx/physx/include"
 IncludeDir["SPIRV_Reflect"] = "vendor/spirv-reflect"
 IncludeDir["Tracy"] = "vendor/tracy"
 IncludeDir["WinPixRuntime"] = "vendor/WinPixEventRuntime"
-IncludeDir["Compressonator"] = "vendor/Compressonator/include"
 IncludeDir["Streamline"] = "vendor/streamline/include"
 
 LibDir = {}
 LibDir["Vulkan"] = "%{VULKAN_SDK}/Lib"
-LibDir["Compressonator"] = "vendor/Compressonator/lib/bin/x64"
 
 group "Dependencies"
 include "vendor/EASTL"
@@ -74,9 +73,8 @@ function copy_dir_to_target_dir(from_dir, folder)
 	}
 end
 
-project "Engine"
-	location "Engine"
-	kind "ConsoleApp"
+-- Compiler and linker setup of everything that builds engine sources
+function engine_settings()
 	language "C++"
 	cppdialect "C++17"
 	staticruntime "on"
@@ -89,8 +87,8 @@ project "Engine"
 	
 	files
 	{
-		"%{prj.name}/src/**.h",
-		"%{prj.name}/src/**.cpp",
+		"Engine/src/**.h",
+		"Engine/src/**.cpp",
 		"%{IncludeDir.EASTL}/../**.natvis",
 		"%{IncludeDir.YamlCpp}/../**.natvis",
 		"%{IncludeDir.Entt}/../natvis/**.natvis",
@@ -123,14 +121,12 @@ project "Engine"
 		"%{IncludeDir.SPIRV_Reflect}",
 		"%{IncludeDir.Tracy}/tracy",
 		"%{IncludeDir.WinPixRuntime}/include",
-		"%{IncludeDir.Compressonator}",
 		"%{IncludeDir.Streamline}",
 	}
 
 	libdirs
 	{
 		"%{IncludeDir.WinPixRuntime}/lib",
-		"%{LibDir.Compressonator}"
 	}
 
 	links
@@ -163,15 +159,6 @@ project "Engine"
 
 	filter "system:windows"
 		systemversion "latest"
-		-- Agility SDK
-		copy_file_to_target_dir("%{wks.location}%{IncludeDir.DirectX}/../dlls/D3D12", "D3D12/", "D3D12Core.dll")
-		copy_file_to_target_dir("%{wks.location}%{IncludeDir.DirectX}/../dlls/D3D12", "D3D12/", "D3D12Core.pdb")
-		copy_file_to_target_dir("%{wks.location}%{IncludeDir.DirectX}/../dlls/D3D12", "D3D12/", "d3d12SDKLayers.dll")
-		copy_file_to_target_dir("%{wks.location}%{IncludeDir.DirectX}/../dlls/D3D12", "D3D12/", "d3d12SDKLayers.pdb")
-		-- WinPixRuntime
-		copy_file_to_target_dir("%{wks.location}%{IncludeDir.WinPixRuntime}/dlls/", "/", "WinPixEventRuntime.dll")
-		-- Streamline
-		copy_dir_to_target_dir("%{wks.location}vendor/streamline/bin/x64/development", "NVStreamline/")
 
 	filter "configurations:Debug"
 		editandcontinue "On"
@@ -181,10 +168,6 @@ project "Engine"
 			"DEBUG",
 			"_DEBUG"
 		}
-		links
-		{
-			"Compressonator_MTd.lib",
-		}
 
 	filter "configurations:Fast Debug"
 		editandcontinue "Off"
@@ -194,10 +177,6 @@ project "Engine"
 			"TRACY_ENABLE",
 			"TRACY_ON_DEMAND"
 		}
-		links
-		{
-			"Compressonator_MTd.lib",
-		}
 
 	filter "configurations:Release"
 		optimize "On"
@@ -207,7 +186,39 @@ project "Engine"
 			"TRACY_ON_DEMAND",
 			"NDEBUG"
 		}
-		links
-		{
-			"Compressonator_MT.lib",
-		}
\ No newline at end of file
+
+	filter {}
+end
+
+project "Engine"
+	location "Engine"
+	kind "ConsoleApp"
+	engine_settings()
+
+	filter "system:windows"
+		-- Agility SDK
+		copy_file_to_target_dir("%{wks.location}%{IncludeDir.DirectX}/../dlls/D3D12", "D3D12/", "D3D12Core.dll")
+		copy_file_to_target_dir("%{wks.location}%{IncludeDir.DirectX}/../dlls/D3D12", "D3D12/", "D3D12Core.pdb")
+		copy_file_to_target_dir("%{wks.location}%{IncludeDir.DirectX}/../dlls/D3D12", "D3D12/", "d3d12SDKLayers.dll")
+		copy_file_to_target_dir("%{wks.location}%{IncludeDir.DirectX}/../dlls/D3D12", "D3D12/", "d3d12SDKLayers.pdb")
+		-- WinPixRuntime
+		copy_file_to_target_dir("%{wks.location}%{IncludeDir.WinPixRuntime}/dlls/", "/", "WinPixEventRuntime.dll")
+		-- Streamline
+		copy_dir_to_target_dir("%{wks.location}vendor/streamline/bin/x64/development", "NVStreamline/")
+
+-- CPU side of engine data paths measured on the null RHI, see Engine/microbenchmarks
+project "Microbenchmarks"
+	location "Engine"
+	kind "ConsoleApp"
+	engine_settings()
+
+	files
+	{
+		"Engine/microbenchmarks/**.h",
+		"Engine/microbenchmarks/**.cpp",
+	}
+
+	removefiles
+	{
+		"Engine/src/Main.cpp",
+	}